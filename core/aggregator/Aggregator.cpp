@@ -21,6 +21,8 @@
 #include <config_manager/ConfigManager.h>
 #include <monitor/LogFileProfiler.h>
 
+#include <algorithm>
+#include <chrono>
 #include <numeric>
 #include <vector>
 
@@ -36,6 +38,7 @@ using namespace sls_logs;
 
 DEFINE_FLAG_BOOL(default_secondary_storage, "default strategy whether enable secondary storage", false);
 DEFINE_FLAG_INT32(batch_send_metric_size, "batch send metric size limit(bytes)(default 256KB)", 256 * 1024);
+DEFINE_FLAG_INT32(merge_map_shard_count, "shards of aggregator merge maps, each with its own lock", 16);
 
 DECLARE_FLAG_INT32(merge_log_count_limit);
 DECLARE_FLAG_INT32(same_topic_merge_send_count);
@@ -43,11 +46,90 @@ DECLARE_FLAG_INT32(max_send_log_group_size);
 
 namespace logtail {
 
+namespace {
+
+// helpers hiding the difference between sls_logs::LogGroup and SerializedLogGroup during merging
+
+inline sls_logs::LogGroup& GetGroupFields(sls_logs::LogGroup& logGroup) {
+    return logGroup;
+}
+
+inline sls_logs::LogGroup& GetGroupFields(SerializedLogGroup& logGroup) {
+    return logGroup.mGroup;
+}
+
+inline uint32_t GetLogTime(const sls_logs::LogGroup& logGroup, int32_t idx) {
+    return logGroup.logs(idx).time();
+}
+
+inline uint32_t GetLogTime(const SerializedLogGroup& logGroup, int32_t idx) {
+    return logGroup.mLogTimes[idx];
+}
+
+inline void ReserveLogs(MergeItem* item, const sls_logs::LogGroup& logGroup) {
+    item->mLogGroup.mutable_logs()->Reserve(INT32_FLAG(merge_log_count_limit));
+}
+
+inline void ReserveLogs(MergeItem* item, const SerializedLogGroup& logGroup) {
+}
+
+// the log is owned by the merge item afterwards, call ReleaseLogs after all logs are moved
+inline void MoveLog(sls_logs::LogGroup& logGroup, int32_t idx, MergeItem* item) {
+    item->mLogGroup.mutable_logs()->AddAllocated(logGroup.mutable_logs()->Mutable(idx));
+}
+
+inline void MoveLog(SerializedLogGroup& logGroup, int32_t idx, MergeItem* item) {
+    StringView data = logGroup.GetLogData(idx);
+    item->mLastSerializedLog = std::make_pair(static_cast<uint32_t>(item->mSerializedLogs.size()),
+                                              static_cast<uint32_t>(data.size()));
+    item->mSerializedLogs.append(data.data(), data.size());
+}
+
+inline void ReleaseLogs(sls_logs::LogGroup& logGroup) {
+    int32_t logSize = logGroup.logs_size();
+    for (int32_t logIdx = 0; logIdx < logSize; logIdx++) {
+        logGroup.mutable_logs()->ReleaseLast();
+    }
+}
+
+inline void ReleaseLogs(SerializedLogGroup& logGroup) {
+}
+
+} // namespace
+
+MergeItem::~MergeItem() {
+    if (mMemoryBudget) {
+        mMemoryBudget->Release(mChargedBytes);
+    }
+}
 
 bool MergeItem::IsReady() {
     return mRawBytes > INT32_FLAG(batch_send_metric_size) || ((time(NULL) - mLastUpdateTime) >= mBatchSendInterval);
 }
 
+void MergeItem::ChargeMemoryBudget(const std::shared_ptr<PipelineMemoryBudget>& budget) {
+    if (!budget || mRawBytes == mChargedBytes) {
+        return;
+    }
+    if (!mMemoryBudget) {
+        mMemoryBudget = budget;
+    }
+    mMemoryBudget->Reserve(mRawBytes - mChargedBytes);
+    mChargedBytes = mRawBytes;
+}
+
+void MergeItem::SerializeToString(std::string* output) const {
+    output->clear();
+    if (!mSerializedLogs.empty()) {
+        // fields can be in any order on the wire, so serialized logs can be put before the other fields
+        output->reserve(mSerializedLogs.size() + mLogGroup.ByteSizeLong());
+        output->append(mSerializedLogs);
+        mLogGroup.AppendToString(output);
+    } else {
+        mLogGroup.SerializeToString(output);
+    }
+}
+
 bool PackageListMergeBuffer::IsReady(int32_t curTime) {
     // should use 2 * INT32_FLAG(batch_send_interval)), package list interval should > merge item interval
     return (mTotalRawBytes >= INT32_FLAG(batch_send_metric_size))
@@ -55,39 +137,71 @@ bool PackageListMergeBuffer::IsReady(int32_t curTime) {
 }
 
 
+Aggregator::Aggregator() {
+    mMergeShards.resize(std::max(INT32_FLAG(merge_map_shard_count), 1));
+    for (auto& shard : mMergeShards) {
+        shard.reset(new MergeShard());
+    }
+}
+
+std::unique_lock<PTMutex> Aggregator::LockMergeShard(MergeShard& shard) {
+    std::unique_lock<PTMutex> lock(shard.mMergeLock, std::try_to_lock);
+    if (!lock.owns_lock()) {
+        auto startTime = std::chrono::steady_clock::now();
+        lock.lock();
+        shard.mLockWaitTimeNs.fetch_add(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - startTime).count(),
+            std::memory_order_relaxed);
+    }
+    return lock;
+}
+
 bool Aggregator::FlushReadyBuffer() {
+    int32_t curTime = time(NULL);
+    for (auto& shard : mMergeShards) {
+        FlushMergeShard(*shard, curTime);
+    }
+    return true;
+}
+
+void Aggregator::FlushMergeShard(MergeShard& shard, int32_t curTime) {
     static Sender* sender = Sender::Instance();
     vector<MergeItem*> sendDataVec;
+    vector<MergeItem*> packageItems;
     {
-        PTScopedLock lock(mMergeLock);
-        unordered_map<int64_t, MergeItem*>::iterator itr = mMergeMap.begin();
-        for (; itr != mMergeMap.end();) {
+        auto lock = LockMergeShard(shard);
+        unordered_map<int64_t, MergeItem*>::iterator itr = shard.mMergeMap.begin();
+        for (; itr != shard.mMergeMap.end();) {
             if (Application::GetInstance()->IsExiting()
                 || (itr->second->IsReady()
                     && sender->GetSenderFeedBackInterface()->IsValidToPush(itr->second->mLogstoreKey))) {
                 if (itr->second->mMergeType == FlusherSLS::Batch::MergeType::TOPIC)
                     sendDataVec.push_back(itr->second);
-                else {
-                    int64_t key = itr->second->mKey;
-                    unordered_map<int64_t, PackageListMergeBuffer*>::iterator pIter = mPackageListMergeMap.find(key);
-                    if (pIter == mPackageListMergeMap.end()) {
-                        PackageListMergeBuffer* tmpPtr = new PackageListMergeBuffer;
-                        pIter = mPackageListMergeMap.insert(std::make_pair(key, tmpPtr)).first;
-                    }
-                    pIter->second->AddMergeItem(itr->second);
-                }
-                itr = mMergeMap.erase(itr);
+                else
+                    packageItems.push_back(itr->second);
+                itr = shard.mMergeMap.erase(itr);
             } else
                 itr++;
         }
     }
+    // package list buffers are keyed by logstore, which may belong to another shard
+    for (auto item : packageItems) {
+        MergeShard& packageShard = GetMergeShard(item->mKey);
+        auto lock = LockMergeShard(packageShard);
+        unordered_map<int64_t, PackageListMergeBuffer*>::iterator pIter
+            = packageShard.mPackageListMergeMap.find(item->mKey);
+        if (pIter == packageShard.mPackageListMergeMap.end()) {
+            PackageListMergeBuffer* tmpPtr = new PackageListMergeBuffer;
+            pIter = packageShard.mPackageListMergeMap.insert(std::make_pair(item->mKey, tmpPtr)).first;
+        }
+        pIter->second->AddMergeItem(item);
+    }
 
     vector<vector<MergeItem*> > packageListVec;
-    int32_t curTime = time(NULL);
     {
-        PTScopedLock lock(mMergeLock);
-        unordered_map<int64_t, PackageListMergeBuffer*>::iterator pIter = mPackageListMergeMap.begin();
-        for (; pIter != mPackageListMergeMap.end();) {
+        auto lock = LockMergeShard(shard);
+        unordered_map<int64_t, PackageListMergeBuffer*>::iterator pIter = shard.mPackageListMergeMap.begin();
+        for (; pIter != shard.mPackageListMergeMap.end();) {
             if (Application::GetInstance()->IsExiting()
                 || (pIter->second->IsReady(curTime) && pIter->second->mMergeItems.size() > 0
                     && sender->GetSenderFeedBackInterface()->IsValidToPush(
@@ -103,7 +217,7 @@ bool Aggregator::FlushReadyBuffer() {
                     sendDataVec.push_back(
                         pIter->second->mMergeItems[0]); // send LogGroup avoid more cost for LogPackageList
                 delete pIter->second;
-                pIter = mPackageListMergeMap.erase(pIter);
+                pIter = shard.mPackageListMergeMap.erase(pIter);
             } else
                 pIter++;
         }
@@ -115,7 +229,6 @@ bool Aggregator::FlushReadyBuffer() {
     for (vector<vector<MergeItem*> >::iterator plIter = packageListVec.begin(); plIter != packageListVec.end();
          ++plIter)
         sender->SendLogPackageList(*plIter);
-    return true;
 }
 
 void Aggregator::AddPackIDForLogGroup(const std::string& packIDPrefix,
@@ -141,6 +254,51 @@ bool Aggregator::Add(const std::string& projectName,
                      const std::string& defaultRegion,
                      const std::string& filename,
                      const LogGroupContext& context) {
+    return AddImpl(projectName,
+                   sourceId,
+                   logGroup,
+                   logGroupKey,
+                   config,
+                   mergeType,
+                   logGroupSize,
+                   defaultRegion,
+                   filename,
+                   context);
+}
+
+bool Aggregator::Add(const std::string& projectName,
+                     const std::string& sourceId,
+                     SerializedLogGroup& logGroup,
+                     int64_t logGroupKey,
+                     const FlusherSLS* config,
+                     FlusherSLS::Batch::MergeType mergeType,
+                     uint32_t logGroupSize,
+                     const std::string& defaultRegion,
+                     const std::string& filename,
+                     const LogGroupContext& context) {
+    return AddImpl(projectName,
+                   sourceId,
+                   logGroup,
+                   logGroupKey,
+                   config,
+                   mergeType,
+                   logGroupSize,
+                   defaultRegion,
+                   filename,
+                   context);
+}
+
+template <class T>
+bool Aggregator::AddImpl(const std::string& projectName,
+                         const std::string& sourceId,
+                         T& logGroup,
+                         int64_t logGroupKey,
+                         const FlusherSLS* config,
+                         FlusherSLS::Batch::MergeType mergeType,
+                         uint32_t logGroupSize,
+                         const std::string& defaultRegion,
+                         const std::string& filename,
+                         const LogGroupContext& context) {
     if (logGroupSize == 0) {
         logGroupSize = logGroup.ByteSize();
     }
@@ -155,22 +313,22 @@ bool Aggregator::Add(const std::string& projectName,
     if (logSize == 0)
         return true;
     vector<int32_t> neededLogs;
-    int32_t neededLogSize = logSize;
     neededLogs.resize(logSize);
     std::iota(std::begin(neededLogs), std::end(neededLogs), 0);
 
     static Sender* sender = Sender::Instance();
+    sls_logs::LogGroup& groupFields = GetGroupFields(logGroup);
     const string& region = (config == NULL ? defaultRegion : config->mRegion);
     const string& aliuid = (config == NULL ? STRING_FLAG(logtail_profile_aliuid) : config->mAliuid);
     const string& configName = ((config == NULL || !config->HasContext()) ? "" : config->GetContext().GetConfigName());
-    const string& category = logGroup.category();
-    const string& topic = logGroup.topic();
-    const string& source = logGroup.has_source() ? logGroup.source() : LogFileProfiler::mIpAddr;
+    const string& category = groupFields.category();
+    const string& topic = groupFields.topic();
+    const string& source = groupFields.has_source() ? groupFields.source() : LogFileProfiler::mIpAddr;
     string shardHashKey = CalPostRequestShardHashKey(source, topic, config);
 
     // Replay checkpoint had already been merged, resend directly.
     if (context.mExactlyOnceCheckpoint && context.mExactlyOnceCheckpoint->IsComplete()) {
-        AddPackIDForLogGroup(sourceId, logGroupKey, logGroup);
+        AddPackIDForLogGroup(sourceId, logGroupKey, groupFields);
         sender->SendCompressed(projectName, logGroup, neededLogs, configName, aliuid, region, filename, context);
         LOG_DEBUG(sLogger,
                   ("complete checkpoint", "resend directly")("filename", filename)(
@@ -189,161 +347,158 @@ bool Aggregator::Add(const std::string& projectName,
         key = logGroupKey;
     }
 
-    LogGroup discardLogGroup;
     vector<MergeItem*> sendDataVec;
     int32_t logByteSize = logGroupSize / logSize;
-    decltype(logGroup.mutable_logs()->mutable_data()) mutableLogPtr = logGroup.mutable_logs()->mutable_data();
-    int32_t neededIdx = 0;
-    int32_t discardLogSize = logSize - neededLogSize;
-    if (discardLogSize > 0) {
-        discardLogGroup.mutable_logs()->Reserve(discardLogSize);
-    }
     int32_t logCountMin = INT32_FLAG(merge_log_count_limit) > 1 ? (INT32_FLAG(merge_log_count_limit) - 1) : 0;
     int32_t logGroupByteMin = AppConfig::GetInstance()->GetMaxHoldedDataSize() > logByteSize
         ? (AppConfig::GetInstance()->GetMaxHoldedDataSize() - logByteSize)
         : 0;
 
+    // charged once per merge item instead of per log, as the budget is shared with other threads
+    shared_ptr<PipelineMemoryBudget> budget = config == NULL ? nullptr : config->GetMemoryBudget();
     int32_t curTime = time(NULL);
     {
-        PTScopedLock lock(mMergeLock);
-        unordered_map<int64_t, PackageListMergeBuffer*>::iterator pIter = mPackageListMergeMap.find(logstoreKey);
-        ;
-        unordered_map<int64_t, MergeItem*>::iterator itr = mMergeMap.find(logGroupKey);
+        MergeShard& shard = GetMergeShard(key);
+        auto lock = LockMergeShard(shard);
+        auto& mergeMap = shard.mMergeMap;
+        auto& packageListMergeMap = shard.mPackageListMergeMap;
+        unordered_map<int64_t, PackageListMergeBuffer*>::iterator pIter = packageListMergeMap.find(logstoreKey);
+        unordered_map<int64_t, MergeItem*>::iterator itr = mergeMap.find(logGroupKey);
         MergeItem* value = NULL;
         // for mergeType: LOGSTORE, value is always new
         if (mergeType == FlusherSLS::Batch::MergeType::LOGSTORE) {
-            if (pIter == mPackageListMergeMap.end()) {
+            if (pIter == packageListMergeMap.end()) {
                 PackageListMergeBuffer* tmpPtr = new PackageListMergeBuffer();
-                pIter = mPackageListMergeMap.insert(std::make_pair(logstoreKey, tmpPtr)).first;
+                pIter = packageListMergeMap.insert(std::make_pair(logstoreKey, tmpPtr)).first;
             }
         } else {
-            if (itr != mMergeMap.end()) {
+            if (itr != mergeMap.end()) {
                 value = itr->second;
             } else {
-                itr = mMergeMap.insert(std::make_pair(logGroupKey, value)).first;
+                itr = mergeMap.insert(std::make_pair(logGroupKey, value)).first;
             }
         }
         bool mergeFinishedFlag = false, initFlag = false;
         for (int32_t logIdx = 0; logIdx < logSize; logIdx++) {
-            if (neededIdx < neededLogSize && logIdx == neededLogs[neededIdx]) {
-                if (value == NULL
-                    || (value->mLines > logCountMin || value->mRawBytes > logGroupByteMin
-                        || (curTime - value->mLastUpdateTime) >= INT32_FLAG(batch_send_interval)
-                        || ((value->mLogGroup).logs(0).time() / 60 != (*(mutableLogPtr + logIdx))->time() / 60))) {
-                    // value is not NULL, log group merging finished
-                    if (value != NULL) {
-                        if (context.mMarkOffsetFlag) {
-                            // log group is split here, merged into MergeItem
-                            // set sparse info len to 0 because we don't know the real size of merged log group
-                            FileInfo* fileInfo = new FileInfo(*context.mFileInfoPtr);
-                            fileInfo->len = 0;
-                            value->mLogGroupContext.mFileInfoPtr.reset(fileInfo);
-                            mergeFinishedFlag = true;
-                        }
-
-                        // put finished value to sendDataVec, and set new value
-                        if (mergeType != FlusherSLS::Batch::MergeType::LOGSTORE) {
-                            sendDataVec.push_back(value);
-                        } else {
-                            pIter->second->AddMergeItem(value);
-                        }
+            uint32_t logTime = GetLogTime(logGroup, logIdx);
+            if (value == NULL
+                || (value->mLines > logCountMin || value->mRawBytes > logGroupByteMin
+                    || (curTime - value->mLastUpdateTime) >= INT32_FLAG(batch_send_interval)
+                    || (value->mLogTimeInMinute / 60 != static_cast<int32_t>(logTime / 60)))) {
+                // value is not NULL, log group merging finished
+                if (value != NULL) {
+                    value->ChargeMemoryBudget(budget);
+                    if (context.mMarkOffsetFlag) {
+                        // log group is split here, merged into MergeItem
+                        // set sparse info len to 0 because we don't know the real size of merged log group
+                        FileInfo* fileInfo = new FileInfo(*context.mFileInfoPtr);
+                        fileInfo->len = 0;
+                        value->mLogGroupContext.mFileInfoPtr.reset(fileInfo);
+                        mergeFinishedFlag = true;
                     }
 
-                    bool bufferOrNot = config == NULL ? BOOL_FLAG(default_secondary_storage) : true;
-                    int32_t batchSendInterval
-                        = config == NULL ? INT32_FLAG(batch_send_interval) : config->mBatch.mSendIntervalSecs;
-                    // when old value is finish
-                    // or new value
-                    if (context.mExactlyOnceCheckpoint) {
-                        // The log group might be splitted to multiple merge items, so we must
-                        //  copy range checkpoint in context.
-                        auto newContext = context;
-                        newContext.mExactlyOnceCheckpoint.reset(
-                            new RangeCheckpoint(*(context.mExactlyOnceCheckpoint.get())));
-                        value = new MergeItem(projectName,
-                                              configName,
-                                              filename,
-                                              bufferOrNot,
-                                              aliuid,
-                                              region,
-                                              key,
-                                              mergeType,
-                                              shardHashKey,
-                                              feedBackKey,
-                                              batchSendInterval,
-                                              newContext);
+                    // put finished value to sendDataVec, and set new value
+                    if (mergeType != FlusherSLS::Batch::MergeType::LOGSTORE) {
+                        sendDataVec.push_back(value);
                     } else {
-                        value = new MergeItem(projectName,
-                                              configName,
-                                              filename,
-                                              bufferOrNot,
-                                              aliuid,
-                                              region,
-                                              key,
-                                              mergeType,
-                                              shardHashKey,
-                                              feedBackKey,
-                                              batchSendInterval,
-                                              context);
+                        pIter->second->AddMergeItem(value);
                     }
-                    value->mLastUpdateTime = curTime; // set the last update time before enqueue
+                }
 
-                    initFlag = true;
-                    if (mergeType != FlusherSLS::Batch::MergeType::LOGSTORE) {
-                        itr->second = value;
-                    }
+                bool bufferOrNot = config == NULL ? BOOL_FLAG(default_secondary_storage) : true;
+                int32_t batchSendInterval
+                    = config == NULL ? INT32_FLAG(batch_send_interval) : config->mBatch.mSendIntervalSecs;
+                // when old value is finish
+                // or new value
+                if (context.mExactlyOnceCheckpoint) {
+                    // The log group might be splitted to multiple merge items, so we must
+                    //  copy range checkpoint in context.
+                    auto newContext = context;
+                    newContext.mExactlyOnceCheckpoint.reset(
+                        new RangeCheckpoint(*(context.mExactlyOnceCheckpoint.get())));
+                    value = new MergeItem(projectName,
+                                          configName,
+                                          filename,
+                                          bufferOrNot,
+                                          aliuid,
+                                          region,
+                                          key,
+                                          mergeType,
+                                          shardHashKey,
+                                          feedBackKey,
+                                          batchSendInterval,
+                                          newContext);
+                } else {
+                    value = new MergeItem(projectName,
+                                          configName,
+                                          filename,
+                                          bufferOrNot,
+                                          aliuid,
+                                          region,
+                                          key,
+                                          mergeType,
+                                          shardHashKey,
+                                          feedBackKey,
+                                          batchSendInterval,
+                                          context);
+                }
+                value->mLastUpdateTime = curTime; // set the last update time before enqueue
 
-                    (value->mLogGroup).mutable_logs()->Reserve(INT32_FLAG(merge_log_count_limit));
-                    (value->mLogGroup).set_category(category);
-                    (value->mLogGroup).set_topic(topic);
-                    (value->mLogGroup).set_machineuuid(Application::GetInstance()->GetUUID());
-                    (value->mLogGroup).set_source(logGroup.has_source() ? logGroup.source() : LogFileProfiler::mIpAddr);
-
-                    for (int32_t logTagIdx = 0; logTagIdx < logGroup.logtags_size(); ++logTagIdx) {
-                        const sls_logs::LogTag& oriLogTag = logGroup.logtags(logTagIdx);
-                        sls_logs::LogTag* logTagPtr = (value->mLogGroup).add_logtags();
-                        logTagPtr->set_key(oriLogTag.key());
-                        logTagPtr->set_value(oriLogTag.value());
-                    }
+                initFlag = true;
+                if (mergeType != FlusherSLS::Batch::MergeType::LOGSTORE) {
+                    itr->second = value;
+                }
 
-                    AddPackIDForLogGroup(sourceId, logGroupKey, value->mLogGroup);
+                ReserveLogs(value, logGroup);
+                (value->mLogGroup).set_category(category);
+                (value->mLogGroup).set_topic(topic);
+                (value->mLogGroup).set_machineuuid(Application::GetInstance()->GetUUID());
+                (value->mLogGroup).set_source(source);
+
+                for (int32_t logTagIdx = 0; logTagIdx < groupFields.logtags_size(); ++logTagIdx) {
+                    const sls_logs::LogTag& oriLogTag = groupFields.logtags(logTagIdx);
+                    sls_logs::LogTag* logTagPtr = (value->mLogGroup).add_logtags();
+                    logTagPtr->set_key(oriLogTag.key());
+                    logTagPtr->set_value(oriLogTag.value());
                 }
 
-                (value->mLogGroup).mutable_logs()->AddAllocated(*(mutableLogPtr + logIdx));
-                if (context.mExactlyOnceCheckpoint) {
-                    // TODO: for GBK, position is not correct
-                    auto& logPosition = context.mExactlyOnceCheckpoint->positions[logIdx];
-                    auto& cpt = value->mLogGroupContext.mExactlyOnceCheckpoint->data;
+                AddPackIDForLogGroup(sourceId, logGroupKey, value->mLogGroup);
+            }
 
-                    // First log, update read_offset.
-                    if (1 == value->mLogGroup.logs_size()) {
-                        cpt.set_read_offset(logPosition.first);
-                    }
-                    // Update read_length.
-                    cpt.set_read_length(logPosition.first + logPosition.second - cpt.read_offset());
+            MoveLog(logGroup, logIdx, value);
+            if (context.mExactlyOnceCheckpoint) {
+                // TODO: for GBK, position is not correct
+                auto& logPosition = context.mExactlyOnceCheckpoint->positions[logIdx];
+                auto& cpt = value->mLogGroupContext.mExactlyOnceCheckpoint->data;
+
+                // First log, update read_offset.
+                if (0 == value->mLines) {
+                    cpt.set_read_offset(logPosition.first);
                 }
+                // Update read_length.
+                cpt.set_read_length(logPosition.first + logPosition.second - cpt.read_offset());
+            }
 
-                // get first log time as log time of this log group in merge item
-                value->mLogTimeInMinute = (value->mLogGroup).logs(0).time() - (value->mLogGroup).logs(0).time() % 60;
-                value->mRawBytes += logByteSize;
-                value->mLines++;
-                neededIdx++;
-            } else {
-                discardLogGroup.mutable_logs()->AddAllocated(*(mutableLogPtr + logIdx));
+            // get first log time as log time of this log group in merge item
+            if (0 == value->mLines) {
+                value->mLogTimeInMinute = logTime - logTime % 60;
             }
+            value->mRawBytes += logByteSize;
+            value->mLines++;
+        }
+        if (value != NULL) {
+            value->ChargeMemoryBudget(budget);
         }
 
         // handle truncate info, the first truncate info may be inserted while merge item 'value' initialized
         if (context.mFuseMode) {
-            MergeTruncateInfo(logGroup, value);
+            MergeTruncateInfo(groupFields, value);
         }
         if (context.mMarkOffsetFlag && !mergeFinishedFlag && !initFlag) {
             value->mLogGroupContext.mFileInfoPtr = context.mFileInfoPtr;
         }
-        // AddAllocated above
-        for (int32_t logIdx = 0; logIdx < logSize; logIdx++) {
-            logGroup.mutable_logs()->ReleaseLast();
-        }
+        // MoveLog above
+        ReleaseLogs(logGroup);
 
         if (mergeType == FlusherSLS::Batch::MergeType::LOGSTORE) {
             pIter->second->AddMergeItem(value);
@@ -357,14 +512,14 @@ bool Aggregator::Add(const std::string& projectName,
                 sendDataVec.insert(
                     sendDataVec.end(), (pIter->second)->mMergeItems.begin(), (pIter->second)->mMergeItems.end());
                 delete pIter->second;
-                mPackageListMergeMap.erase(pIter);
+                packageListMergeMap.erase(pIter);
             }
         } else {
             if (value != NULL
                 && (value->IsReady() || Application::GetInstance()->IsExiting() || context.mExactlyOnceCheckpoint)) {
                 sendDataVec.push_back(value);
-                if (itr != mMergeMap.end()) {
-                    mMergeMap.erase(itr);
+                if (itr != mergeMap.end()) {
+                    mergeMap.erase(itr);
                 }
             }
         }
@@ -488,10 +643,29 @@ int64_t Aggregator::GetAndIncLogPackSeq(int64_t key) {
 }
 
 bool Aggregator::IsMergeMapEmpty() {
-    PTScopedLock lock(mMergeLock);
-    if (mMergeMap.size() == 0 && mPackageListMergeMap.size() == 0)
-        return true;
-    return false;
+    for (auto& shard : mMergeShards) {
+        PTScopedLock lock(shard->mMergeLock);
+        if (shard->mMergeMap.size() != 0 || shard->mPackageListMergeMap.size() != 0)
+            return false;
+    }
+    return true;
+}
+
+void Aggregator::FetchShardStatistics(std::vector<size_t>& itemCounts, std::vector<uint64_t>& lockWaitTimeUs) {
+    itemCounts.clear();
+    lockWaitTimeUs.clear();
+    for (auto& shard : mMergeShards) {
+        size_t itemCount = 0;
+        {
+            PTScopedLock lock(shard->mMergeLock);
+            itemCount = shard->mMergeMap.size();
+            for (const auto& item : shard->mPackageListMergeMap) {
+                itemCount += item.second->mMergeItems.size();
+            }
+        }
+        itemCounts.push_back(itemCount);
+        lockWaitTimeUs.push_back(shard->mLockWaitTimeNs.exchange(0) / 1000);
+    }
 }
 
 } // namespace logtail
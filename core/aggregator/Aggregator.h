@@ -15,6 +15,9 @@
  */
 
 #pragma once
+#include <atomic>
+#include <memory>
+#include <mutex>
 #include <string>
 #include "log_pb/sls_logs.pb.h"
 #include <unordered_map>
@@ -22,7 +25,9 @@
 #include "common/Lock.h"
 #include "common/LogGroupContext.h"
 #include "common/Flags.h"
+#include "common/memory/MemoryBudgetManager.h"
 #include "flusher/FlusherSLS.h"
+#include "log_pb/LogGroupSerializer.h"
 
 DECLARE_FLAG_INT32(batch_send_interval);
 
@@ -36,6 +41,10 @@ struct MergeItem {
     std::string mConfigName;
     std::string mFilename;
     sls_logs::LogGroup mLogGroup;
+    // logs merged from SerializedLogGroup, which are in wire format already
+    std::string mSerializedLogs;
+    // [offset, size) of the last log in mSerializedLogs, including the field tag and length
+    std::pair<uint32_t, uint32_t> mLastSerializedLog{0, 0};
     std::string mShardHashKey;
     bool mBufferOrNot;
     std::string mAliuid;
@@ -48,7 +57,14 @@ struct MergeItem {
 
     LogGroupContext mLogGroupContext;
 
+    // raw bytes merged are charged to the budget of the pipeline until the item is destroyed, i.e. sent or discarded
+    std::shared_ptr<PipelineMemoryBudget> mMemoryBudget;
+    int32_t mChargedBytes = 0;
+
     bool IsReady();
+    void SerializeToString(std::string* output) const;
+    // charge bytes merged since the last call
+    void ChargeMemoryBudget(const std::shared_ptr<PipelineMemoryBudget>& budget);
     MergeItem(const std::string& projectName,
               const std::string& configName,
               const std::string& filename,
@@ -78,6 +94,9 @@ struct MergeItem {
         mBatchSendInterval = batchSendInterval;
         mLogGroupContext = context;
     }
+    MergeItem(const MergeItem&) = delete;
+    MergeItem& operator=(const MergeItem&) = delete;
+    ~MergeItem();
 };
 
 struct PackageListMergeBuffer {
@@ -119,6 +138,8 @@ public:
 
     bool FlushReadyBuffer();
     bool IsMergeMapEmpty();
+    // merge items held and lock wait time since last call, per shard
+    void FetchShardStatistics(std::vector<size_t>& itemCounts, std::vector<uint64_t>& lockWaitTimeUs);
 
     std::string
     CalPostRequestShardHashKey(const std::string& source, const std::string& topic, const FlusherSLS* config);
@@ -134,6 +155,17 @@ public:
              const std::string& filename = "",
              const LogGroupContext& context = LogGroupContext());
 
+    bool Add(const std::string& projectName,
+             const std::string& sourceId,
+             SerializedLogGroup& logGroup,
+             int64_t logGroupKey,
+             const FlusherSLS* config,
+             FlusherSLS::Batch::MergeType mergeType,
+             uint32_t logGroupSize,
+             const std::string& defaultRegion = "",
+             const std::string& filename = "",
+             const LogGroupContext& context = LogGroupContext());
+
     void CleanLogPackSeqMap();
     void CleanTimeoutLogPackSeq();
 
@@ -154,6 +186,31 @@ private:
         }
     };
 
+    template <class T>
+    bool AddImpl(const std::string& projectName,
+                 const std::string& sourceId,
+                 T& logGroup,
+                 int64_t logGroupKey,
+                 const FlusherSLS* config,
+                 FlusherSLS::Batch::MergeType mergeType,
+                 uint32_t logGroupSize,
+                 const std::string& defaultRegion,
+                 const std::string& filename,
+                 const LogGroupContext& context);
+
+    // Merge maps are sharded by merge key, i.e. logstore key for LOGSTORE merge type and log group key for TOPIC, so
+    // that adding logs of different logstores does not contend on one lock.
+    struct MergeShard {
+        std::unordered_map<int64_t, MergeItem*> mMergeMap;
+        std::unordered_map<int64_t, PackageListMergeBuffer*> mPackageListMergeMap;
+        PTMutex mMergeLock;
+        std::atomic_uint64_t mLockWaitTimeNs{0};
+    };
+
+    MergeShard& GetMergeShard(int64_t key) { return *mMergeShards[static_cast<uint64_t>(key) % mMergeShards.size()]; }
+    static std::unique_lock<PTMutex> LockMergeShard(MergeShard& shard);
+    void FlushMergeShard(MergeShard& shard, int32_t curTime);
+
     void MergeTruncateInfo(const sls_logs::LogGroup& logGroup, MergeItem* mergeItem);
 
     int64_t GetAndIncLogPackSeq(int64_t key);
@@ -161,16 +218,14 @@ private:
     void AddPackIDForLogGroup(const std::string& packIDPrefix, int64_t logGroupKey, sls_logs::LogGroup& logGroup);
 
 private:
-    Aggregator() = default;
+    Aggregator();
     ~Aggregator() = default;
 
 private:
     std::unordered_map<int64_t, LogPackSeqInfo*> mLogPackSeqMap;
     PTMutex mLogPackSeqMapLock;
 
-    std::unordered_map<int64_t, MergeItem*> mMergeMap;
-    std::unordered_map<int64_t, PackageListMergeBuffer*> mPackageListMergeMap;
-    PTMutex mMergeLock;
+    std::vector<std::unique_ptr<MergeShard>> mMergeShards;
 
 #ifdef APSARA_UNIT_TEST_MAIN
     int mSendVectorSize = 0;
@@ -45,6 +45,7 @@ DEFINE_FLAG_INT32(pub_buffer_file_num, "how many buffer files in default", 25);
 DEFINE_FLAG_INT32(default_local_file_size, "default size of one buffer file", 20 * 1024 * 1024);
 DEFINE_FLAG_INT32(pub_local_file_size, "default size of one buffer file", 20 * 1024 * 1024);
 DEFINE_FLAG_INT32(process_thread_count, "", 1);
+DEFINE_FLAG_INT32(reader_thread_count, "threads reading files besides LogInput thread, 0 means reading in LogInput thread", 0);
 DEFINE_FLAG_INT32(send_request_concurrency, "max count keep in mem when async send", 10);
 DEFINE_FLAG_BOOL(enable_send_tps_smoothing, "avoid web server load burst", true);
 DEFINE_FLAG_BOOL(enable_flow_control, "if enable flow control", true);
@@ -162,6 +163,7 @@ AppConfig::AppConfig() {
     // mOpenStreamLog = false;
     mSendRequestConcurrency = INT32_FLAG(send_request_concurrency);
     mProcessThreadCount = INT32_FLAG(process_thread_count);
+    mReaderThreadCount = INT32_FLAG(reader_thread_count);
     // mMappingConfigPath = STRING_FLAG(default_mapping_config_path);
     mMachineCpuUsageThreshold = DOUBLE_FLAG(default_machine_cpu_usage_threshold);
     mCpuUsageUpLimit = DOUBLE_FLAG(cpu_usage_up_limit);
@@ -361,6 +363,7 @@ void AppConfig::LoadEnvResourceLimit() {
     LoadSingleValueEnvConfig("mem_usage_limit", mMemUsageUpLimit, (int64_t)384);
     LoadSingleValueEnvConfig("max_bytes_per_sec", mMaxBytePerSec, (int32_t)(1024 * 1024));
     LoadSingleValueEnvConfig("process_thread_count", mProcessThreadCount, (int32_t)1);
+    LoadSingleValueEnvConfig("reader_thread_count", mReaderThreadCount, (int32_t)0);
     LoadSingleValueEnvConfig("send_request_concurrency", mSendRequestConcurrency, (int32_t)2);
 }
 
@@ -452,6 +455,11 @@ void AppConfig::LoadResourceConf(const Json::Value& confJson) {
     else
         mProcessThreadCount = INT32_FLAG(process_thread_count);
 
+    if (confJson.isMember("reader_thread_count") && confJson["reader_thread_count"].isInt())
+        mReaderThreadCount = confJson["reader_thread_count"].asInt();
+    else
+        mReaderThreadCount = INT32_FLAG(reader_thread_count);
+
     LoadInt32Parameter(INT32_FLAG(logreader_max_rotate_queue_size),
                        confJson,
                        "logreader_max_rotate_queue_size",
@@ -67,6 +67,7 @@ private:
     int64_t mMemUsageUpLimit;
 #endif
     int32_t mProcessThreadCount;
+    int32_t mReaderThreadCount;
     bool mInputFlowControl;
     bool mResourceAutoScale;
     float mMachineCpuUsageThreshold;
@@ -327,6 +328,8 @@ public:
 
     int32_t GetProcessThreadCount() const { return mProcessThreadCount; }
 
+    int32_t GetReaderThreadCount() const { return mReaderThreadCount; }
+
     // const std::string& GetMappingConfigPath() const { return mMappingConfigPath; }
 
     // const std::string& GetUserConfigPath() const { return mUserConfigPath; }
@@ -0,0 +1,365 @@
+// Copyright 2024 iLogtail Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "checkpoint/BinaryCheckPointStore.h"
+
+#include <chrono>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <thread>
+
+#include "checkpoint/CheckPointManager.h"
+#include "common/Flags.h"
+#include "common/HashUtil.h"
+#include "logger/Logger.h"
+
+DEFINE_FLAG_INT32(check_point_compaction_ratio,
+                  "rewrite binary check point file when it is larger than n times of the live check points",
+                  4);
+
+using namespace std;
+
+namespace logtail {
+
+static const char kMagic[4] = {'L', 'T', 'C', 'P'};
+static const uint32_t kFormatVersion = 1;
+static const size_t kHeaderSize = sizeof(kMagic) + 2 * sizeof(uint32_t);
+// body size and hash
+static const size_t kRecordHeaderSize = sizeof(uint32_t) + sizeof(uint64_t);
+
+enum RecordType : uint8_t { FILE_CHECK_POINT = 1, DELETE_FILE_CHECK_POINT = 2, DIR_CHECK_POINTS = 3 };
+
+enum FileCheckPointFlag : uint8_t { FILE_OPEN = 1, CONTAINER_STOPPED = 2, LAST_FORCE_READ = 4 };
+
+template <typename T>
+static void PutInt(string& buf, T value) {
+    buf.append(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+static void PutString(string& buf, const string& str) {
+    PutInt<uint32_t>(buf, str.size());
+    buf.append(str);
+}
+
+class RecordReader {
+public:
+    RecordReader(const char* data, size_t size) : mCur(data), mEnd(data + size) {}
+
+    template <typename T>
+    bool GetInt(T& value) {
+        if (static_cast<size_t>(mEnd - mCur) < sizeof(T)) {
+            return false;
+        }
+        memcpy(&value, mCur, sizeof(T));
+        mCur += sizeof(T);
+        return true;
+    }
+
+    bool GetString(string& str) {
+        uint32_t size = 0;
+        if (!GetInt(size) || static_cast<size_t>(mEnd - mCur) < size) {
+            return false;
+        }
+        str.assign(mCur, size);
+        mCur += size;
+        return true;
+    }
+
+    bool IsEnd() const { return mCur == mEnd; }
+
+private:
+    const char* mCur;
+    const char* mEnd;
+};
+
+// appends a record framed with its body size and hash, and returns the hash
+static uint64_t AppendRecord(string& buf, RecordType type, const string& payload) {
+    size_t start = buf.size();
+    PutInt<uint32_t>(buf, payload.size() + 1);
+    PutInt<uint64_t>(buf, 0);
+    PutInt<uint8_t>(buf, type);
+    buf.append(payload);
+    uint64_t hash = HashSignatureString(buf.data() + start + kRecordHeaderSize, payload.size() + 1);
+    memcpy(&buf[start + sizeof(uint32_t)], &hash, sizeof(hash));
+    return hash;
+}
+
+static void EncodeFileCheckPoint(const CheckPoint& cpt, string& payload) {
+    payload.clear();
+    PutInt<uint64_t>(payload, cpt.mDevInode.dev);
+    PutInt<uint64_t>(payload, cpt.mDevInode.inode);
+    PutString(payload, cpt.mConfigName);
+    PutString(payload, cpt.mFileName);
+    PutString(payload, cpt.mRealFileName);
+    PutInt<int64_t>(payload, cpt.mOffset);
+    PutInt<uint64_t>(payload, cpt.mSignatureHash);
+    PutInt<uint32_t>(payload, cpt.mSignatureSize);
+    PutInt<int32_t>(payload, cpt.mLastUpdateTime);
+    PutInt<uint8_t>(payload,
+                    (cpt.mFileOpenFlag ? FILE_OPEN : 0) | (cpt.mContainerStopped ? CONTAINER_STOPPED : 0)
+                        | (cpt.mLastForceRead ? LAST_FORCE_READ : 0));
+}
+
+static bool DecodeFileCheckPoint(RecordReader& reader, CheckPoint& cpt) {
+    uint8_t flags = 0;
+    if (!(reader.GetInt(cpt.mDevInode.dev) && reader.GetInt(cpt.mDevInode.inode) && reader.GetString(cpt.mConfigName)
+          && reader.GetString(cpt.mFileName) && reader.GetString(cpt.mRealFileName) && reader.GetInt(cpt.mOffset)
+          && reader.GetInt(cpt.mSignatureHash) && reader.GetInt(cpt.mSignatureSize)
+          && reader.GetInt(cpt.mLastUpdateTime) && reader.GetInt(flags) && reader.IsEnd())) {
+        return false;
+    }
+    cpt.mFileOpenFlag = flags & FILE_OPEN;
+    cpt.mContainerStopped = flags & CONTAINER_STOPPED;
+    cpt.mLastForceRead = flags & LAST_FORCE_READ;
+    return true;
+}
+
+static void EncodeDirCheckPoints(const unordered_map<string, DirCheckPointPtr>& dirCheckPoints, string& payload) {
+    // sorted, so that the same dir check points always have the same hash
+    map<string, const DirCheckPoint*> sortedDirs;
+    for (const auto& item : dirCheckPoints) {
+        sortedDirs.emplace(item.first, item.second.get());
+    }
+    payload.clear();
+    PutInt<uint32_t>(payload, sortedDirs.size());
+    for (const auto& item : sortedDirs) {
+        PutString(payload, item.first);
+        PutInt<int32_t>(payload, item.second->mUpdateTime);
+        PutInt<uint32_t>(payload, item.second->mSubDir.size());
+        for (const auto& subDir : item.second->mSubDir) {
+            PutString(payload, subDir);
+        }
+    }
+}
+
+static bool DecodeDirCheckPoints(RecordReader& reader, vector<DirCheckPointPtr>& dirCheckPoints) {
+    uint32_t dirCount = 0;
+    if (!reader.GetInt(dirCount)) {
+        return false;
+    }
+    vector<DirCheckPointPtr> res;
+    for (uint32_t i = 0; i < dirCount; ++i) {
+        DirCheckPointPtr dir(new DirCheckPoint());
+        uint32_t subDirCount = 0;
+        if (!(reader.GetString(dir->mParentName) && reader.GetInt(dir->mUpdateTime) && reader.GetInt(subDirCount))) {
+            return false;
+        }
+        for (uint32_t j = 0; j < subDirCount; ++j) {
+            string subDir;
+            if (!reader.GetString(subDir)) {
+                return false;
+            }
+            dir->mSubDir.insert(std::move(subDir));
+        }
+        res.push_back(dir);
+    }
+    if (!reader.IsEnd()) {
+        return false;
+    }
+    dirCheckPoints.swap(res);
+    return true;
+}
+
+bool BinaryCheckPointStore::Load(const string& filePath,
+                                 int32_t& version,
+                                 vector<CheckPointPtr>& fileCheckPoints,
+                                 vector<DirCheckPointPtr>& dirCheckPoints) {
+    Reset();
+    ifstream fin(filePath.c_str(), ios::binary);
+    if (!fin) {
+        return false;
+    }
+    string content((istreambuf_iterator<char>(fin)), istreambuf_iterator<char>());
+    if (content.size() < kHeaderSize || memcmp(content.data(), kMagic, sizeof(kMagic)) != 0) {
+        return false;
+    }
+    uint32_t formatVersion = 0;
+    RecordReader headerReader(content.data() + sizeof(kMagic), kHeaderSize - sizeof(kMagic));
+    if (!headerReader.GetInt(formatVersion) || formatVersion != kFormatVersion || !headerReader.GetInt(version)) {
+        return false;
+    }
+
+    map<FileCheckPointKey, CheckPointPtr> files;
+    size_t pos = kHeaderSize;
+    while (pos < content.size()) {
+        uint32_t bodySize = 0;
+        uint64_t hash = 0;
+        RecordReader frameReader(content.data() + pos, content.size() - pos);
+        if (!frameReader.GetInt(bodySize) || !frameReader.GetInt(hash) || bodySize == 0
+            || content.size() - pos - kRecordHeaderSize < bodySize) {
+            break;
+        }
+        const char* body = content.data() + pos + kRecordHeaderSize;
+        if (static_cast<uint64_t>(HashSignatureString(body, bodySize)) != hash) {
+            break;
+        }
+        RecordReader reader(body + 1, bodySize - 1);
+        bool valid = true;
+        switch (static_cast<uint8_t>(body[0])) {
+            case FILE_CHECK_POINT: {
+                CheckPointPtr cpt(new CheckPoint());
+                valid = DecodeFileCheckPoint(reader, *cpt);
+                if (valid) {
+                    FileCheckPointKey key(cpt->mDevInode, cpt->mConfigName);
+                    mFileRecordHashes[key] = hash;
+                    files[key] = cpt;
+                }
+                break;
+            }
+            case DELETE_FILE_CHECK_POINT: {
+                FileCheckPointKey key;
+                valid = reader.GetInt(key.first.dev) && reader.GetInt(key.first.inode) && reader.GetString(key.second)
+                    && reader.IsEnd();
+                if (valid) {
+                    mFileRecordHashes.erase(key);
+                    files.erase(key);
+                }
+                break;
+            }
+            case DIR_CHECK_POINTS:
+                valid = DecodeDirCheckPoints(reader, dirCheckPoints);
+                if (valid) {
+                    mDirRecordHash = hash;
+                }
+                break;
+            default:
+                valid = false;
+        }
+        if (!valid) {
+            break;
+        }
+        pos += kRecordHeaderSize + bodySize;
+    }
+    if (pos == content.size()) {
+        mFileSize = content.size();
+    } else {
+        // the remaining is dropped, and the file is rewritten on next dump
+        LOG_WARNING(sLogger,
+                    ("binary check point file is truncated or broken, discard the rest", filePath)("offset", pos)(
+                        "file size", content.size()));
+    }
+    fileCheckPoints.reserve(files.size());
+    for (auto& item : files) {
+        fileCheckPoints.push_back(std::move(item.second));
+    }
+    return true;
+}
+
+bool BinaryCheckPointStore::Dump(const string& filePath,
+                                 int32_t version,
+                                 const vector<const CheckPoint*>& fileCheckPoints,
+                                 const unordered_map<string, DirCheckPointPtr>& dirCheckPoints) {
+    string appended, payload, record;
+    map<FileCheckPointKey, uint64_t> fileRecordHashes;
+    uint64_t liveSize = kHeaderSize;
+    for (const auto* cpt : fileCheckPoints) {
+        EncodeFileCheckPoint(*cpt, payload);
+        record.clear();
+        uint64_t hash = AppendRecord(record, FILE_CHECK_POINT, payload);
+        liveSize += record.size();
+        FileCheckPointKey key(cpt->mDevInode, cpt->mConfigName);
+        auto iter = mFileRecordHashes.find(key);
+        if (iter == mFileRecordHashes.end() || iter->second != hash) {
+            appended.append(record);
+        }
+        fileRecordHashes.emplace(std::move(key), hash);
+    }
+    for (const auto& item : mFileRecordHashes) {
+        if (fileRecordHashes.find(item.first) == fileRecordHashes.end()) {
+            payload.clear();
+            PutInt<uint64_t>(payload, item.first.first.dev);
+            PutInt<uint64_t>(payload, item.first.first.inode);
+            PutString(payload, item.first.second);
+            AppendRecord(appended, DELETE_FILE_CHECK_POINT, payload);
+        }
+    }
+    EncodeDirCheckPoints(dirCheckPoints, payload);
+    string dirRecord;
+    uint64_t dirRecordHash = AppendRecord(dirRecord, DIR_CHECK_POINTS, payload);
+    liveSize += dirRecord.size();
+    if (dirRecordHash != mDirRecordHash) {
+        appended.append(dirRecord);
+    }
+
+    if (mFileSize == 0
+        || mFileSize + appended.size() > liveSize * max(INT32_FLAG(check_point_compaction_ratio), 1)) {
+        if (!Compact(filePath, version, fileCheckPoints, dirRecord)) {
+            Reset();
+            return false;
+        }
+        mFileSize = liveSize;
+    } else if (!appended.empty()) {
+        ofstream fout(filePath.c_str(), ios::binary | ios::app);
+        fout.write(appended.data(), appended.size());
+        fout.close();
+        if (!fout.good()) {
+            LOG_ERROR(sLogger, ("append to binary check point file failed", filePath)("errno", errno));
+            // the file may end with a torn record now
+            Reset();
+            return false;
+        }
+        mFileSize += appended.size();
+    }
+    mFileRecordHashes.swap(fileRecordHashes);
+    mDirRecordHash = dirRecordHash;
+    LOG_DEBUG(sLogger,
+              ("dump binary check point, file check point", fileCheckPoints.size())("appended bytes", appended.size())(
+                  "file size", mFileSize));
+    return true;
+}
+
+void BinaryCheckPointStore::Reset() {
+    mFileRecordHashes.clear();
+    mDirRecordHash = 0;
+    mFileSize = 0;
+}
+
+bool BinaryCheckPointStore::Compact(const string& filePath,
+                                    int32_t version,
+                                    const vector<const CheckPoint*>& fileCheckPoints,
+                                    const string& dirRecord) {
+    string tmpFilePath = filePath + ".bak";
+    ofstream fout(tmpFilePath.c_str(), ios::binary | ios::trunc);
+    if (!fout) {
+        LOG_ERROR(sLogger, ("open binary check point file error", tmpFilePath)("errno", errno));
+        return false;
+    }
+    string buf(kMagic, sizeof(kMagic)), payload;
+    PutInt<uint32_t>(buf, kFormatVersion);
+    PutInt<int32_t>(buf, version);
+    for (const auto* cpt : fileCheckPoints) {
+        EncodeFileCheckPoint(*cpt, payload);
+        AppendRecord(buf, FILE_CHECK_POINT, payload);
+    }
+    buf.append(dirRecord);
+    fout.write(buf.data(), buf.size());
+    fout.close();
+    if (!fout.good()) {
+        LOG_ERROR(sLogger, ("write binary check point file failed", tmpFilePath)("errno", errno));
+        return false;
+    }
+#if defined(_MSC_VER)
+    // The rename on Windows will fail if the destination is existing.
+    remove(filePath.c_str());
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+#endif
+    if (rename(tmpFilePath.c_str(), filePath.c_str()) == -1) {
+        LOG_ERROR(sLogger, ("rename binary check point file fail, errno", errno));
+        return false;
+    }
+    return true;
+}
+
+} // namespace logtail
@@ -0,0 +1,74 @@
+/*
+ * Copyright 2024 iLogtail Authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "common/DevInode.h"
+
+namespace logtail {
+
+class CheckPoint;
+class DirCheckPoint;
+
+// Persists file and dir checkpoints in a compact binary file, which is a header followed by records.
+//
+// Each record is (payload size, hash, type, payload), with integers in host byte order. A dump only appends records
+// of the file checkpoints that are new or changed since the last dump, deletion records of the ones gone, and the dir
+// checkpoints as a whole if any of them changed. When the file grows too large compared with the live records, it is
+// rewritten with the live records only. A torn record at the end, left by a crash during appending, is dropped when
+// loading.
+class BinaryCheckPointStore {
+public:
+    // @return false if the file is not a binary checkpoint file, in which case nothing is loaded
+    bool Load(const std::string& filePath,
+              int32_t& version,
+              std::vector<std::shared_ptr<CheckPoint>>& fileCheckPoints,
+              std::vector<std::shared_ptr<DirCheckPoint>>& dirCheckPoints);
+    bool Dump(const std::string& filePath,
+              int32_t version,
+              const std::vector<const CheckPoint*>& fileCheckPoints,
+              const std::unordered_map<std::string, std::shared_ptr<DirCheckPoint>>& dirCheckPoints);
+    // forget what has been persisted, so that the file is rewritten on next dump
+    void Reset();
+
+private:
+    using FileCheckPointKey = std::pair<DevInode, std::string>;
+
+    bool Compact(const std::string& filePath,
+                 int32_t version,
+                 const std::vector<const CheckPoint*>& fileCheckPoints,
+                 const std::string& dirRecord);
+
+    // the hash of the last record persisted for each file checkpoint
+    std::map<FileCheckPointKey, uint64_t> mFileRecordHashes;
+    uint64_t mDirRecordHash = 0;
+    // 0 if the file is not known to be intact
+    uint64_t mFileSize = 0;
+
+#ifdef APSARA_UNIT_TEST_MAIN
+    friend class BinaryCheckPointStoreUnittest;
+#endif
+};
+
+} // namespace logtail
@@ -40,14 +40,30 @@ DEFINE_FLAG_INT32(check_point_version, "now check point version xx.xx.xx such as
 DEFINE_FLAG_INT32(check_point_dump_interval, "default 15 min", 15 * 60);
 DEFINE_FLAG_INT32(check_point_max_count, "max check point count", 100000);
 DEFINE_FLAG_INT32(checkpoint_find_max_file_count, "", 1000);
+DEFINE_FLAG_BOOL(enable_binary_check_point,
+                 "dump check points incrementally in binary format instead of rewriting the json file, the json file "
+                 "is kept but no longer updated, so versions without binary format lose the offsets since then",
+                 false);
 
 namespace logtail {
 
+// The binary check point file is removed when the json one is dumped, while the json one is kept when the binary one is
+// dumped, so that versions without binary format can still load it. When both exist, the one modified later is loaded.
+static std::string GetBinaryCheckPointFilePath(const std::string& checkPointFile) {
+    return checkPointFile + ".bin";
+}
+
+static time_t GetModifyTime(const std::string& filePath) {
+    fsutil::PathStat buf;
+    return fsutil::PathStat::stat(filePath, buf) ? buf.GetMtime() : 0;
+}
+
 bool CheckPointManager::CheckVersion() {
     return (mLoadVersion == NO_CHECKPOINT_VERSION) || (mLoadVersion / 10000 == INT32_FLAG(check_point_version) / 10000);
 }
 
 void CheckPointManager::AddCheckPoint(CheckPoint* checkPointPtr) {
+    ScopedSpinLock lock(mFileCheckPointLock);
     DevInodeCheckPointHashMap::iterator it
         = mDevInodeCheckPointPtrMap.find(CheckPointKey(checkPointPtr->mDevInode, checkPointPtr->mConfigName));
     if (it != mDevInodeCheckPointPtrMap.end())
@@ -57,12 +73,14 @@ void CheckPointManager::AddCheckPoint(CheckPoint* checkPointPtr) {
 }
 
 void CheckPointManager::DeleteCheckPoint(DevInode devInode, const std::string& configName) {
+    ScopedSpinLock lock(mFileCheckPointLock);
     DevInodeCheckPointHashMap::iterator it = mDevInodeCheckPointPtrMap.find(CheckPointKey(devInode, configName));
     if (it != mDevInodeCheckPointPtrMap.end())
         mDevInodeCheckPointPtrMap.erase(it);
 }
 
 bool CheckPointManager::GetCheckPoint(DevInode devInode, const std::string& configName, CheckPointPtr& checkPointPtr) {
+    ScopedSpinLock lock(mFileCheckPointLock);
     DevInodeCheckPointHashMap::iterator it = mDevInodeCheckPointPtrMap.find(CheckPointKey(devInode, configName));
     if (it != mDevInodeCheckPointPtrMap.end()) {
         checkPointPtr = it->second;
@@ -120,13 +138,31 @@ void CheckPointManager::AddDirCheckPoint(const string& dirname) {
     ptr->mSubDir.insert(dirname);
 }
 void CheckPointManager::LoadCheckPoint() {
-    Json::Value root;
-    ParseConfResult cptRes = ParseConfig(AppConfig::GetInstance()->GetCheckPointFilePath(), root);
+    const string& checkPointFile = AppConfig::GetInstance()->GetCheckPointFilePath();
     // if new checkpoint file not exist, check old checkpoint file.
-    if (cptRes == CONFIG_NOT_EXIST
-        && AppConfig::GetInstance()->GetCheckPointFilePath() != STRING_FLAG(check_point_filename)) {
-        cptRes = ParseConfig(STRING_FLAG(check_point_filename), root);
+    string jsonCheckPointFile = checkPointFile;
+    string binaryCheckPointFile = GetBinaryCheckPointFilePath(checkPointFile);
+    if (checkPointFile != STRING_FLAG(check_point_filename)) {
+        if (!CheckExistance(jsonCheckPointFile)) {
+            jsonCheckPointFile = STRING_FLAG(check_point_filename);
+        }
+        if (!CheckExistance(binaryCheckPointFile)) {
+            binaryCheckPointFile = GetBinaryCheckPointFilePath(STRING_FLAG(check_point_filename));
+        }
     }
+    // the json file is newer if binary format has been turned off since the binary file was dumped
+    if (CheckExistance(binaryCheckPointFile)
+        && (!CheckExistance(jsonCheckPointFile)
+            || GetModifyTime(binaryCheckPointFile) >= GetModifyTime(jsonCheckPointFile))
+        && LoadBinaryCheckPoint(binaryCheckPointFile)) {
+        if (binaryCheckPointFile != GetBinaryCheckPointFilePath(checkPointFile)) {
+            // loaded from the old path, rewrite the new one as a whole on next dump
+            mBinaryStore.Reset();
+        }
+        return;
+    }
+    Json::Value root;
+    ParseConfResult cptRes = ParseConfig(jsonCheckPointFile, root);
     if (cptRes != CONFIG_OK) {
         if (cptRes == CONFIG_NOT_EXIST)
             LOG_INFO(sLogger, ("no check point file to load", AppConfig::GetInstance()->GetCheckPointFilePath()));
@@ -314,6 +350,9 @@ bool CheckPointManager::DumpCheckPointToLocal() {
         LogtailAlarm::GetInstance()->SendAlarm(CHECKPOINT_ALARM, "open check point file dir failed");
         return false;
     }
+    if (BOOL_FLAG(enable_binary_check_point)) {
+        return DumpBinaryCheckPoint(checkPointFile);
+    }
 
     Json::Value root;
     mReaderCount = mDevInodeCheckPointPtrMap.size();
@@ -418,6 +457,11 @@ bool CheckPointManager::DumpCheckPointToLocal() {
                                                std::string("rename check point file fail, errno ") + ToString(errno));
         return false;
     }
+    string binaryCheckPointFile = GetBinaryCheckPointFilePath(checkPointFile);
+    if (CheckExistance(binaryCheckPointFile)) {
+        remove(binaryCheckPointFile.c_str());
+        mBinaryStore.Reset();
+    }
     LOG_DEBUG(sLogger,
               ("dump checkpoint, version", INT32_FLAG(check_point_version))(
                   "file check point", mDevInodeCheckPointPtrMap.size())("dir check point", mDirNameMap.size()));
@@ -425,6 +469,75 @@ bool CheckPointManager::DumpCheckPointToLocal() {
     return true;
 }
 
+bool CheckPointManager::LoadBinaryCheckPoint(const std::string& filePath) {
+    int32_t version = NO_CHECKPOINT_VERSION;
+    vector<CheckPointPtr> fileCheckPoints;
+    vector<DirCheckPointPtr> dirCheckPoints;
+    if (!mBinaryStore.Load(filePath, version, fileCheckPoints, dirCheckPoints)) {
+        LOG_ERROR(sLogger, ("load binary check point file fail, try json check point file", filePath));
+        LogtailAlarm::GetInstance()->SendAlarm(CHECKPOINT_ALARM, "binary check point file is invalid");
+        return false;
+    }
+    mLoadVersion = version;
+
+    time_t now = time(NULL);
+    for (auto& dir : dirCheckPoints) {
+        if (dir->mUpdateTime >= now - INT32_FLAG(file_check_point_time_out)) {
+            mDirNameMap[dir->mParentName] = dir;
+        } else {
+            LOG_INFO(sLogger,
+                     ("load timeout dir check point, ignore", dir->mParentName)(ToString(dir->mUpdateTime), now));
+        }
+    }
+    mReaderCount = fileCheckPoints.size();
+    {
+        ScopedSpinLock lock(mFileCheckPointLock);
+        for (auto& cpt : fileCheckPoints) {
+            // can not get file's dev inode
+            if (!cpt->mDevInode.IsValid()) {
+                LOG_WARNING(sLogger, ("can not find check point dev inode, discard it", cpt->mFileName));
+                continue;
+            }
+            mDevInodeCheckPointPtrMap[CheckPointKey(cpt->mDevInode, cpt->mConfigName)] = cpt;
+        }
+    }
+    LOG_INFO(sLogger,
+             ("load binary checkpoint, version", mLoadVersion)("file check point", mDevInodeCheckPointPtrMap.size())(
+                 "dir check point", mDirNameMap.size()));
+    return true;
+}
+
+bool CheckPointManager::DumpBinaryCheckPoint(const std::string& filePath) {
+    string binaryCheckPointFile = GetBinaryCheckPointFilePath(filePath);
+    mReaderCount = mDevInodeCheckPointPtrMap.size();
+    vector<const CheckPoint*> checkPoints;
+    checkPoints.reserve(mDevInodeCheckPointPtrMap.size());
+    for (const auto& item : mDevInodeCheckPointPtrMap) {
+        checkPoints.push_back(item.second.get());
+    }
+    if (checkPoints.size() > (size_t)INT32_FLAG(check_point_max_count)) {
+        // only the most recently updated ones are kept, which needs no full sort
+        nth_element(checkPoints.begin(),
+                    checkPoints.begin() + INT32_FLAG(check_point_max_count),
+                    checkPoints.end(),
+                    CheckPointManager::CheckPointCmpByUpdateTime);
+        checkPoints.resize(INT32_FLAG(check_point_max_count));
+        LOG_WARNING(sLogger, ("Too many check point", mDevInodeCheckPointPtrMap.size()));
+        LogtailAlarm::GetInstance()->SendAlarm(CHECKPOINT_ALARM,
+                                               "Too many check point:" + ToString(mDevInodeCheckPointPtrMap.size()));
+    }
+
+    if (!mBinaryStore.Dump(binaryCheckPointFile, INT32_FLAG(check_point_version), checkPoints, mDirNameMap)) {
+        LOG_ERROR(sLogger, ("dump check point to file failed", binaryCheckPointFile));
+        LogtailAlarm::GetInstance()->SendAlarm(CHECKPOINT_ALARM, "dump check point to file failed");
+        return false;
+    }
+    LOG_DEBUG(sLogger,
+              ("dump binary checkpoint, version", INT32_FLAG(check_point_version))(
+                  "file check point", checkPoints.size())("dir check point", mDirNameMap.size()));
+    return true;
+}
+
 int32_t CheckPointManager::GetReaderCount() {
     return mReaderCount;
 }
@@ -22,8 +22,10 @@
 #include <ctime>
 #include <json/json.h>
 #include <boost/optional.hpp>
+#include "checkpoint/BinaryCheckPointStore.h"
 #include "common/DevInode.h"
 #include "common/EncodingConverter.h"
+#include "common/Lock.h"
 #include "common/SplitedFilePath.h"
 
 #ifdef APSARA_UNIT_TEST_MAIN
@@ -109,14 +111,20 @@ public:
 
 private:
     DevInodeCheckPointHashMap mDevInodeCheckPointPtrMap;
+    // file checkpoints are added, got and deleted by readers, which may run in reader pool threads
+    SpinLock mFileCheckPointLock;
     std::unordered_map<std::string, DirCheckPointPtr> mDirNameMap;
     int32_t mLastCheckTime;
     int32_t mLastDumpTime;
     int32_t mLoadVersion;
     int32_t mReaderCount;
+    BinaryCheckPointStore mBinaryStore;
     CheckPointManager()
         : mLastCheckTime(time(NULL)), mLastDumpTime(time(NULL)), mLoadVersion(NO_CHECKPOINT_VERSION), mReaderCount(0) {}
 
+    bool LoadBinaryCheckPoint(const std::string& filePath);
+    bool DumpBinaryCheckPoint(const std::string& filePath);
+
 public:
     bool CheckVersion();
     void AddCheckPoint(CheckPoint* checkPointPtr);
@@ -22,64 +22,123 @@
 #endif
 #include <zstd/zstd.h>
 
+#include <atomic>
 #include <cstring>
+#include <memory>
 
+#include "common/TimeUtil.h"
 #include "log_pb/sls_logs.pb.h"
 
 namespace logtail {
 
 const int32_t ZSTD_DEFAULT_LEVEL = 1;
 
-bool UncompressData(sls_logs::SlsCompressType compressType,
-                    const std::string& src,
-                    uint32_t rawSize,
-                    std::string& dst) {
+namespace {
+
+struct ZstdCCtxDeleter {
+    void operator()(ZSTD_CCtx* ctx) const { ZSTD_freeCCtx(ctx); }
+};
+
+struct ZstdDCtxDeleter {
+    void operator()(ZSTD_DCtx* ctx) const { ZSTD_freeDCtx(ctx); }
+};
+
+// Compression state is reused by each thread instead of being allocated for every payload. Contexts are created lazily
+// so that threads never compressing anything do not pay for them.
+ZSTD_CCtx* GetThreadZstdCCtx() {
+    static thread_local std::unique_ptr<ZSTD_CCtx, ZstdCCtxDeleter> sCtx(ZSTD_createCCtx());
+    return sCtx.get();
+}
+
+ZSTD_DCtx* GetThreadZstdDCtx() {
+    static thread_local std::unique_ptr<ZSTD_DCtx, ZstdDCtxDeleter> sCtx(ZSTD_createDCtx());
+    return sCtx.get();
+}
+
+void* GetThreadLz4State() {
+    static thread_local std::unique_ptr<char[]> sState(new char[LZ4_sizeofState()]);
+    return sState.get();
+}
+
+struct CompressCounter {
+    std::atomic_uint64_t mRawBytes{0};
+    std::atomic_uint64_t mCompressedBytes{0};
+    std::atomic_uint64_t mCpuTimeNs{0};
+};
+
+CompressCounter sCompressCounters[sls_logs::SlsCompressType_ARRAYSIZE];
+
+void RecordCompress(sls_logs::SlsCompressType compressType, uint64_t rawSize, uint64_t compressedSize, uint64_t cpuNs) {
+    auto& counter = sCompressCounters[compressType];
+    counter.mRawBytes.fetch_add(rawSize, std::memory_order_relaxed);
+    counter.mCompressedBytes.fetch_add(compressedSize, std::memory_order_relaxed);
+    counter.mCpuTimeNs.fetch_add(cpuNs, std::memory_order_relaxed);
+}
+
+bool DoCompressData(sls_logs::SlsCompressType compressType, const char* src, uint32_t size, std::string& dst) {
     switch (compressType) {
-        case sls_logs::SLS_CMP_NONE:
-            dst = src;
+        case sls_logs::SLS_CMP_NONE: {
+            dst.assign(src, size);
             return true;
+        }
         case sls_logs::SLS_CMP_LZ4:
-            return UncompressLz4(src, rawSize, dst);
+            return CompressLz4(src, size, dst);
         case sls_logs::SLS_CMP_DEFLATE:
-            return UncompressDeflate(src, rawSize, dst);
+            return CompressDeflate(src, size, dst);
         case sls_logs::SLS_CMP_ZSTD:
-            return UncompressZstd(src, rawSize, dst);
+            return CompressZstd(src, size, dst, ZSTD_DEFAULT_LEVEL);
         default:
             return false;
     }
 }
 
-bool CompressData(sls_logs::SlsCompressType compressType, const std::string& src, std::string& dst) {
+} // namespace
+
+CompressStatistics ExchangeCompressStatistics(sls_logs::SlsCompressType compressType) {
+    CompressStatistics stat;
+    if (!sls_logs::SlsCompressType_IsValid(compressType)) {
+        return stat;
+    }
+    auto& counter = sCompressCounters[compressType];
+    stat.mRawBytes = counter.mRawBytes.exchange(0);
+    stat.mCompressedBytes = counter.mCompressedBytes.exchange(0);
+    stat.mCpuTimeNs = counter.mCpuTimeNs.exchange(0);
+    return stat;
+}
+
+bool UncompressData(sls_logs::SlsCompressType compressType,
+                    const std::string& src,
+                    uint32_t rawSize,
+                    std::string& dst) {
     switch (compressType) {
         case sls_logs::SLS_CMP_NONE:
             dst = src;
             return true;
         case sls_logs::SLS_CMP_LZ4:
-            return CompressLz4(src, dst);
+            return UncompressLz4(src, rawSize, dst);
         case sls_logs::SLS_CMP_DEFLATE:
-            return CompressDeflate(src, dst);
+            return UncompressDeflate(src, rawSize, dst);
         case sls_logs::SLS_CMP_ZSTD:
-            return CompressZstd(src, dst, ZSTD_DEFAULT_LEVEL);
+            return UncompressZstd(src, rawSize, dst);
         default:
             return false;
     }
 }
 
+bool CompressData(sls_logs::SlsCompressType compressType, const std::string& src, std::string& dst) {
+    return CompressData(compressType, src.data(), src.size(), dst);
+}
+
 bool CompressData(sls_logs::SlsCompressType compressType, const char* src, uint32_t size, std::string& dst) {
-    switch (compressType) {
-        case sls_logs::SLS_CMP_NONE: {
-            dst.assign(src, size);
-            return true;
-        }
-        case sls_logs::SLS_CMP_LZ4:
-            return CompressLz4(src, size, dst);
-        case sls_logs::SLS_CMP_DEFLATE:
-            return CompressDeflate(src, size, dst);
-        case sls_logs::SLS_CMP_ZSTD:
-            return CompressZstd(src, size, dst, ZSTD_DEFAULT_LEVEL);
-        default:
-            return false;
+    if (compressType == sls_logs::SLS_CMP_NONE || !sls_logs::SlsCompressType_IsValid(compressType)) {
+        return DoCompressData(compressType, src, size, dst);
     }
+    uint64_t startTime = GetCurrentThreadCpuTimeInNanoSeconds();
+    if (!DoCompressData(compressType, src, size, dst)) {
+        return false;
+    }
+    RecordCompress(compressType, size, dst.size(), GetCurrentThreadCpuTimeInNanoSeconds() - startTime);
+    return true;
 }
 
 bool RawCompress(std::string& data) {
@@ -248,7 +307,7 @@ bool CompressLz4(const char* srcPtr, const uint32_t srcSize, std::string& dst) {
     dst.resize(encodingSize);
     char* compressed = const_cast<char*>(dst.c_str());
     try {
-        encodingSize = LZ4_compress_default(srcPtr, compressed, srcSize, encodingSize);
+        encodingSize = LZ4_compress_fast_extState(GetThreadLz4State(), srcPtr, compressed, srcSize, encodingSize, 1);
         if (encodingSize) {
             dst.resize(encodingSize);
             return true;
@@ -271,7 +330,9 @@ bool UncompressZstd(const char* srcPtr, const uint32_t srcSize, const uint32_t r
     char* unCompressed = const_cast<char*>(dst.c_str());
     uint32_t length = 0;
     try {
-        length = ZSTD_decompress(unCompressed, rawSize, srcPtr, srcSize);
+        ZSTD_DCtx* ctx = GetThreadZstdDCtx();
+        length = ctx ? ZSTD_decompressDCtx(ctx, unCompressed, rawSize, srcPtr, srcSize)
+                     : ZSTD_decompress(unCompressed, rawSize, srcPtr, srcSize);
     } catch (...) {
         return false;
     }
@@ -286,7 +347,9 @@ bool CompressZstd(const char* srcPtr, const uint32_t srcSize, std::string& dst,
     dst.resize(encodingSize);
     char* compressed = const_cast<char*>(dst.c_str());
     try {
-        size_t const cmp_size = ZSTD_compress(compressed, encodingSize, srcPtr, srcSize, level);
+        ZSTD_CCtx* ctx = GetThreadZstdCCtx();
+        size_t const cmp_size = ctx ? ZSTD_compressCCtx(ctx, compressed, encodingSize, srcPtr, srcSize, level)
+                                    : ZSTD_compress(compressed, encodingSize, srcPtr, srcSize, level);
         if (ZSTD_isError(cmp_size)) {
             return false;
         }
@@ -301,4 +364,29 @@ bool CompressZstd(const std::string& src, std::string& dst, int32_t level) {
     return CompressZstd(src.c_str(), src.length(), dst, level);
 }
 
+bool CompressZstdUsingDict(const char* srcPtr, const uint32_t srcSize, std::string& dst, const ZSTD_CDict_s* dict) {
+    ZSTD_CCtx* ctx = GetThreadZstdCCtx();
+    if (ctx == nullptr || dict == nullptr) {
+        return false;
+    }
+    dst.resize(ZSTD_compressBound(srcSize));
+    size_t const cmpSize = ZSTD_compress_usingCDict(ctx, &dst[0], dst.size(), srcPtr, srcSize, dict);
+    if (ZSTD_isError(cmpSize)) {
+        return false;
+    }
+    dst.resize(cmpSize);
+    return true;
+}
+
+bool UncompressZstdUsingDict(
+    const char* srcPtr, const uint32_t srcSize, const uint32_t rawSize, std::string& dst, const ZSTD_DDict_s* dict) {
+    ZSTD_DCtx* ctx = GetThreadZstdDCtx();
+    if (ctx == nullptr || dict == nullptr) {
+        return false;
+    }
+    dst.resize(rawSize);
+    size_t const length = ZSTD_decompress_usingDDict(ctx, &dst[0], rawSize, srcPtr, srcSize, dict);
+    return !ZSTD_isError(length) && length == rawSize;
+}
+
 } // namespace logtail
@@ -19,10 +19,23 @@
 #include <cstdint>
 #include "log_pb/sls_logs.pb.h"
 
+struct ZSTD_CDict_s;
+struct ZSTD_DDict_s;
+
 namespace logtail {
 
 extern const int32_t ZSTD_DEFAULT_LEVEL;
 
+// accumulated by CompressData() for each compress type, cpu time is measured on the compressing thread
+struct CompressStatistics {
+    uint64_t mRawBytes = 0;
+    uint64_t mCompressedBytes = 0;
+    uint64_t mCpuTimeNs = 0;
+};
+
+// @return statistics since last call for @compressType
+CompressStatistics ExchangeCompressStatistics(sls_logs::SlsCompressType compressType);
+
 bool UncompressData(sls_logs::SlsCompressType compressType, const std::string& src, uint32_t rawSize, std::string& dst);
 
 bool CompressData(sls_logs::SlsCompressType compressType, const std::string& src, std::string& dst);
@@ -47,6 +60,11 @@ bool UncompressZstd(const char* srcPtr, const uint32_t srcSize, const uint32_t r
 bool CompressZstd(const char* srcPtr, const uint32_t srcSize, std::string& dst, int32_t level);
 bool CompressZstd(const std::string& src, std::string& dst, int32_t level);
 
+// the level is the one @dict is created with
+bool CompressZstdUsingDict(const char* srcPtr, const uint32_t srcSize, std::string& dst, const ZSTD_CDict_s* dict);
+bool UncompressZstdUsingDict(
+    const char* srcPtr, const uint32_t srcSize, const uint32_t rawSize, std::string& dst, const ZSTD_DDict_s* dict);
+
 // old mode , with 8 bytes leading raw size
 bool RawCompress(std::string& data);
 bool Compress(std::string& data);
@@ -0,0 +1,79 @@
+// Copyright 2024 iLogtail Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "common/GlobMatcher.h"
+
+#include <cstring>
+
+#if defined(__linux__)
+#include <fnmatch.h>
+#endif
+
+#include "common/StringTools.h"
+
+namespace logtail {
+
+static const char* kGlobSpecialChars = "*?[\\";
+
+GlobMatcher::GlobMatcher(const std::string& pattern, int flags) : mPattern(pattern), mFlags(flags) {
+#if defined(_MSC_VER)
+    // fnmatch on Windows is case insensitive, always use it
+    mType = Type::GENERIC;
+#else
+    size_t pos = pattern.find_first_of(kGlobSpecialChars);
+    if (flags != 0 && flags != FNM_PATHNAME) {
+        mType = Type::GENERIC;
+    } else if (pos == std::string::npos) {
+        mType = Type::LITERAL;
+        mLiteral = pattern;
+    } else if (pattern == "*") {
+        mType = Type::ANY;
+    } else if (pos == 0 && pattern[0] == '*' && pattern.find_first_of(kGlobSpecialChars, 1) == std::string::npos) {
+        mType = Type::SUFFIX;
+        mLiteral = pattern.substr(1);
+    } else if (pos == pattern.size() - 1 && pattern[pos] == '*') {
+        mType = Type::PREFIX;
+        mLiteral = pattern.substr(0, pos);
+    } else {
+        mType = Type::GENERIC;
+    }
+#endif
+}
+
+bool GlobMatcher::Match(const std::string& str) const {
+    // with FNM_PATHNAME, '*' does not match '/'
+    switch (mType) {
+        case Type::LITERAL:
+            return str == mLiteral;
+        case Type::ANY:
+            return mFlags == 0 || str.find('/') == std::string::npos;
+        case Type::SUFFIX: {
+            if (str.size() < mLiteral.size()
+                || memcmp(str.data() + str.size() - mLiteral.size(), mLiteral.data(), mLiteral.size()) != 0) {
+                return false;
+            }
+            return mFlags == 0 || memchr(str.data(), '/', str.size() - mLiteral.size()) == nullptr;
+        }
+        case Type::PREFIX: {
+            if (str.size() < mLiteral.size() || memcmp(str.data(), mLiteral.data(), mLiteral.size()) != 0) {
+                return false;
+            }
+            return mFlags == 0 || str.find('/', mLiteral.size()) == std::string::npos;
+        }
+        default:
+            return fnmatch(mPattern.c_str(), str.c_str(), mFlags) == 0;
+    }
+}
+
+} // namespace logtail
@@ -0,0 +1,48 @@
+/*
+ * Copyright 2024 iLogtail Authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <string>
+
+namespace logtail {
+
+// A glob pattern compiled once for repeated matching, with the same result as fnmatch(pattern, str, flags) == 0.
+// Patterns in the most common shapes, i.e. "name", "*suffix", "prefix*" and "*", are matched by string comparison,
+// the others fall back to fnmatch. Only flags 0 and FNM_PATHNAME are compiled.
+class GlobMatcher {
+public:
+    GlobMatcher() = default;
+    explicit GlobMatcher(const std::string& pattern, int flags = 0);
+
+    bool Match(const std::string& str) const;
+    const std::string& GetPattern() const { return mPattern; }
+
+private:
+    enum class Type { LITERAL, PREFIX, SUFFIX, ANY, GENERIC };
+
+    std::string mPattern;
+    // the pattern without the leading or trailing '*'
+    std::string mLiteral;
+    int mFlags = 0;
+    Type mType = Type::LITERAL;
+
+#ifdef APSARA_UNIT_TEST_MAIN
+    friend class GlobMatcherUnittest;
+#endif
+};
+
+} // namespace logtail
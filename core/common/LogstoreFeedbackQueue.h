@@ -170,6 +170,7 @@ protected:
 #ifdef APSARA_UNIT_TEST_MAIN
     friend class ProcessQueueUnittest;
     friend class ExactlyOnceQueueManagerUnittest;
+    friend class ConcurrentProcessQueueManagerUnittest;
 #endif
 };
 
@@ -25,6 +25,7 @@
 #include "LogGroupContext.h"
 #include "common/FeedbackInterface.h"
 #include "common/LogstoreFeedbackKey.h"
+#include "common/memory/MemoryBudgetManager.h"
 #include "logger/Logger.h"
 #include "common/LogstoreFeedbackQueue.h"
 #include "sender/SenderQueueParam.h"
@@ -81,6 +82,11 @@ struct LoggroupTimeValue {
     int32_t mLogTimeInMinute;
     LogGroupContext mLogGroupContext;
 
+    // log data is charged to the budget of the pipeline until the item is destroyed, i.e. sent or written to disk
+    std::shared_ptr<PipelineMemoryBudget> mMemoryBudget;
+    // log data may be compressed again before sending
+    int64_t mChargedBytes = 0;
+
     LoggroupTimeValue(const std::string& projectName,
                       const std::string& logstore,
                       const std::string& configName,
@@ -118,6 +124,23 @@ struct LoggroupTimeValue {
         mLogGroupContext = context;
     }
 
+    LoggroupTimeValue(const LoggroupTimeValue&) = delete;
+    LoggroupTimeValue& operator=(const LoggroupTimeValue&) = delete;
+    ~LoggroupTimeValue() {
+        if (mMemoryBudget) {
+            mMemoryBudget->Release(mChargedBytes);
+        }
+    }
+
+    void ChargeMemoryBudget(const std::shared_ptr<PipelineMemoryBudget>& budget) {
+        if (!budget || mMemoryBudget) {
+            return;
+        }
+        mMemoryBudget = budget;
+        mChargedBytes = mLogData.size();
+        mMemoryBudget->Reserve(mChargedBytes);
+    }
+
 #ifdef APSARA_UNIT_TEST_MAIN
     LoggroupTimeValue() {}
 #endif
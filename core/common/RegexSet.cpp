@@ -0,0 +1,164 @@
+// Copyright 2024 iLogtail Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "common/RegexSet.h"
+
+#include <algorithm>
+
+#include "common/ParamExtractor.h"
+#include "common/StringTools.h"
+
+namespace logtail {
+
+bool ParseRegexEngine(const std::string& name, RegexEngine& engine) {
+    if (name == "boost") {
+        engine = RegexEngine::BOOST;
+    } else if (name == "re2") {
+        engine = RegexEngine::RE2;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+bool GetOptionalRegexEngineParam(const Json::Value& config,
+                                 const std::string& key,
+                                 RegexEngine& engine,
+                                 std::string& errorMsg) {
+    std::string name;
+    if (!GetOptionalStringParam(config, key, name, errorMsg)) {
+        return false;
+    }
+    if (!name.empty() && !ParseRegexEngine(name, engine)) {
+        errorMsg = "string param " + key + " is not valid";
+        return false;
+    }
+    return true;
+}
+
+const std::string& RegexEngineToString(RegexEngine engine) {
+    static const std::string sBoost = "boost", sRE2 = "re2";
+    return engine == RegexEngine::RE2 ? sRE2 : sBoost;
+}
+
+RE2::Options GetBoostCompatibleRE2Options() {
+    RE2::Options options;
+    options.set_encoding(RE2::Options::EncodingLatin1);
+    options.set_dot_nl(true);
+    options.set_log_errors(false);
+    return options;
+}
+
+std::string ToBoostCompatibleRE2Pattern(const std::string& pattern) {
+    return "(?m)" + pattern;
+}
+
+RegexSet::RegexSet(RegexEngine engine, Anchor anchor) : mEngine(engine), mAnchor(anchor) {
+    if (mEngine == RegexEngine::RE2) {
+        mRE2Set.reset(new RE2::Set(GetBoostCompatibleRE2Options(),
+                                   mAnchor == Anchor::FULL ? RE2::ANCHOR_BOTH : RE2::ANCHOR_START));
+    }
+}
+
+int RegexSet::Add(const std::string& pattern) {
+    if (mCompiled) {
+        return -1;
+    }
+    try {
+        mBoostRegs.emplace_back(pattern);
+    } catch (...) {
+        return -1;
+    }
+    int index = static_cast<int>(mBoostRegs.size()) - 1;
+    if (mRE2Set) {
+        std::string error;
+        if (mRE2Set->Add(ToBoostCompatibleRE2Pattern(pattern), &error) >= 0) {
+            mRE2Indexes.push_back(index);
+        } else {
+            mBoostOnlyIndexes.push_back(index);
+        }
+    }
+    return index;
+}
+
+bool RegexSet::Compile() {
+    bool res = true;
+    if (mRE2Set) {
+        if (mRE2Indexes.empty()) {
+            mRE2Set.reset();
+        } else if (!mRE2Set->Compile()) {
+            // e.g. the automaton exceeds the memory budget of RE2, so evaluate them with boost instead
+            mRE2Set.reset();
+            mBoostOnlyIndexes.insert(mBoostOnlyIndexes.end(), mRE2Indexes.begin(), mRE2Indexes.end());
+            std::sort(mBoostOnlyIndexes.begin(), mBoostOnlyIndexes.end());
+            mRE2Indexes.clear();
+            res = false;
+        }
+    }
+    mCompiled = true;
+    return res;
+}
+
+bool RegexSet::Match(const char* buffer, size_t size, std::vector<int>& matched, std::string& exception) const {
+    matched.clear();
+    // patterns are evaluated with boost until compiled
+    if (mEngine == RegexEngine::BOOST || !mCompiled) {
+        for (size_t i = 0; i < mBoostRegs.size(); ++i) {
+            if (MatchBoost(i, buffer, size, exception)) {
+                matched.push_back(static_cast<int>(i));
+            }
+        }
+        return !matched.empty();
+    }
+
+    if (mRE2Set) {
+        static thread_local std::vector<int> sRE2Matched;
+        sRE2Matched.clear();
+        if (mRE2Set->Match(re2::StringPiece(buffer, size), &sRE2Matched)) {
+            for (int i : sRE2Matched) {
+                matched.push_back(mRE2Indexes[i]);
+            }
+        }
+    }
+    for (int i : mBoostOnlyIndexes) {
+        if (MatchBoost(i, buffer, size, exception)) {
+            matched.push_back(i);
+        }
+    }
+    std::sort(matched.begin(), matched.end());
+    return !matched.empty();
+}
+
+bool RegexSet::MatchAll(const char* buffer, size_t size, std::string& exception) const {
+    if (mEngine == RegexEngine::BOOST || !mCompiled) {
+        for (size_t i = 0; i < mBoostRegs.size(); ++i) {
+            if (!MatchBoost(i, buffer, size, exception)) {
+                return false;
+            }
+        }
+        return true;
+    }
+    static thread_local std::vector<int> sMatched;
+    Match(buffer, size, sMatched, exception);
+    return sMatched.size() == mBoostRegs.size();
+}
+
+bool RegexSet::MatchBoost(size_t index, const char* buffer, size_t size, std::string& exception) const {
+    if (mAnchor == Anchor::FULL) {
+        return BoostRegexMatch(buffer, size, mBoostRegs[index], exception);
+    }
+    return BoostRegexSearch(buffer, size, mBoostRegs[index], exception);
+}
+
+} // namespace logtail
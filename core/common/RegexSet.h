@@ -0,0 +1,96 @@
+/*
+ * Copyright 2024 iLogtail Authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <json/json.h>
+#include <re2/set.h>
+
+#include <boost/regex.hpp>
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace logtail {
+
+enum class RegexEngine { BOOST, RE2 };
+
+// "boost" or "re2", case sensitive
+bool ParseRegexEngine(const std::string& name, RegexEngine& engine);
+// @engine is left unchanged if param @key is missing or not valid
+bool GetOptionalRegexEngineParam(const Json::Value& config,
+                                 const std::string& key,
+                                 RegexEngine& engine,
+                                 std::string& errorMsg);
+const std::string& RegexEngineToString(RegexEngine engine);
+
+// RE2 options making a pattern behave as boost::regex does by default, i.e. matching bytes rather than UTF-8, '.'
+// matching newline, and '^' and '$' matching at line boundaries (with the pattern prefixed by "(?m)").
+RE2::Options GetBoostCompatibleRE2Options();
+std::string ToBoostCompatibleRE2Pattern(const std::string& pattern);
+
+// A set of patterns evaluated against the same text, reporting which of them match.
+//
+// With the BOOST engine, patterns are evaluated one by one. With the RE2 engine, patterns are compiled into one
+// automaton by RE2::Set and evaluated in a single pass over the text, no matter how many patterns there are. Patterns
+// not supported by RE2, e.g. with back references or lookarounds, are still evaluated with boost, so the result does
+// not depend on the engine.
+class RegexSet {
+public:
+    enum class Anchor {
+        // the whole text should match, as BoostRegexMatch
+        FULL,
+        // the text should start with a match, as BoostRegexSearch
+        PREFIX
+    };
+
+    RegexSet(RegexEngine engine, Anchor anchor);
+
+    // @return index of the pattern in the set, or -1 if the pattern is not a valid regex
+    int Add(const std::string& pattern);
+    // must be called after all patterns are added and before matching
+    bool Compile();
+
+    // @param matched [out] indexes of the patterns matched, in ascending order
+    // @return true if any pattern matches
+    bool Match(const char* buffer, size_t size, std::vector<int>& matched, std::string& exception) const;
+    // @return true if all patterns match, which stops at the first mismatch with the BOOST engine
+    bool MatchAll(const char* buffer, size_t size, std::string& exception) const;
+
+    RegexEngine GetEngine() const { return mEngine; }
+    size_t Size() const { return mBoostRegs.size(); }
+
+private:
+    bool MatchBoost(size_t index, const char* buffer, size_t size, std::string& exception) const;
+
+    RegexEngine mEngine;
+    Anchor mAnchor;
+    std::vector<boost::regex> mBoostRegs;
+    // for RE2 engine only
+    std::unique_ptr<RE2::Set> mRE2Set;
+    // index in the set of each pattern in mRE2Set
+    std::vector<int> mRE2Indexes;
+    // indexes of the patterns not supported by RE2
+    std::vector<int> mBoostOnlyIndexes;
+    bool mCompiled = false;
+
+#ifdef APSARA_UNIT_TEST_MAIN
+    friend class RegexSetUnittest;
+#endif
+};
+
+} // namespace logtail
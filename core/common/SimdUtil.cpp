@@ -0,0 +1,324 @@
+// Copyright 2024 iLogtail Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "common/SimdUtil.h"
+
+#include <cstring>
+
+#if defined(__x86_64__) || defined(_M_X64)
+#define LOGTAIL_SIMD_SSE2
+#include <emmintrin.h>
+#if defined(__GNUC__) || defined(__clang__)
+#define LOGTAIL_SIMD_AVX2
+#include <immintrin.h>
+#endif
+#endif
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+namespace logtail {
+
+namespace {
+
+inline uint32_t CountTrailingZeros(uint32_t mask) {
+#if defined(_MSC_VER)
+    unsigned long index = 0;
+    _BitScanForward(&index, mask);
+    return static_cast<uint32_t>(index);
+#else
+    return static_cast<uint32_t>(__builtin_ctz(mask));
+#endif
+}
+
+const char* FindFirstOfScalar(const char* begin, const char* end, char c) {
+    const void* res = memchr(begin, c, end - begin);
+    return res == nullptr ? end : static_cast<const char*>(res);
+}
+
+const char* FindFirstOf2Scalar(const char* begin, const char* end, char c1, char c2) {
+    for (; begin < end; ++begin) {
+        if (*begin == c1 || *begin == c2) {
+            return begin;
+        }
+    }
+    return end;
+}
+
+void FindAllOfScalar(const char* data, size_t size, char c, std::vector<size_t>& offsets) {
+    const char* end = data + size;
+    for (const char* cur = FindFirstOfScalar(data, end, c); cur != end; cur = FindFirstOfScalar(cur + 1, end, c)) {
+        offsets.push_back(cur - data);
+    }
+}
+
+void ClassifyBlock64Scalar(const char* data, size_t size, char c1, char c2, uint64_t& mask1, uint64_t& mask2) {
+    mask1 = 0;
+    mask2 = 0;
+    for (size_t i = 0; i < size; ++i) {
+        mask1 |= static_cast<uint64_t>(data[i] == c1) << i;
+        mask2 |= static_cast<uint64_t>(data[i] == c2) << i;
+    }
+}
+
+// a partial block is copied to a zero padded one, and the bits of the padding are cleared from the masks afterwards
+inline const char* PadBlock64(const char* data, size_t size, char (&block)[64]) {
+    if (size == 64) {
+        return data;
+    }
+    memcpy(block, data, size);
+    memset(block + size, 0, 64 - size);
+    return block;
+}
+
+inline uint64_t LowBits64(size_t size) {
+    return size >= 64 ? ~0ULL : (1ULL << size) - 1;
+}
+
+#ifdef LOGTAIL_SIMD_SSE2
+const char* FindFirstOfSSE2(const char* begin, const char* end, char c) {
+    const __m128i pattern = _mm_set1_epi8(c);
+    for (; begin + 16 <= end; begin += 16) {
+        __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(begin));
+        uint32_t mask = static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(block, pattern)));
+        if (mask != 0) {
+            return begin + CountTrailingZeros(mask);
+        }
+    }
+    return FindFirstOfScalar(begin, end, c);
+}
+
+const char* FindFirstOf2SSE2(const char* begin, const char* end, char c1, char c2) {
+    const __m128i pattern1 = _mm_set1_epi8(c1);
+    const __m128i pattern2 = _mm_set1_epi8(c2);
+    for (; begin + 16 <= end; begin += 16) {
+        __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(begin));
+        __m128i eq = _mm_or_si128(_mm_cmpeq_epi8(block, pattern1), _mm_cmpeq_epi8(block, pattern2));
+        uint32_t mask = static_cast<uint32_t>(_mm_movemask_epi8(eq));
+        if (mask != 0) {
+            return begin + CountTrailingZeros(mask);
+        }
+    }
+    return FindFirstOf2Scalar(begin, end, c1, c2);
+}
+
+void FindAllOfSSE2(const char* data, size_t size, char c, std::vector<size_t>& offsets) {
+    const __m128i pattern = _mm_set1_epi8(c);
+    size_t pos = 0;
+    for (; pos + 16 <= size; pos += 16) {
+        __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + pos));
+        uint32_t mask = static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(block, pattern)));
+        while (mask != 0) {
+            offsets.push_back(pos + CountTrailingZeros(mask));
+            mask &= mask - 1;
+        }
+    }
+    for (; pos < size; ++pos) {
+        if (data[pos] == c) {
+            offsets.push_back(pos);
+        }
+    }
+}
+
+void ClassifyBlock64SSE2(const char* data, size_t size, char c1, char c2, uint64_t& mask1, uint64_t& mask2) {
+    char padded[64];
+    const char* block = PadBlock64(data, size, padded);
+    const __m128i pattern1 = _mm_set1_epi8(c1);
+    const __m128i pattern2 = _mm_set1_epi8(c2);
+    mask1 = 0;
+    mask2 = 0;
+    for (size_t i = 0; i < 64; i += 16) {
+        __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(block + i));
+        mask1 |= static_cast<uint64_t>(static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(chunk, pattern1)))) << i;
+        mask2 |= static_cast<uint64_t>(static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(chunk, pattern2)))) << i;
+    }
+    mask1 &= LowBits64(size);
+    mask2 &= LowBits64(size);
+}
+#endif
+
+#ifdef LOGTAIL_SIMD_AVX2
+__attribute__((target("avx2"))) const char* FindFirstOfAVX2(const char* begin, const char* end, char c) {
+    const __m256i pattern = _mm256_set1_epi8(c);
+    for (; begin + 32 <= end; begin += 32) {
+        __m256i block = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(begin));
+        uint32_t mask = static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(block, pattern)));
+        if (mask != 0) {
+            return begin + CountTrailingZeros(mask);
+        }
+    }
+    return FindFirstOfSSE2(begin, end, c);
+}
+
+__attribute__((target("avx2"))) const char*
+FindFirstOf2AVX2(const char* begin, const char* end, char c1, char c2) {
+    const __m256i pattern1 = _mm256_set1_epi8(c1);
+    const __m256i pattern2 = _mm256_set1_epi8(c2);
+    for (; begin + 32 <= end; begin += 32) {
+        __m256i block = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(begin));
+        __m256i eq = _mm256_or_si256(_mm256_cmpeq_epi8(block, pattern1), _mm256_cmpeq_epi8(block, pattern2));
+        uint32_t mask = static_cast<uint32_t>(_mm256_movemask_epi8(eq));
+        if (mask != 0) {
+            return begin + CountTrailingZeros(mask);
+        }
+    }
+    return FindFirstOf2SSE2(begin, end, c1, c2);
+}
+
+__attribute__((target("avx2"))) void FindAllOfAVX2(const char* data, size_t size, char c, std::vector<size_t>& offsets) {
+    const __m256i pattern = _mm256_set1_epi8(c);
+    size_t pos = 0;
+    for (; pos + 32 <= size; pos += 32) {
+        __m256i block = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + pos));
+        uint32_t mask = static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(block, pattern)));
+        while (mask != 0) {
+            offsets.push_back(pos + CountTrailingZeros(mask));
+            mask &= mask - 1;
+        }
+    }
+    for (; pos < size; ++pos) {
+        if (data[pos] == c) {
+            offsets.push_back(pos);
+        }
+    }
+}
+
+__attribute__((target("avx2"))) void
+ClassifyBlock64AVX2(const char* data, size_t size, char c1, char c2, uint64_t& mask1, uint64_t& mask2) {
+    char padded[64];
+    const char* block = PadBlock64(data, size, padded);
+    const __m256i pattern1 = _mm256_set1_epi8(c1);
+    const __m256i pattern2 = _mm256_set1_epi8(c2);
+    __m256i lo = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(block));
+    __m256i hi = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(block + 32));
+    mask1 = static_cast<uint64_t>(static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(lo, pattern1))))
+        | static_cast<uint64_t>(static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(hi, pattern1)))) << 32;
+    mask2 = static_cast<uint64_t>(static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(lo, pattern2))))
+        | static_cast<uint64_t>(static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(hi, pattern2)))) << 32;
+    mask1 &= LowBits64(size);
+    mask2 &= LowBits64(size);
+}
+#endif
+
+struct SimdDispatcher {
+    SimdLevel mLevel = SimdLevel::SCALAR;
+    const char* (*mFindFirstOf)(const char*, const char*, char) = FindFirstOfScalar;
+    const char* (*mFindFirstOf2)(const char*, const char*, char, char) = FindFirstOf2Scalar;
+    void (*mFindAllOf)(const char*, size_t, char, std::vector<size_t>&) = FindAllOfScalar;
+    void (*mClassifyBlock64)(const char*, size_t, char, char, uint64_t&, uint64_t&) = ClassifyBlock64Scalar;
+
+    SimdDispatcher() { Select(DetectSimdLevel()); }
+
+    static SimdLevel DetectSimdLevel() {
+#if defined(LOGTAIL_SIMD_AVX2)
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("avx2")) {
+            return SimdLevel::AVX2;
+        }
+#endif
+#if defined(LOGTAIL_SIMD_SSE2)
+        return SimdLevel::SSE2;
+#else
+        return SimdLevel::SCALAR;
+#endif
+    }
+
+    void Select(SimdLevel level) {
+        switch (level) {
+#if defined(LOGTAIL_SIMD_AVX2)
+            case SimdLevel::AVX2:
+                mFindFirstOf = FindFirstOfAVX2;
+                mFindFirstOf2 = FindFirstOf2AVX2;
+                mFindAllOf = FindAllOfAVX2;
+                mClassifyBlock64 = ClassifyBlock64AVX2;
+                break;
+#endif
+#if defined(LOGTAIL_SIMD_SSE2)
+            case SimdLevel::SSE2:
+                mFindFirstOf = FindFirstOfSSE2;
+                mFindFirstOf2 = FindFirstOf2SSE2;
+                mFindAllOf = FindAllOfSSE2;
+                mClassifyBlock64 = ClassifyBlock64SSE2;
+                break;
+#endif
+            default:
+                level = SimdLevel::SCALAR;
+                mFindFirstOf = FindFirstOfScalar;
+                mFindFirstOf2 = FindFirstOf2Scalar;
+                mFindAllOf = FindAllOfScalar;
+                mClassifyBlock64 = ClassifyBlock64Scalar;
+                break;
+        }
+        mLevel = level;
+    }
+};
+
+SimdDispatcher& GetDispatcher() {
+    static SimdDispatcher sDispatcher;
+    return sDispatcher;
+}
+
+} // namespace
+
+SimdLevel GetSimdLevel() {
+    return GetDispatcher().mLevel;
+}
+
+const char* SimdLevelToString(SimdLevel level) {
+    switch (level) {
+        case SimdLevel::AVX2:
+            return "avx2";
+        case SimdLevel::SSE2:
+            return "sse2";
+        default:
+            return "scalar";
+    }
+}
+
+const char* FindFirstOf(const char* begin, const char* end, char c) {
+    if (begin >= end) {
+        return end;
+    }
+    return GetDispatcher().mFindFirstOf(begin, end, c);
+}
+
+const char* FindFirstOf(const char* begin, const char* end, char c1, char c2) {
+    if (begin >= end) {
+        return end;
+    }
+    return GetDispatcher().mFindFirstOf2(begin, end, c1, c2);
+}
+
+void FindAllOf(const char* data, size_t size, char c, std::vector<size_t>& offsets) {
+    if (size == 0) {
+        return;
+    }
+    GetDispatcher().mFindAllOf(data, size, c, offsets);
+}
+
+void ClassifyBlock64(const char* data, size_t size, char c1, char c2, uint64_t& mask1, uint64_t& mask2) {
+    GetDispatcher().mClassifyBlock64(data, size, c1, c2, mask1, mask2);
+}
+
+#ifdef APSARA_UNIT_TEST_MAIN
+void SetSimdLevelForTest(SimdLevel level) {
+    SimdDispatcher& dispatcher = GetDispatcher();
+    if (static_cast<int>(level) > static_cast<int>(SimdDispatcher::DetectSimdLevel())) {
+        level = SimdDispatcher::DetectSimdLevel();
+    }
+    dispatcher.Select(level);
+}
+#endif
+
+} // namespace logtail
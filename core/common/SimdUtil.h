@@ -0,0 +1,85 @@
+/*
+ * Copyright 2024 iLogtail Authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+// Vectorized byte scanning utility.
+// On x86_64, AVX2 is used when supported by the running CPU, otherwise SSE2. Other platforms use scalar code.
+namespace logtail {
+
+enum class SimdLevel { SCALAR, SSE2, AVX2 };
+
+// Instruction set selected at runtime for all functions below.
+SimdLevel GetSimdLevel();
+const char* SimdLevelToString(SimdLevel level);
+
+// Find the first occurrence of @c in [@begin, @end), return @end if not found.
+const char* FindFirstOf(const char* begin, const char* end, char c);
+
+// Find the first occurrence of @c1 or @c2 in [@begin, @end), return @end if not found.
+const char* FindFirstOf(const char* begin, const char* end, char c1, char c2);
+
+// Append the offsets (relative to @data) of all occurrences of @c in [@data, @data + @size) to @offsets.
+void FindAllOf(const char* data, size_t size, char c, std::vector<size_t>& offsets);
+
+// Classify a block of at most 64 bytes: bit i of @mask1 (resp. @mask2) is set if @data[i] is @c1 (resp. @c2).
+// Bits beyond @size are cleared.
+void ClassifyBlock64(const char* data, size_t size, char c1, char c2, uint64_t& mask1, uint64_t& mask2);
+
+// Bit i of the result is the xor of bits [0, i] of @mask. For a mask of quote positions, the bits set are those from
+// each opening quote up to, but excluding, the matching closing quote.
+inline uint64_t PrefixXor(uint64_t mask) {
+    mask ^= mask << 1;
+    mask ^= mask << 2;
+    mask ^= mask << 4;
+    mask ^= mask << 8;
+    mask ^= mask << 16;
+    mask ^= mask << 32;
+    return mask;
+}
+
+// @mask must not be 0.
+inline uint32_t CountTrailingZeros64(uint64_t mask) {
+#if defined(_MSC_VER)
+    unsigned long index = 0;
+    _BitScanForward64(&index, mask);
+    return static_cast<uint32_t>(index);
+#else
+    return static_cast<uint32_t>(__builtin_ctzll(mask));
+#endif
+}
+
+inline uint32_t PopCount64(uint64_t mask) {
+#if defined(_MSC_VER)
+    return static_cast<uint32_t>(__popcnt64(mask));
+#else
+    return static_cast<uint32_t>(__builtin_popcountll(mask));
+#endif
+}
+
+#ifdef APSARA_UNIT_TEST_MAIN
+// Force the implementation used, level higher than the CPU supports is ignored.
+void SetSimdLevelForTest(SimdLevel level);
+#endif
+
+} // namespace logtail
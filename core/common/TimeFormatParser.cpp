@@ -0,0 +1,450 @@
+// Copyright 2024 iLogtail Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "common/TimeFormatParser.h"
+
+#include <cctype>
+#include <cstring>
+#include <limits>
+
+#include "common/StringTools.h"
+
+using namespace std;
+
+namespace logtail {
+
+static const char* const sDays[7] = {"Sunday", "Monday", "Tuesday", "Wednesday", "Thursday", "Friday", "Saturday"};
+static const char* const sAbbrDays[7] = {"Sun", "Mon", "Tue", "Wed", "Thu", "Fri", "Sat"};
+static const char* const sMonths[12] = {"January",
+                                        "February",
+                                        "March",
+                                        "April",
+                                        "May",
+                                        "June",
+                                        "July",
+                                        "August",
+                                        "September",
+                                        "October",
+                                        "November",
+                                        "December"};
+static const char* const sAbbrMonths[12]
+    = {"Jan", "Feb", "Mar", "Apr", "May", "Jun", "Jul", "Aug", "Sep", "Oct", "Nov", "Dec"};
+
+static inline bool IsDigit(char c) {
+    return c >= '0' && c <= '9';
+}
+
+static inline bool IsSpace(char c) {
+    return isspace(static_cast<unsigned char>(c));
+}
+
+// same as conv_num in Strptime.cpp: digits are consumed greedily as long as the result may stay within @ulim
+static const char* ParseNum(const char* p, const char* end, int& dest, unsigned int llim, unsigned int ulim) {
+    if (p == end || !IsDigit(*p)) {
+        return nullptr;
+    }
+    unsigned int result = 0;
+    unsigned int rulim = ulim;
+    do {
+        result = result * 10 + (*p++ - '0');
+        rulim /= 10;
+    } while (result * 10 <= ulim && rulim && p != end && IsDigit(*p));
+    if (result < llim || result > ulim) {
+        return nullptr;
+    }
+    dest = result;
+    return p;
+}
+
+static inline bool CaseInsensitiveEqual(const char* p, const char* name, size_t len) {
+    for (size_t i = 0; i < len; ++i) {
+        if (tolower(static_cast<unsigned char>(p[i])) != tolower(static_cast<unsigned char>(name[i]))) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Same as find_string in Strptime.cpp, which tries full names before abbreviated ones. Since abbreviations are
+// distinct prefixes of full names, the only full name that may match is the one of the matched abbreviation.
+static const char* ParseName(
+    const char* p, const char* end, int& dest, const char* const* names, const char* const* abbrNames, int cnt) {
+    if (end - p < 3) {
+        return nullptr;
+    }
+    for (int i = 0; i < cnt; ++i) {
+        if (CaseInsensitiveEqual(p, abbrNames[i], 3)) {
+            dest = i;
+            size_t len = strlen(names[i]);
+            if (static_cast<size_t>(end - p) >= len && CaseInsensitiveEqual(p + 3, names[i] + 3, len - 3)) {
+                return p + len;
+            }
+            return p + 3;
+        }
+    }
+    return nullptr;
+}
+
+// Local time is converted the same way as Strptime, i.e. by mktime with tm_isdst unset, which is expensive due to
+// time zone lookup. Since the offset from UTC stays the same within an hour, the timestamp of the hour is cached per
+// thread, so that logs in the same hour cost no more than an addition.
+static bool MakeTime(struct tm& tm, time_t& res) {
+    struct HourCache {
+        int64_t mKey = numeric_limits<int64_t>::min();
+        time_t mTime = 0;
+    };
+    static thread_local HourCache sCache;
+
+    int64_t key = ((static_cast<int64_t>(tm.tm_year) * 12 + tm.tm_mon) * 32 + tm.tm_mday) * 24 + tm.tm_hour;
+    if (key != sCache.mKey) {
+        struct tm hourTm = tm;
+        hourTm.tm_min = 0;
+        hourTm.tm_sec = 0;
+        time_t hourTime = mktime(&hourTm);
+        if (hourTime == -1) {
+            return false;
+        }
+        sCache.mKey = key;
+        sCache.mTime = hourTime;
+    }
+    res = sCache.mTime + tm.tm_min * 60 + tm.tm_sec;
+    return true;
+}
+
+bool TimeFormatParser::Compile(const string& format, int32_t specifiedYear) {
+    mOps.clear();
+    mCompiled = false;
+    mEpoch = false;
+    mDefaultYear = 0;
+    if (format == "%s") {
+        mEpoch = true;
+        mCompiled = true;
+        return true;
+    }
+    // Strptime with %f only parses the nanosecond part
+    if (format == "%f" || !CompileOps(format.c_str())) {
+        mOps.clear();
+        return false;
+    }
+
+    size_t yearCnt = 0;
+    for (const auto& op : mOps) {
+        if (op.mType == OpType::YEAR || op.mType == OpType::SHORT_YEAR) {
+            ++yearCnt;
+        }
+    }
+    if (yearCnt > 1) {
+        // %y after %Y keeps the century, leave it to Strptime
+        mOps.clear();
+        return false;
+    }
+    if (yearCnt == 0) {
+        // year deduction from current time is left to Strptime, and so is mktime on an invalid year
+        if (specifiedYear <= 0) {
+            mOps.clear();
+            return false;
+        }
+        mDefaultYear = specifiedYear - 1900;
+    }
+    mCompiled = true;
+    return true;
+}
+
+bool TimeFormatParser::CompileOps(const char* fmt) {
+    for (char c = *fmt++; c != '\0'; c = *fmt++) {
+        // Strptime parses composite conversions recursively, which clears the nanosecond parsed before
+        if (c == '%' && strchr("cDxFRTX", *fmt) != nullptr) {
+            for (const auto& op : mOps) {
+                if (op.mType == OpType::NANOSECOND) {
+                    return false;
+                }
+            }
+        }
+        if (IsSpace(c)) {
+            mOps.push_back({OpType::SPACE, 0});
+            continue;
+        }
+        if (c != '%') {
+            mOps.push_back({OpType::LITERAL, c});
+            continue;
+        }
+        switch (c = *fmt++) {
+            case '%':
+                mOps.push_back({OpType::LITERAL, '%'});
+                break;
+            case 'c':
+                if (!CompileOps("%a %b %d %H:%M:%S %Y")) {
+                    return false;
+                }
+                break;
+            case 'D':
+            case 'x':
+                if (!CompileOps("%m/%d/%y")) {
+                    return false;
+                }
+                break;
+            case 'F':
+                if (!CompileOps("%Y-%m-%d")) {
+                    return false;
+                }
+                break;
+            case 'R':
+                if (!CompileOps("%H:%M")) {
+                    return false;
+                }
+                break;
+            case 'T':
+            case 'X':
+                if (!CompileOps("%H:%M:%S")) {
+                    return false;
+                }
+                break;
+            case 'A':
+            case 'a':
+                mOps.push_back({OpType::WEEKDAY_NAME, 0});
+                break;
+            case 'B':
+            case 'b':
+            case 'h':
+                mOps.push_back({OpType::MONTH_NAME, 0});
+                break;
+            case 'd':
+            case 'e':
+                mOps.push_back({OpType::DAY, 0});
+                break;
+            case 'f':
+                mOps.push_back({OpType::NANOSECOND, 0});
+                break;
+            case 'H':
+            case 'k':
+                mOps.push_back({OpType::HOUR, 0});
+                break;
+            case 'M':
+                mOps.push_back({OpType::MINUTE, 0});
+                break;
+            case 'm':
+                mOps.push_back({OpType::MONTH, 0});
+                break;
+            case 'S':
+                mOps.push_back({OpType::SECOND, 0});
+                break;
+            case 'Y':
+                mOps.push_back({OpType::YEAR, 0});
+                break;
+            case 'y':
+                mOps.push_back({OpType::SHORT_YEAR, 0});
+                break;
+            case 'Z':
+                mOps.push_back({OpType::ZONE_NAME, 0});
+                break;
+            case 'z':
+                mOps.push_back({OpType::ZONE_OFFSET, 0});
+                break;
+            case 'n':
+            case 't':
+                mOps.push_back({OpType::SPACE, 0});
+                break;
+            default:
+                // 12-hour clock, week and day of year, alternative modifiers, etc.
+                return false;
+        }
+    }
+    return true;
+}
+
+bool TimeFormatParser::Parse(StringView str, LogtailTime& ts, int& nanosecondLength) const {
+    if (!mCompiled) {
+        return false;
+    }
+    if (mEpoch) {
+        return ParseEpoch(str, ts, nanosecondLength);
+    }
+
+    struct tm tm = {};
+    tm.tm_year = mDefaultYear;
+    long nanosecond = 0;
+    const char* p = str.data();
+    const char* end = str.data() + str.size();
+    for (const auto& op : mOps) {
+        int value = 0;
+        switch (op.mType) {
+            case OpType::LITERAL:
+                if (p == end || *p != op.mLiteral) {
+                    return false;
+                }
+                ++p;
+                break;
+            case OpType::SPACE:
+                while (p != end && IsSpace(*p)) {
+                    ++p;
+                }
+                break;
+            case OpType::YEAR:
+                if (!(p = ParseNum(p, end, value, 0, 9999))) {
+                    return false;
+                }
+                tm.tm_year = value - 1900;
+                break;
+            case OpType::SHORT_YEAR:
+                if (!(p = ParseNum(p, end, value, 0, 99))) {
+                    return false;
+                }
+                tm.tm_year = value <= 68 ? value + 100 : value;
+                break;
+            case OpType::MONTH:
+                if (!(p = ParseNum(p, end, value, 1, 12))) {
+                    return false;
+                }
+                tm.tm_mon = value - 1;
+                break;
+            case OpType::MONTH_NAME:
+                if (!(p = ParseName(p, end, tm.tm_mon, sMonths, sAbbrMonths, 12))) {
+                    return false;
+                }
+                break;
+            case OpType::DAY:
+                if (!(p = ParseNum(p, end, tm.tm_mday, 1, 31))) {
+                    return false;
+                }
+                break;
+            case OpType::HOUR:
+                if (!(p = ParseNum(p, end, tm.tm_hour, 0, 23))) {
+                    return false;
+                }
+                break;
+            case OpType::MINUTE:
+                if (!(p = ParseNum(p, end, tm.tm_min, 0, 59))) {
+                    return false;
+                }
+                break;
+            case OpType::SECOND:
+                if (!(p = ParseNum(p, end, tm.tm_sec, 0, 61))) {
+                    return false;
+                }
+                break;
+            case OpType::NANOSECOND: {
+                const char* begin = p;
+                while (p != end && IsDigit(*p) && p - begin < 10) {
+                    nanosecond = nanosecond * 10 + (*p++ - '0');
+                }
+                int len = p - begin;
+                // Strptime overflows with more than 9 digits
+                if (len == 0 || len > 9) {
+                    return false;
+                }
+                for (int i = len; i < 9; ++i) {
+                    nanosecond *= 10;
+                }
+                nanosecondLength = len;
+                break;
+            }
+            case OpType::WEEKDAY_NAME:
+                if (!(p = ParseName(p, end, tm.tm_wday, sDays, sAbbrDays, 7))) {
+                    return false;
+                }
+                break;
+            case OpType::ZONE_NAME:
+                // only GMT and UTC are recognized by Strptime on Linux, other names are left unparsed
+                if (end - p >= 3
+                    && (CStringNCaseInsensitiveCmp(p, "GMT", 3) == 0 || CStringNCaseInsensitiveCmp(p, "UTC", 3) == 0)) {
+                    p += 3;
+                }
+                break;
+            case OpType::ZONE_OFFSET: {
+                // the offset is validated but not applied, the same as Strptime
+                while (p != end && IsSpace(*p)) {
+                    ++p;
+                }
+                if (p == end) {
+                    return false;
+                }
+                char sign = *p++;
+                if (sign == 'Z') {
+                    break;
+                }
+                if (sign == 'U' || sign == 'G') {
+                    if (sign == 'G' && (p == end || *p++ != 'M')) {
+                        return false;
+                    }
+                    if (p == end || *p++ != 'T') {
+                        return false;
+                    }
+                    break;
+                }
+                if (sign != '+' && sign != '-') {
+                    // time zone names and military zones
+                    return false;
+                }
+                int offset = 0;
+                int digitCnt = 0;
+                while (digitCnt < 4 && p != end) {
+                    if (IsDigit(*p)) {
+                        offset = offset * 10 + (*p++ - '0');
+                        ++digitCnt;
+                    } else if (digitCnt == 2 && *p == ':') {
+                        ++p;
+                    } else {
+                        break;
+                    }
+                }
+                if (digitCnt != 2 && (digitCnt != 4 || offset % 100 >= 60)) {
+                    return false;
+                }
+                break;
+            }
+        }
+    }
+
+    if (!MakeTime(tm, ts.tv_sec)) {
+        return false;
+    }
+    ts.tv_nsec = nanosecond;
+    return true;
+}
+
+bool TimeFormatParser::ParseEpoch(StringView str, LogtailTime& ts, int& nanosecondLength) const {
+    // Strptime takes the first 10 digits as seconds and the rest as nanosecond. Leading zeros, signs and spaces
+    // accepted by strtoll are left to it.
+    size_t digitCnt = 0;
+    while (digitCnt < str.size() && IsDigit(str[digitCnt])) {
+        ++digitCnt;
+    }
+    if (digitCnt == 0 || str[0] == '0' || digitCnt > 19) {
+        return false;
+    }
+    size_t secondLen = digitCnt < 10 ? digitCnt : 10;
+    time_t second = 0;
+    for (size_t i = 0; i < secondLen; ++i) {
+        second = second * 10 + (str[i] - '0');
+    }
+    long nanosecond = 0;
+    int len = static_cast<int>(digitCnt - secondLen);
+    if (len > 9) {
+        return false;
+    }
+    for (size_t i = secondLen; i < digitCnt; ++i) {
+        nanosecond = nanosecond * 10 + (str[i] - '0');
+    }
+    if (len > 0) {
+        for (int i = len; i < 9; ++i) {
+            nanosecond *= 10;
+        }
+    }
+    ts.tv_sec = second;
+    ts.tv_nsec = nanosecond;
+    nanosecondLength = len;
+    return true;
+}
+
+} // namespace logtail
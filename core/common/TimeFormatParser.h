@@ -0,0 +1,76 @@
+/*
+ * Copyright 2024 iLogtail Authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "common/TimeUtil.h"
+#include "models/StringView.h"
+
+namespace logtail {
+
+// A time format compiled into a sequence of digit fields and literal checks, which avoids interpreting the format for
+// each log as Strptime does. Epoch format %s is handled by a dedicated path.
+//
+// Parsing is intended to be a fast path in front of Strptime: the result is always the same as Strptime(), but inputs
+// the compiled parser is not sure about, e.g. time zone names or more than 9 digits of nanosecond, are rejected and
+// left to Strptime.
+class TimeFormatParser {
+public:
+    // @return false if @format contains conversions not supported, in which case Parse() always fails
+    bool Compile(const std::string& format, int32_t specifiedYear = -1);
+    bool IsCompiled() const { return mCompiled; }
+
+    // @return false if @str cannot be parsed by the compiled format, the caller should turn to Strptime then
+    bool Parse(StringView str, LogtailTime& ts, int& nanosecondLength) const;
+
+private:
+    enum class OpType : uint8_t {
+        LITERAL,
+        SPACE,
+        YEAR,
+        SHORT_YEAR,
+        MONTH,
+        MONTH_NAME,
+        DAY,
+        HOUR,
+        MINUTE,
+        SECOND,
+        NANOSECOND,
+        WEEKDAY_NAME,
+        ZONE_NAME,
+        ZONE_OFFSET,
+    };
+
+    struct Op {
+        OpType mType;
+        char mLiteral;
+    };
+
+    bool CompileOps(const char* fmt);
+    bool ParseEpoch(StringView str, LogtailTime& ts, int& nanosecondLength) const;
+
+    std::vector<Op> mOps;
+    bool mCompiled = false;
+    bool mEpoch = false;
+    // year used when there is no year in the format, relative to 1900
+    int32_t mDefaultYear = 0;
+};
+
+} // namespace logtail
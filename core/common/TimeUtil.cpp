@@ -23,6 +23,8 @@
 #if defined(__linux__)
 #include <sys/sysinfo.h>
 #include <utmp.h>
+#elif defined(_MSC_VER)
+#include <Windows.h>
 #endif
 #include "common/LogtailCommonFlags.h"
 #include "common/ParamExtractor.h"
@@ -374,6 +376,25 @@ uint64_t GetCurrentTimeInNanoSeconds() {
         .count();
 }
 
+uint64_t GetCurrentThreadCpuTimeInNanoSeconds() {
+#if defined(__linux__)
+    timespec ts;
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+    return static_cast<uint64_t>(ts.tv_sec) * 1000000000ULL + ts.tv_nsec;
+#elif defined(_MSC_VER)
+    FILETIME creationTime, exitTime, kernelTime, userTime;
+    if (!GetThreadTimes(GetCurrentThread(), &creationTime, &exitTime, &kernelTime, &userTime)) {
+        return 0;
+    }
+    // in 100ns
+    uint64_t kernel = (static_cast<uint64_t>(kernelTime.dwHighDateTime) << 32) | kernelTime.dwLowDateTime;
+    uint64_t user = (static_cast<uint64_t>(userTime.dwHighDateTime) << 32) | userTime.dwLowDateTime;
+    return (kernel + user) * 100;
+#else
+    return 0;
+#endif
+}
+
 bool ParseTimeZoneOffsetSecond(const std::string& logTZ, int& logTZSecond) {
     if (logTZ.size() != strlen("GMT+08:00") || logTZ[6] != ':' || (logTZ[3] != '+' && logTZ[3] != '-')) {
         return false;
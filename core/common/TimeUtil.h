@@ -47,6 +47,8 @@ std::string GetTimeStamp(time_t tm, const std::string& format = "%Y%m%d%H%M%S");
 uint64_t GetCurrentTimeInMicroSeconds();
 uint64_t GetCurrentTimeInMilliSeconds();
 uint64_t GetCurrentTimeInNanoSeconds();
+// CPU time consumed by the calling thread in ns, 0 on platforms not supported.
+uint64_t GetCurrentThreadCpuTimeInNanoSeconds();
 
 // Get offset between current time zone and UTC in seconds.
 // For example, for UTC+8, returns 8*60*60.
@@ -0,0 +1,11 @@
+#include "version.h"
+
+const char* const ILOGTAIL_VERSION = "2.0.0";
+const char* const ILOGTAIL_GIT_HASH = "f4bd39dfddebc7665e6cbe0ae7b9ec0b959c98dc";
+const char* const ILOGTAIL_BUILD_DATE = "20261016";
+
+#if defined(__linux__)
+const char* const ILOGTAIL_UPDATE_SUFFIX = "";
+#elif defined(_MSC_VER)
+const char* const ILOGTAIL_UPDATE_SUFFIX = ".update";
+#endif
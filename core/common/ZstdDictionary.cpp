@@ -0,0 +1,178 @@
+// Copyright 2024 iLogtail Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "common/ZstdDictionary.h"
+
+#include <zstd/zdict.h>
+#include <zstd/zstd.h>
+
+#include <algorithm>
+#include <ctime>
+
+#include "common/Flags.h"
+#include "common/TimeUtil.h"
+#include "logger/Logger.h"
+
+DEFINE_FLAG_BOOL(enable_zstd_dictionary_evaluation,
+                 "train zstd dictionaries per logstore and evaluate them on sampled log groups",
+                 false);
+DEFINE_FLAG_INT32(zstd_dictionary_sample_interval, "sample one of every n log groups of a logstore", 10);
+DEFINE_FLAG_INT32(zstd_dictionary_sample_count, "log groups sampled to train a dictionary", 100);
+DEFINE_FLAG_INT32(zstd_dictionary_max_sample_size, "bytes, larger log groups are truncated when sampled", 128 * 1024);
+DEFINE_FLAG_INT32(zstd_dictionary_size, "max bytes of a trained dictionary", 32 * 1024);
+DEFINE_FLAG_INT32(zstd_dictionary_refresh_interval,
+                  "seconds, retrain the dictionary of a logstore, and drop logstores not sent since then",
+                  3600);
+
+namespace logtail {
+
+// too few samples can not tell what is common in the log groups
+static const size_t kMinTrainSampleCount = 8;
+
+std::shared_ptr<ZstdDictionary>
+ZstdDictionary::Train(const std::vector<std::string>& samples, size_t capacity, int32_t level) {
+    if (samples.size() < kMinTrainSampleCount || capacity == 0) {
+        return nullptr;
+    }
+    std::string buffer;
+    std::vector<size_t> sampleSizes;
+    sampleSizes.reserve(samples.size());
+    for (const auto& sample : samples) {
+        buffer.append(sample);
+        sampleSizes.push_back(sample.size());
+    }
+
+    std::shared_ptr<ZstdDictionary> dict(new ZstdDictionary());
+    dict->mContent.resize(capacity);
+    size_t dictSize = ZDICT_trainFromBuffer(
+        &dict->mContent[0], capacity, buffer.data(), sampleSizes.data(), static_cast<unsigned>(sampleSizes.size()));
+    if (ZDICT_isError(dictSize)) {
+        LOG_DEBUG(sLogger, ("train zstd dictionary fail", ZDICT_getErrorName(dictSize))("samples", samples.size()));
+        return nullptr;
+    }
+    dict->mContent.resize(dictSize);
+    dict->mId = ZDICT_getDictID(dict->mContent.data(), dict->mContent.size());
+    dict->mCDict = ZSTD_createCDict(dict->mContent.data(), dict->mContent.size(), level);
+    dict->mDDict = ZSTD_createDDict(dict->mContent.data(), dict->mContent.size());
+    if (dict->mCDict == nullptr || dict->mDDict == nullptr) {
+        return nullptr;
+    }
+    return dict;
+}
+
+ZstdDictionary::~ZstdDictionary() {
+    ZSTD_freeCDict(mCDict);
+    ZSTD_freeDDict(mDDict);
+}
+
+bool ZstdDictionary::Compress(const char* src, uint32_t size, std::string& dst) const {
+    return CompressZstdUsingDict(src, size, dst, mCDict);
+}
+
+bool ZstdDictionary::Uncompress(const char* src, uint32_t size, uint32_t rawSize, std::string& dst) const {
+    return UncompressZstdUsingDict(src, size, rawSize, dst, mDDict);
+}
+
+void ZstdDictionaryManager::Feed(LogstoreFeedBackKey key, const char* data, uint32_t size) {
+    if (!BOOL_FLAG(enable_zstd_dictionary_evaluation)) {
+        return;
+    }
+    time_t curTime = time(NULL);
+    std::shared_ptr<ZstdDictionary> dict;
+    std::vector<std::string> samples;
+    {
+        std::lock_guard<std::mutex> lock(mMux);
+        auto& entry = mEntries[key];
+        entry.mLastFeedTime = curTime;
+        if (entry.mFedCount++ % std::max(INT32_FLAG(zstd_dictionary_sample_interval), 1) != 0) {
+            return;
+        }
+        dict = entry.mDictionary;
+        if (!entry.mTraining
+            && (dict == nullptr || curTime - entry.mLastTrainTime >= INT32_FLAG(zstd_dictionary_refresh_interval))) {
+            entry.mSamples.emplace_back(data, std::min(size, (uint32_t)INT32_FLAG(zstd_dictionary_max_sample_size)));
+            if (entry.mSamples.size() >= (size_t)INT32_FLAG(zstd_dictionary_sample_count)) {
+                entry.mTraining = true;
+                samples.swap(entry.mSamples);
+            }
+        }
+    }
+    if (dict) {
+        Evaluate(*dict, data, size);
+    }
+    if (samples.empty()) {
+        return;
+    }
+
+    // the send path is not blocked by training, the current dictionary keeps being evaluated meanwhile
+    std::call_once(mTrainPoolOnce, [this]() { mTrainPool.Start(); });
+    mTrainPool.Add([this, key, samples, curTime]() { TrainDictionary(key, samples, curTime); });
+}
+
+void ZstdDictionaryManager::TrainDictionary(LogstoreFeedBackKey key,
+                                            const std::vector<std::string>& samples,
+                                            time_t sampleTime) {
+    auto newDict = ZstdDictionary::Train(samples, INT32_FLAG(zstd_dictionary_size));
+    std::lock_guard<std::mutex> lock(mMux);
+    // entries being trained are never removed
+    auto& entry = mEntries[key];
+    entry.mTraining = false;
+    entry.mLastTrainTime = sampleTime;
+    if (newDict) {
+        LOG_INFO(sLogger,
+                 ("zstd dictionary trained, logstore key", key)("id", newDict->GetId())(
+                     "size", newDict->GetContent().size())("samples", samples.size()));
+        entry.mDictionary = newDict;
+    }
+}
+
+std::shared_ptr<ZstdDictionary> ZstdDictionaryManager::GetDictionary(LogstoreFeedBackKey key) const {
+    std::lock_guard<std::mutex> lock(mMux);
+    auto iter = mEntries.find(key);
+    return iter == mEntries.end() ? nullptr : iter->second.mDictionary;
+}
+
+CompressStatistics ZstdDictionaryManager::ExchangeStatistics() {
+    std::lock_guard<std::mutex> lock(mMux);
+    CompressStatistics stat = mStatistics;
+    mStatistics = CompressStatistics();
+    return stat;
+}
+
+void ZstdDictionaryManager::RemoveExpired(time_t curTime) {
+    std::lock_guard<std::mutex> lock(mMux);
+    for (auto iter = mEntries.begin(); iter != mEntries.end();) {
+        if (!iter->second.mTraining
+            && curTime - iter->second.mLastFeedTime >= INT32_FLAG(zstd_dictionary_refresh_interval)) {
+            iter = mEntries.erase(iter);
+        } else {
+            ++iter;
+        }
+    }
+}
+
+void ZstdDictionaryManager::Evaluate(const ZstdDictionary& dict, const char* data, uint32_t size) {
+    static thread_local std::string sCompressed;
+    uint64_t startTime = GetCurrentThreadCpuTimeInNanoSeconds();
+    if (!dict.Compress(data, size, sCompressed)) {
+        return;
+    }
+    uint64_t cpuTime = GetCurrentThreadCpuTimeInNanoSeconds() - startTime;
+    std::lock_guard<std::mutex> lock(mMux);
+    mStatistics.mRawBytes += size;
+    mStatistics.mCompressedBytes += sCompressed.size();
+    mStatistics.mCpuTimeNs += cpuTime;
+}
+
+} // namespace logtail
@@ -0,0 +1,105 @@
+/*
+ * Copyright 2024 iLogtail Authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "common/CompressTools.h"
+#include "common/LogstoreFeedbackKey.h"
+#include "common/ThreadPool.h"
+
+namespace logtail {
+
+// A zstd dictionary trained from samples of serialized log groups, together with the digested forms used by the
+// compressing and decompressing side.
+class ZstdDictionary {
+public:
+    // @return nullptr if there are too few samples or the samples have nothing in common
+    static std::shared_ptr<ZstdDictionary>
+    Train(const std::vector<std::string>& samples, size_t capacity, int32_t level = ZSTD_DEFAULT_LEVEL);
+
+    ZstdDictionary(const ZstdDictionary&) = delete;
+    ZstdDictionary& operator=(const ZstdDictionary&) = delete;
+    ~ZstdDictionary();
+
+    bool Compress(const char* src, uint32_t size, std::string& dst) const;
+    bool Uncompress(const char* src, uint32_t size, uint32_t rawSize, std::string& dst) const;
+
+    uint32_t GetId() const { return mId; }
+    const std::string& GetContent() const { return mContent; }
+
+private:
+    ZstdDictionary() = default;
+
+    std::string mContent;
+    uint32_t mId = 0;
+    ZSTD_CDict_s* mCDict = nullptr;
+    ZSTD_DDict_s* mDDict = nullptr;
+};
+
+// Keeps a dictionary per logstore, trained from log groups sampled from the send path and retrained periodically.
+// Training takes a while, so it runs in a background thread and the dictionary of a logstore is replaced when done.
+//
+// SLS does not accept payloads compressed with a custom dictionary, so the dictionaries are only evaluated: sampled log
+// groups are additionally compressed with the dictionary of their logstore, and the statistics can be compared with
+// the ones of CompressData() before dictionary compression is enabled for any real payload.
+class ZstdDictionaryManager {
+public:
+    static ZstdDictionaryManager* GetInstance() {
+        static ZstdDictionaryManager* ptr = new ZstdDictionaryManager();
+        return ptr;
+    }
+
+    // called with each serialized log group before it is compressed, does nothing unless evaluation is enabled
+    void Feed(LogstoreFeedBackKey key, const char* data, uint32_t size);
+    std::shared_ptr<ZstdDictionary> GetDictionary(LogstoreFeedBackKey key) const;
+    // statistics of compression with dictionaries since last call
+    CompressStatistics ExchangeStatistics();
+    void RemoveExpired(time_t curTime);
+
+private:
+    struct LogstoreEntry {
+        std::vector<std::string> mSamples;
+        std::shared_ptr<ZstdDictionary> mDictionary;
+        uint64_t mFedCount = 0;
+        time_t mLastTrainTime = 0;
+        time_t mLastFeedTime = 0;
+        bool mTraining = false;
+    };
+
+    ZstdDictionaryManager() = default;
+
+    void Evaluate(const ZstdDictionary& dict, const char* data, uint32_t size);
+    void TrainDictionary(LogstoreFeedBackKey key, const std::vector<std::string>& samples, time_t sampleTime);
+
+    mutable std::mutex mMux;
+    std::unordered_map<LogstoreFeedBackKey, LogstoreEntry> mEntries;
+    CompressStatistics mStatistics;
+    ThreadPool mTrainPool{1};
+    std::once_flag mTrainPoolOnce;
+
+#ifdef APSARA_UNIT_TEST_MAIN
+    friend class ZstdDictionaryUnittest;
+#endif
+};
+
+} // namespace logtail
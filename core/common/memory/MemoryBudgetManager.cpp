@@ -0,0 +1,241 @@
+// Copyright 2024 iLogtail Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "common/memory/MemoryBudgetManager.h"
+
+#include <algorithm>
+
+#include "common/Flags.h"
+#include "monitor/MetricConstants.h"
+
+DEFINE_FLAG_INT32(memory_budget_percent,
+                  "memory held by pipelines at most, in percent of the memory limit of the process, 0 means unlimited",
+                  50);
+DEFINE_FLAG_INT32(memory_budget_pipeline_percent,
+                  "memory held by one pipeline at most, in percent of the global memory budget",
+                  50);
+DEFINE_FLAG_INT32(memory_budget_low_priority_percent,
+                  "pipelines of the lowest priority are paused once the global memory usage reaches the percent of "
+                  "the global memory budget",
+                  70);
+DEFINE_FLAG_INT32(memory_budget_low_watermark_percent,
+                  "pushing is allowed again once the memory usage drops to the percent of the budget",
+                  80);
+
+using namespace std;
+
+namespace logtail {
+
+PipelineMemoryBudget::PipelineMemoryBudget(MemoryBudgetManager* manager, const string& configName, bool lowPriority)
+    : mManager(manager), mConfigName(configName), mLowPriority(lowPriority) {
+    WriteMetrics::GetInstance()->PrepareMetricsRecordRef(
+        mMetricsRecordRef, {{"config_name", configName}, {"component_name", "memory_budget"}});
+    mUsageBytes = mMetricsRecordRef.CreateGauge(METRIC_PIPELINE_MEMORY_BUDGET_USAGE_BYTES);
+    mLimitBytes = mMetricsRecordRef.CreateGauge(METRIC_PIPELINE_MEMORY_BUDGET_LIMIT_BYTES);
+    mBlockTotal = mMetricsRecordRef.CreateCounter(METRIC_PIPELINE_MEMORY_BUDGET_BLOCK_TOTAL);
+}
+
+void PipelineMemoryBudget::Reserve(int64_t bytes) {
+    int64_t usage = mUsage.fetch_add(bytes, memory_order_relaxed) + bytes;
+    mManager->ReserveGlobal(bytes);
+    int64_t limit = mManager->GetPipelineLimit();
+    // no feedback is given here, since data is usually reserved with the queue locked, and a release slipping in
+    // before the state is changed is corrected by the next release
+    if (limit > 0 && usage >= limit && mValidToPush.exchange(false, memory_order_acq_rel)) {
+        mBlockTotal->Add(1);
+    }
+}
+
+void PipelineMemoryBudget::Release(int64_t bytes) {
+    mUsage.fetch_sub(bytes, memory_order_relaxed);
+    mManager->ReleaseGlobal(bytes);
+    ValidatePushIfNeeded();
+}
+
+bool PipelineMemoryBudget::IsValidToPush() const {
+    return mValidToPush.load(memory_order_acquire) && mManager->IsValidToPush(IsLowPriority());
+}
+
+void PipelineMemoryBudget::SetUpStreamFeedbacks(int64_t key, const vector<FeedbackInterface*>& feedbacks) {
+    ScopedSpinLock lock(mFeedbackLock);
+    mFeedbackKey = key;
+    mUpStreamFeedbacks = feedbacks;
+}
+
+void PipelineMemoryBudget::GiveFeedback() const {
+    ScopedSpinLock lock(mFeedbackLock);
+    for (auto& item : mUpStreamFeedbacks) {
+        item->Feedback(mFeedbackKey);
+    }
+}
+
+void PipelineMemoryBudget::UpdateMetrics(int64_t limit) {
+    mUsageBytes->Set(max<int64_t>(GetUsage(), 0));
+    mLimitBytes->Set(limit);
+}
+
+void PipelineMemoryBudget::ValidatePushIfNeeded() {
+    if (mValidToPush.load(memory_order_acquire)) {
+        return;
+    }
+    int64_t limit = mManager->GetPipelineLimit();
+    if (limit > 0 && GetUsage() > mManager->GetLowWatermark(limit)) {
+        return;
+    }
+    bool expected = false;
+    if (mValidToPush.compare_exchange_strong(expected, true, memory_order_acq_rel)) {
+        GiveFeedback();
+    }
+}
+
+shared_ptr<PipelineMemoryBudget> MemoryBudgetManager::CreateOrUpdateBudget(const string& configName,
+                                                                          bool lowPriority) {
+    lock_guard<mutex> lock(mBudgetMux);
+    auto& budget = mBudgets[configName];
+    if (budget) {
+        budget->SetLowPriority(lowPriority);
+    } else {
+        budget = make_shared<PipelineMemoryBudget>(this, configName, lowPriority);
+    }
+    return budget;
+}
+
+void MemoryBudgetManager::DeleteBudget(const string& configName) {
+    // data still in flight is released to the budget, which lives until the last of them
+    lock_guard<mutex> lock(mBudgetMux);
+    mBudgets.erase(configName);
+}
+
+shared_ptr<PipelineMemoryBudget> MemoryBudgetManager::GetBudget(const string& configName) const {
+    lock_guard<mutex> lock(mBudgetMux);
+    auto iter = mBudgets.find(configName);
+    if (iter == mBudgets.end()) {
+        return nullptr;
+    }
+    return iter->second;
+}
+
+void MemoryBudgetManager::SetGlobalLimit(int64_t limit) {
+    int64_t oldLimit = mGlobalLimit.exchange(limit, memory_order_relaxed);
+    if (oldLimit == limit) {
+        return;
+    }
+    // a larger limit may end the backpressure at once
+    int64_t usage = GetGlobalUsage();
+    if (!ValidateGlobalPushIfNeeded(limit, usage) && IsLowPriorityPaused(oldLimit, usage)
+        && !IsLowPriorityPaused(limit, usage)) {
+        GiveFeedbacks(true);
+    }
+}
+
+int64_t MemoryBudgetManager::GetPipelineLimit() const {
+    return GetGlobalLimit() * INT32_FLAG(memory_budget_pipeline_percent) / 100;
+}
+
+void MemoryBudgetManager::SetOverLimit(bool overLimit) {
+    if (mOverLimit.exchange(overLimit, memory_order_acq_rel) && !overLimit) {
+        GiveFeedbacks(false);
+    }
+}
+
+bool MemoryBudgetManager::IsValidToPush(bool lowPriority) const {
+    if (IsOverLimit() || !mGlobalValidToPush.load(memory_order_acquire)) {
+        return false;
+    }
+    if (lowPriority && IsLowPriorityPaused(GetGlobalLimit(), GetGlobalUsage())) {
+        return false;
+    }
+    return true;
+}
+
+void MemoryBudgetManager::UpdateMetrics() const {
+    int64_t limit = GetPipelineLimit();
+    lock_guard<mutex> lock(mBudgetMux);
+    for (const auto& item : mBudgets) {
+        item.second->UpdateMetrics(limit);
+    }
+}
+
+void MemoryBudgetManager::ReserveGlobal(int64_t bytes) {
+    int64_t usage = mGlobalUsage.fetch_add(bytes, memory_order_relaxed) + bytes;
+    int64_t limit = GetGlobalLimit();
+    if (limit > 0 && usage >= limit) {
+        mGlobalValidToPush.store(false, memory_order_release);
+    }
+}
+
+void MemoryBudgetManager::ReleaseGlobal(int64_t bytes) {
+    int64_t usage = mGlobalUsage.fetch_sub(bytes, memory_order_relaxed) - bytes;
+    int64_t limit = GetGlobalLimit();
+    if (ValidateGlobalPushIfNeeded(limit, usage)) {
+        return;
+    }
+    // only the release crossing the threshold sees the usage on both sides of it
+    if (IsLowPriorityPaused(limit, usage + bytes) && !IsLowPriorityPaused(limit, usage)) {
+        GiveFeedbacks(true);
+    }
+}
+
+bool MemoryBudgetManager::ValidateGlobalPushIfNeeded(int64_t limit, int64_t usage) {
+    if (mGlobalValidToPush.load(memory_order_acquire)) {
+        return false;
+    }
+    if (limit > 0 && usage > GetLowWatermark(limit)) {
+        return false;
+    }
+    bool expected = false;
+    if (mGlobalValidToPush.compare_exchange_strong(expected, true, memory_order_acq_rel)) {
+        GiveFeedbacks(false);
+        return true;
+    }
+    return false;
+}
+
+int64_t MemoryBudgetManager::GetLowWatermark(int64_t limit) const {
+    return limit * INT32_FLAG(memory_budget_low_watermark_percent) / 100;
+}
+
+bool MemoryBudgetManager::IsLowPriorityPaused(int64_t limit, int64_t usage) const {
+    return limit > 0 && usage >= limit * INT32_FLAG(memory_budget_low_priority_percent) / 100;
+}
+
+void MemoryBudgetManager::GiveFeedbacks(bool lowPriorityOnly) const {
+    vector<shared_ptr<PipelineMemoryBudget>> budgets;
+    {
+        lock_guard<mutex> lock(mBudgetMux);
+        for (const auto& item : mBudgets) {
+            budgets.push_back(item.second);
+        }
+    }
+    for (const auto& budget : budgets) {
+        if ((!lowPriorityOnly || budget->IsLowPriority()) && budget->IsValidToPush()) {
+            budget->GiveFeedback();
+        }
+    }
+}
+
+#ifdef APSARA_UNIT_TEST_MAIN
+void MemoryBudgetManager::Clear() {
+    {
+        lock_guard<mutex> lock(mBudgetMux);
+        mBudgets.clear();
+    }
+    mGlobalLimit = 0;
+    mGlobalUsage = 0;
+    mGlobalValidToPush = true;
+    mOverLimit = false;
+}
+#endif
+
+} // namespace logtail
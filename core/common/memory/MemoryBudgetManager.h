@@ -0,0 +1,160 @@
+/*
+ * Copyright 2024 iLogtail Authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "common/FeedbackInterface.h"
+#include "common/Lock.h"
+#include "monitor/LogtailMetric.h"
+
+namespace logtail {
+
+class MemoryBudgetManager;
+
+// Bytes held in memory by a pipeline, i.e. event groups waiting in or being processed from its process queue, logs
+// being aggregated and log groups waiting in sender queues.
+//
+// Reserving never fails, since the data is in memory already. Instead, pushing to the pipeline is forbidden once the
+// usage reaches the pipeline limit, and is allowed again with feedback given to upstreams when the usage drops to the
+// low watermark, as process queues do with item counts.
+class PipelineMemoryBudget {
+public:
+    PipelineMemoryBudget(MemoryBudgetManager* manager, const std::string& configName, bool lowPriority);
+
+    PipelineMemoryBudget(const PipelineMemoryBudget&) = delete;
+    PipelineMemoryBudget& operator=(const PipelineMemoryBudget&) = delete;
+
+    void Reserve(int64_t bytes);
+    void Release(int64_t bytes);
+
+    // false if either the pipeline or the global budget is exhausted, or the pipeline is paused for its low priority
+    bool IsValidToPush() const;
+
+    int64_t GetUsage() const { return mUsage.load(std::memory_order_relaxed); }
+    const std::string& GetConfigName() const { return mConfigName; }
+
+    void SetLowPriority(bool lowPriority) { mLowPriority.store(lowPriority, std::memory_order_relaxed); }
+    bool IsLowPriority() const { return mLowPriority.load(std::memory_order_relaxed); }
+
+    // @key is passed to the feedbacks, which is the key of the process queue of the pipeline
+    void SetUpStreamFeedbacks(int64_t key, const std::vector<FeedbackInterface*>& feedbacks);
+    void GiveFeedback() const;
+
+    void UpdateMetrics(int64_t limit);
+
+private:
+    // the last one that brings the usage to the low watermark restores the push state and gives feedback
+    void ValidatePushIfNeeded();
+
+    MemoryBudgetManager* mManager;
+    const std::string mConfigName;
+    std::atomic_bool mLowPriority;
+    std::atomic<int64_t> mUsage{0};
+    std::atomic_bool mValidToPush{true};
+
+    // feedbacks are only changed on config update
+    mutable SpinLock mFeedbackLock;
+    int64_t mFeedbackKey = -1;
+    std::vector<FeedbackInterface*> mUpStreamFeedbacks;
+
+    MetricsRecordRef mMetricsRecordRef;
+    GaugePtr mUsageBytes;
+    GaugePtr mLimitBytes;
+    CounterPtr mBlockTotal;
+
+#ifdef APSARA_UNIT_TEST_MAIN
+    friend class MemoryBudgetManagerUnittest;
+#endif
+};
+
+// Accounts memory held by all pipelines against a global budget derived from the memory limit of the process, so that
+// inputs are slowed down before the limit is hit, instead of restarting the process and dropping everything in memory.
+//
+// Backpressure is applied in steps as the global usage grows:
+// 1. pipelines of the lowest priority are paused once the usage reaches memory_budget_low_priority_percent of the
+//    global limit;
+// 2. every pipeline is limited to memory_budget_pipeline_percent of the global limit, so that one pipeline stuck on
+//    its destination cannot starve the others;
+// 3. all pipelines are paused once the global limit is reached, or the process is found to exceed its memory limit.
+class MemoryBudgetManager {
+public:
+    MemoryBudgetManager(const MemoryBudgetManager&) = delete;
+    MemoryBudgetManager& operator=(const MemoryBudgetManager&) = delete;
+
+    static MemoryBudgetManager* GetInstance() {
+        static MemoryBudgetManager instance;
+        return &instance;
+    }
+
+    // the budget is kept on update, so that data in flight is released to the same budget
+    std::shared_ptr<PipelineMemoryBudget> CreateOrUpdateBudget(const std::string& configName, bool lowPriority);
+    void DeleteBudget(const std::string& configName);
+    // nullptr is returned if the budget does not exist
+    std::shared_ptr<PipelineMemoryBudget> GetBudget(const std::string& configName) const;
+
+    // @limit is in bytes, and 0 means unlimited
+    void SetGlobalLimit(int64_t limit);
+    int64_t GetGlobalLimit() const { return mGlobalLimit.load(std::memory_order_relaxed); }
+    int64_t GetGlobalUsage() const { return mGlobalUsage.load(std::memory_order_relaxed); }
+    int64_t GetPipelineLimit() const;
+
+    // set by the monitor while the process exceeds its memory limit, whatever the usage accounted
+    void SetOverLimit(bool overLimit);
+    bool IsOverLimit() const { return mOverLimit.load(std::memory_order_relaxed); }
+
+    bool IsValidToPush(bool lowPriority) const;
+
+    void UpdateMetrics() const;
+
+private:
+    friend class PipelineMemoryBudget;
+
+    MemoryBudgetManager() = default;
+    ~MemoryBudgetManager() = default;
+
+    void ReserveGlobal(int64_t bytes);
+    void ReleaseGlobal(int64_t bytes);
+    // returns true if pushing is allowed again and feedback is given to all
+    bool ValidateGlobalPushIfNeeded(int64_t limit, int64_t usage);
+    int64_t GetLowWatermark(int64_t limit) const;
+    bool IsLowPriorityPaused(int64_t limit, int64_t usage) const;
+    // feedback is only given to pipelines which are allowed to push now
+    void GiveFeedbacks(bool lowPriorityOnly) const;
+
+    mutable std::mutex mBudgetMux;
+    std::unordered_map<std::string, std::shared_ptr<PipelineMemoryBudget>> mBudgets;
+
+    std::atomic<int64_t> mGlobalLimit{0};
+    std::atomic<int64_t> mGlobalUsage{0};
+    std::atomic_bool mGlobalValidToPush{true};
+    std::atomic_bool mOverLimit{false};
+
+#ifdef APSARA_UNIT_TEST_MAIN
+    void Clear();
+    friend class MemoryBudgetManagerUnittest;
+    friend class ProcessQueueManagerUnittest;
+#endif
+};
+
+} // namespace logtail
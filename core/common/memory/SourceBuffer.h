@@ -167,6 +167,12 @@ public:
     StringBuffer CopyString(const std::string& s) { return CopyString(s.data(), s.length()); }
     StringBuffer CopyString(StringView s) { return CopyString(s.data(), s.length()); }
 
+    // raw memory which lives as long as the source buffer, aligned to pointer size
+    void* Allocate(size_t size) { return mAllocator.Allocate(size); }
+
+    // memory taken from the heap, excluding retained owners
+    int64_t GetAllocatedSize() const { return mAllocator.GetAllocatedSize(); }
+
 private:
     BufferAllocator mAllocator;
 
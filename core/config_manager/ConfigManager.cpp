@@ -562,16 +562,17 @@ FileDiscoveryConfig ConfigManager::FindBestMatch(const string& path, const strin
             }
         }
     }
-    const auto& nameConfigMap = FileServer::GetInstance()->GetAllFileDiscoveryConfigs();
-    auto itr = nameConfigMap.begin();
+    vector<FileDiscoveryConfig> candidates;
+    FileServer::GetInstance()->GetFileDiscoveryConfigIndex().FindCandidates(path, candidates);
+    auto itr = candidates.begin();
     FileDiscoveryConfig prevMatch(nullptr, nullptr);
     size_t prevLen = 0;
     size_t curLen = 0;
     uint32_t nameRepeat = 0;
     string logNameList;
     vector<FileDiscoveryConfig> multiConfigs;
-    for (; itr != nameConfigMap.end(); ++itr) {
-        const FileDiscoveryOptions* config = itr->second.first;
+    for (; itr != candidates.end(); ++itr) {
+        const FileDiscoveryOptions* config = itr->first;
         // // exclude __FUSE_CONFIG__
         // if (itr->first == STRING_FLAG(fuse_customized_config_name)) {
         //     continue;
@@ -583,21 +584,21 @@ FileDiscoveryConfig ConfigManager::FindBestMatch(const string& path, const strin
             if (!name.empty() && !config->mAllowingIncludedByMultiConfigs) {
                 nameRepeat++;
                 logNameList.append("logstore:");
-                logNameList.append(itr->second.second->GetLogstoreName());
+                logNameList.append(itr->second->GetLogstoreName());
                 logNameList.append(",config:");
-                logNameList.append(itr->second.second->GetConfigName());
+                logNameList.append(itr->second->GetConfigName());
                 logNameList.append(" ");
-                multiConfigs.push_back(itr->second);
+                multiConfigs.push_back(*itr);
             }
 
             // note: best config is the one which length is longest and create time is nearest
             curLen = config->GetBasePath().size();
             if (prevLen < curLen) {
-                prevMatch = itr->second;
+                prevMatch = *itr;
                 prevLen = curLen;
             } else if (prevLen == curLen && prevMatch.first) {
-                if (prevMatch.second->GetCreateTime() > itr->second.second->GetCreateTime()) {
-                    prevMatch = itr->second;
+                if (prevMatch.second->GetCreateTime() > itr->second->GetCreateTime()) {
+                    prevMatch = *itr;
                     prevLen = curLen;
                 }
             }
@@ -651,10 +652,11 @@ int32_t ConfigManager::FindAllMatch(vector<FileDiscoveryConfig>& allConfig,
         }
     }
     bool alarmFlag = false;
-    auto nameConfigMap = FileServer::GetInstance()->GetAllFileDiscoveryConfigs();
-    auto itr = nameConfigMap.begin();
-    for (; itr != nameConfigMap.end(); ++itr) {
-        const FileDiscoveryOptions* config = itr->second.first;
+    vector<FileDiscoveryConfig> candidates;
+    FileServer::GetInstance()->GetFileDiscoveryConfigIndex().FindCandidates(path, candidates);
+    auto itr = candidates.begin();
+    for (; itr != candidates.end(); ++itr) {
+        const FileDiscoveryOptions* config = itr->first;
         // // exclude __FUSE_CONFIG__
         // if (itr->first == STRING_FLAG(fuse_customized_config_name)) {
         //     continue;
@@ -662,7 +664,7 @@ int32_t ConfigManager::FindAllMatch(vector<FileDiscoveryConfig>& allConfig,
 
         bool match = config->IsMatch(path, name);
         if (match) {
-            allConfig.push_back(itr->second);
+            allConfig.push_back(*itr);
         }
     }
 
@@ -699,16 +701,17 @@ int32_t ConfigManager::FindMatchWithForceFlag(std::vector<FileDiscoveryConfig>&
             }
         }
     }
-    auto nameConfigMap = FileServer::GetInstance()->GetAllFileDiscoveryConfigs();
-    auto itr = nameConfigMap.begin();
+    vector<FileDiscoveryConfig> candidates;
+    FileServer::GetInstance()->GetFileDiscoveryConfigIndex().FindCandidates(path, candidates);
+    auto itr = candidates.begin();
     FileDiscoveryConfig prevMatch = make_pair(nullptr, nullptr);
     size_t prevLen = 0;
     size_t curLen = 0;
     uint32_t nameRepeat = 0;
     string logNameList;
     vector<FileDiscoveryConfig> multiConfigs;
-    for (; itr != nameConfigMap.end(); ++itr) {
-        FileDiscoveryConfig config = itr->second;
+    for (; itr != candidates.end(); ++itr) {
+        const FileDiscoveryConfig& config = *itr;
         // // exclude __FUSE_CONFIG__
         // if (itr->first == STRING_FLAG(fuse_customized_config_name)) {
         //     continue;
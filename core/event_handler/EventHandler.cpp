@@ -14,6 +14,7 @@
 
 #include "EventHandler.h"
 
+#include <atomic>
 #include <iostream>
 #include <string>
 #include <vector>
@@ -747,10 +748,12 @@ void ModifyHandler::Handle(const Event& event) {
         bool hasMoreData;
         do {
             if (!ProcessQueueManager::GetInstance()->IsValidToPush(reader->GetQueueKey())) {
-                static int32_t s_lastOutPutTime = 0;
+                // shared by the handlers on all reader threads, only the thread winning the exchange reports
+                static std::atomic<int32_t> s_lastOutPutTime{0};
                 int32_t curTime = time(NULL);
-                if (curTime - s_lastOutPutTime > 600) {
-                    s_lastOutPutTime = curTime;
+                int32_t lastOutPutTime = s_lastOutPutTime.load(std::memory_order_relaxed);
+                if (curTime - lastOutPutTime > 600
+                    && s_lastOutPutTime.compare_exchange_strong(lastOutPutTime, curTime, std::memory_order_relaxed)) {
                     LOG_WARNING(sLogger,
                                 ("logprocess queue is full, put modify event to event queue again",
                                  reader->GetHostLogPath())(reader->GetProject(), reader->GetLogstore()));
@@ -18,6 +18,7 @@
 
 #include "EventHandler.h"
 #include "HistoryFileImporter.h"
+#include "ShardedReaderPool.h"
 #include "app_config/AppConfig.h"
 #include "application/Application.h"
 #include "checkpoint/CheckPointManager.h"
@@ -58,6 +59,7 @@ DEFINE_FLAG_INT32(clear_config_match_interval, "seconds", 600);
 DEFINE_FLAG_INT32(check_block_event_interval, "seconds", 1);
 DEFINE_FLAG_STRING(local_event_data_file_name, "local event data file name", "local_event.json");
 DEFINE_FLAG_INT32(read_local_event_interval, "seconds", 60);
+DEFINE_FLAG_INT32(reader_pool_max_batch_events, "max events dispatched to reader pool before waiting for them", 1000);
 DEFINE_FLAG_BOOL(force_close_file_on_container_stopped,
                  "whether close file handler immediately when associate container stopped",
                  false);
@@ -89,12 +91,14 @@ void LogInput::Start() {
         initialized = true;
 
     mInteruptFlag = false;
+    ShardedReaderPool::GetInstance()->Start(AppConfig::GetInstance()->GetReaderThreadCount());
     new Thread([this]() { ProcessLoop(); });
 }
 
 void LogInput::Resume() {
     LOG_INFO(sLogger, ("event handle daemon resume", "starts"));
     mInteruptFlag = false;
+    ShardedReaderPool::GetInstance()->Start(AppConfig::GetInstance()->GetReaderThreadCount());
     mAccessMainThreadRWL.unlock();
     LOG_INFO(sLogger, ("event handle daemon resume", "succeeded"));
 }
@@ -108,12 +112,17 @@ void LogInput::HoldOn() {
         mInteruptFlag = true;
         mAccessMainThreadRWL.lock();
     }
+    // readers and checkpoints are dumped after hold on, no reader thread should touch them since then
+    ShardedReaderPool::GetInstance()->Stop();
     LOG_INFO(sLogger, ("event handle daemon pause", "succeeded"));
 }
 
 void LogInput::TryReadEvents(bool forceRead) {
     if (mInteruptFlag)
         return;
+    // event dispatcher is not thread safe, fs events are only read in LogInput thread
+    if (ShardedReaderPool::IsReaderThread())
+        return;
 
     if (!forceRead) {
         int64_t curMicroSeconds = GetCurrentTimeInMicroSeconds();
@@ -294,12 +303,34 @@ bool LogInput::ReadLocalEvents() {
     return true;
 }
 
+bool LogInput::DispatchToReaderPool(EventDispatcher* dispatcher, Event* ev) {
+    ShardedReaderPool* readerPool = ShardedReaderPool::GetInstance();
+    if (!readerPool->IsEnabled() || !ShardedReaderPool::IsShardable(*ev)) {
+        return false;
+    }
+    // handlers are registered or unregistered only in this thread, so it's safe to get it here
+    EventHandler* handler = dispatcher->GetHandler(ev->GetSource().c_str());
+    // only the handler of a directory owns its readers exclusively, others (e.g. the shared NormalEventHandler)
+    // register directories and handlers, which must be done in this thread
+    if (handler == NULL || dynamic_cast<CreateModifyHandler*>(handler) == NULL) {
+        return false;
+    }
+    dispatcher->PropagateTimeout(ev->GetSource().c_str());
+    readerPool->Dispatch(handler, ev);
+    return true;
+}
+
 void LogInput::ProcessEvent(EventDispatcher* dispatcher, Event* ev) {
     const string& source = ev->GetSource();
     const string& object = ev->GetObject();
     LOG_DEBUG(sLogger,
               ("process event, type", ev->GetTypeString())("dir", ev->GetSource())("filename", ev->GetObject())(
                   "config", ev->GetConfigName()));
+    if (DispatchToReaderPool(dispatcher, ev)) {
+        return;
+    }
+    // the event may touch any handler, wait for the readers to keep events of the same file in order
+    WaitReaderPool();
     if (ev->IsTimeout())
         dispatcher->UnregisterAllDir(source);
     else {
@@ -336,6 +367,11 @@ void LogInput::ProcessEvent(EventDispatcher* dispatcher, Event* ev) {
     delete ev;
 }
 
+void LogInput::WaitReaderPool() {
+    // keep reading fs events while waiting, just like a blocked push in the reader
+    ShardedReaderPool::GetInstance()->WaitAllDone([this]() { TryReadEvents(false); });
+}
+
 void LogInput::UpdateCriticalMetric(int32_t curTime) {
     LogtailMonitor::GetInstance()->UpdateMetric("last_read_event_time",
                                                 GetTimeStamp(mLastReadEventTime, "%Y-%m-%d %H:%M:%S"));
@@ -347,6 +383,8 @@ void LogInput::UpdateCriticalMetric(int32_t curTime) {
     LogtailMonitor::GetInstance()->UpdateMetric("register_handler", EventDispatcher::GetInstance()->GetHandlerCount());
     LogtailMonitor::GetInstance()->UpdateMetric("reader_count", CheckPointManager::Instance()->GetReaderCount());
     LogtailMonitor::GetInstance()->UpdateMetric("multi_config", AppConfig::GetInstance()->IsAcceptMultiConfig());
+    LogtailMonitor::GetInstance()->UpdateMetric("reader_thread_count",
+                                                ShardedReaderPool::GetInstance()->GetThreadCount());
     mEventProcessCount = 0;
 }
 
@@ -370,17 +408,24 @@ void* LogInput::ProcessLoop() {
     int32_t lastReadLocalEventTime = prevTime;
     mEventProcessCount = 0;
     BlockedEventManager* pBlockedEventManager = BlockedEventManager::GetInstance();
+    ShardedReaderPool* readerPool = ShardedReaderPool::GetInstance();
     string path;
     while (true) {
         ReadLock lock(mAccessMainThreadRWL);
         TryReadEvents(false);
         Event* ev = PopEventQueue();
         if (ev != NULL) {
-            ++mEventProcessCount;
-            if (mIdleFlag)
-                delete ev;
-            else
-                ProcessEvent(dispatcher, ev);
+            // with reader pool enabled, modify events are handled in batch so that files of different handlers can be
+            // read concurrently
+            int32_t batchCount = readerPool->IsEnabled() ? INT32_FLAG(reader_pool_max_batch_events) : 1;
+            do {
+                ++mEventProcessCount;
+                if (mIdleFlag)
+                    delete ev;
+                else
+                    ProcessEvent(dispatcher, ev);
+            } while (--batchCount > 0 && (ev = PopEventQueue()) != NULL);
+            WaitReaderPool();
         } else
             usleep(INT32_FLAG(log_input_thread_wait_interval));
         if (mIdleFlag)
@@ -464,6 +509,7 @@ void* LogInput::ProcessLoop() {
 }
 
 void LogInput::PushEventQueue(std::vector<Event*>& eventVec) {
+    lock_guard<mutex> lock(mEventQueueMux);
     for (std::vector<Event*>::iterator iter = eventVec.begin(); iter != eventVec.end(); ++iter) {
         string key;
         key.append((*iter)->GetSource())
@@ -501,6 +547,7 @@ void LogInput::PushEventQueue(Event* ev) {
         .append(">")
         .append(ev->GetConfigName());
     int64_t hashKey = HashSignatureString(key.c_str(), key.size());
+    lock_guard<mutex> lock(mEventQueueMux);
     if (ev->GetType() == EVENT_MODIFY) {
         if (mModifyEventSet.find(hashKey) != mModifyEventSet.end()) {
             delete ev;
@@ -513,6 +560,7 @@ void LogInput::PushEventQueue(Event* ev) {
 }
 
 Event* LogInput::PopEventQueue() {
+    lock_guard<mutex> lock(mEventQueueMux);
     if (mInotifyEventQueue.size() > 0) {
         Event* ev = mInotifyEventQueue.front();
         mInotifyEventQueue.pop();
@@ -533,6 +581,7 @@ void LogInput::CleanEnviroments() {
             break;
         delete ev;
     }
+    lock_guard<mutex> lock(mEventQueueMux);
     mModifyEventSet.clear();
 }
 #endif
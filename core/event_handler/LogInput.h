@@ -18,6 +18,7 @@
 #define __LOG_ILOGTAIL_LOG_INPUT_H__
 
 #include <condition_variable>
+#include <mutex>
 #include <queue>
 #include <string>
 #include <unordered_set>
@@ -64,11 +65,15 @@ private:
     ~LogInput();
     void* ProcessLoop();
     void ProcessEvent(EventDispatcher* dispatcher, Event* ev);
+    bool DispatchToReaderPool(EventDispatcher* dispatcher, Event* ev);
+    void WaitReaderPool();
     Event* PopEventQueue();
     void UpdateCriticalMetric(int32_t curTime);
 
     std::queue<Event*> mInotifyEventQueue;
     std::unordered_set<int64_t> mModifyEventSet;
+    // events can be pushed back by reader threads
+    std::mutex mEventQueueMux;
     ReadWriteLock mAccessMainThreadRWL;
     int32_t mCheckBaseDirInterval;
     int32_t mCheckSymbolicLinkInterval;
@@ -0,0 +1,122 @@
+// Copyright 2024 iLogtail Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "event_handler/ShardedReaderPool.h"
+
+#include <chrono>
+
+#include "event/Event.h"
+#include "event_handler/EventHandler.h"
+#include "logger/Logger.h"
+
+namespace logtail {
+
+static thread_local bool sIsReaderThread = false;
+
+void ShardedReaderPool::Start(int32_t threadCount) {
+    if (IsEnabled() || threadCount <= 0) {
+        return;
+    }
+    mStopFlag = false;
+    for (int32_t i = 0; i < threadCount; ++i) {
+        mShards.emplace_back(new Shard);
+    }
+    for (auto& shard : mShards) {
+        Shard* ptr = shard.get();
+        shard->mThread = CreateThread([this, ptr]() { Run(ptr); });
+    }
+    LOG_INFO(sLogger, ("sharded reader pool", "started")("thread count", threadCount));
+}
+
+void ShardedReaderPool::Stop() {
+    if (!IsEnabled()) {
+        return;
+    }
+    mStopFlag = true;
+    for (auto& shard : mShards) {
+        {
+            std::lock_guard<std::mutex> lock(shard->mMux);
+        }
+        shard->mCV.notify_one();
+    }
+    // events left in queues are handled before threads exit
+    for (auto& shard : mShards) {
+        shard->mThread->Wait(0);
+    }
+    mShards.clear();
+    LOG_INFO(sLogger, ("sharded reader pool", "stopped"));
+}
+
+void ShardedReaderPool::Dispatch(EventHandler* handler, Event* ev) {
+    Shard* shard = mShards[GetShardIndex(handler)].get();
+    ++mPendingCount;
+    {
+        std::lock_guard<std::mutex> lock(shard->mMux);
+        shard->mQueue.emplace_back(handler, ev);
+    }
+    shard->mCV.notify_one();
+}
+
+void ShardedReaderPool::WaitAllDone(const std::function<void()>& onWait) {
+    static const std::chrono::milliseconds sWaitInterval(10);
+    std::unique_lock<std::mutex> lock(mDoneMux);
+    while (!mDoneCV.wait_for(lock, sWaitInterval, [this]() { return mPendingCount == 0; })) {
+        if (onWait) {
+            lock.unlock();
+            onWait();
+            lock.lock();
+        }
+    }
+}
+
+bool ShardedReaderPool::IsReaderThread() {
+    return sIsReaderThread;
+}
+
+bool ShardedReaderPool::IsShardable(const Event& ev) {
+    static const EventType sUnshardableTypes = EVENT_TIMEOUT | EVENT_CREATE | EVENT_ISDIR | EVENT_MOVE_FROM
+        | EVENT_MOVE_TO | EVENT_DELETE | EVENT_CONTAINER_STOPPED;
+    return ev.IsModify() && (ev.GetType() & sUnshardableTypes) == 0;
+}
+
+void ShardedReaderPool::Run(Shard* shard) {
+    sIsReaderThread = true;
+    while (true) {
+        std::pair<EventHandler*, Event*> item;
+        {
+            std::unique_lock<std::mutex> lock(shard->mMux);
+            shard->mCV.wait(lock, [this, shard]() { return mStopFlag || !shard->mQueue.empty(); });
+            if (shard->mQueue.empty()) {
+                break;
+            }
+            item = shard->mQueue.front();
+            shard->mQueue.pop_front();
+        }
+        item.first->Handle(*item.second);
+        delete item.second;
+        if (--mPendingCount == 0) {
+            std::lock_guard<std::mutex> lock(mDoneMux);
+            mDoneCV.notify_all();
+        }
+    }
+    sIsReaderThread = false;
+}
+
+size_t ShardedReaderPool::GetShardIndex(const EventHandler* handler) const {
+    // handlers are heap allocated, low bits of the address are always the same
+    uintptr_t key = reinterpret_cast<uintptr_t>(handler) >> 4;
+    return std::hash<uintptr_t>()(key) % mShards.size();
+}
+
+} // namespace logtail
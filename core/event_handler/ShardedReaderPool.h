@@ -0,0 +1,87 @@
+/*
+ * Copyright 2024 iLogtail Authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+#include "common/Thread.h"
+
+namespace logtail {
+
+class Event;
+class EventHandler;
+
+// Handle file modify events in several reader threads. Events are sharded by the handler they belong to, so all readers
+// of a handler are only accessed by one thread at a time and the events of a file are handled in the order they are
+// dispatched. The pool never runs concurrently with the other work of LogInput, which must call WaitAllDone before
+// touching any handler, e.g. handling timeout or directory events, and stop the pool before readers are dumped.
+class ShardedReaderPool {
+public:
+    static ShardedReaderPool* GetInstance() {
+        static ShardedReaderPool* ptr = new ShardedReaderPool();
+        return ptr;
+    }
+
+    // threadCount <= 0 means the pool is disabled and events are handled in LogInput thread.
+    void Start(int32_t threadCount);
+    void Stop();
+    bool IsEnabled() const { return !mShards.empty(); }
+    size_t GetThreadCount() const { return mShards.size(); }
+
+    // The event is owned by the pool afterwards.
+    void Dispatch(EventHandler* handler, Event* ev);
+    // Block until all dispatched events are handled, @onWait is called periodically during waiting.
+    void WaitAllDone(const std::function<void()>& onWait = nullptr);
+
+    static bool IsReaderThread();
+    // Only plain modify events of files can be handled concurrently.
+    static bool IsShardable(const Event& ev);
+
+private:
+    struct Shard {
+        std::mutex mMux;
+        std::condition_variable mCV;
+        std::deque<std::pair<EventHandler*, Event*>> mQueue;
+        ThreadPtr mThread;
+    };
+
+    ShardedReaderPool() = default;
+    ~ShardedReaderPool() = default;
+
+    void Run(Shard* shard);
+    size_t GetShardIndex(const EventHandler* handler) const;
+
+    std::vector<std::unique_ptr<Shard>> mShards;
+    std::atomic_bool mStopFlag{false};
+    std::atomic_int mPendingCount{0};
+    std::mutex mDoneMux;
+    std::condition_variable mDoneCV;
+
+#ifdef APSARA_UNIT_TEST_MAIN
+    friend class ShardedReaderPoolUnittest;
+#endif
+};
+
+} // namespace logtail
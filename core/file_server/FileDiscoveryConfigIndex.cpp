@@ -0,0 +1,140 @@
+// Copyright 2024 iLogtail Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "file_server/FileDiscoveryConfigIndex.h"
+
+#include <algorithm>
+#include <cctype>
+
+#include "common/FileSystemUtil.h"
+
+using namespace std;
+
+namespace logtail {
+
+void FileDiscoveryConfigIndex::Add(const string& name, const FileDiscoveryConfig& config) {
+    Remove(name);
+    Anchor anchor = GetAnchor(*config.first);
+    if (!anchor.mIndexed) {
+        mUnindexedConfigs.emplace_back(name, config);
+    } else {
+        Node* node = &mRoot;
+        for (const auto& dir : anchor.mDirs) {
+            auto& child = node->mChildren[dir];
+            if (!child) {
+                child.reset(new Node());
+            }
+            node = child.get();
+        }
+        node->mConfigs.emplace_back(name, config);
+    }
+    mConfigAnchors[name] = std::move(anchor);
+}
+
+void FileDiscoveryConfigIndex::Remove(const string& name) {
+    auto iter = mConfigAnchors.find(name);
+    if (iter == mConfigAnchors.end()) {
+        return;
+    }
+    if (!iter->second.mIndexed) {
+        mUnindexedConfigs.erase(remove_if(mUnindexedConfigs.begin(),
+                                          mUnindexedConfigs.end(),
+                                          [&name](const pair<string, FileDiscoveryConfig>& item) {
+                                              return item.first == name;
+                                          }),
+                                mUnindexedConfigs.end());
+    } else {
+        RemoveFromNode(mRoot, name, iter->second.mDirs, 0);
+    }
+    mConfigAnchors.erase(iter);
+}
+
+void FileDiscoveryConfigIndex::FindCandidates(const string& path, vector<FileDiscoveryConfig>& configs) const {
+    for (const auto& item : mUnindexedConfigs) {
+        configs.emplace_back(item.second);
+    }
+    vector<string> dirs;
+    SplitPath(path, dirs);
+    const Node* node = &mRoot;
+    for (size_t i = 0;; ++i) {
+        for (const auto& item : node->mConfigs) {
+            configs.emplace_back(item.second);
+        }
+        if (i == dirs.size()) {
+            break;
+        }
+        auto iter = node->mChildren.find(dirs[i]);
+        if (iter == node->mChildren.end()) {
+            break;
+        }
+        node = iter->second.get();
+    }
+}
+
+FileDiscoveryConfigIndex::Anchor FileDiscoveryConfigIndex::GetAnchor(const FileDiscoveryOptions& options) {
+    Anchor anchor;
+    if (options.IsContainerDiscoveryEnabled()) {
+        return anchor;
+    }
+    anchor.mIndexed = true;
+    SplitPath(options.GetBasePath(), anchor.mDirs);
+    if (!options.GetWildcardPaths().empty()) {
+        // with FNM_PATHNAME, directories before the first wildcard can only be matched by themselves
+        auto iter = find_if(anchor.mDirs.begin(), anchor.mDirs.end(), [](const string& dir) {
+            return dir.find_first_of("*?[\\") != string::npos;
+        });
+        anchor.mDirs.erase(iter, anchor.mDirs.end());
+    }
+    return anchor;
+}
+
+void FileDiscoveryConfigIndex::SplitPath(const string& path, vector<string>& dirs) {
+    size_t start = 0;
+    while (start < path.size()) {
+        size_t end = path.find(PATH_SEPARATOR[0], start);
+        if (end == string::npos) {
+            end = path.size();
+        }
+        if (end > start) {
+            dirs.emplace_back(path, start, end - start);
+#if defined(_MSC_VER)
+            // wildcard paths are matched case-insensitively on Windows
+            transform(dirs.back().begin(), dirs.back().end(), dirs.back().begin(), ::tolower);
+#endif
+        }
+        start = end + 1;
+    }
+}
+
+bool FileDiscoveryConfigIndex::RemoveFromNode(Node& node,
+                                              const string& name,
+                                              const vector<string>& dirs,
+                                              size_t depth) {
+    if (depth == dirs.size()) {
+        node.mConfigs.erase(remove_if(node.mConfigs.begin(),
+                                      node.mConfigs.end(),
+                                      [&name](const pair<string, FileDiscoveryConfig>& item) {
+                                          return item.first == name;
+                                      }),
+                            node.mConfigs.end());
+    } else {
+        auto iter = node.mChildren.find(dirs[depth]);
+        if (iter != node.mChildren.end() && RemoveFromNode(*iter->second, name, dirs, depth + 1)) {
+            node.mChildren.erase(iter);
+        }
+    }
+    return node.mConfigs.empty() && node.mChildren.empty();
+}
+
+} // namespace logtail
@@ -0,0 +1,72 @@
+/*
+ * Copyright 2024 iLogtail Authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "file_server/FileDiscoveryOptions.h"
+
+namespace logtail {
+
+// A prefix trie on the constant leading directories of the base paths of file discovery configs, i.e. the directories
+// before the first wildcard. Finding configs for a path only visits the configs whose base path may contain it, which
+// takes time in the depth of the path rather than the number of configs.
+//
+// Candidates found are a superset of the matched configs, FileDiscoveryOptions::IsMatch is still needed. Configs with
+// container discovery enabled are matched against real paths of containers, which change without the config being
+// updated, so they are always candidates.
+class FileDiscoveryConfigIndex {
+public:
+    // a config with the same name is replaced
+    void Add(const std::string& name, const FileDiscoveryConfig& config);
+    void Remove(const std::string& name);
+
+    // candidates are appended to @configs
+    void FindCandidates(const std::string& path, std::vector<FileDiscoveryConfig>& configs) const;
+    size_t Size() const { return mConfigAnchors.size(); }
+
+private:
+    struct Node {
+        std::unordered_map<std::string, std::unique_ptr<Node>> mChildren;
+        std::vector<std::pair<std::string, FileDiscoveryConfig>> mConfigs;
+    };
+
+    struct Anchor {
+        bool mIndexed = false;
+        // leading directories of the base path
+        std::vector<std::string> mDirs;
+    };
+
+    static Anchor GetAnchor(const FileDiscoveryOptions& options);
+    static void SplitPath(const std::string& path, std::vector<std::string>& dirs);
+    // @return true if the node becomes empty
+    static bool RemoveFromNode(Node& node, const std::string& name, const std::vector<std::string>& dirs, size_t depth);
+
+    Node mRoot;
+    std::vector<std::pair<std::string, FileDiscoveryConfig>> mUnindexedConfigs;
+    std::unordered_map<std::string, Anchor> mConfigAnchors;
+
+#ifdef APSARA_UNIT_TEST_MAIN
+    friend class FileDiscoveryConfigIndexUnittest;
+#endif
+};
+
+} // namespace logtail
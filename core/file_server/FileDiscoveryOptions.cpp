@@ -171,6 +171,7 @@ bool FileDiscoveryOptions::Init(const Json::Value& config, const PipelineContext
     mBasePath = EncodingConverter::GetInstance()->FromUTF8ToACP(mBasePath);
     mFilePattern = EncodingConverter::GetInstance()->FromUTF8ToACP(mFilePattern);
 #endif
+    mFilePatternMatcher = GlobMatcher(mFilePattern);
     size_t len = mBasePath.size();
     if (len > 2 && mBasePath[len - 1] == '*' && mBasePath[len - 2] == '*'
         && mBasePath[len - 3] == filesystem::path::preferred_separator) {
@@ -233,9 +234,9 @@ bool FileDiscoveryOptions::Init(const Json::Value& config, const PipelineContext
             }
             bool isMultipleLevelWildcard = mExcludeFilePaths[i].find("**") != string::npos;
             if (isMultipleLevelWildcard) {
-                mMLFilePathBlacklist.push_back(mExcludeFilePaths[i]);
+                mMLFilePathBlacklist.emplace_back(mExcludeFilePaths[i]);
             } else {
-                mFilePathBlacklist.push_back(mExcludeFilePaths[i]);
+                mFilePathBlacklist.emplace_back(mExcludeFilePaths[i], FNM_PATHNAME);
             }
         }
     }
@@ -263,7 +264,7 @@ bool FileDiscoveryOptions::Init(const Json::Value& config, const PipelineContext
                                      ctx.GetRegion());
                 continue;
             }
-            mFileNameBlacklist.push_back(mExcludeFiles[i]);
+            mFileNameBlacklist.emplace_back(mExcludeFiles[i]);
         }
     }
 
@@ -292,13 +293,13 @@ bool FileDiscoveryOptions::Init(const Json::Value& config, const PipelineContext
             }
             bool isMultipleLevelWildcard = mExcludeDirs[i].find("**") != string::npos;
             if (isMultipleLevelWildcard) {
-                mMLWildcardDirPathBlacklist.push_back(mExcludeDirs[i]);
+                mMLWildcardDirPathBlacklist.emplace_back(mExcludeDirs[i]);
                 continue;
             }
             bool isWildcardPath
                 = mExcludeDirs[i].find("*") != string::npos || mExcludeDirs[i].find("?") != string::npos;
             if (isWildcardPath) {
-                mWildcardDirPathBlacklist.push_back(mExcludeDirs[i]);
+                mWildcardDirPathBlacklist.emplace_back(mExcludeDirs[i], FNM_PATHNAME);
             } else {
                 mDirPathBlacklist.push_back(mExcludeDirs[i]);
             }
@@ -428,12 +429,12 @@ bool FileDiscoveryOptions::IsDirectoryInBlacklist(const string& dirPath) const {
         }
     }
     for (auto& dp : mWildcardDirPathBlacklist) {
-        if (0 == fnmatch(dp.c_str(), dirPath.c_str(), FNM_PATHNAME)) {
+        if (dp.Match(dirPath)) {
             return true;
         }
     }
     for (auto& dp : mMLWildcardDirPathBlacklist) {
-        if (0 == fnmatch(dp.c_str(), dirPath.c_str(), 0)) {
+        if (dp.Match(dirPath)) {
             return true;
         }
     }
@@ -454,12 +455,12 @@ bool FileDiscoveryOptions::IsObjectInBlacklist(const string& path, const string&
 
     auto const filePath = PathJoin(path, name);
     for (auto& fp : mFilePathBlacklist) {
-        if (0 == fnmatch(fp.c_str(), filePath.c_str(), FNM_PATHNAME)) {
+        if (fp.Match(filePath)) {
             return true;
         }
     }
     for (auto& fp : mMLFilePathBlacklist) {
-        if (0 == fnmatch(fp.c_str(), filePath.c_str(), 0)) {
+        if (fp.Match(filePath)) {
             return true;
         }
     }
@@ -473,7 +474,7 @@ bool FileDiscoveryOptions::IsFileNameInBlacklist(const string& fileName) const {
     }
 
     for (auto& pattern : mFileNameBlacklist) {
-        if (0 == fnmatch(pattern.c_str(), fileName.c_str(), 0)) {
+        if (pattern.Match(fileName)) {
             return true;
         }
     }
@@ -486,7 +487,7 @@ bool FileDiscoveryOptions::IsFileNameInBlacklist(const string& fileName) const {
 bool FileDiscoveryOptions::IsMatch(const string& path, const string& name) const {
     // Check if the file name is matched or blacklisted.
     if (!name.empty()) {
-        if (fnmatch(mFilePattern.c_str(), name.c_str(), 0) != 0)
+        if (!mFilePatternMatcher.Match(name))
             return false;
         if (IsFileNameInBlacklist(name)) {
             return false;
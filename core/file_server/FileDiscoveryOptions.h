@@ -24,6 +24,7 @@
 #include <utility>
 #include <vector>
 
+#include "common/GlobMatcher.h"
 #include "file_server/ContainerInfo.h"
 #include "pipeline/PipelineContext.h"
 
@@ -81,6 +82,7 @@ private:
 
     std::string mBasePath;
     std::string mFilePattern;
+    GlobMatcher mFilePatternMatcher;
     std::vector<std::string> mConstWildcardPaths;
     std::vector<std::string> mWildcardPaths;
     uint16_t mWildcardDepth;
@@ -95,17 +97,17 @@ private:
     // /app/log but keep /app/text.log, because /app does not match /app/*. And
     // because /app/log is filtered, so any changes under it will be ignored, so
     // both /app/log/sub and /app/log/text.log will be blacklisted.
-    std::vector<std::string> mWildcardDirPathBlacklist;
+    std::vector<GlobMatcher> mWildcardDirPathBlacklist;
     // Multiple level wildcard (**) is included, use fnmatch with 0 as flags to filter,
     // which will blacklist /path/a/b with pattern /path/**.
-    std::vector<std::string> mMLWildcardDirPathBlacklist;
+    std::vector<GlobMatcher> mMLWildcardDirPathBlacklist;
     // Absolute path of files to filter, */? is supported, such as /app/log/100*.log.
-    std::vector<std::string> mFilePathBlacklist;
+    std::vector<GlobMatcher> mFilePathBlacklist;
     // Multiple level wildcard (**) is included.
-    std::vector<std::string> mMLFilePathBlacklist;
+    std::vector<GlobMatcher> mMLFilePathBlacklist;
     // File name only, */? is supported too, such as 100*.log. It is similar to
     // mFilePattern, but works in reversed way.
-    std::vector<std::string> mFileNameBlacklist;
+    std::vector<GlobMatcher> mFileNameBlacklist;
 
     bool mEnableContainerDiscovery = false;
     std::shared_ptr<std::vector<ContainerInfo>> mContainerInfos; // must not be null if container discovery is enabled
@@ -119,11 +119,13 @@ FileDiscoveryConfig FileServer::GetFileDiscoveryConfig(const string& name) const
 // 添加文件发现配置
 void FileServer::AddFileDiscoveryConfig(const string& name, FileDiscoveryOptions* opts, const PipelineContext* ctx) {
     mPipelineNameFileDiscoveryConfigsMap[name] = make_pair(opts, ctx);
+    mFileDiscoveryConfigIndex.Add(name, make_pair(opts, ctx));
 }
 
 // 移除给定名称的文件发现配置
 void FileServer::RemoveFileDiscoveryConfig(const string& name) {
     mPipelineNameFileDiscoveryConfigsMap.erase(name);
+    mFileDiscoveryConfigIndex.Remove(name);
 }
 
 // 获取给定名称的文件读取器配置
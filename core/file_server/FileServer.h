@@ -20,6 +20,7 @@
 #include <unordered_map>
 #include <utility>
 
+#include "file_server/FileDiscoveryConfigIndex.h"
 #include "file_server/FileDiscoveryOptions.h"
 #include "file_server/MultilineOptions.h"
 #include "pipeline/PipelineContext.h"
@@ -44,6 +45,7 @@ public:
     const std::unordered_map<std::string, FileDiscoveryConfig>& GetAllFileDiscoveryConfigs() const {
         return mPipelineNameFileDiscoveryConfigsMap;
     }
+    const FileDiscoveryConfigIndex& GetFileDiscoveryConfigIndex() const { return mFileDiscoveryConfigIndex; }
     void AddFileDiscoveryConfig(const std::string& name, FileDiscoveryOptions* opts, const PipelineContext* ctx);
     void RemoveFileDiscoveryConfig(const std::string& name);
 
@@ -79,6 +81,7 @@ private:
     void PauseInner();
 
     std::unordered_map<std::string, FileDiscoveryConfig> mPipelineNameFileDiscoveryConfigsMap;
+    FileDiscoveryConfigIndex mFileDiscoveryConfigIndex;
     std::unordered_map<std::string, FileReaderConfig> mPipelineNameFileReaderConfigsMap;
     std::unordered_map<std::string, MultilineConfig> mPipelineNameMultilineConfigsMap;
     std::unordered_map<std::string, std::shared_ptr<std::vector<ContainerInfo>>> mAllContainerInfoMap;
@@ -15,6 +15,7 @@
 #include "file_server/MultilineOptions.h"
 
 #include "common/ParamExtractor.h"
+#include "common/StringTools.h"
 
 using namespace std;
 
@@ -49,6 +50,19 @@ bool MultilineOptions::Init(const Json::Value& config, const PipelineContext& ct
                               ctx.GetRegion());
     }
 
+    // RegexEngine
+    if (!GetOptionalRegexEngineParam(config, "Multiline.RegexEngine", mRegexEngine, errorMsg)) {
+        PARAM_WARNING_DEFAULT(ctx.GetLogger(),
+                              ctx.GetAlarm(),
+                              errorMsg,
+                              "boost",
+                              pluginName,
+                              ctx.GetConfigName(),
+                              ctx.GetProjectName(),
+                              ctx.GetLogstoreName(),
+                              ctx.GetRegion());
+    }
+
     if (mMode == Mode::CUSTOM) {
         // StartPattern
         string pattern;
@@ -154,6 +168,9 @@ bool MultilineOptions::Init(const Json::Value& config, const PipelineContext& ct
         }
         if (mStartPatternRegPtr || mEndPatternRegPtr) {
             mIsMultiline = true;
+            if (mRegexEngine == RegexEngine::RE2) {
+                BuildPatternSet();
+            }
         }
     }
 
@@ -218,6 +235,52 @@ bool MultilineOptions::ParseRegex(const string& pattern, shared_ptr<boost::regex
     return true;
 }
 
+void MultilineOptions::BuildPatternSet() {
+    auto patternSet = make_shared<RegexSet>(RegexEngine::RE2, RegexSet::Anchor::PREFIX);
+    const pair<const shared_ptr<boost::regex>*, PatternType> patterns[]
+        = {{&mStartPatternRegPtr, PatternType::START},
+           {&mContinuePatternRegPtr, PatternType::CONTINUE},
+           {&mEndPatternRegPtr, PatternType::END}};
+    for (const auto& pattern : patterns) {
+        if (*pattern.first && patternSet->Add(pattern.first->get()->str()) >= 0) {
+            mPatternSetTypes.push_back(static_cast<uint8_t>(pattern.second));
+        }
+    }
+    if (mPatternSetTypes.size() != patternSet->Size() || !patternSet->Compile()) {
+        // patterns are evaluated with boost one by one, which gives the same result
+        mPatternSetTypes.clear();
+        return;
+    }
+    mPatternSet = patternSet;
+}
+
+bool MultilineOptions::IsLineMatched(const StringView& line,
+                                     PatternType type,
+                                     LineMatchResult& result,
+                                     string& exception) const {
+    uint8_t bit = static_cast<uint8_t>(type);
+    if ((result.mEvaluated & bit) == 0) {
+        if (mPatternSet) {
+            static thread_local vector<int> sMatched;
+            mPatternSet->Match(line.data(), line.size(), sMatched, exception);
+            for (int i : sMatched) {
+                result.mMatched |= mPatternSetTypes[i];
+            }
+            result.mEvaluated = static_cast<uint8_t>(PatternType::START) | static_cast<uint8_t>(PatternType::CONTINUE)
+                | static_cast<uint8_t>(PatternType::END);
+        } else {
+            const shared_ptr<boost::regex>& reg = type == PatternType::START
+                ? mStartPatternRegPtr
+                : (type == PatternType::CONTINUE ? mContinuePatternRegPtr : mEndPatternRegPtr);
+            if (reg && BoostRegexSearch(line.data(), line.size(), *reg, exception)) {
+                result.mMatched |= bit;
+            }
+            result.mEvaluated |= bit;
+        }
+    }
+    return (result.mMatched & bit) != 0;
+}
+
 const std::string&
 UnmatchedContentTreatmentToString(MultilineOptions::UnmatchedContentTreatment unmatchedContentTreatment) {
     switch (unmatchedContentTreatment) {
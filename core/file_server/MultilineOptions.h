@@ -18,10 +18,14 @@
 
 #include <json/json.h>
 
+#include <cstdint>
 #include <string>
 #include <utility>
+#include <vector>
 
 #include "boost/regex.hpp"
+#include "common/RegexSet.h"
+#include "models/StringView.h"
 #include "pipeline/PipelineContext.h"
 
 namespace logtail {
@@ -30,12 +34,22 @@ class MultilineOptions {
 public:
     enum class Mode { CUSTOM, JSON };
     enum class UnmatchedContentTreatment { DISCARD, SINGLE_LINE };
+    enum class PatternType : uint8_t { START = 1, CONTINUE = 2, END = 4 };
+
+    // patterns of a line evaluated so far, so that each pattern is evaluated at most once per line
+    struct LineMatchResult {
+        uint8_t mEvaluated = 0;
+        uint8_t mMatched = 0;
+    };
 
     bool Init(const Json::Value& config, const PipelineContext& ctx, const std::string& pluginName);
     const std::shared_ptr<boost::regex>& GetStartPatternReg() const { return mStartPatternRegPtr; }
     const std::shared_ptr<boost::regex>& GetContinuePatternReg() const { return mContinuePatternRegPtr; }
     const std::shared_ptr<boost::regex>& GetEndPatternReg() const { return mEndPatternRegPtr; }
     bool IsMultiline() const { return mIsMultiline; }
+    // Whether the line starts with a match of the pattern, as BoostRegexSearch. With the RE2 engine, all patterns are
+    // evaluated in one pass on the first call for a line, and the later calls for the same line are answered by result.
+    bool IsLineMatched(const StringView& line, PatternType type, LineMatchResult& result, std::string& exception) const;
 
     Mode mMode = Mode::CUSTOM;
     std::string mStartPattern;
@@ -43,14 +57,23 @@ public:
     std::string mEndPattern;
     UnmatchedContentTreatment mUnmatchedContentTreatment = UnmatchedContentTreatment::SINGLE_LINE;
     bool mIgnoringUnmatchWarning = false;
+    RegexEngine mRegexEngine = RegexEngine::BOOST;
 
 private:
     bool ParseRegex(const std::string& pattern, std::shared_ptr<boost::regex>& reg);
+    void BuildPatternSet();
 
     std::shared_ptr<boost::regex> mStartPatternRegPtr;
     std::shared_ptr<boost::regex> mContinuePatternRegPtr;
     std::shared_ptr<boost::regex> mEndPatternRegPtr;
+    // for RE2 engine only, with the type of each pattern in the set
+    std::shared_ptr<const RegexSet> mPatternSet;
+    std::vector<uint8_t> mPatternSetTypes;
     bool mIsMultiline = false;
+
+#ifdef APSARA_UNIT_TEST_MAIN
+    friend class MultilineOptionsUnittest;
+#endif
 };
 
 const std::string&
@@ -20,6 +20,7 @@
 #include "common/EndpointUtil.h"
 #include "common/LogtailCommonFlags.h"
 #include "common/ParamExtractor.h"
+#include "common/memory/MemoryBudgetManager.h"
 #include "pipeline/Pipeline.h"
 #include "sender/Sender.h"
 
@@ -300,6 +301,10 @@ bool FlusherSLS::Start() {
     Sender::Instance()->IncreaseProjectReferenceCnt(mProject);
     Sender::Instance()->IncreaseRegionReferenceCnt(mRegion);
     Sender::Instance()->IncreaseAliuidReferenceCntForRegion(mRegion, mAliuid);
+    // the budget is created along with the process queue after flushers are initialized
+    if (HasContext()) {
+        mMemoryBudget = MemoryBudgetManager::GetInstance()->GetBudget(mContext->GetConfigName());
+    }
     return true;
 }
 
@@ -307,6 +312,7 @@ bool FlusherSLS::Stop(bool isPipelineRemoving) {
     Sender::Instance()->DecreaseProjectReferenceCnt(mProject);
     Sender::Instance()->DecreaseRegionReferenceCnt(mRegion);
     Sender::Instance()->DecreaseAliuidReferenceCntForRegion(mRegion, mAliuid);
+    mMemoryBudget.reset();
     return true;
 }
 
@@ -19,6 +19,7 @@
 #include "plugin/interface/Flusher.h"
 
 #include <cstdint>
+#include <memory>
 #include <string>
 #include <unordered_set>
 #include <vector>
@@ -29,6 +30,8 @@
 
 namespace logtail {
 
+class PipelineMemoryBudget;
+
 class FlusherSLS : public Flusher {
 public:
     enum class CompressType { NONE, LZ4, ZSTD };
@@ -53,6 +56,8 @@ public:
     bool Start() override;
     bool Stop(bool isPipelineRemoving) override;
     LogstoreFeedBackKey GetLogstoreKey() const { return mLogstoreKey; }
+    // memory budget of the pipeline, resolved on start so that adding logs does not look it up each time
+    const std::shared_ptr<PipelineMemoryBudget>& GetMemoryBudget() const { return mMemoryBudget; }
 
     std::string mProject;
     std::string mLogstore;
@@ -71,6 +76,7 @@ private:
     void GenerateGoPlugin(const Json::Value& config, Json::Value& res) const;
 
     LogstoreFeedBackKey mLogstoreKey = 0;
+    std::shared_ptr<PipelineMemoryBudget> mMemoryBudget;
 };
 
 } // namespace logtail
@@ -0,0 +1,76 @@
+// Copyright 2024 iLogtail Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "go_pipeline/LogGroupColumns.h"
+
+#include "models/LogEvent.h"
+
+namespace logtail {
+
+void LogGroupColumns::Add(const PipelineEventGroup& eventGroup,
+                          const std::string& logstore,
+                          bool enableTimestampNanosecond) {
+    uint32_t firstLog = mLogs.size() / kLogFieldCount;
+    for (const auto& event : eventGroup.GetEvents()) {
+        if (!event.Is<LogEvent>()) {
+            continue;
+        }
+        const auto& logEvent = event.Cast<LogEvent>();
+        uint32_t firstString = mStrings.size() / 2;
+        uint32_t contentCount = 0;
+        for (const auto& kv : logEvent) {
+            AddString(kv.first);
+            AddString(kv.second);
+            ++contentCount;
+        }
+        auto timeNs = enableTimestampNanosecond ? logEvent.GetTimestampNanosecond() : std::nullopt;
+        mLogs.insert(mLogs.end(),
+                     {firstString,
+                      contentCount,
+                      static_cast<uint32_t>(logEvent.GetTimestamp()),
+                      timeNs ? timeNs.value() : 0,
+                      timeNs ? 1U : 0U});
+    }
+    uint32_t logCount = mLogs.size() / kLogFieldCount - firstLog;
+    if (logCount == 0) {
+        return;
+    }
+
+    uint32_t firstTag = mStrings.size() / 2;
+    for (const auto& tag : eventGroup.GetTags()) {
+        AddString(tag.first);
+        AddString(tag.second);
+    }
+    uint32_t tagCount = eventGroup.GetTags().size();
+    uint32_t category = AddString(logstore);
+    uint32_t topic = AddString(eventGroup.GetMetadata(EventGroupMetaKey::TOPIC));
+    uint32_t packId = AddString(eventGroup.GetMetadata(EventGroupMetaKey::SOURCE_ID));
+    mGroups.insert(mGroups.end(), {firstLog, logCount, firstTag, tagCount, category, topic, packId});
+}
+
+void LogGroupColumns::Clear() {
+    mData.clear();
+    mStrings.clear();
+    mLogs.clear();
+    mGroups.clear();
+}
+
+uint32_t LogGroupColumns::AddString(StringView str) {
+    mStrings.push_back(mData.size());
+    mStrings.push_back(str.size());
+    mData.append(str.data(), str.size());
+    return mStrings.size() / 2 - 1;
+}
+
+} // namespace logtail
@@ -0,0 +1,63 @@
+/*
+ * Copyright 2024 iLogtail Authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "models/PipelineEventGroup.h"
+#include "models/StringView.h"
+
+namespace logtail {
+
+// Log groups to be passed to Go plugins in one call, laid out in flat columns instead of serialized protobuf, so that
+// neither side has to encode or decode every field.
+//
+// All keys and values are appended to one byte buffer, and referred to by index in the following columns:
+// - strings: (offset, length) of each string in the buffer.
+// - logs: (first string, content count, time, time_ns, has time_ns) of each log, where the contents are consecutive
+//   key and value strings.
+// - groups: (first log, log count, first tag string, tag count, category, topic, pack id) of each log group, where
+//   the logs are consecutive and the last three are string indexes.
+//
+// The layout must be kept in sync with pluginmanager/log_group_columns.go.
+class LogGroupColumns {
+public:
+    static const uint32_t kLogFieldCount = 5;
+    static const uint32_t kGroupFieldCount = 7;
+
+    // groups without any log are skipped, just like the ones passed as protobuf
+    void Add(const PipelineEventGroup& eventGroup, const std::string& logstore, bool enableTimestampNanosecond);
+    void Clear();
+
+    size_t GetGroupCount() const { return mGroups.size() / kGroupFieldCount; }
+    const std::string& GetData() const { return mData; }
+    const std::vector<uint32_t>& GetStrings() const { return mStrings; }
+    const std::vector<uint32_t>& GetLogs() const { return mLogs; }
+    const std::vector<uint32_t>& GetGroups() const { return mGroups; }
+
+private:
+    uint32_t AddString(StringView str);
+
+    std::string mData;
+    std::vector<uint32_t> mStrings;
+    std::vector<uint32_t> mLogs;
+    std::vector<uint32_t> mGroups;
+};
+
+} // namespace logtail
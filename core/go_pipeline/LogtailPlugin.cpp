@@ -47,6 +47,7 @@ LogtailPlugin::LogtailPlugin() {
     mResumeFun = NULL;
     mLoadGlobalConfigFun = NULL;
     mProcessRawLogFun = NULL;
+    mProcessLogGroupColumnsFun = NULL;
     mPluginValid = false;
     mPluginAlarmConfig.mLogstore = "logtail_alarm";
     mPluginAlarmConfig.mAliuid = STRING_FLAG(logtail_profile_aliuid);
@@ -426,6 +427,12 @@ bool LogtailPlugin::LoadPluginBase() {
             LOG_ERROR(sLogger, ("load ProcessLogGroup error, Message", error));
             return mPluginValid;
         }
+        // optional, log groups are passed as protobuf if not exported
+        mProcessLogGroupColumnsFun = (ProcessLogGroupColumnsFun)loader.LoadMethod("ProcessLogGroupColumns", error);
+        if (!error.empty()) {
+            LOG_WARNING(sLogger, ("load ProcessLogGroupColumns error, Message", error));
+            mProcessLogGroupColumnsFun = NULL;
+        }
 
         mPluginBasePtr = loader.Release();
     }
@@ -506,6 +513,32 @@ void LogtailPlugin::ProcessLogGroup(const std::string& configName,
     }
 }
 
+void LogtailPlugin::ProcessLogGroupColumns(const std::string& configName, const LogGroupColumns& columns) {
+    if (columns.GetGroupCount() == 0 || !IsLogGroupColumnsSupported()) {
+        return;
+    }
+    std::string realConfigName = configName + "/2";
+    GoString goConfigName;
+    GoSlice goData;
+    GoSlice goStrings;
+    GoSlice goLogs;
+    GoSlice goGroups;
+    goConfigName.n = realConfigName.size();
+    goConfigName.p = realConfigName.c_str();
+    goData.data = (void*)columns.GetData().data();
+    goData.len = goData.cap = columns.GetData().size();
+    goStrings.data = (void*)columns.GetStrings().data();
+    goStrings.len = goStrings.cap = columns.GetStrings().size();
+    goLogs.data = (void*)columns.GetLogs().data();
+    goLogs.len = goLogs.cap = columns.GetLogs().size();
+    goGroups.data = (void*)columns.GetGroups().data();
+    goGroups.len = goGroups.cap = columns.GetGroups().size();
+    GoInt rst = mProcessLogGroupColumnsFun(goConfigName, goData, goStrings, goLogs, goGroups);
+    if (rst != (GoInt)0) {
+        LOG_WARNING(sLogger, ("process loggroup columns error", configName)("result", rst));
+    }
+}
+
 K8sContainerMeta LogtailPlugin::GetContainerMeta(const string& containerID) {
     if (mPluginValid && mGetContainerMetaFun != nullptr) {
         GoString id;
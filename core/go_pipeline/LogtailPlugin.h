@@ -29,6 +29,7 @@
 #include <json/json.h>
 
 #include "flusher/FlusherSLS.h"
+#include "go_pipeline/LogGroupColumns.h"
 #include "log_pb/sls_logs.pb.h"
 
 extern "C" {
@@ -126,6 +127,7 @@ typedef GoInt (*InitPluginBaseFun)();
 typedef GoInt (*InitPluginBaseV2Fun)(GoString cfg);
 typedef GoInt (*ProcessLogsFun)(GoString c, GoSlice l, GoString p, GoString t, GoSlice tags);
 typedef GoInt (*ProcessLogGroupFun)(GoString c, GoSlice l, GoString p);
+typedef GoInt (*ProcessLogGroupColumnsFun)(GoString c, GoSlice data, GoSlice strings, GoSlice logs, GoSlice groups);
 typedef struct innerContainerMeta* (*GetContainerMetaFun)(GoString containerID);
 
 // Methods export by adapter.
@@ -221,6 +223,10 @@ public:
 
     void ProcessLogGroup(const std::string& configName, sls_logs::LogGroup& logGroup, const std::string& packId);
 
+    // false if the plugin base is built before log groups can be passed as columns
+    bool IsLogGroupColumnsSupported() { return mPluginValid && mProcessLogGroupColumnsFun != NULL; }
+    void ProcessLogGroupColumns(const std::string& configName, const logtail::LogGroupColumns& columns);
+
     static int IsValidToSend(long long logstoreKey);
 
     static int SendPb(const char* configName,
@@ -262,6 +268,7 @@ private:
     logtail::FlusherSLS mPluginContainerConfig;
     ProcessLogsFun mProcessLogsFun;
     ProcessLogGroupFun mProcessLogGroupFun;
+    ProcessLogGroupColumnsFun mProcessLogGroupColumnsFun;
     GetContainerMetaFun mGetContainerMetaFun;
 
     // Configuration for plugin system in JSON format.
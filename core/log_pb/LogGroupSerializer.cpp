@@ -0,0 +1,118 @@
+// Copyright 2024 iLogtail Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "log_pb/LogGroupSerializer.h"
+
+namespace logtail {
+
+static inline size_t uint32_size(uint32_t v) {
+    if (v < (1UL << 7)) {
+        return 1;
+    } else if (v < (1UL << 14)) {
+        return 2;
+    } else if (v < (1UL << 21)) {
+        return 3;
+    } else if (v < (1UL << 28)) {
+        return 4;
+    } else {
+        return 5;
+    }
+}
+
+size_t LogGroupSerializer::CalculateContentSize(size_t keySize, size_t valueSize) {
+    size_t contentSize = 1 + uint32_size(keySize) + keySize + 1 + uint32_size(valueSize) + valueSize;
+    return 1 + uint32_size(contentSize) + contentSize;
+}
+
+size_t LogGroupSerializer::CalculateLogSize(uint32_t logTime, size_t contentsSize, bool hasTimeNs) {
+    // Time: tag + varint, Time_ns: tag + fixed32
+    return 1 + uint32_size(logTime) + contentsSize + (hasTimeNs ? 5 : 0);
+}
+
+size_t LogGroupSerializer::CalculateLogFieldSize(size_t logSize) {
+    return 1 + uint32_size(logSize) + logSize;
+}
+
+void LogGroupSerializer::StartToAddLog(size_t logSize) {
+    mOutput.push_back(0x0A);
+    AddVarint32(logSize);
+}
+
+void LogGroupSerializer::AddLogTime(uint32_t logTime) {
+    mOutput.push_back(0x08);
+    AddVarint32(logTime);
+}
+
+void LogGroupSerializer::AddLogContent(StringView key, StringView value) {
+    size_t contentSize = 1 + uint32_size(key.size()) + key.size() + 1 + uint32_size(value.size()) + value.size();
+    mOutput.push_back(0x12);
+    AddVarint32(contentSize);
+    AddLengthDelimited(0x0A, key);
+    AddLengthDelimited(0x12, value);
+}
+
+void LogGroupSerializer::AddLogTimeNs(uint32_t logTimeNs) {
+    // fixed32 is little endian on the wire
+    mOutput.push_back(0x25);
+    mOutput.push_back(static_cast<char>(logTimeNs & 0xFF));
+    mOutput.push_back(static_cast<char>((logTimeNs >> 8) & 0xFF));
+    mOutput.push_back(static_cast<char>((logTimeNs >> 16) & 0xFF));
+    mOutput.push_back(static_cast<char>((logTimeNs >> 24) & 0xFF));
+}
+
+void LogGroupSerializer::AddCategory(StringView category) {
+    AddLengthDelimited(0x12, category);
+}
+
+void LogGroupSerializer::AddTopic(StringView topic) {
+    AddLengthDelimited(0x1A, topic);
+}
+
+void LogGroupSerializer::AddSource(StringView source) {
+    AddLengthDelimited(0x22, source);
+}
+
+void LogGroupSerializer::AddMachineUUID(StringView machineUUID) {
+    AddLengthDelimited(0x2A, machineUUID);
+}
+
+void LogGroupSerializer::AddLogTag(StringView key, StringView value) {
+    size_t tagSize = 1 + uint32_size(key.size()) + key.size() + 1 + uint32_size(value.size()) + value.size();
+    mOutput.push_back(0x32);
+    AddVarint32(tagSize);
+    AddLengthDelimited(0x0A, key);
+    AddLengthDelimited(0x12, value);
+}
+
+void LogGroupSerializer::AddVarint32(uint32_t value) {
+    while (value >= 0x80) {
+        mOutput.push_back(static_cast<char>(value | 0x80));
+        value >>= 7;
+    }
+    mOutput.push_back(static_cast<char>(value));
+}
+
+void LogGroupSerializer::AddLengthDelimited(char tag, StringView value) {
+    mOutput.push_back(tag);
+    AddVarint32(value.size());
+    mOutput.append(value.data(), value.size());
+}
+
+void SerializedLogGroup::AppendToString(std::string* output) const {
+    output->reserve(output->size() + ByteSize());
+    output->append(mLogsData);
+    mGroup.AppendToString(output);
+}
+
+} // namespace logtail
@@ -0,0 +1,82 @@
+/*
+ * Copyright 2024 iLogtail Authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "log_pb/sls_logs.pb.h"
+#include "models/StringView.h"
+
+namespace logtail {
+
+// Write sls_logs.LogGroup in wire format directly into a string, without building intermediate protobuf objects.
+// The size of each log must be known before it is written, use the Calculate* functions to get it.
+class LogGroupSerializer {
+public:
+    explicit LogGroupSerializer(std::string& output) : mOutput(output) {}
+
+    void Reserve(size_t size) { mOutput.reserve(mOutput.size() + size); }
+
+    // repeated Log Logs = 1, the fields of a log must be written in the order of Time, Contents and Time_ns
+    void StartToAddLog(size_t logSize);
+    void AddLogTime(uint32_t logTime);
+    void AddLogContent(StringView key, StringView value);
+    void AddLogTimeNs(uint32_t logTimeNs);
+
+    void AddCategory(StringView category);
+    void AddTopic(StringView topic);
+    void AddSource(StringView source);
+    void AddMachineUUID(StringView machineUUID);
+    void AddLogTag(StringView key, StringView value);
+
+    // size of a Log.Content field, including its tag and length
+    static size_t CalculateContentSize(size_t keySize, size_t valueSize);
+    // size of a Log message, excluding its tag and length
+    static size_t CalculateLogSize(uint32_t logTime, size_t contentsSize, bool hasTimeNs);
+    // size of a LogGroup.Logs field, including its tag and length
+    static size_t CalculateLogFieldSize(size_t logSize);
+
+private:
+    void AddVarint32(uint32_t value);
+    void AddLengthDelimited(char tag, StringView value);
+
+    std::string& mOutput;
+};
+
+// sls_logs.LogGroup with all logs already serialized by LogGroupSerializer. Since repeated fields can be concatenated
+// on the wire, logs can be moved between log groups by plain byte copy, and the group level fields, which are tiny and
+// may still be modified during batching, are kept in mGroup whose logs are always empty.
+struct SerializedLogGroup {
+    sls_logs::LogGroup mGroup;
+    std::string mLogsData;
+    // [offset, size) of each log in mLogsData, including the field tag and length
+    std::vector<std::pair<uint32_t, uint32_t>> mLogRanges;
+    std::vector<uint32_t> mLogTimes;
+
+    int logs_size() const { return static_cast<int>(mLogRanges.size()); }
+    StringView GetLogData(int idx) const {
+        return StringView(mLogsData.data() + mLogRanges[idx].first, mLogRanges[idx].second);
+    }
+    size_t ByteSize() const { return mLogsData.size() + mGroup.ByteSizeLong(); }
+    // Append the whole log group in wire format to @output.
+    void AppendToString(std::string* output) const;
+};
+
+} // namespace logtail
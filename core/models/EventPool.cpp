@@ -0,0 +1,236 @@
+/*
+ * Copyright 2024 iLogtail Authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "models/EventPool.h"
+
+#include <mutex>
+#include <vector>
+
+#include "common/Flags.h"
+#include "models/LogEvent.h"
+#include "models/MetricEvent.h"
+#include "models/SpanEvent.h"
+
+DEFINE_FLAG_INT32(event_pool_batch_size,
+                  "number of events moved between thread cache and global pool at a time, 0 to disable event pool",
+                  256);
+DEFINE_FLAG_INT32(event_pool_max_size, "max number of events of each type cached in global pool", 4096);
+
+using namespace std;
+
+namespace logtail {
+
+atomic_uint64_t EventPool::sAcquireCount{0};
+atomic_uint64_t EventPool::sHitCount{0};
+atomic_int64_t EventPool::sRetainedBytes{0};
+
+template <class T>
+class EventCache {
+public:
+    ~EventCache() {
+        Publish();
+        for (T* e : mEvents) {
+            EventPool::sRetainedBytes -= RetainedSize(*e);
+            delete e;
+        }
+    }
+
+    T* Acquire(PipelineEventGroup* ptr) {
+        if (mEvents.empty()) {
+            Refill();
+        }
+        T* e = nullptr;
+        if (mEvents.empty()) {
+            e = new T(ptr);
+        } else {
+            e = mEvents.back();
+            mEvents.pop_back();
+            e->ResetPipelineEventGroup(ptr);
+            mRetainedBytesDelta -= RetainedSize(*e);
+            ++mHitCount;
+        }
+        ++mAcquireCount;
+        if (++mOpCount >= sPublishInterval) {
+            Publish();
+        }
+        return e;
+    }
+
+    void Release(T* e) {
+        size_t batchSize = static_cast<size_t>(INT32_FLAG(event_pool_batch_size));
+        if (batchSize == 0) {
+            delete e;
+            return;
+        }
+        e->Reset();
+        mEvents.push_back(e);
+        mRetainedBytesDelta += RetainedSize(*e);
+        if (mEvents.size() >= 2 * batchSize) {
+            Drain(batchSize);
+        } else if (++mOpCount >= sPublishInterval) {
+            Publish();
+        }
+    }
+
+private:
+    // all threads share the same global pool of a type, which is never freed
+    struct GlobalPool {
+        mutex mMux;
+        vector<T*> mEvents;
+    };
+
+    static GlobalPool& GetGlobalPool() {
+        static GlobalPool* pool = new GlobalPool();
+        return *pool;
+    }
+
+    static size_t RetainedSize(const T& e);
+
+    void Refill() {
+        size_t batchSize = static_cast<size_t>(INT32_FLAG(event_pool_batch_size));
+        GlobalPool& pool = GetGlobalPool();
+        lock_guard<mutex> lock(pool.mMux);
+        size_t cnt = min(batchSize, pool.mEvents.size());
+        mEvents.insert(mEvents.end(), pool.mEvents.end() - cnt, pool.mEvents.end());
+        pool.mEvents.resize(pool.mEvents.size() - cnt);
+    }
+
+    // move the oldest @cnt events out of the thread cache, so that recently used ones are kept for better locality
+    void Drain(size_t cnt) {
+        GlobalPool& pool = GetGlobalPool();
+        size_t maxSize = static_cast<size_t>(INT32_FLAG(event_pool_max_size));
+        size_t moved = 0;
+        {
+            lock_guard<mutex> lock(pool.mMux);
+            if (pool.mEvents.size() < maxSize) {
+                moved = min(cnt, maxSize - pool.mEvents.size());
+                pool.mEvents.insert(pool.mEvents.end(), mEvents.begin(), mEvents.begin() + moved);
+            }
+        }
+        for (size_t i = moved; i < cnt; ++i) {
+            mRetainedBytesDelta -= RetainedSize(*mEvents[i]);
+            delete mEvents[i];
+        }
+        mEvents.erase(mEvents.begin(), mEvents.begin() + cnt);
+        Publish();
+    }
+
+    void Publish() {
+        EventPool::sAcquireCount += mAcquireCount;
+        EventPool::sHitCount += mHitCount;
+        EventPool::sRetainedBytes += mRetainedBytesDelta;
+        mAcquireCount = 0;
+        mHitCount = 0;
+        mRetainedBytesDelta = 0;
+        mOpCount = 0;
+    }
+
+    static const uint64_t sPublishInterval = 1024;
+
+    vector<T*> mEvents;
+    uint64_t mAcquireCount = 0;
+    uint64_t mHitCount = 0;
+    int64_t mRetainedBytesDelta = 0;
+    uint64_t mOpCount = 0;
+};
+
+template <>
+size_t EventCache<LogEvent>::RetainedSize(const LogEvent& e) {
+    return sizeof(LogEvent) + e.mContents.capacity() * sizeof(ContentsContainer::value_type);
+}
+
+template <>
+size_t EventCache<MetricEvent>::RetainedSize(const MetricEvent& e) {
+    return sizeof(MetricEvent);
+}
+
+template <>
+size_t EventCache<SpanEvent>::RetainedSize(const SpanEvent& e) {
+    return sizeof(SpanEvent) + e.mEvents.capacity() * sizeof(SpanEvent::InnerEvent)
+        + e.mLinks.capacity() * sizeof(SpanEvent::SpanLink);
+}
+
+struct EventCaches {
+    EventCache<LogEvent> mLogEvents;
+    EventCache<MetricEvent> mMetricEvents;
+    EventCache<SpanEvent> mSpanEvents;
+};
+
+enum class CacheState { UNINITIALIZED, ALIVE, DESTROYED };
+
+// The state is trivially destructible and remains accessible after the caches are destroyed at thread exit, when events
+// still alive, e.g. those owned by static objects, are simply freed.
+static thread_local CacheState sCacheState = CacheState::UNINITIALIZED;
+
+static EventCaches* GetCaches() {
+    if (sCacheState == CacheState::DESTROYED) {
+        return nullptr;
+    }
+    struct Holder {
+        Holder() { sCacheState = CacheState::ALIVE; }
+        ~Holder() { sCacheState = CacheState::DESTROYED; }
+        EventCaches mCaches;
+    };
+    static thread_local Holder holder;
+    return &holder.mCaches;
+}
+
+LogEvent* EventPool::AcquireLogEvent(PipelineEventGroup* ptr) {
+    EventCaches* caches = GetCaches();
+    return caches ? caches->mLogEvents.Acquire(ptr) : new LogEvent(ptr);
+}
+
+MetricEvent* EventPool::AcquireMetricEvent(PipelineEventGroup* ptr) {
+    EventCaches* caches = GetCaches();
+    return caches ? caches->mMetricEvents.Acquire(ptr) : new MetricEvent(ptr);
+}
+
+SpanEvent* EventPool::AcquireSpanEvent(PipelineEventGroup* ptr) {
+    EventCaches* caches = GetCaches();
+    return caches ? caches->mSpanEvents.Acquire(ptr) : new SpanEvent(ptr);
+}
+
+void EventPool::Release(PipelineEvent* e) {
+    if (e == nullptr) {
+        return;
+    }
+    EventCaches* caches = GetCaches();
+    if (caches == nullptr) {
+        delete e;
+        return;
+    }
+    switch (e->GetType()) {
+        case PipelineEvent::Type::LOG:
+            caches->mLogEvents.Release(static_cast<LogEvent*>(e));
+            break;
+        case PipelineEvent::Type::METRIC:
+            caches->mMetricEvents.Release(static_cast<MetricEvent*>(e));
+            break;
+        case PipelineEvent::Type::SPAN:
+            caches->mSpanEvents.Release(static_cast<SpanEvent*>(e));
+            break;
+        default:
+            delete e;
+            break;
+    }
+}
+
+void EventPool::FetchStatistics(uint64_t& acquireCount, uint64_t& hitCount) {
+    acquireCount = sAcquireCount.exchange(0);
+    hitCount = sHitCount.exchange(0);
+}
+
+} // namespace logtail
@@ -0,0 +1,65 @@
+/*
+ * Copyright 2024 iLogtail Authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+
+namespace logtail {
+
+class PipelineEvent;
+class PipelineEventGroup;
+class LogEvent;
+class MetricEvent;
+class SpanEvent;
+
+// Recycle pipeline events so that the events of a new group, together with the content vectors of log events, do not
+// have to be allocated from the heap again. Each thread keeps a small cache of released events of each type. When the
+// cache grows too large, a batch of events is moved to a global pool, from which threads with an empty cache refill
+// theirs. So events released in processor threads can be reused by the input threads which create them.
+class EventPool {
+public:
+    static LogEvent* AcquireLogEvent(PipelineEventGroup* ptr);
+    static MetricEvent* AcquireMetricEvent(PipelineEventGroup* ptr);
+    static SpanEvent* AcquireSpanEvent(PipelineEventGroup* ptr);
+    // The event is cleared and cached for later use, or freed if the pool is full.
+    static void Release(PipelineEvent* e);
+
+    // Counters of all threads since last call. Counters of a thread are only published every several hundred operations
+    // and on thread exit, so the result is approximate.
+    static void FetchStatistics(uint64_t& acquireCount, uint64_t& hitCount);
+    // estimated memory held by all cached events
+    static int64_t GetRetainedBytes() { return sRetainedBytes.load(std::memory_order_relaxed); }
+
+private:
+    template <class T>
+    friend class EventCache;
+
+    static std::atomic_uint64_t sAcquireCount;
+    static std::atomic_uint64_t sHitCount;
+    static std::atomic_int64_t sRetainedBytes;
+
+#ifdef APSARA_UNIT_TEST_MAIN
+    friend class EventPoolUnittest;
+#endif
+};
+
+struct PipelineEventDeleter {
+    void operator()(PipelineEvent* e) const { EventPool::Release(e); }
+};
+
+} // namespace logtail
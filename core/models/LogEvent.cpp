@@ -16,23 +16,49 @@
 
 #include "models/LogEvent.h"
 
+#include <cstring>
+#include <string_view>
+
 using namespace std;
 
 namespace logtail {
 
+static inline size_t HashContentKey(StringView key) {
+    return hash<string_view>()(string_view(key.data(), key.size()));
+}
+
 LogEvent::LogEvent(PipelineEventGroup* ptr) : PipelineEvent(Type::LOG, ptr) {
 }
 
+void LogEvent::Reset() {
+    static const size_t sMaxReservedContents = 32;
+
+    PipelineEvent::Reset();
+    mContents.clear();
+    if (mContents.capacity() > sMaxReservedContents) {
+        ContentsContainer().swap(mContents);
+    }
+    mAllocatedContentSize = 0;
+    mContentsSize = 0;
+    // the index is allocated from the source buffer of the previous group
+    mIndexSlots = nullptr;
+    mIndexCapacity = 0;
+    mIndexSize = 0;
+    mFileOffset = 0;
+    mRawSize = 0;
+}
+
 StringView LogEvent::GetContent(StringView key) const {
-    auto it = mIndex.find(key);
-    if (it != mIndex.end()) {
-        return mContents[it->second].first.second;
+    size_t pos = FindContentPos(key);
+    if (pos != mContents.size() && mContents[pos].second) {
+        return mContents[pos].first.second;
     }
     return gEmptyStringView;
 }
 
 bool LogEvent::HasContent(StringView key) const {
-    return mIndex.find(key) != mIndex.end();
+    size_t pos = FindContentPos(key);
+    return pos != mContents.size() && mContents[pos].second;
 }
 
 void LogEvent::SetContent(StringView key, StringView val) {
@@ -52,40 +78,41 @@ void LogEvent::SetContentNoCopy(const StringBuffer& key, const StringBuffer& val
 }
 
 void LogEvent::SetContentNoCopy(StringView key, StringView val) {
-    auto it = mIndex.find(key);
-    if (it != mIndex.end()) {
-        auto& field = mContents[it->second].first;
+    size_t pos = FindContentPos(key);
+    if (pos != mContents.size() && mContents[pos].second) {
+        auto& field = mContents[pos].first;
         mAllocatedContentSize += key.size() + val.size() - field.first.size() - field.second.size();
         field = make_pair(key, val);
     } else {
+        ++mContentsSize;
         mAllocatedContentSize += key.size() + val.size();
         mContents.emplace_back(make_pair(key, val), true);
-        mIndex[key] = mContents.size() - 1;
+        IndexContent(mContents.size() - 1);
     }
 }
 
 void LogEvent::DelContent(StringView key) {
-    auto it = mIndex.find(key);
-    if (it != mIndex.end()) {
-        auto& field = mContents[it->second].first;
+    size_t pos = FindContentPos(key);
+    if (pos != mContents.size() && mContents[pos].second) {
+        auto& field = mContents[pos].first;
         mAllocatedContentSize -= field.first.size() + field.second.size();
-        mContents[it->second].second = false;
-        mIndex.erase(it);
+        mContents[pos].second = false;
+        --mContentsSize;
     }
 }
 
 LogEvent::ContentIterator LogEvent::FindContent(StringView key) {
-    auto it = mIndex.find(key);
-    if (it != mIndex.end()) {
-        return ContentIterator(mContents.begin() + it->second, mContents);
+    size_t pos = FindContentPos(key);
+    if (pos != mContents.size() && mContents[pos].second) {
+        return ContentIterator(mContents.begin() + pos, mContents);
     }
     return ContentIterator(mContents.end(), mContents);
 }
 
 LogEvent::ConstContentIterator LogEvent::FindContent(StringView key) const {
-    auto it = mIndex.find(key);
-    if (it != mIndex.end()) {
-        return ConstContentIterator(mContents.begin() + it->second, mContents);
+    size_t pos = FindContentPos(key);
+    if (pos != mContents.size() && mContents[pos].second) {
+        return ConstContentIterator(mContents.begin() + pos, mContents);
     }
     return ConstContentIterator(mContents.end(), mContents);
 }
@@ -124,9 +151,71 @@ LogEvent::ConstContentIterator LogEvent::cend() const {
 }
 
 void LogEvent::AppendContentNoCopy(StringView key, StringView val) {
+    // only the last content with the same key can be found, so the number of contents doesn't change if it exists
+    size_t pos = FindContentPos(key);
+    if (pos == mContents.size() || !mContents[pos].second) {
+        ++mContentsSize;
+    }
     mAllocatedContentSize += key.size() + val.size();
     mContents.emplace_back(make_pair(key, val), true);
-    mIndex[key] = mContents.size() - 1;
+    IndexContent(mContents.size() - 1);
+}
+
+size_t LogEvent::FindContentPos(StringView key) const {
+    if (mIndexSlots != nullptr) {
+        uint32_t slot = *FindIndexSlot(key);
+        return slot == 0 ? mContents.size() : slot - 1;
+    }
+    for (size_t pos = mContents.size(); pos > 0; --pos) {
+        if (mContents[pos - 1].first.first == key) {
+            return pos - 1;
+        }
+    }
+    return mContents.size();
+}
+
+void LogEvent::IndexContent(size_t pos) {
+    if (mIndexSlots == nullptr) {
+        if (mContents.size() > sContentIndexThreshold) {
+            RebuildIndex(sContentIndexThreshold * 4);
+        }
+        return;
+    }
+    uint32_t* slot = FindIndexSlot(mContents[pos].first.first);
+    if (*slot == 0 && ++mIndexSize * 2 > mIndexCapacity) {
+        // keep load factor under 0.5, the old slots are released together with the source buffer
+        RebuildIndex(mIndexCapacity * 2);
+        return;
+    }
+    *slot = pos + 1;
+}
+
+void LogEvent::RebuildIndex(uint32_t capacity) {
+    while (capacity < mContents.size() * 2) {
+        capacity *= 2;
+    }
+    mIndexSlots = static_cast<uint32_t*>(GetSourceBuffer()->Allocate(capacity * sizeof(uint32_t)));
+    memset(mIndexSlots, 0, capacity * sizeof(uint32_t));
+    mIndexCapacity = capacity;
+    mIndexSize = 0;
+    for (size_t pos = 0; pos < mContents.size(); ++pos) {
+        uint32_t* slot = FindIndexSlot(mContents[pos].first.first);
+        if (*slot == 0) {
+            ++mIndexSize;
+        }
+        *slot = pos + 1;
+    }
+}
+
+uint32_t* LogEvent::FindIndexSlot(StringView key) const {
+    // capacity is a power of 2 and the index is never full
+    const uint32_t mask = mIndexCapacity - 1;
+    for (uint32_t i = HashContentKey(key) & mask;; i = (i + 1) & mask) {
+        uint32_t* slot = mIndexSlots + i;
+        if (*slot == 0 || mContents[*slot - 1].first.first == key) {
+            return slot;
+        }
+    }
 }
 
 size_t LogEvent::DataSize() const {
@@ -63,6 +63,9 @@ private:
 
 class LogEvent : public PipelineEvent {
     friend class PipelineEventGroup;
+    friend class EventPool;
+    template <class T>
+    friend class EventCache;
 
 public:
     using ConstContentIterator = BaseContentIterator<ContentsContainer::const_iterator, const LogContent>;
@@ -85,8 +88,8 @@ public:
     }
     std::pair<uint32_t, uint32_t> GetPosition() const { return {mFileOffset, mRawSize}; }
 
-    bool Empty() const { return mIndex.empty(); }
-    size_t Size() const { return mIndex.size(); }
+    bool Empty() const { return mContentsSize == 0; }
+    size_t Size() const { return mContentsSize; }
 
     ContentIterator begin();
     ContentIterator end();
@@ -105,16 +108,34 @@ public:
 private:
     LogEvent(PipelineEventGroup* ptr);
 
+    // clear the event for reuse, the capacity of mContents is kept unless it is too large
+    void Reset();
+
     // this is only used for ProcessorParseApsaraNative for backward compatability, since multiple keys are allowed.
     // We do not invalidate existing LogContent when the same key has arrived.
     friend class ProcessorParseApsaraNative;
     void AppendContentNoCopy(StringView key, StringView val);
 
+    // position of the last content with @key in mContents, which may have been deleted, or mContents.size() if not found
+    size_t FindContentPos(StringView key) const;
+    // make the content at @pos the one found by its key
+    void IndexContent(size_t pos);
+    void RebuildIndex(uint32_t capacity);
+    uint32_t* FindIndexSlot(StringView key) const;
+
     // since log reduce in SLS server requires the original order of log contents, we have to maintain this sequential
     // information for backward compatability.
     ContentsContainer mContents;
     size_t mAllocatedContentSize = 0;
-    std::map<StringView, size_t> mIndex;
+    // number of contents that can be found by key
+    size_t mContentsSize = 0;
+    // Most logs have only a few contents, for which a linear scan on mContents is faster than any index. An open
+    // addressing hash index is built only after mContents grows beyond sContentIndexThreshold. The slots store position
+    // in mContents plus 1 and are allocated from the source buffer.
+    static const size_t sContentIndexThreshold = 16;
+    uint32_t* mIndexSlots = nullptr;
+    uint32_t mIndexCapacity = 0;
+    uint32_t mIndexSize = 0;
     uint32_t mFileOffset = 0;
     uint32_t mRawSize = 0;
 };
@@ -23,6 +23,13 @@ namespace logtail {
 MetricEvent::MetricEvent(PipelineEventGroup* ptr) : PipelineEvent(Type::METRIC, ptr) {
 }
 
+void MetricEvent::Reset() {
+    PipelineEvent::Reset();
+    mName = StringView();
+    mValue = MetricValue();
+    mTags.Clear();
+}
+
 void MetricEvent::SetName(const string& name) {
     const StringBuffer& b = GetSourceBuffer()->CopyString(name);
     mName = StringView(b.data, b.size);
@@ -28,6 +28,9 @@ namespace logtail {
 
 class MetricEvent : public PipelineEvent {
     friend class PipelineEventGroup;
+    friend class EventPool;
+    template <class T>
+    friend class EventCache;
 
 public:
     StringView GetName() const { return mName; }
@@ -71,6 +74,8 @@ public:
 private:
     MetricEvent(PipelineEventGroup* ptr);
 
+    void Reset();
+
     StringView mName;
     MetricValue mValue;
     SizedMap mTags;
@@ -67,6 +67,12 @@ public:
 protected:
     PipelineEvent(Type type, PipelineEventGroup* ptr);
 
+    void Reset() {
+        mTimestamp = 0;
+        mTimestampNanosecond.reset();
+        mPipelineEventGroupPtr = nullptr;
+    }
+
     Type mType = Type::NONE;
     time_t mTimestamp = 0;
     std::optional<uint32_t> mTimestampNanosecond;
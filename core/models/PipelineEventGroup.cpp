@@ -19,6 +19,7 @@
 #include <sstream>
 
 #include "logger/Logger.h"
+#include "models/EventPool.h"
 #include "processor/inner/ProcessorParseContainerLogNative.h"
 
 using namespace std;
@@ -49,34 +50,31 @@ PipelineEventGroup& PipelineEventGroup::operator=(PipelineEventGroup&& rhs) noex
 }
 
 unique_ptr<LogEvent> PipelineEventGroup::CreateLogEvent() {
-    // cannot use make_unique here because the private constructor is friend only to PipelineEventGroup
-    return unique_ptr<LogEvent>(new LogEvent(this));
+    return unique_ptr<LogEvent>(EventPool::AcquireLogEvent(this));
 }
 
 unique_ptr<MetricEvent> PipelineEventGroup::CreateMetricEvent() {
-    // cannot use make_unique here because the private constructor is friend only to PipelineEventGroup
-    return unique_ptr<MetricEvent>(new MetricEvent(this));
+    return unique_ptr<MetricEvent>(EventPool::AcquireMetricEvent(this));
 }
 
 unique_ptr<SpanEvent> PipelineEventGroup::CreateSpanEvent() {
-    // cannot use make_unique here because the private constructor is friend only to PipelineEventGroup
-    return unique_ptr<SpanEvent>(new SpanEvent(this));
+    return unique_ptr<SpanEvent>(EventPool::AcquireSpanEvent(this));
 }
 
 LogEvent* PipelineEventGroup::AddLogEvent() {
-    LogEvent* e = new LogEvent(this);
+    LogEvent* e = EventPool::AcquireLogEvent(this);
     mEvents.emplace_back(e);
     return e;
 }
 
 MetricEvent* PipelineEventGroup::AddMetricEvent() {
-    MetricEvent* e = new MetricEvent(this);
+    MetricEvent* e = EventPool::AcquireMetricEvent(this);
     mEvents.emplace_back(e);
     return e;
 }
 
 SpanEvent* PipelineEventGroup::AddSpanEvent() {
-    SpanEvent* e = new SpanEvent(this);
+    SpanEvent* e = EventPool::AcquireSpanEvent(this);
     mEvents.emplace_back(e);
     return e;
 }
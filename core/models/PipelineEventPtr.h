@@ -18,6 +18,7 @@
 #include <memory>
 #include <typeinfo>
 
+#include "models/EventPool.h"
 #include "models/LogEvent.h"
 #include "models/MetricEvent.h"
 #include "models/PipelineEvent.h"
@@ -28,12 +29,12 @@ namespace logtail {
 class PipelineEventPtr {
 public:
     PipelineEventPtr() = default;
-    PipelineEventPtr(PipelineEvent* ptr) : mData(std::unique_ptr<PipelineEvent>(ptr)) {}
-    PipelineEventPtr(std::unique_ptr<PipelineEvent>&& ptr) : mData(std::move(ptr)) {}
+    PipelineEventPtr(PipelineEvent* ptr) : mData(ptr) {}
+    PipelineEventPtr(std::unique_ptr<PipelineEvent>&& ptr) : mData(ptr.release()) {}
     // default copy/move constructor is ok
     void Reset(std::unique_ptr<PipelineEvent>&& ptr) { mData.reset(ptr.release()); }
     PipelineEventPtr& operator=(std::unique_ptr<PipelineEvent>&& ptr) {
-        mData = std::move(ptr);
+        mData.reset(ptr.release());
         return *this;
     }
 
@@ -72,7 +73,8 @@ public:
     const PipelineEvent* operator->() const { return mData.operator->(); }
 
 private:
-    std::unique_ptr<PipelineEvent> mData;
+    // events are returned to EventPool on destruction
+    std::unique_ptr<PipelineEvent, PipelineEventDeleter> mData;
 };
 
 } // namespace logtail
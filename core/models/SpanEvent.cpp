@@ -187,6 +187,23 @@ const string SpanEvent::OTLP_SCOPE_VERSION = "otlp.scope.version";
 SpanEvent::SpanEvent(PipelineEventGroup* ptr) : PipelineEvent(Type::SPAN, ptr) {
 }
 
+void SpanEvent::Reset() {
+    PipelineEvent::Reset();
+    mTraceId = StringView();
+    mSpanId = StringView();
+    mTraceState = StringView();
+    mParentSpanId = StringView();
+    mName = StringView();
+    mKind = Kind::Unspecified;
+    mStartTimeNs = 0;
+    mEndTimeNs = 0;
+    mTags.Clear();
+    mEvents.clear();
+    mLinks.clear();
+    mStatus = StatusCode::Unset;
+    mScopeTags.Clear();
+}
+
 void SpanEvent::SetTraceId(const string& traceId) {
     const StringBuffer& b = GetSourceBuffer()->CopyString(traceId);
     mTraceId = StringView(b.data, b.size);
@@ -33,6 +33,9 @@ namespace logtail {
 // Besides, PipelineEventGroup is equivalent to ResourceSpan in otlp, with Resource Attributes stored in mTags
 class SpanEvent : public PipelineEvent {
     friend class PipelineEventGroup;
+    friend class EventPool;
+    template <class T>
+    friend class EventCache;
 
 public:
     class SpanLink {
@@ -179,6 +182,8 @@ public:
 private:
     SpanEvent(PipelineEventGroup* ptr);
 
+    void Reset();
+
     StringView mTraceId; // required
     StringView mSpanId; // required
     StringView mTraceState;
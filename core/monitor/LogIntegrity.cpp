@@ -798,7 +798,16 @@ void LogIntegrity::FillLogTimeInfo(LogIntegrityInfo* info, const std::string& na
 }
 
 std::string LogIntegrity::GetLastLogLine(MergeItem* item) {
-    const LogGroup& logGroup = item->mLogGroup;
+    LogGroup lastSerializedLog;
+    if (item->mLogGroup.logs_size() < 1 && item->mLastSerializedLog.second > 0) {
+        // logs merged in wire format, and the field of a log is a valid log group with that log only
+        if (!lastSerializedLog.ParseFromArray(item->mSerializedLogs.data() + item->mLastSerializedLog.first,
+                                              item->mLastSerializedLog.second)) {
+            LOG_ERROR(sLogger, ("invalid serialized log group, size", item->mSerializedLogs.size()));
+            return "";
+        }
+    }
+    const LogGroup& logGroup = item->mLogGroup.logs_size() < 1 ? lastSerializedLog : item->mLogGroup;
     if (logGroup.logs_size() < 1) {
         LOG_ERROR(sLogger, ("invalid log group, size", logGroup.logs_size()));
         return "";
@@ -73,4 +73,9 @@ const std::string METRIC_PROC_MERGE_MULTILINE_LOG_UNMATCHED_RECORDS_TOTAL
 const std::string METRIC_PROC_PARSE_STDOUT_TOTAL = "proc_parse_stdout_total";
 const std::string METRIC_PROC_PARSE_STDERR_TOTAL = "proc_parse_stderr_total";
 
+// pipeline memory budget metrics
+const std::string METRIC_PIPELINE_MEMORY_BUDGET_USAGE_BYTES = "pipeline_memory_budget_usage_bytes";
+const std::string METRIC_PIPELINE_MEMORY_BUDGET_LIMIT_BYTES = "pipeline_memory_budget_limit_bytes";
+const std::string METRIC_PIPELINE_MEMORY_BUDGET_BLOCK_TOTAL = "pipeline_memory_budget_block_total";
+
 } // namespace logtail
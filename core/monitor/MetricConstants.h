@@ -65,4 +65,9 @@ extern const std::string METRIC_PROC_MERGE_MULTILINE_LOG_UNMATCHED_RECORDS_TOTAL
 extern const std::string METRIC_PROC_PARSE_STDOUT_TOTAL;
 extern const std::string METRIC_PROC_PARSE_STDERR_TOTAL;
 
+// pipeline memory budget metrics
+extern const std::string METRIC_PIPELINE_MEMORY_BUDGET_USAGE_BYTES;
+extern const std::string METRIC_PIPELINE_MEMORY_BUDGET_LIMIT_BYTES;
+extern const std::string METRIC_PIPELINE_MEMORY_BUDGET_BLOCK_TOTAL;
+
 } // namespace logtail
@@ -22,6 +22,7 @@
 #include <fstream>
 #include <functional>
 
+#include "aggregator/Aggregator.h"
 #include "app_config/AppConfig.h"
 #include "common/Constants.h"
 #include "common/DevInode.h"
@@ -31,12 +32,14 @@
 #include "common/RuntimeUtil.h"
 #include "common/StringTools.h"
 #include "common/TimeUtil.h"
+#include "common/memory/MemoryBudgetManager.h"
 #include "common/version.h"
 #include "config_manager/ConfigManager.h"
 #include "event_handler/LogInput.h"
 #include "go_pipeline/LogtailPlugin.h"
 #include "log_pb/sls_logs.pb.h"
 #include "logger/Logger.h"
+#include "models/EventPool.h"
 #include "monitor/LogFileProfiler.h"
 #include "monitor/LogtailAlarm.h"
 #include "sender/Sender.h"
@@ -54,6 +57,15 @@ using namespace std;
 using namespace sls_logs;
 
 DEFINE_FLAG_BOOL(logtail_dump_monitor_info, "enable to dump Logtail monitor info (CPU, mem)", false);
+DEFINE_FLAG_INT32(mem_soft_limit_percent,
+                  "inputs are paused once the memory usage exceeds the percent of the memory limit, and restart is "
+                  "still done if it does not drop in flag(mem_limit_num) intervals",
+                  80);
+DEFINE_FLAG_INT32(mem_hard_limit_percent,
+                  "restart at once if the memory usage exceeds the percent of the memory limit, which should be hit "
+                  "before the process is killed by a cgroup sized to the memory limit",
+                  95);
+DECLARE_FLAG_INT32(memory_budget_percent);
 DECLARE_FLAG_BOOL(send_prefer_real_ip);
 DECLARE_FLAG_BOOL(check_profile_region);
 
@@ -182,7 +194,7 @@ void LogtailMonitor::Monitor() {
             // flag(cpu_limit_num) and flag(mem_limit_num)).
             // Returning true means too much violations, so we have to prepare to restart
             // logtail to release resource.
-            // Mainly for controlling memory because we have no idea to descrease memory usage.
+            // Inputs are paused first to release memory, and restart is the last resort when it does not drop.
             if (CheckCpuLimit() || CheckMemLimit()) {
                 LOG_ERROR(sLogger,
                           ("Resource used by program exceeds upper limit",
@@ -295,6 +307,26 @@ bool LogtailMonitor::SendStatusProfile(bool suicide) {
         UpdateMetric("env_config_count", envTags.size());
     }
     UpdateMetric("used_sending_concurrency", Sender::Instance()->GetSendingBufferCount());
+    uint64_t eventAcquireCount = 0, eventPoolHitCount = 0;
+    EventPool::FetchStatistics(eventAcquireCount, eventPoolHitCount);
+    if (eventAcquireCount > 0) {
+        UpdateMetric("event_pool_hit_rate", static_cast<double>(eventPoolHitCount) / eventAcquireCount);
+    }
+    UpdateMetric("event_pool_retained_bytes", EventPool::GetRetainedBytes());
+    UpdateMetric("memory_budget_usage_bytes", MemoryBudgetManager::GetInstance()->GetGlobalUsage());
+    UpdateMetric("memory_budget_limit_bytes", MemoryBudgetManager::GetInstance()->GetGlobalLimit());
+    UpdateMetric("memory_over_limit", MemoryBudgetManager::GetInstance()->IsOverLimit());
+    MemoryBudgetManager::GetInstance()->UpdateMetrics();
+    std::vector<size_t> shardItemCounts;
+    std::vector<uint64_t> shardLockWaitTimeUs;
+    Aggregator::GetInstance()->FetchShardStatistics(shardItemCounts, shardLockWaitTimeUs);
+    vector<string> shardItems, shardLockWaits;
+    for (size_t i = 0; i < shardItemCounts.size(); ++i) {
+        shardItems.push_back(ToString(shardItemCounts[i]));
+        shardLockWaits.push_back(ToString(shardLockWaitTimeUs[i]));
+    }
+    UpdateMetric("merge_shard_items", shardItems);
+    UpdateMetric("merge_shard_lock_wait_us", shardLockWaits);
 
     AddLogContent(logPtr, "metric_json", MetricToString());
     AddLogContent(logPtr, "status", CheckLogtailStatus());
@@ -437,11 +469,31 @@ bool LogtailMonitor::CheckCpuLimit() {
 }
 
 bool LogtailMonitor::CheckMemLimit() {
-    if (mMemStat.mRss > AppConfig::GetInstance()->GetMemUsageUpLimit()) {
+    int64_t memLimit = AppConfig::GetInstance()->GetMemUsageUpLimit();
+    // the limit may be changed by config
+    MemoryBudgetManager::GetInstance()->SetGlobalLimit(memLimit * 1024 * 1024 * INT32_FLAG(memory_budget_percent)
+                                                       / 100);
+    if (mMemStat.mRss > memLimit * INT32_FLAG(mem_hard_limit_percent) / 100) {
+        return true;
+    }
+    if (mMemStat.mRss > memLimit * INT32_FLAG(mem_soft_limit_percent) / 100) {
+        if (!MemoryBudgetManager::GetInstance()->IsOverLimit()) {
+            LOG_WARNING(sLogger,
+                        ("memory usage exceeds soft limit", "pause all inputs")("mem_rss", mMemStat.mRss)(
+                            "memory budget usage", MemoryBudgetManager::GetInstance()->GetGlobalUsage()));
+            LogInput::GetInstance()->SetForceClearFlag(true);
+        }
+        MemoryBudgetManager::GetInstance()->SetOverLimit(true);
+        // memory may not be returned to the system after data is released, so the pause is bounded
         if (++mMemStat.mViolateNum > INT32_FLAG(mem_limit_num))
             return true;
-    } else
+    } else {
+        if (MemoryBudgetManager::GetInstance()->IsOverLimit()) {
+            LOG_INFO(sLogger, ("memory usage drops below soft limit", "resume all inputs")("mem_rss", mMemStat.mRss));
+        }
+        MemoryBudgetManager::GetInstance()->SetOverLimit(false);
         mMemStat.mViolateNum = 0;
+    }
     return false;
 }
 
@@ -108,8 +108,9 @@ private:
     // CheckCpuLimit checks if current cpu usage exceeds limit.
     // @return true if the cpu usage exceeds limit continuously.
     bool CheckCpuLimit();
-    // CheckMemLimit checks if the memory usage exceeds limit.
-    // @return true if the memory usage exceeds limit continuously.
+    // CheckMemLimit checks if the memory usage exceeds limit, in which case all inputs are paused through the memory
+    // budget until it drops below the limit.
+    // @return true if the memory usage exceeds the hard limit continuously.
     bool CheckMemLimit();
 
     // SendStatusProfile collects status profile and send them to server.
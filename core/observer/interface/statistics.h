@@ -150,6 +150,7 @@ struct NetworkStatistic {
     uint32_t mEbpfGCReleaseFDCount{0};
     uint32_t mEbpfDisableProcesses{0};
     uint32_t mEbpfUsingConnections{0};
+    uint32_t mParseQueueDropCount{0};
 
     void FlushMetrics() {
         static auto sMonitor = LogtailMonitor::GetInstance();
@@ -169,6 +170,7 @@ struct NetworkStatistic {
         sMonitor->UpdateMetric("observer_ebpf_disable_processes", mEbpfDisableProcesses);
         sMonitor->UpdateMetric("observer_ebpf_holding_connections", mEbpfUsingConnections);
         sMonitor->UpdateMetric("observer_ebpf_lost_count", mEbpfLostCount);
+        sMonitor->UpdateMetric("observer_parse_queue_drop_count", mParseQueueDropCount);
         doClear();
     }
 
@@ -188,7 +190,8 @@ struct NetworkStatistic {
            << " mEbpfLostCount: " << statistic.mEbpfLostCount << " mEbpfGCCount: " << statistic.mEbpfGCCount
            << " mEbpfGCReleaseFDCount: " << statistic.mEbpfGCReleaseFDCount
            << " mEbpfDisableProcesses: " << statistic.mEbpfDisableProcesses
-           << " mEbpfUsingConnections: " << statistic.mEbpfUsingConnections;
+           << " mEbpfUsingConnections: " << statistic.mEbpfUsingConnections
+           << " mParseQueueDropCount: " << statistic.mParseQueueDropCount;
         return os;
     }
 
@@ -220,6 +223,7 @@ private:
         mEbpfDisableProcesses = 0;
         mEbpfUsingConnections = 0;
         mEbpfLostCount = 0;
+        mParseQueueDropCount = 0;
     }
 };
 
@@ -39,6 +39,7 @@ void ContainerProcessGroup::FlushOutMetrics(uint64_t timeNano,
 void ContainerProcessGroupManager::FlushOutMetrics(std::vector<sls_logs::Log>& allData,
                                                    std::vector<std::pair<std::string, std::string>>& tags,
                                                    uint64_t interval) {
+    std::lock_guard<std::mutex> lock(mMutex);
     uint64_t timeNano = GetCurrentTimeInNanoSeconds();
     for (auto& iter : mPureProcessGroupMap) {
         iter.second->FlushOutMetrics(timeNano, allData, tags, interval);
@@ -48,8 +49,31 @@ void ContainerProcessGroupManager::FlushOutMetrics(std::vector<sls_logs::Log>& a
     }
 }
 
+void ContainerProcessGroupManager::GetAllProcessGroups(std::vector<ContainerProcessGroupPtr>& groups) {
+    std::lock_guard<std::mutex> lock(mMutex);
+    groups.reserve(groups.size() + mPureProcessGroupMap.size() + mContainerProcessGroupMap.size());
+    for (auto& iter : mPureProcessGroupMap) {
+        groups.push_back(iter.second);
+    }
+    for (auto& iter : mContainerProcessGroupMap) {
+        groups.push_back(iter.second);
+    }
+}
+
+bool ContainerProcessGroupManager::GetFormattedMeta(uint32_t pid,
+                                                    std::vector<std::pair<std::string, std::string>>& formattedMeta) {
+    std::lock_guard<std::mutex> lock(mMutex);
+    const ProcessMetaPtr& meta = doGetProcessMeta(pid);
+    if (!meta->PassFilterRules()) {
+        return false;
+    }
+    formattedMeta = meta->GetFormattedMeta();
+    return true;
+}
+
 
 bool ContainerProcessGroupManager::Init(const std::string& cgroupPath) {
+    std::lock_guard<std::mutex> lock(mMutex);
     if (!this->mGgoupBasePath.empty()) {
         return true;
     }
@@ -114,6 +138,7 @@ int32_t ContainerProcessGroupManager::DetectContainerType(const std::string& pro
 }
 
 void ContainerProcessGroupManager::FlushMetas() {
+    std::lock_guard<std::mutex> lock(mMutex);
     // ProcessMetaStatistic is the gauge value, so must clear history data before fetching meta.
     ProcessMetaStatistic::Clear();
     std::vector<std::string> paths;
@@ -242,6 +267,11 @@ void ContainerProcessGroupManager::FlushPids(const std::unordered_set<uint32_t>&
 }
 
 ProcessMetaPtr ContainerProcessGroupManager::GetProcessMeta(uint32_t pid) {
+    std::lock_guard<std::mutex> lock(mMutex);
+    return doGetProcessMeta(pid);
+}
+
+ProcessMetaPtr ContainerProcessGroupManager::doGetProcessMeta(uint32_t pid) {
     auto findIter = mProcessMetaMap.find(pid);
     if (findIter != mProcessMetaMap.end()) {
         // todo 还需要检查插入时间，如果超过几分钟，还需要刷新一次PID列表
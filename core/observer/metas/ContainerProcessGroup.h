@@ -34,7 +34,14 @@ namespace logtail {
 
 
 struct ContainerProcessGroup {
-    explicit ContainerProcessGroup(const ProcessMetaPtr& meta) : mMetaPtr(meta) { mAggregator.SetProcessMeta(meta); }
+    explicit ContainerProcessGroup(const ProcessMetaPtr& meta, size_t shardCount = 1) : mMetaPtr(meta) {
+        mAggregator.SetProcessMeta(meta);
+        mShardAggregators.resize(shardCount);
+        for (auto& aggregator : mShardAggregators) {
+            aggregator.reset(new ProtocolEventAggregators);
+            aggregator->SetProcessMeta(meta);
+        }
+    }
 
     void AddProcess(uint32_t pid) { mAllProcesses.insert(pid); }
 
@@ -48,6 +55,17 @@ struct ContainerProcessGroup {
         return mAllProcesses.empty();
     }
 
+    /**
+     * @brief GetShardAggregator returns the aggregators written by the processes parsed in the shard.
+     */
+    ProtocolEventAggregators* GetShardAggregator(size_t shard) { return mShardAggregators[shard].get(); }
+
+    /**
+     * @brief MergeShardAggregator moves the aggregation results of the shard into mAggregator to be flushed.
+     * @note the shard must not be parsing at the same time.
+     */
+    void MergeShardAggregator(size_t shard) { mAggregator.Merge(*mShardAggregators[shard]); }
+
     void FlushOutMetrics(uint64_t timeNano,
                          std::vector<sls_logs::Log>& allData,
                          std::vector<std::pair<std::string, std::string>>& tags,
@@ -55,7 +73,10 @@ struct ContainerProcessGroup {
 
     std::unordered_set<uint32_t> mAllProcesses;
     ProcessMetaPtr mMetaPtr;
+    // merged aggregation results of all shards, only accessed when flushing
     ProtocolEventAggregators mAggregator;
+    // one for each parsing shard, so that processes in the same group can be parsed by different threads
+    std::vector<std::unique_ptr<ProtocolEventAggregators>> mShardAggregators;
 };
 
 typedef std::shared_ptr<ContainerProcessGroup> ContainerProcessGroupPtr;
@@ -76,7 +97,13 @@ public:
 
     bool Init(const std::string& cgroupPath = "/sys/fs");
 
+    /**
+     * @brief SetShardCount sets the number of parsing shards, which must be called before any group is created.
+     */
+    void SetShardCount(size_t shardCount) { mShardCount = shardCount; }
+
     void ResetFilterProcessMeta() {
+        std::lock_guard<std::mutex> lock(mMutex);
         for (const auto& item : this->mProcessMetaMap) {
             item.second->ResetFilter();
         }
@@ -98,13 +125,14 @@ public:
      * @return
      */
     ContainerProcessGroupPtr GetContainerProcessGroupPtr(const ProcessMetaPtr& meta, uint32_t pid) {
+        std::lock_guard<std::mutex> lock(mMutex);
         const std::string& containerID = meta->Container.ContainerID;
         if (containerID.empty()) {
             auto findIter = mPureProcessGroupMap.find(meta->PID);
             if (findIter != mPureProcessGroupMap.end()) {
                 return findIter->second;
             }
-            ContainerProcessGroupPtr newPtr(new ContainerProcessGroup(meta));
+            ContainerProcessGroupPtr newPtr(new ContainerProcessGroup(meta, mShardCount));
             mPureProcessGroupMap.insert(std::make_pair(meta->PID, newPtr));
             return newPtr;
         }
@@ -113,7 +141,7 @@ public:
             findIter->second->AddProcess(pid);
             return findIter->second;
         }
-        ContainerProcessGroupPtr newPtr(new ContainerProcessGroup(meta));
+        ContainerProcessGroupPtr newPtr(new ContainerProcessGroup(meta, mShardCount));
         newPtr->AddProcess(pid);
         mContainerProcessGroupMap.insert(std::make_pair(containerID, newPtr));
         return newPtr;
@@ -125,6 +153,7 @@ public:
      * @param pid
      */
     void OnProcessDestroy(ProcessMeta* meta, uint32_t pid) {
+        std::lock_guard<std::mutex> lock(mMutex);
         const std::string& containerID = meta->Container.ContainerID;
         if (containerID.empty()) {
             // only delete pid without container
@@ -145,12 +174,52 @@ public:
                          std::vector<std::pair<std::string, std::string>>& tags,
                          uint64_t interval);
 
+    /**
+     * @brief GetAllProcessGroups returns a snapshot of all the groups created.
+     */
+    void GetAllProcessGroups(std::vector<ContainerProcessGroupPtr>& groups);
+
+    /**
+     * @brief GetFormattedMeta copies the formatted meta of the process, as metas may be refreshed by other threads.
+     * @return false if the process does not pass the filter rules
+     */
+    bool GetFormattedMeta(uint32_t pid, std::vector<std::pair<std::string, std::string>>& formattedMeta);
+
+
+    /**
+     * @brief PassFilterRules checks the meta against the filter rules, only the first check of a refreshed meta
+     * takes the lock.
+     */
+    bool PassFilterRules(const ProcessMetaPtr& meta) {
+        int8_t rst = meta->GetFilterResult();
+        if (rst != 0) {
+            return rst > 0;
+        }
+        std::lock_guard<std::mutex> lock(mMutex);
+        return meta->PassFilterRules();
+    }
+
+    /**
+     * @brief GetMetaString and GetProcessCMD copy the fields under the lock, as metas are refreshed in place by
+     * FlushMetas.
+     */
+    std::string GetMetaString(const ProcessMetaPtr& meta) {
+        std::lock_guard<std::mutex> lock(mMutex);
+        return meta->ToString();
+    }
+
+    std::string GetProcessCMD(const ProcessMetaPtr& meta) {
+        std::lock_guard<std::mutex> lock(mMutex);
+        return meta->ProcessCMD;
+    }
 
     void FlushMetas();
 
     std::string GetContainerType() { return ContainerTypeToString(this->mContainerType); };
 
 protected:
+    ProcessMetaPtr doGetProcessMeta(uint32_t pid);
+
     void FlushPids(const std::unordered_set<uint32_t>& existedPids);
 
     // 0 means success, -1 means ignored path,
@@ -165,6 +234,9 @@ private:
     ContainerProcessGroupManager() { mProcessMetaStatistic = ProcessMetaStatistic::GetInstance(); }
 
     ProcessMetaStatistic* mProcessMetaStatistic;
+    // the manager is shared by all the parsing shards, and metas are refreshed in place
+    std::mutex mMutex;
+    size_t mShardCount = 1;
     // 从ContainerCenter同步过来的所有容器对应PID列表
     std::unordered_map<uint32_t, ProcessMetaPtr> mProcessMetaMap;
     uint32_t mLastNormalProcessMetaUpdateTime = 0;
@@ -181,6 +253,19 @@ private:
     // matcher and containerType would be kept in the whole life cycle;
     KubernetesCGroupPathMatcher* mMatcher = NULL;
     CONTAINER_TYPE mContainerType = CONTAINER_TYPE_UNKNOWN;
+
+#ifdef APSARA_UNIT_TEST_MAIN
+    // drop all the metas and groups, e.g. before the shard count is changed
+    void Clear() {
+        std::lock_guard<std::mutex> lock(mMutex);
+        mProcessMetaMap.clear();
+        mPureProcessGroupMap.clear();
+        mContainerProcessGroupMap.clear();
+    }
+
+    friend class NetworkObserverReplayBenchmark;
+    friend class NetworkObserverUnittest;
+#endif
 };
 
 } // namespace logtail
@@ -16,6 +16,7 @@
 
 #pragma once
 
+#include <atomic>
 #include <string>
 #include <memory>
 #include <vector>
@@ -166,9 +167,16 @@ struct ProcessMeta {
 
     void ResetFilter() { this->mPassFilterRules = 0; }
 
+    /**
+     * @brief GetFilterResult returns the cached filter result without evaluating the rules.
+     * @return 1 if passed, -1 if filtered, 0 if not evaluated yet
+     */
+    int8_t GetFilterResult() const { return mPassFilterRules.load(std::memory_order_relaxed); }
+
 private:
     std::vector<std::pair<std::string, std::string> > mMetaInfo;
-    int8_t mPassFilterRules = 0;
+    // read lock-free by the parsing shards, see ContainerProcessGroupManager::PassFilterRules
+    std::atomic<int8_t> mPassFilterRules{0};
     friend class CGroupPathResolverUnittest;
 };
 
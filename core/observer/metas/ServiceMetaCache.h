@@ -19,6 +19,7 @@
 
 #include <utility>
 #include <list>
+#include <mutex>
 #include <unordered_map>
 #include <ostream>
 #include "interface/type.h"
@@ -125,10 +126,11 @@ public:
     void AddHostName(uint32_t pid, const std::string& hostname, const std::string& ip);
 
     // GetHostName called by other protocol parser to get remote hostname and wrapper hostname category.
-    const ServiceMeta& GetOrPutServiceMeta(uint32_t pid, const std::string& ip, ProtocolType protocolType);
+    // Metas are returned by value, as they may be evicted by other threads once the lock is released.
+    ServiceMeta GetOrPutServiceMeta(uint32_t pid, const std::string& ip, ProtocolType protocolType);
 
     // GetHostName called by statistics to get remote hostname and hostname category.
-    const ServiceMeta& GetServiceMeta(uint32_t pid, const std::string& ip);
+    ServiceMeta GetServiceMeta(uint32_t pid, const std::string& ip);
 
     // OnProcessDestroy delete cache metas.
     void OnProcessDestroy(uint32_t pid);
@@ -143,6 +145,8 @@ private:
 
 
 private:
+    // metas are added by parsing threads and read when flushing
+    std::mutex mMutex;
     std::unordered_map<uint32_t, ServiceMetaCache*> mHostnameMetas;
     friend class HostnameMetaUnittest;
 };
@@ -19,6 +19,7 @@
 #include "metas/ContainerProcessGroup.h"
 #include "sources/pcap/PCAPWrapper.h"
 #include "sources/ebpf/EBPFWrapper.h"
+#include "sources/dump/PacketEventDumpReader.h"
 #include "common/LogtailCommonFlags.h"
 #include "config_manager/ConfigManager.h"
 #include "MachineInfoUtil.h"
@@ -34,6 +35,8 @@
 #endif
 #include "flusher/FlusherSLS.h"
 #include "common/HashUtil.h"
+#include <algorithm>
+#include <chrono>
 
 DEFINE_FLAG_INT64(sls_observer_network_ebpf_connection_gc_interval,
                   "SLS Observer NetWork connection gc interval seconds",
@@ -42,14 +45,37 @@ DEFINE_FLAG_INT64(sls_observer_network_max_save_size,
                   "SLS Observer NetWork max save file size",
                   1024LL * 1024LL * 1024LL);
 DEFINE_FLAG_STRING(sls_observer_network_save_filename, "SLS Observer NetWork save disk's file name", "ebpf.dump");
+DEFINE_FLAG_INT32(sls_observer_network_parse_thread_count,
+                  "SLS Observer NetWork threads parsing packets, 0 means parsing in the capturing thread",
+                  0);
+DEFINE_FLAG_INT32(sls_observer_network_parse_queue_size,
+                  "SLS Observer NetWork max packets waiting to be parsed by each thread",
+                  100000);
 
 DECLARE_FLAG_INT32(merge_log_count_limit);
 
 namespace logtail {
 
+NetworkObserver::NetworkObserver() {
+    mLastGCTimeNs = GetCurrentTimeInNanoSeconds();
+    mLastL4FlushTimeNs = GetCurrentTimeInNanoSeconds();
+    mLastL7FlushTimeNs = GetCurrentTimeInNanoSeconds();
+    mConfig = NetworkConfig::GetInstance();
+    mNetworkStatistic = NetworkStatistic::GetInstance();
+    mServiceMetaManager = ServiceMetaManager::GetInstance();
+    size_t shardCount = std::max(INT32_FLAG(sls_observer_network_parse_thread_count), 1);
+    for (size_t i = 0; i < shardCount; ++i) {
+        mShards.emplace_back(new NetworkObserverShard(i));
+    }
+    ContainerProcessGroupManager::GetInstance()->SetShardCount(shardCount);
+}
+
 NetworkObserver::~NetworkObserver() {
-    for (auto& mAllProcess : mAllProcesses) {
-        delete mAllProcess.second;
+    StopParseWorkers();
+    for (auto& shard : mShards) {
+        for (auto& item : shard->mAllProcesses) {
+            delete item.second;
+        }
     }
 }
 void NetworkObserver::HoldOn(bool exitFlag) {
@@ -79,9 +105,12 @@ uint32_t NetworkObserver::EBPFConnectionGC(uint64_t nowTimeNs) {
     std::unordered_set<int32_t> pids;
     GetAllPids(pids);
     for (auto& connId : connIds) {
-        auto findIter = mAllProcesses.find(connId.tgid);
-        if (findIter != mAllProcesses.end()) {
-            if (findIter->second->HasConnection(EBPFWrapper::ConvertConnIdToSockHash(&connId))) {
+        {
+            NetworkObserverShard& shard = GetShard(connId.tgid);
+            std::lock_guard<std::mutex> lock(shard.mProcessesMutex);
+            auto findIter = shard.mAllProcesses.find(connId.tgid);
+            if (findIter != shard.mAllProcesses.end()
+                && findIter->second->HasConnection(EBPFWrapper::ConvertConnIdToSockHash(&connId))) {
                 continue;
             }
         }
@@ -115,30 +144,52 @@ void NetworkObserver::GarbageCollection(uint64_t nowTimeNs) {
     size_t maxSizeLimit = 1024 * 1024;
     ++mNetworkStatistic->mGCCount;
     ProtocolDebugStatistic::Clear();
-    for (auto iter = mAllProcesses.begin(); iter != mAllProcesses.end();) {
-        ProcessObserver* observer = iter->second;
-        if (observer->GarbageCollection(maxSizeLimit, nowTimeNs)) {
-            LOG_DEBUG(sLogger,
-                      ("delete processor observer when gc, meta", observer->GetProcessMeta()->ToString())("pid",
-                                                                                                          iter->first));
-            static ContainerProcessGroupManager* containerProcessGroupManager
-                = ContainerProcessGroupManager::GetInstance();
-            // @note we must us iter->first as pid (not processMeta->Pid), because processMeta may belong to other pid
-            // in the same container
-            containerProcessGroupManager->OnProcessDestroy(observer->GetProcessMeta().get(), iter->first);
-            mServiceMetaManager->OnProcessDestroy(iter->first);
-            delete observer;
-            iter = mAllProcesses.erase(iter);
-            ++mNetworkStatistic->mGCReleaseProcessCount;
-        } else {
-            ++iter;
+    for (auto& shard : mShards) {
+        std::lock_guard<std::mutex> lock(shard->mProcessesMutex);
+        for (auto iter = shard->mAllProcesses.begin(); iter != shard->mAllProcesses.end();) {
+            ProcessObserver* observer = iter->second;
+            if (observer->GarbageCollection(maxSizeLimit, nowTimeNs)) {
+                static ContainerProcessGroupManager* containerProcessGroupManager
+                    = ContainerProcessGroupManager::GetInstance();
+                LOG_DEBUG(sLogger,
+                          ("delete processor observer when gc, meta",
+                           containerProcessGroupManager->GetMetaString(observer->GetProcessMeta()))("pid",
+                                                                                                   iter->first));
+                // @note we must us iter->first as pid (not processMeta->Pid), because processMeta may belong to other
+                // pid in the same container
+                containerProcessGroupManager->OnProcessDestroy(observer->GetProcessMeta().get(), iter->first);
+                mServiceMetaManager->OnProcessDestroy(iter->first);
+                delete observer;
+                iter = shard->mAllProcesses.erase(iter);
+                ++mNetworkStatistic->mGCReleaseProcessCount;
+            } else {
+                ++iter;
+            }
         }
-        mServiceMetaManager->GarbageTimeoutHostname(nowTimeNs / 1000000);
     }
+    mServiceMetaManager->GarbageTimeoutHostname(nowTimeNs / 1000000);
+}
+
+size_t NetworkObserver::GetProcessCount() {
+    size_t count = 0;
+    for (auto& shard : mShards) {
+        std::lock_guard<std::mutex> lock(shard->mProcessesMutex);
+        count += shard->mAllProcesses.size();
+    }
+    return count;
 }
 
 void NetworkObserver::FlushOutMetrics(std::vector<sls_logs::Log>& allData) {
     static ContainerProcessGroupManager* containerProcessGroupManager = ContainerProcessGroupManager::GetInstance();
+    // merge the aggregation results of all shards first, so that one log is flushed out for each key
+    std::vector<ContainerProcessGroupPtr> groups;
+    containerProcessGroupManager->GetAllProcessGroups(groups);
+    for (auto& shard : mShards) {
+        std::lock_guard<std::mutex> lock(shard->mProcessesMutex);
+        for (auto& group : groups) {
+            group->MergeShardAggregator(shard->mIndex);
+        }
+    }
     containerProcessGroupManager->FlushOutMetrics(allData, mConfig->mTags, mConfig->mFlushOutL7Interval);
 }
 
@@ -164,6 +215,7 @@ void NetworkObserver::FlushStatistics(logtail::NetStaticticsMap& statisticsMap,
         content->set_value(tag.second);
     }
 
+    std::vector<std::pair<std::string, std::string>> formattedMeta;
     for (auto iter = mergedMap.begin(); iter != mergedMap.end() && lastSize < allData.size(); ++iter) {
         sls_logs::Log* log = &allData[lastSize];
         log->mutable_contents()->Reserve(16);
@@ -174,14 +226,13 @@ void NetworkObserver::FlushStatistics(logtail::NetStaticticsMap& statisticsMap,
         if (iter->first.PID == 0) {
             root["_process_pid_"] = "0";
         } else {
-            const ProcessMetaPtr& ptr = cpgManager->GetProcessMeta(iter->first.PID);
-            if (!ptr->PassFilterRules()) {
+            if (!cpgManager->GetFormattedMeta(iter->first.PID, formattedMeta)) {
                 if (this->mEBPFWrapper != nullptr) {
                     this->mEBPFWrapper->DisableProcess(iter->first.PID);
                 }
                 continue;
             }
-            for (const auto& item : ptr->GetFormattedMeta()) {
+            for (const auto& item : formattedMeta) {
                 root[item.first] = item.second;
             }
         }
@@ -212,9 +263,9 @@ void NetworkObserver::FlushOutStatistics(std::vector<sls_logs::Log>& allData) {
     }
 }
 
-ProcessObserver* NetworkObserver::GetProcess(PacketEventHeader* header, bool create) {
-    auto findIter = mAllProcesses.find(header->PID);
-    if (findIter != mAllProcesses.end()) {
+ProcessObserver* NetworkObserver::GetProcess(NetworkObserverShard& shard, PacketEventHeader* header, bool create) {
+    auto findIter = shard.mAllProcesses.find(header->PID);
+    if (findIter != shard.mAllProcesses.end()) {
         return findIter->second;
     }
     if (!create) {
@@ -225,8 +276,8 @@ ProcessObserver* NetworkObserver::GetProcess(PacketEventHeader* header, bool cre
     ProcessMetaPtr processMeta = containerProcessGroupManager->GetProcessMeta(header->PID);
     ContainerProcessGroupPtr groupPtr
         = containerProcessGroupManager->GetContainerProcessGroupPtr(processMeta, header->PID);
-    newProc->SetProcessGroup(groupPtr);
-    mAllProcesses.insert(std::make_pair(header->PID, newProc));
+    newProc->SetProcessGroup(groupPtr, shard.mIndex);
+    shard.mAllProcesses.insert(std::make_pair(header->PID, newProc));
     return newProc;
 }
 
@@ -257,6 +308,37 @@ int NetworkObserver::OnPacketEvent(void* event, size_t len) {
             }
         }
     }
+    if (header->EventType == PacketEventType_None) {
+        return 0;
+    }
+    NetworkObserverShard& shard = GetShard(header->PID);
+    if (!shard.mWorkerThread) {
+        std::lock_guard<std::mutex> lock(shard.mProcessesMutex);
+        ParsePacketEvent(shard, event, len);
+        return 0;
+    }
+    // the event and its payload are only valid in the callback, so they are copied for the worker in the same layout
+    // as dumped
+    std::string buffer;
+    PacketEventToBuffer(event, len, buffer);
+    bool wasEmpty = false;
+    {
+        std::lock_guard<std::mutex> lock(shard.mQueueMutex);
+        if (shard.mPendingEvents.size() >= (size_t)INT32_FLAG(sls_observer_network_parse_queue_size)) {
+            ++mNetworkStatistic->mParseQueueDropCount;
+            return 0;
+        }
+        wasEmpty = shard.mPendingEvents.empty();
+        shard.mPendingEvents.emplace_back(std::move(buffer));
+    }
+    if (wasEmpty) {
+        shard.mQueueCond.notify_one();
+    }
+    return 0;
+}
+
+void NetworkObserver::ParsePacketEvent(NetworkObserverShard& shard, void* event, size_t len) {
+    auto header = static_cast<PacketEventHeader*>(event);
     switch (header->EventType) {
         case PacketEventType_None:
             break;
@@ -266,11 +348,9 @@ int NetworkObserver::OnPacketEvent(void* event, size_t len) {
             if (data->PtlType == ProtocolType_None) {
                 break;
             }
-            ProcessObserver* proc = GetProcess(header);
-            if (!proc->GetProcessMeta()->PassFilterRules()) {
-                if (this->mEBPFWrapper != nullptr) {
-                    this->mEBPFWrapper->DisableProcess(header->PID);
-                }
+            ProcessObserver* proc = GetProcess(shard, header);
+            if (!ContainerProcessGroupManager::GetInstance()->PassFilterRules(proc->GetProcessMeta())) {
+                DisableProcess(header->PID);
                 break;
             }
             proc->OnData(header, data);
@@ -278,29 +358,54 @@ int NetworkObserver::OnPacketEvent(void* event, size_t len) {
         case PacketEventType_Connected:
         case PacketEventType_Accepted:
             // create process
-            GetProcess(header);
+            GetProcess(shard, header);
             break;
         case PacketEventType_Closed: {
-            ProcessObserver* proc = GetProcess(header, false);
+            ProcessObserver* proc = GetProcess(shard, header, false);
             if (proc == nullptr) {
                 break;
             }
             proc->ConnectionMarkDeleted(header);
         } break;
     }
-    return 0;
 }
+
+void NetworkObserver::DisableProcess(uint32_t pid) {
+    if (mEBPFWrapper == nullptr) {
+        return;
+    }
+    std::lock_guard<std::mutex> lock(mDisableProcessesMutex);
+    mProcessesToDisable.push_back(pid);
+}
+
+void NetworkObserver::ApplyDisableProcesses() {
+    std::vector<uint32_t> pids;
+    {
+        std::lock_guard<std::mutex> lock(mDisableProcessesMutex);
+        pids.swap(mProcessesToDisable);
+    }
+    if (mEBPFWrapper == nullptr) {
+        return;
+    }
+    for (auto pid : pids) {
+        mEBPFWrapper->DisableProcess(pid);
+    }
+}
+
 void NetworkObserver::OnProcessDestroyed(uint32_t pid, const char* command, size_t len) {
-    auto findIter = mAllProcesses.find(pid);
-    if (findIter != mAllProcesses.end()) {
+    NetworkObserverShard& shard = GetShard(pid);
+    std::lock_guard<std::mutex> lock(shard.mProcessesMutex);
+    auto findIter = shard.mAllProcesses.find(pid);
+    if (findIter != shard.mAllProcesses.end()) {
         auto& meta = findIter->second->GetProcessMeta();
-        if (meta && meta->ProcessCMD.size() == len && memcmp(meta->ProcessCMD.c_str(), command, len) == 0) {
+        std::string processCMD = meta ? ContainerProcessGroupManager::GetInstance()->GetProcessCMD(meta) : "";
+        if (meta && processCMD.size() == len && memcmp(processCMD.c_str(), command, len) == 0) {
             findIter->second->MarkDeleted();
             LOG_DEBUG(sLogger, ("process destroyed, mark deleted, command", command)("pid", pid));
         } else {
             LOG_INFO(sLogger,
                      ("find pid on process destroyed, but command not match, destroyed command",
-                      command)("pid", pid)("real command", meta ? meta->ProcessCMD : ""));
+                      command)("pid", pid)("real command", processCMD));
         }
     }
 }
@@ -362,9 +467,12 @@ void NetworkObserver::EventLoop() {
     LOG_INFO(sLogger, ("start observer network event loop", "success"));
     ContainerProcessGroupManager::GetInstance()->Init();
     if (mConfig->mLocalFileEnabled) {
-        mReplayFilePtr = fopen64(STRING_FLAG(sls_observer_network_save_filename).c_str(), "rb+");
+        mReplayReader.reset(new PacketEventDumpReader);
+        mReplayPos = 0;
+        if (!mReplayReader->Open(STRING_FLAG(sls_observer_network_save_filename))) {
+            mReplayReader.reset();
+        }
     }
-    uint64_t lastProfilingTime = GetCurrentTimeInNanoSeconds();
     while (true) {
         bool hasMoreData = false;
         ReadLock lock(mEventLoopThreadRWL);
@@ -413,51 +521,38 @@ void NetworkObserver::EventLoop() {
                            rst)("time", GetCurrentTimeInNanoSeconds() - nowTimeNs / 1000LL / 1000LL));
             }
         }
-        if (mReplayFilePtr != nullptr) {
-            uint32_t dataSize = 0;
-            fread(&dataSize, 1, 4, mReplayFilePtr);
-            if (dataSize != 0 && dataSize < 1024 * 1024) {
-                char* buf = (char*)malloc(dataSize);
-                if (dataSize != fread(buf, 1, dataSize, mReplayFilePtr)) {
-                    LOG_ERROR(sLogger, ("read ebpf replay file failed", errno));
-                } else {
-                    void* event = nullptr;
-                    int32_t len = 0;
-                    BufferToPacketEvent(buf, static_cast<int32_t>(dataSize), event, len);
-                    if (event != nullptr) {
-                        OnPacketEvent(event, len);
-                        hasMoreData = true;
-                    }
-                }
-                free(buf);
+        if (mReplayReader) {
+            void* event = nullptr;
+            int32_t len = 0;
+            int32_t rst = 0;
+            while (rst < 100 && mReplayReader->Read(mReplayPos, event, len)) {
+                OnPacketEvent(event, len);
+                ++rst;
+            }
+            if (rst >= 100) {
+                hasMoreData = true;
+            } else {
+                LOG_INFO(sLogger,
+                         ("replay ebpf dump file done, offset", mReplayPos)("file size", mReplayReader->GetFileSize()));
+                mReplayReader.reset();
             }
         }
+        ApplyDisableProcesses();
 
-        // fetching metas
-        if (nowTimeNs - mLastFlushMetaTimeNs >= mConfig->mFlushMetaInterval * 1000ULL * 1000ULL * 1000ULL) {
-            mLastFlushMetaTimeNs = nowTimeNs;
-            ContainerProcessGroupManager::GetInstance()->Init();
-            ContainerProcessGroupManager::GetInstance()->FlushMetas();
-        }
-
-        // GC
-        if (nowTimeNs - mLastGCTimeNs >= INT64_FLAG(sls_observer_network_gc_interval) * 1000ULL * 1000ULL * 1000ULL) {
-            mLastGCTimeNs = nowTimeNs;
-            GarbageCollection(nowTimeNs);
-        }
         if (mEBPFWrapper != nullptr
             && nowTimeNs - mLastEbpfGCTimeNs
                 > INT64_FLAG(sls_observer_network_ebpf_connection_gc_interval) * 1000ULL * 1000ULL * 1000ULL) {
             mLastEbpfGCTimeNs = nowTimeNs;
             mNetworkStatistic->mEbpfUsingConnections = EBPFConnectionGC(nowTimeNs);
         }
+        // connection metas are used by the eBPF wrapper when capturing
         if (nowTimeNs - mLastFlushNetlinkTimeNs >= mConfig->mFlushNetlinkInterval * 1000ULL * 1000ULL * 1000ULL) {
             mLastFlushNetlinkTimeNs = nowTimeNs;
             ConnectionMetaManager::GetInstance()->Init();
             ConnectionMetaManager::GetInstance()->GarbageCollection();
         }
 
-        // flush observer metrics
+        // flush observer statistics, which are collected by the capturing sources
         if (nowTimeNs - mLastL4FlushTimeNs >= mConfig->mFlushOutL4Interval * 1000ULL * 1000ULL * 1000ULL) {
             mLastL4FlushTimeNs = nowTimeNs;
             std::vector<sls_logs::Log> allLogs;
@@ -470,6 +565,66 @@ void NetworkObserver::EventLoop() {
                 mNetworkStatistic->mOutputBytes += item.GetCachedSize();
             }
         }
+        if (!hasMoreData) {
+            usleep(1000 * INT32_FLAG(sls_observer_network_no_data_sleep_interval_ms));
+        }
+    }
+}
+
+void NetworkObserver::ParseLoop(NetworkObserverShard* shard) {
+    LOG_INFO(sLogger, ("start observer network parse loop", shard->mIndex));
+    std::vector<std::string> events;
+    while (true) {
+        {
+            auto timeout = std::chrono::milliseconds(INT32_FLAG(sls_observer_network_no_data_sleep_interval_ms));
+            std::unique_lock<std::mutex> lock(shard->mQueueMutex);
+            shard->mQueueCond.wait_for(
+                lock, timeout, [shard]() { return !shard->mPendingEvents.empty() || shard->mStopParsing; });
+            events.swap(shard->mPendingEvents);
+            if (events.empty() && shard->mStopParsing) {
+                break;
+            }
+        }
+        if (events.empty()) {
+            continue;
+        }
+        ReadLock lock(mEventLoopThreadRWL);
+        std::lock_guard<std::mutex> processesLock(shard->mProcessesMutex);
+        for (auto& buffer : events) {
+            void* event = nullptr;
+            int32_t len = 0;
+            BufferToPacketEvent(&buffer[4], static_cast<int32_t>(buffer.size() - 4), event, len);
+            if (event != nullptr) {
+                ParsePacketEvent(*shard, event, len);
+            }
+        }
+        events.clear();
+    }
+    LOG_INFO(sLogger, ("stop observer network parse loop", shard->mIndex));
+}
+
+void NetworkObserver::HousekeepingLoop() {
+    LOG_INFO(sLogger, ("start observer network housekeeping loop", "success"));
+    uint64_t lastProfilingTime = GetCurrentTimeInNanoSeconds();
+    while (true) {
+        usleep(100 * 1000);
+        ReadLock lock(mEventLoopThreadRWL);
+        if (mPCAPWrapper == nullptr && mEBPFWrapper == nullptr) {
+            continue;
+        }
+        uint64_t nowTimeNs = GetCurrentTimeInNanoSeconds();
+        // fetching metas
+        if (nowTimeNs - mLastFlushMetaTimeNs >= mConfig->mFlushMetaInterval * 1000ULL * 1000ULL * 1000ULL) {
+            mLastFlushMetaTimeNs = nowTimeNs;
+            ContainerProcessGroupManager::GetInstance()->Init();
+            ContainerProcessGroupManager::GetInstance()->FlushMetas();
+        }
+
+        // GC
+        if (nowTimeNs - mLastGCTimeNs >= INT64_FLAG(sls_observer_network_gc_interval) * 1000ULL * 1000ULL * 1000ULL) {
+            mLastGCTimeNs = nowTimeNs;
+            GarbageCollection(nowTimeNs);
+        }
 
         // flush observer metrics
         if (nowTimeNs - mLastL7FlushTimeNs >= mConfig->mFlushOutL7Interval * 1000ULL * 1000ULL * 1000ULL) {
@@ -505,9 +660,6 @@ void NetworkObserver::EventLoop() {
                                                      ContainerProcessGroupManager::GetInstance()->GetContainerType());
             lastProfilingTime = nowTimeNs;
         }
-        if (!hasMoreData) {
-            usleep(1000 * INT32_FLAG(sls_observer_network_no_data_sleep_interval_ms));
-        }
     }
 }
 
@@ -518,9 +670,44 @@ void NetworkObserver::BindSender() {
 
 inline void NetworkObserver::StartEventLoop() {
     if (!mEventLoopThread) {
+        StartParseWorkers();
+        mHousekeepingThread = CreateThread([this]() { HousekeepingLoop(); });
         mEventLoopThread = CreateThread([this]() { EventLoop(); });
     }
 }
+
+void NetworkObserver::StartParseWorkers() {
+    if (INT32_FLAG(sls_observer_network_parse_thread_count) <= 0) {
+        return;
+    }
+    for (auto& shard : mShards) {
+        if (shard->mWorkerThread) {
+            continue;
+        }
+        NetworkObserverShard* shardPtr = shard.get();
+        {
+            std::lock_guard<std::mutex> lock(shard->mQueueMutex);
+            shard->mStopParsing = false;
+        }
+        shard->mWorkerThread = CreateThread([this, shardPtr]() { ParseLoop(shardPtr); });
+    }
+}
+
+void NetworkObserver::StopParseWorkers() {
+    for (auto& shard : mShards) {
+        if (!shard->mWorkerThread) {
+            continue;
+        }
+        {
+            std::lock_guard<std::mutex> lock(shard->mQueueMutex);
+            shard->mStopParsing = true;
+        }
+        shard->mQueueCond.notify_one();
+        shard->mWorkerThread->Wait(0);
+        shard->mWorkerThread.reset();
+    }
+}
+
 int NetworkObserver::OutputPluginProcess(std::vector<sls_logs::Log>& logs, const Pipeline* config) {
     static auto sPlugin = LogtailPlugin::GetInstance();
     auto now = GetCurrentLogtailTime();
@@ -19,6 +19,9 @@
 #include "interface/network.h"
 #include "interface/helper.h"
 #include "NetworkConfig.h"
+#include <condition_variable>
+#include <memory>
+#include <mutex>
 #include <unordered_map>
 #include <ostream>
 #include "log_pb/sls_logs.pb.h"
@@ -35,6 +38,27 @@ namespace logtail {
 class ProcessObserver;
 class PCAPWrapper;
 class EBPFWrapper;
+class PacketEventDumpReader;
+
+/**
+ * @brief NetworkObserverShard parses the packets of a part of processes, chosen by pid, so that packets of the same
+ * connection are always parsed in order by the same thread.
+ */
+struct NetworkObserverShard {
+    explicit NetworkObserverShard(size_t index) : mIndex(index) {}
+
+    size_t mIndex;
+    // guards mAllProcesses and the aggregators of the shard
+    std::mutex mProcessesMutex;
+    std::unordered_map<uint32_t, ProcessObserver*> mAllProcesses;
+    std::mutex mQueueMutex;
+    std::condition_variable mQueueCond;
+    // packets captured but not parsed yet, in the dump format, only used when the shard has its own worker thread
+    std::vector<std::string> mPendingEvents;
+    // the worker exits once the pending events are parsed
+    bool mStopParsing = false;
+    ThreadPtr mWorkerThread;
+};
 
 
 class NetworkObserver {
@@ -57,18 +81,18 @@ public:
     void Reload();
 
 private:
-    NetworkObserver() {
-        mLastGCTimeNs = GetCurrentTimeInNanoSeconds();
-        mLastL4FlushTimeNs = GetCurrentTimeInNanoSeconds();
-        mLastL7FlushTimeNs = GetCurrentTimeInNanoSeconds();
-        mConfig = NetworkConfig::GetInstance();
-        mNetworkStatistic = NetworkStatistic::GetInstance();
-        mServiceMetaManager = ServiceMetaManager::GetInstance();
-    }
+    NetworkObserver();
     ~NetworkObserver();
 
+    // captures packets and dispatches them to the shards
     void EventLoop();
 
+    // parses the packets dispatched to the shard
+    void ParseLoop(NetworkObserverShard* shard);
+
+    // refreshes metas, collects garbage and flushes out the protocol metrics, off the capturing thread
+    void HousekeepingLoop();
+
 
     void GarbageCollection(uint64_t nowTimeNs);
 
@@ -80,7 +104,11 @@ private:
      * @param create  whether create new process obj when not found
      * @return ProcessObserver allocated in heap.
      */
-    ProcessObserver* GetProcess(PacketEventHeader* header, bool create = true);
+    ProcessObserver* GetProcess(NetworkObserverShard& shard, PacketEventHeader* header, bool create = true);
+
+    NetworkObserverShard& GetShard(uint32_t pid) { return *mShards[pid % mShards.size()]; }
+
+    size_t GetProcessCount();
 
     /**
      * @brief BindSender bind different output ways, such as sls or plugins output ways.
@@ -98,6 +126,13 @@ private:
 
     int OnPacketEvent(void* event, size_t len);
 
+    // @note the processes mutex of the shard must be held
+    void ParsePacketEvent(NetworkObserverShard& shard, void* event, size_t len);
+
+    // eBPF wrapper is not thread safe, so processes are disabled by the capturing thread
+    void DisableProcess(uint32_t pid);
+    void ApplyDisableProcesses();
+
     void OnProcessDestroyed(uint32_t pid, const char* command, size_t len);
 
     /**
@@ -118,9 +153,18 @@ private:
     // create a still running thread to process observer data.
     void StartEventLoop();
 
-    std::unordered_map<uint32_t, ProcessObserver*> mAllProcesses;
+    // create a parsing thread for each shard if sls_observer_network_parse_thread_count > 0
+    void StartParseWorkers();
+    // wait until the packets pending are parsed, then stop the parsing threads
+    void StopParseWorkers();
+
+    // at least one, packets are parsed by the capturing thread if the shards have no worker thread
+    std::vector<std::unique_ptr<NetworkObserverShard>> mShards;
+    std::mutex mDisableProcessesMutex;
+    std::vector<uint32_t> mProcessesToDisable;
     std::function<int(std::vector<sls_logs::Log>&, const Pipeline*)> mSenderFunc;
     ThreadPtr mEventLoopThread;
+    ThreadPtr mHousekeepingThread;
     ReadWriteLock mEventLoopThreadRWL;
     uint64_t mLastGCTimeNs = 0;
     uint64_t mLastL4FlushTimeNs = 0;
@@ -131,7 +175,8 @@ private:
     uint64_t mLastProbeDisableProcessNs = 0;
     uint64_t mLastCleanAllDisableProcessNs = 0;
     FILE* mDumpFilePtr = nullptr;
-    FILE* mReplayFilePtr = nullptr;
+    std::unique_ptr<PacketEventDumpReader> mReplayReader;
+    size_t mReplayPos = 0;
     int64_t mDumpSize = 0;
 
     // don't delete following pointer, the lifecycles of them may be over current instance.
@@ -150,6 +195,7 @@ private:
     friend class ProtocolMySqlUnittest;
     friend class ProtocolRedisUnittest;
     friend class ProtocolPgSqlUnittest;
+    friend class NetworkObserverReplayBenchmark;
 };
 
 } // namespace logtail
@@ -31,7 +31,9 @@ bool ProcessObserver::GarbageCollection(size_t size_limit_bytes, uint64_t nowTim
         ConnectionObserver* conn = iter->second;
         if (conn->GarbageCollection(size_limit_bytes, nowTimeNs)) {
             LOG_DEBUG(sLogger,
-                      ("delete connection observer when gc, id", GetProcessMeta()->ToString())("conn id", iter->first));
+                      ("delete connection observer when gc, id",
+                       ContainerProcessGroupManager::GetInstance()->GetMetaString(GetProcessMeta()))("conn id",
+                                                                                                     iter->first));
             delete conn;
             iter = mAllConnections.erase(iter);
             ++sNetStatistic->mGCReleaseConnCount;
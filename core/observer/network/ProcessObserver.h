@@ -69,9 +69,13 @@ public:
 
     ProtocolEventAggregators* GetAggregator() { return mAllAggregator; }
 
-    void SetProcessGroup(ContainerProcessGroupPtr& groupPtr) {
+    /**
+     * @brief SetProcessGroup binds the process to its group.
+     * @param shard index of the shard parsing the process, whose aggregators in the group are used.
+     */
+    void SetProcessGroup(ContainerProcessGroupPtr& groupPtr, size_t shard = 0) {
         mProcessGroupPtr = groupPtr;
-        mAllAggregator = &mProcessGroupPtr->mAggregator;
+        mAllAggregator = mProcessGroupPtr->GetShardAggregator(shard);
     }
 
     /**
@@ -17,6 +17,24 @@
 namespace logtail {
 
 
+void ProtocolEventAggregators::Merge(ProtocolEventAggregators& other) {
+    if (other.mDNSAggregators != nullptr) {
+        GetDNSAggregator()->Merge(*other.mDNSAggregators);
+    }
+    if (other.mHTTPAggregators != nullptr) {
+        GetHTTPAggregator()->Merge(*other.mHTTPAggregators);
+    }
+    if (other.mMySQLAggregators != nullptr) {
+        GetMySQLAggregator()->Merge(*other.mMySQLAggregators);
+    }
+    if (other.mRedisAggregators != nullptr) {
+        GetRedisAggregator()->Merge(*other.mRedisAggregators);
+    }
+    if (other.mPgSQLAggregators != nullptr) {
+        GetPgSQLAggregator()->Merge(*other.mPgSQLAggregators);
+    }
+}
+
 void ProtocolEventAggregators::FlushOutMetrics(uint64_t timeNano,
                                                std::vector<sls_logs::Log>& allData,
                                                std::vector<std::pair<std::string, std::string>>& processTags,
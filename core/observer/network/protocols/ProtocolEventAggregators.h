@@ -105,6 +105,12 @@ public:
 
     void SetProcessMeta(const ProcessMetaPtr& metaPtr) { mMetaPtr = metaPtr; }
 
+    /**
+     * @brief Merge moves the aggregation results of other into this one, leaving other empty.
+     * @param other aggregators of the same process group, which are not used by others at the same time.
+     */
+    void Merge(ProtocolEventAggregators& other);
+
     void FlushOutMetrics(uint64_t timeNano,
                          std::vector<sls_logs::Log>& allData,
                          std::vector<std::pair<std::string, std::string>>& processTags,
@@ -25,6 +25,8 @@
 #include "Logger.h"
 #include <unordered_map>
 #include <ostream>
+#include <algorithm>
+#include <vector>
 
 namespace logtail {
 
@@ -72,6 +74,137 @@ struct CommonProtocolEvent {
     CommonProtocolEventInfo Info;
 };
 
+/**
+ * Mergeable latency histogram with log-linear buckets, used to estimate latency quantiles.
+ *
+ * Latencies are recorded in microseconds. Values below 2^kSubBucketBits have a bucket each, and every higher power of
+ * two is split into 2^kSubBucketBits buckets of equal width, so a quantile estimated by the bucket midpoint is off by
+ * at most 1/2^(kSubBucketBits+1), i.e. 6.25%. Values of 2^32us (about 71 minutes) or more fall into the last bucket.
+ *
+ * Only buckets hit are stored, 8 bytes each, so a sketch never takes more than kBucketCount * 8 = 1920 bytes besides
+ * itself, while requests of a single key usually spread over a few dozens of buckets.
+ */
+class LatencySketch {
+public:
+    static constexpr uint32_t kSubBucketBits = 3;
+    static constexpr uint32_t kMaxValueBits = 32;
+    static constexpr uint32_t kBucketCount = (kMaxValueBits - kSubBucketBits + 1) << kSubBucketBits;
+
+    void Clear() {
+        mBuckets.clear();
+        mTotalCount = 0;
+    }
+
+    uint64_t Count() const { return mTotalCount; }
+
+    void Add(int64_t latencyNs, uint32_t count = 1) {
+        uint32_t index = GetBucketIndex(latencyNs > 0 ? static_cast<uint64_t>(latencyNs) / 1000 : 0);
+        auto iter = std::lower_bound(
+            mBuckets.begin(), mBuckets.end(), index, [](const Bucket& b, uint32_t idx) { return b.mIndex < idx; });
+        if (iter == mBuckets.end() || iter->mIndex != index) {
+            iter = mBuckets.insert(iter, Bucket{index, 0});
+        }
+        iter->mCount += count;
+        mTotalCount += count;
+    }
+
+    void Merge(const LatencySketch& other) {
+        if (other.mBuckets.empty()) {
+            return;
+        }
+        std::vector<Bucket> merged;
+        merged.reserve(mBuckets.size() + other.mBuckets.size());
+        auto lhs = mBuckets.cbegin();
+        auto rhs = other.mBuckets.cbegin();
+        while (lhs != mBuckets.cend() || rhs != other.mBuckets.cend()) {
+            if (rhs == other.mBuckets.cend() || (lhs != mBuckets.cend() && lhs->mIndex < rhs->mIndex)) {
+                merged.push_back(*lhs++);
+            } else if (lhs == mBuckets.cend() || rhs->mIndex < lhs->mIndex) {
+                merged.push_back(*rhs++);
+            } else {
+                merged.push_back(Bucket{lhs->mIndex, lhs->mCount + rhs->mCount});
+                ++lhs;
+                ++rhs;
+            }
+        }
+        mBuckets.swap(merged);
+        mTotalCount += other.mTotalCount;
+    }
+
+    /**
+     * @param quantile in [0, 1]
+     * @return estimated latency in nanoseconds, or 0 if nothing is recorded.
+     */
+    int64_t GetQuantileNs(double quantile) const {
+        if (mTotalCount == 0) {
+            return 0;
+        }
+        uint64_t rank = static_cast<uint64_t>(quantile * mTotalCount + 0.5);
+        rank = std::min(std::max(rank, static_cast<uint64_t>(1)), mTotalCount);
+        uint64_t cnt = 0;
+        for (const auto& bucket : mBuckets) {
+            cnt += bucket.mCount;
+            if (cnt >= rank) {
+                return static_cast<int64_t>(GetBucketLowerBound(bucket.mIndex) + GetBucketUpperBound(bucket.mIndex))
+                    * 500;
+            }
+        }
+        return static_cast<int64_t>(GetBucketLowerBound(mBuckets.back().mIndex)) * 1000;
+    }
+
+    /**
+     * Serialize the sketch as "<kSubBucketBits>|<lower bound in us>:<count>,...", e.g. "3|0:2,96:10,112:1". Bucket
+     * bounds can be derived from the lower bound and kSubBucketBits, so sketches can be merged downstream.
+     */
+    std::string Serialize() const {
+        std::string res = std::to_string(kSubBucketBits);
+        res.push_back('|');
+        for (size_t i = 0; i < mBuckets.size(); ++i) {
+            if (i != 0) {
+                res.push_back(',');
+            }
+            res.append(std::to_string(GetBucketLowerBound(mBuckets[i].mIndex)));
+            res.push_back(':');
+            res.append(std::to_string(mBuckets[i].mCount));
+        }
+        return res;
+    }
+
+    static uint32_t GetBucketIndex(uint64_t valueUs) {
+        valueUs = std::min(valueUs, (static_cast<uint64_t>(1) << kMaxValueBits) - 1);
+        if (valueUs < (1U << kSubBucketBits)) {
+            return static_cast<uint32_t>(valueUs);
+        }
+        uint32_t shift = 63 - __builtin_clzll(valueUs) - kSubBucketBits;
+        return ((shift + 1) << kSubBucketBits) + static_cast<uint32_t>(valueUs >> shift) - (1U << kSubBucketBits);
+    }
+
+    static uint64_t GetBucketLowerBound(uint32_t index) {
+        if (index < (1U << kSubBucketBits)) {
+            return index;
+        }
+        uint32_t shift = (index >> kSubBucketBits) - 1;
+        return static_cast<uint64_t>((1U << kSubBucketBits) + (index & ((1U << kSubBucketBits) - 1))) << shift;
+    }
+
+    static uint64_t GetBucketUpperBound(uint32_t index) {
+        if (index < (1U << kSubBucketBits)) {
+            return index + 1;
+        }
+        return GetBucketLowerBound(index) + (static_cast<uint64_t>(1) << ((index >> kSubBucketBits) - 1));
+    }
+
+private:
+    struct Bucket {
+        uint32_t mIndex;
+        uint32_t mCount;
+    };
+
+    // sorted by index
+    std::vector<Bucket> mBuckets;
+    uint64_t mTotalCount = 0;
+};
+
 /**
  * Aggregate single protocol event info.
  */
@@ -82,6 +215,7 @@ struct CommonProtocolAggResult {
         TotalLatencyNs = 0;
         TotalReqBytes = 0;
         TotalRespBytes = 0;
+        Latency.Clear();
     }
 
     bool IsEmpty() const { return TotalCount == 0; }
@@ -91,6 +225,7 @@ struct CommonProtocolAggResult {
         TotalLatencyNs += info.LatencyNs;
         TotalReqBytes += info.ReqBytes;
         TotalRespBytes += info.RespBytes;
+        Latency.Add(info.LatencyNs);
     }
 
     void Merge(CommonProtocolAggResult& aggResult) {
@@ -98,6 +233,7 @@ struct CommonProtocolAggResult {
         TotalLatencyNs += aggResult.TotalLatencyNs;
         TotalReqBytes += aggResult.TotalReqBytes;
         TotalRespBytes += aggResult.TotalRespBytes;
+        Latency.Merge(aggResult.Latency);
     }
 
     void ToPB(sls_logs::Log* log) const {
@@ -105,13 +241,14 @@ struct CommonProtocolAggResult {
         AddAnyLogContent(log, observer::kLatencyNs, TotalLatencyNs);
         AddAnyLogContent(log, observer::kReqBytes, TotalReqBytes);
         AddAnyLogContent(log, observer::kRespBytes, TotalRespBytes);
-        AddAnyLogContent(log, observer::kTdigestLatency, std::string("xxxxx"));
+        AddAnyLogContent(log, observer::kTdigestLatency, Latency.Serialize());
     }
 
     int64_t TotalCount{0};
     int64_t TotalLatencyNs{0};
     int64_t TotalReqBytes{0};
     int64_t TotalRespBytes{0};
+    LatencySketch Latency;
 };
 
 
@@ -222,6 +359,27 @@ public:
         return true;
     }
 
+    /**
+     * Move all the aggregation results of another aggregator into this one, leaving the other one empty.
+     * @param other the aggregator to merge, which must not be used by others at the same time.
+     */
+    void Merge(CommonProtocolEventAggregator& other) {
+        for (auto iter = other.mProtocolEventAggMap.begin(); iter != other.mProtocolEventAggMap.end(); ++iter) {
+            if (iter->second->AggResult.IsEmpty()) {
+                other.mAggItemManager.Delete(iter->second);
+                continue;
+            }
+            auto findRst = mProtocolEventAggMap.find(iter->first);
+            if (findRst == mProtocolEventAggMap.end()) {
+                mProtocolEventAggMap.insert(std::make_pair(iter->first, iter->second));
+            } else {
+                findRst->second->Merge(*iter->second);
+                other.mAggItemManager.Delete(iter->second);
+            }
+        }
+        other.mProtocolEventAggMap.clear();
+    }
+
     void FlushLogs(std::vector<sls_logs::Log>& allData,
                    const std::string& tags,
                    google::protobuf::RepeatedPtrField<sls_logs::Log_Content>& globalTags,
@@ -0,0 +1,97 @@
+// Copyright 2024 iLogtail Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "observer/network/sources/dump/PacketEventDumpReader.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cstring>
+
+#include "logger/Logger.h"
+
+namespace logtail {
+
+bool PacketEventDumpReader::Open(const std::string& fileName) {
+    Close();
+    int fd = open(fileName.c_str(), O_RDONLY);
+    if (fd < 0) {
+        LOG_ERROR(sLogger, ("open packet event dump file failed", fileName)("errno", errno));
+        return false;
+    }
+    struct stat buf;
+    if (fstat(fd, &buf) != 0) {
+        LOG_ERROR(sLogger, ("stat packet event dump file failed", fileName)("errno", errno));
+        close(fd);
+        return false;
+    }
+    if (buf.st_size > 0) {
+        // the payload may be modified in place by parsers, which is kept from the file by a private mapping
+        void* data = mmap(nullptr, static_cast<size_t>(buf.st_size), PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+        if (data == MAP_FAILED) {
+            LOG_ERROR(sLogger, ("map packet event dump file failed", fileName)("errno", errno));
+            close(fd);
+            return false;
+        }
+        mData = static_cast<char*>(data);
+        mFileSize = static_cast<size_t>(buf.st_size);
+    }
+    // the mapping is still valid after the fd is closed
+    close(fd);
+    return true;
+}
+
+void PacketEventDumpReader::Close() {
+    if (mData != nullptr) {
+        munmap(mData, mFileSize);
+        mData = nullptr;
+    }
+    mFileSize = 0;
+}
+
+bool PacketEventDumpReader::Read(size_t& pos, void*& event, int32_t& len) {
+    if (mData == nullptr || pos >= mFileSize || mFileSize - pos < sizeof(uint32_t)) {
+        return false;
+    }
+    const char* record = mData + pos;
+    uint32_t size = 0;
+    memcpy(&size, record, sizeof(uint32_t));
+    if (size > mFileSize - pos - sizeof(uint32_t)) {
+        return false;
+    }
+    record += sizeof(uint32_t);
+    if (size == sizeof(PacketEventHeader)) {
+        memcpy(mEvent, record, sizeof(PacketEventHeader));
+    } else if (size >= sizeof(PacketEventHeader) + sizeof(PacketEventData)) {
+        memcpy(mEvent, record, sizeof(PacketEventHeader) + sizeof(PacketEventData));
+        auto data = reinterpret_cast<PacketEventData*>(mEvent + sizeof(PacketEventHeader));
+        if (data->BufferLen < 0
+            || static_cast<size_t>(data->BufferLen)
+                > size - sizeof(PacketEventHeader) - sizeof(PacketEventData)) {
+            return false;
+        }
+        // the payload is referred to in place, and the file is never modified as the mapping is private
+        data->Buffer = const_cast<char*>(record) + sizeof(PacketEventHeader) + sizeof(PacketEventData);
+    } else {
+        return false;
+    }
+    event = mEvent;
+    len = static_cast<int32_t>(size);
+    pos += sizeof(uint32_t) + size;
+    return true;
+}
+
+} // namespace logtail
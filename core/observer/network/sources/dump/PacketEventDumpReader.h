@@ -0,0 +1,60 @@
+/*
+ * Copyright 2024 iLogtail Authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+#include "observer/interface/network.h"
+
+namespace logtail {
+
+/**
+ * @brief PacketEventDumpReader reads the packet events dumped by NetworkObserver to
+ * sls_observer_network_save_filename, i.e. records of a 4 bytes size followed by the event, for replay.
+ *
+ * The file is mapped into memory once, so reading an event copies nothing but its header, which is moved out of the
+ * mapping to be aligned, while the payload is referred to in place.
+ */
+class PacketEventDumpReader {
+public:
+    PacketEventDumpReader() = default;
+    PacketEventDumpReader(const PacketEventDumpReader&) = delete;
+    PacketEventDumpReader& operator=(const PacketEventDumpReader&) = delete;
+
+    bool Open(const std::string& fileName);
+    void Close();
+
+    size_t GetFileSize() const { return mFileSize; }
+
+    /**
+     * @brief Read the event at pos of the file.
+     * @param pos offset of the record, which is moved to the next record on success.
+     * @param event [out] valid until the next read or the reader is closed.
+     * @return false at the end of file or on a broken record.
+     */
+    bool Read(size_t& pos, void*& event, int32_t& len);
+
+private:
+    char* mData = nullptr;
+    size_t mFileSize = 0;
+    // header and data of the last event read
+    alignas(std::max_align_t) char mEvent[sizeof(PacketEventHeader) + sizeof(PacketEventData)];
+};
+
+} // namespace logtail
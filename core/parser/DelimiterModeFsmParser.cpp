@@ -14,6 +14,10 @@
 
 #include "DelimiterModeFsmParser.h"
 
+#include <algorithm>
+
+#include "common/SimdUtil.h"
+
 namespace logtail {
 
 DelimiterModeFsmParser::DelimiterModeFsmParser(char quote, char separator) : quote(quote), separator(separator) {
@@ -209,6 +213,68 @@ bool DelimiterModeFsmParser::ParseDelimiterLine(StringView buffer,
                                                 int begin,
                                                 int end,
                                                 std::vector<StringView>& columnValues) {
+    size_t columnCnt = columnValues.size();
+    if (ParseDelimiterLineByStructuralIndex(buffer.data(), begin, end, columnValues)) {
+        return true;
+    }
+    columnValues.resize(columnCnt);
+    return ParseDelimiterLineByFsm(buffer, begin, end, columnValues);
+}
+
+bool DelimiterModeFsmParser::ParseDelimiterLineByStructuralIndex(const char* buffer,
+                                                                 int begin,
+                                                                 int end,
+                                                                 std::vector<StringView>& columnValues) const {
+    int fieldStart = begin;
+    uint32_t fieldQuoteCnt = 0;
+    // all ones if the last block ends within quotes
+    uint64_t quoteCarry = 0;
+    for (int blockStart = begin; blockStart < end; blockStart += 64) {
+        size_t blockSize = static_cast<size_t>(std::min(end - blockStart, 64));
+        uint64_t separatorMask = 0, quoteMask = 0;
+        ClassifyBlock64(buffer + blockStart, blockSize, separator, quote, separatorMask, quoteMask);
+        if (quoteMask != 0 || quoteCarry != 0) {
+            uint64_t quoted = PrefixXor(quoteMask) ^ quoteCarry;
+            separatorMask &= ~quoted;
+            quoteCarry = 0 - (quoted >> 63);
+        }
+        while (separatorMask != 0) {
+            uint32_t idx = CountTrailingZeros64(separatorMask);
+            uint64_t before = (1ULL << idx) - 1;
+            fieldQuoteCnt += PopCount64(quoteMask & before);
+            quoteMask &= ~before;
+            if (!AddColumn(buffer, fieldStart, blockStart + idx, fieldQuoteCnt, columnValues)) {
+                return false;
+            }
+            fieldStart = blockStart + idx + 1;
+            fieldQuoteCnt = 0;
+            separatorMask &= separatorMask - 1;
+        }
+        fieldQuoteCnt += PopCount64(quoteMask);
+    }
+    return AddColumn(buffer, fieldStart, end, fieldQuoteCnt, columnValues);
+}
+
+bool DelimiterModeFsmParser::AddColumn(const char* buffer,
+                                       int fieldStart,
+                                       int fieldEnd,
+                                       uint32_t quoteCnt,
+                                       std::vector<StringView>& columnValues) const {
+    if (quoteCnt == 0) {
+        columnValues.emplace_back(buffer + fieldStart, fieldEnd - fieldStart);
+        return true;
+    }
+    if (quoteCnt == 2 && fieldEnd - fieldStart >= 2 && buffer[fieldStart] == quote && buffer[fieldEnd - 1] == quote) {
+        columnValues.emplace_back(buffer + fieldStart + 1, fieldEnd - fieldStart - 2);
+        return true;
+    }
+    return false;
+}
+
+bool DelimiterModeFsmParser::ParseDelimiterLineByFsm(StringView buffer,
+                                                     int begin,
+                                                     int end,
+                                                     std::vector<StringView>& columnValues) {
     bool result = true;
     DelimiterModeFsm fsm(STATE_INITIAL, "");
 
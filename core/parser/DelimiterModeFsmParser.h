@@ -17,6 +17,7 @@
 #ifndef __LOG_LOGTAIL_DELIMITER_MODE_FSM_Parser_H__
 #define __LOG_LOGTAIL_DELIMITER_MODE_FSM_Parser_H__
 
+#include <cstdint>
 #include <string>
 #include <vector>
 #include "models/StringView.h"
@@ -68,11 +69,28 @@ public:
 
 public:
     bool ParseDelimiterLine(const char* buffer, int begin, int end, std::vector<std::string>& columnValues);
+    // Columns are located with a structural index first, and the FSM is only run for lines it cannot handle.
     bool ParseDelimiterLine(StringView buffer, int begin, int end, std::vector<StringView>& columnValues);
 
 private:
+    // Separators and quotes of the line are classified 64 bytes at a time into bitmasks, and quoted regions are
+    // resolved with prefix xor, so that separators within them are dropped without visiting each byte. Returns false
+    // if any column is neither unquoted nor enclosed by a pair of quotes only, e.g. with escaped or stray quotes,
+    // leaving the line to the FSM.
+    bool ParseDelimiterLineByStructuralIndex(const char* buffer,
+                                             int begin,
+                                             int end,
+                                             std::vector<StringView>& columnValues) const;
+    bool AddColumn(
+        const char* buffer, int fieldStart, int fieldEnd, uint32_t quoteCnt, std::vector<StringView>& columnValues) const;
+    bool ParseDelimiterLineByFsm(StringView buffer, int begin, int end, std::vector<StringView>& columnValues);
+
     const char quote;
     const char separator;
+
+#ifdef APSARA_UNIT_TEST_MAIN
+    friend class ProcessorParseDelimiterNativeUnittest;
+#endif
 };
 
 } // namespace logtail
@@ -379,7 +379,9 @@ bool Pipeline::Init(Config&& config) {
         uint32_t priority = mContext.GetGlobalConfig().mProcessPriority == 0
             ? ProcessQueueManager::sMaxPriority
             : mContext.GetGlobalConfig().mProcessPriority - 1;
-        ProcessQueueManager::GetInstance()->CreateOrUpdateQueue(mContext.GetProcessQueueKey(), priority);
+        // pipelines without priority configured share the lowest queue priority, but are not paused first
+        bool lowPriority = mContext.GetGlobalConfig().mProcessPriority == ProcessQueueManager::sMaxPriority;
+        ProcessQueueManager::GetInstance()->CreateOrUpdateQueue(mContext.GetProcessQueueKey(), priority, lowPriority);
 
         unordered_set<FeedbackInterface*> feedbackSet;
         for (const auto& input : mInputs) {
@@ -37,6 +37,10 @@ using namespace std;
 namespace logtail {
 
 void logtail::PipelineManager::UpdatePipelines(ConfigDiff& diff) {
+    // Go pipelines can only be loaded and unloaded when the whole plugin system is held on, in which case processing is
+    // held on as well. Otherwise, new pipelines are built before anything is paused, and only the process queues of the
+    // pipelines to be replaced or removed stop being popped, so that other pipelines keep running during the update.
+    bool isGoPipelineChanged = false;
 #ifndef APSARA_UNIT_TEST_MAIN
     // 过渡使用
     static bool isFileServerStarted = false, isInputObserverStarted = false;
@@ -51,6 +55,7 @@ void logtail::PipelineManager::UpdatePipelines(ConfigDiff& diff) {
                             isInputFileChanged,
                             isInputStreamChanged,
                             isInputContainerStdioChanged);
+        isGoPipelineChanged = isGoPipelineChanged || mPipelineNameEntityMap[name]->HasGoPipelines();
     }
     for (const auto& config : diff.mModified) {
         CheckIfInputUpdated(*config.mInputs[0],
@@ -58,6 +63,8 @@ void logtail::PipelineManager::UpdatePipelines(ConfigDiff& diff) {
                             isInputFileChanged,
                             isInputStreamChanged,
                             isInputContainerStdioChanged);
+        isGoPipelineChanged
+            = isGoPipelineChanged || config.HasGoPlugin() || mPipelineNameEntityMap[config.mName]->HasGoPipelines();
     }
     for (const auto& config : diff.mAdded) {
         CheckIfInputUpdated(*config.mInputs[0],
@@ -65,8 +72,16 @@ void logtail::PipelineManager::UpdatePipelines(ConfigDiff& diff) {
                             isInputFileChanged,
                             isInputStreamChanged,
                             isInputContainerStdioChanged);
+        isGoPipelineChanged = isGoPipelineChanged || config.HasGoPlugin();
+    }
+#endif
+
+    vector<pair<string, shared_ptr<Pipeline>>> modifiedPipelines, addedPipelines;
+    if (!isGoPipelineChanged) {
+        BuildPipelines(diff, modifiedPipelines, addedPipelines);
     }
 
+#ifndef APSARA_UNIT_TEST_MAIN
 #if defined(__ENTERPRISE__) && defined(__linux__) && !defined(__ANDROID__)
     if (AppConfig::GetInstance()->ShennongSocketEnabled()) {
         ShennongManager::GetInstance()->Pause();
@@ -83,74 +98,69 @@ void logtail::PipelineManager::UpdatePipelines(ConfigDiff& diff) {
     if (isFileServerStarted && (isInputFileChanged || isInputContainerStdioChanged)) {
         FileServer::GetInstance()->Pause();
     }
-    LogProcess::GetInstance()->HoldOn();
-    LogtailPlugin::GetInstance()->HoldOn(false);
+    if (isGoPipelineChanged) {
+        LogProcess::GetInstance()->HoldOn();
+        LogtailPlugin::GetInstance()->HoldOn(false);
+    }
 #endif
 
+    if (isGoPipelineChanged) {
+        BuildPipelines(diff, modifiedPipelines, addedPipelines);
+    } else {
+        for (const auto& name : diff.mRemoved) {
+            ProcessQueueManager::GetInstance()->InvalidatePop(name);
+        }
+        for (const auto& item : modifiedPipelines) {
+            ProcessQueueManager::GetInstance()->InvalidatePop(item.first);
+        }
+        LogProcess::GetInstance()->WaitForPoppedItems();
+    }
+
     for (const auto& name : diff.mRemoved) {
         auto iter = mPipelineNameEntityMap.find(name);
         iter->second->Stop(true);
         DecreasePluginUsageCnt(iter->second->GetPluginStatistics());
         iter->second->RemoveProcessQueue();
+        lock_guard<mutex> lock(mPipelineNameEntityMapMux);
         mPipelineNameEntityMap.erase(iter);
     }
-    for (auto& config : diff.mModified) {
-        auto p = BuildPipeline(std::move(config));
-        if (!p) {
-            LOG_WARNING(sLogger,
-                        ("failed to build pipeline for existing config",
-                         "keep current pipeline running")("config", config.mName));
-            LogtailAlarm::GetInstance()->SendAlarm(
-                CATEGORY_CONFIG_ALARM,
-                "failed to build pipeline for existing config: keep current pipeline running, config: " + config.mName,
-                config.mProject,
-                config.mLogstore,
-                config.mRegion);
-            diff.mUnchanged.push_back(config.mName);
-            continue;
-        }
-        LOG_INFO(sLogger,
-                 ("pipeline building for existing config succeeded",
-                  "stop the old pipeline and start the new one")("config", config.mName));
-
-        auto iter = mPipelineNameEntityMap.find(config.mName);
+    for (const auto& item : modifiedPipelines) {
+        auto iter = mPipelineNameEntityMap.find(item.first);
         iter->second->Stop(false);
         DecreasePluginUsageCnt(iter->second->GetPluginStatistics());
-        mPipelineNameEntityMap[config.mName] = p;
-        IncreasePluginUsageCnt(p->GetPluginStatistics());
-        p->Start();
+        {
+            // the old pipeline is released once it is no longer used by any thread
+            lock_guard<mutex> lock(mPipelineNameEntityMapMux);
+            iter->second = item.second;
+        }
+        IncreasePluginUsageCnt(item.second->GetPluginStatistics());
+        item.second->Start();
+        ProcessQueueManager::GetInstance()->ValidatePop(item.first);
     }
-    for (auto& config : diff.mAdded) {
-        auto p = BuildPipeline(std::move(config));
-        if (!p) {
-            LOG_WARNING(sLogger,
-                        ("failed to build pipeline for new config", "skip current object")("config", config.mName));
-            LogtailAlarm::GetInstance()->SendAlarm(
-                CATEGORY_CONFIG_ALARM,
-                "failed to build pipeline for new config: skip current object, config: " + config.mName,
-                config.mProject,
-                config.mLogstore,
-                config.mRegion);
-            continue;
+    for (const auto& item : addedPipelines) {
+        {
+            lock_guard<mutex> lock(mPipelineNameEntityMapMux);
+            mPipelineNameEntityMap[item.first] = item.second;
         }
-        LOG_INFO(sLogger,
-                 ("pipeline building for new config succeeded", "begin to start pipeline")("config", config.mName));
-        mPipelineNameEntityMap[config.mName] = p;
-        IncreasePluginUsageCnt(p->GetPluginStatistics());
-        p->Start();
+        IncreasePluginUsageCnt(item.second->GetPluginStatistics());
+        item.second->Start();
     }
 
 #ifndef APSARA_UNIT_TEST_MAIN
-    // 过渡使用，有变更的流水线的Go流水线加载在BuildPipeline中完成
-    for (auto& name : diff.mUnchanged) {
-        mPipelineNameEntityMap[name]->LoadGoPipelines();
+    if (isGoPipelineChanged) {
+        // 过渡使用，有变更的流水线的Go流水线加载在BuildPipeline中完成
+        for (auto& name : diff.mUnchanged) {
+            mPipelineNameEntityMap[name]->LoadGoPipelines();
+        }
     }
     // 在Flusher改造完成前，先不执行如下步骤，不会造成太大影响
     // Sender::CleanUnusedAk();
 
     // 过渡使用
-    LogtailPlugin::GetInstance()->Resume();
-    LogProcess::GetInstance()->Resume();
+    if (isGoPipelineChanged) {
+        LogtailPlugin::GetInstance()->Resume();
+        LogProcess::GetInstance()->Resume();
+    }
     if (isInputFileChanged || isInputContainerStdioChanged) {
         if (isFileServerStarted) {
             FileServer::GetInstance()->Resume();
@@ -190,6 +200,7 @@ void logtail::PipelineManager::UpdatePipelines(ConfigDiff& diff) {
 }
 
 shared_ptr<Pipeline> PipelineManager::FindPipelineByName(const string& configName) const {
+    lock_guard<mutex> lock(mPipelineNameEntityMapMux);
     auto it = mPipelineNameEntityMap.find(configName);
     if (it != mPipelineNameEntityMap.end()) {
         return it->second;
@@ -199,6 +210,7 @@ shared_ptr<Pipeline> PipelineManager::FindPipelineByName(const string& configNam
 
 vector<string> PipelineManager::GetAllPipelineNames() const {
     vector<string> res;
+    lock_guard<mutex> lock(mPipelineNameEntityMapMux);
     for (const auto& item : mPipelineNameEntityMap) {
         res.push_back(item.first);
     }
@@ -246,6 +258,48 @@ void PipelineManager::StopAllPipelines() {
     LOG_INFO(sLogger, ("stop all pipelines", "succeeded"));
 }
 
+void PipelineManager::BuildPipelines(ConfigDiff& diff,
+                                     vector<pair<string, shared_ptr<Pipeline>>>& modifiedPipelines,
+                                     vector<pair<string, shared_ptr<Pipeline>>>& addedPipelines) {
+    for (auto& config : diff.mModified) {
+        auto p = BuildPipeline(std::move(config));
+        if (!p) {
+            LOG_WARNING(sLogger,
+                        ("failed to build pipeline for existing config",
+                         "keep current pipeline running")("config", config.mName));
+            LogtailAlarm::GetInstance()->SendAlarm(
+                CATEGORY_CONFIG_ALARM,
+                "failed to build pipeline for existing config: keep current pipeline running, config: " + config.mName,
+                config.mProject,
+                config.mLogstore,
+                config.mRegion);
+            diff.mUnchanged.push_back(config.mName);
+            continue;
+        }
+        LOG_INFO(sLogger,
+                 ("pipeline building for existing config succeeded",
+                  "stop the old pipeline and start the new one")("config", config.mName));
+        modifiedPipelines.emplace_back(config.mName, p);
+    }
+    for (auto& config : diff.mAdded) {
+        auto p = BuildPipeline(std::move(config));
+        if (!p) {
+            LOG_WARNING(sLogger,
+                        ("failed to build pipeline for new config", "skip current object")("config", config.mName));
+            LogtailAlarm::GetInstance()->SendAlarm(
+                CATEGORY_CONFIG_ALARM,
+                "failed to build pipeline for new config: skip current object, config: " + config.mName,
+                config.mProject,
+                config.mLogstore,
+                config.mRegion);
+            continue;
+        }
+        LOG_INFO(sLogger,
+                 ("pipeline building for new config succeeded", "begin to start pipeline")("config", config.mName));
+        addedPipelines.emplace_back(config.mName, p);
+    }
+}
+
 shared_ptr<Pipeline> PipelineManager::BuildPipeline(Config&& config) {
     shared_ptr<Pipeline> p = make_shared<Pipeline>();
     // only config.mDetail is removed, other members can be safely used later
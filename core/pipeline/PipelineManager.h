@@ -17,8 +17,11 @@
 #pragma once
 
 #include <memory>
+#include <mutex>
 #include <string>
 #include <unordered_map>
+#include <utility>
+#include <vector>
 
 #include "common/Lock.h"
 #include "config/ConfigDiff.h"
@@ -51,6 +54,10 @@ private:
     PipelineManager() = default;
     ~PipelineManager() = default;
 
+    // pipelines failed to build are skipped, and modified ones are added to diff.mUnchanged
+    void BuildPipelines(ConfigDiff& diff,
+                        std::vector<std::pair<std::string, std::shared_ptr<Pipeline>>>& modifiedPipelines,
+                        std::vector<std::pair<std::string, std::shared_ptr<Pipeline>>>& addedPipelines);
     virtual std::shared_ptr<Pipeline> BuildPipeline(Config&& config); // virtual for ut
     void IncreasePluginUsageCnt(
         const std::unordered_map<std::string, std::unordered_map<std::string, uint32_t>>& statistics);
@@ -64,6 +71,9 @@ private:
                              bool& isInputContainerStdioChanged);
 
     std::unordered_map<std::string, std::shared_ptr<Pipeline>> mPipelineNameEntityMap;
+    // only the config update thread modifies the map, and it locks the mutex when doing so, while other threads lock it
+    // when reading
+    mutable std::mutex mPipelineNameEntityMapMux;
     mutable SpinLock mPluginCntMapLock;
     std::unordered_map<std::string, std::unordered_map<std::string, uint32_t>> mPluginCntMap;
 
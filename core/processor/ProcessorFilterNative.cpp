@@ -16,6 +16,7 @@
 
 #include "processor/ProcessorFilterNative.h"
 
+#include <algorithm>
 #include <vector>
 
 #include "common/ParamExtractor.h"
@@ -27,9 +28,46 @@ namespace logtail {
 
 const std::string ProcessorFilterNative::sName = "processor_filter_regex_native";
 
+// regexes of the same key are put in one set, in the order the keys first appear
+static bool BuildKeyRegexSets(const std::vector<std::string>& keys,
+                              const std::vector<std::string>& regs,
+                              std::vector<std::pair<std::string, std::shared_ptr<RegexSet>>>& keyRegexSets) {
+    for (size_t i = 0; i < keys.size(); ++i) {
+        auto it = std::find_if(keyRegexSets.begin(), keyRegexSets.end(), [&](const auto& item) {
+            return item.first == keys[i];
+        });
+        if (it == keyRegexSets.end()) {
+            keyRegexSets.emplace_back(keys[i], std::make_shared<RegexSet>(RegexEngine::RE2, RegexSet::Anchor::FULL));
+            it = keyRegexSets.end() - 1;
+        }
+        if (it->second->Add(regs[i]) < 0) {
+            return false;
+        }
+    }
+    for (auto& item : keyRegexSets) {
+        if (!item.second->Compile()) {
+            return false;
+        }
+    }
+    return true;
+}
+
 bool ProcessorFilterNative::Init(const Json::Value& config) {
     std::string errorMsg;
 
+    // RegexEngine
+    if (!GetOptionalRegexEngineParam(config, "RegexEngine", mRegexEngine, errorMsg)) {
+        PARAM_WARNING_DEFAULT(mContext->GetLogger(),
+                              mContext->GetAlarm(),
+                              errorMsg,
+                              "boost",
+                              sName,
+                              mContext->GetConfigName(),
+                              mContext->GetProjectName(),
+                              mContext->GetLogstoreName(),
+                              mContext->GetRegion());
+    }
+
     // FilterKey + FilterRegex
     std::vector<std::string> filterKeys, filterRegs;
     if (!GetOptionalListParam(config, "FilterKey", filterKeys, errorMsg)
@@ -73,6 +111,10 @@ bool ProcessorFilterNative::Init(const Json::Value& config) {
             mFilterRule = std::make_shared<LogFilterRule>();
             mFilterRule->FilterKeys = filterKeys;
             mFilterRule->FilterRegs = regs;
+            if (mRegexEngine == RegexEngine::RE2
+                && !BuildKeyRegexSets(filterKeys, filterRegs, mFilterRule->KeyRegexSets)) {
+                mFilterRule->KeyRegexSets.clear();
+            }
             mFilterMode = Mode::RULE_MODE;
         }
     }
@@ -90,7 +132,7 @@ bool ProcessorFilterNative::Init(const Json::Value& config) {
                                  mContext->GetLogstoreName(),
                                  mContext->GetRegion());
         } else if (!mInclude.empty()) {
-            std::vector<std::string> keys;
+            std::vector<std::string> keys, regStrs;
             std::vector<boost::regex> regs;
             bool hasError = false;
             for (auto& include : mInclude) {
@@ -107,12 +149,16 @@ bool ProcessorFilterNative::Init(const Json::Value& config) {
                     break;
                 }
                 keys.emplace_back(include.first);
+                regStrs.emplace_back(include.second);
                 regs.emplace_back(boost::regex(include.second));
             }
             if (!hasError) {
                 mFilterRule = std::make_shared<LogFilterRule>();
                 mFilterRule->FilterKeys = keys;
                 mFilterRule->FilterRegs = regs;
+                if (mRegexEngine == RegexEngine::RE2 && !BuildKeyRegexSets(keys, regStrs, mFilterRule->KeyRegexSets)) {
+                    mFilterRule->KeyRegexSets.clear();
+                }
                 mFilterMode = Mode::RULE_MODE;
             }
         }
@@ -291,8 +337,11 @@ bool ProcessorFilterNative::FilterFilterRule(LogEvent& sourceEvent, const LogFil
 }
 
 bool ProcessorFilterNative::IsMatched(const LogEvent& contents, const LogFilterRule& rule) {
+    if (!rule.KeyRegexSets.empty()) {
+        return IsMatchedByRegexSets(contents, rule);
+    }
     const std::vector<std::string>& keys = rule.FilterKeys;
-    const std::vector<boost::regex> regs = rule.FilterRegs;
+    const std::vector<boost::regex>& regs = rule.FilterRegs;
     std::string exception;
     for (uint32_t i = 0; i < keys.size(); ++i) {
         const auto& content = contents.FindContent(keys[i]);
@@ -300,22 +349,42 @@ bool ProcessorFilterNative::IsMatched(const LogEvent& contents, const LogFilterR
             return false;
         }
         if (!BoostRegexMatch(content->second.data(), content->second.size(), regs[i], exception)) {
-            if (!exception.empty()) {
-                LOG_ERROR(GetContext().GetLogger(), ("regex_match in Filter fail", exception));
-                if (GetContext().GetAlarm().IsLowLevelAlarmValid()) {
-                    GetContext().GetAlarm().SendAlarm(REGEX_MATCH_ALARM,
-                                                      "regex_match in Filter fail:" + exception,
-                                                      GetContext().GetProjectName(),
-                                                      GetContext().GetLogstoreName(),
-                                                      GetContext().GetRegion());
-                }
-            }
+            SendRegexMatchAlarm(exception);
+            return false;
+        }
+    }
+    return true;
+}
+
+bool ProcessorFilterNative::IsMatchedByRegexSets(const LogEvent& contents, const LogFilterRule& rule) {
+    std::string exception;
+    for (const auto& item : rule.KeyRegexSets) {
+        const auto& content = contents.FindContent(item.first);
+        if (content == contents.end()) {
+            return false;
+        }
+        if (!item.second->MatchAll(content->second.data(), content->second.size(), exception)) {
+            SendRegexMatchAlarm(exception);
             return false;
         }
     }
     return true;
 }
 
+void ProcessorFilterNative::SendRegexMatchAlarm(const std::string& exception) {
+    if (exception.empty()) {
+        return;
+    }
+    LOG_ERROR(GetContext().GetLogger(), ("regex_match in Filter fail", exception));
+    if (GetContext().GetAlarm().IsLowLevelAlarmValid()) {
+        GetContext().GetAlarm().SendAlarm(REGEX_MATCH_ALARM,
+                                          "regex_match in Filter fail:" + exception,
+                                          GetContext().GetProjectName(),
+                                          GetContext().GetLogstoreName(),
+                                          GetContext().GetRegion());
+    }
+}
+
 static const char UTF8_BYTE_PREFIX = 0x80;
 static const char UTF8_BYTE_MASK = 0xc0;
 
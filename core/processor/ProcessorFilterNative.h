@@ -18,6 +18,7 @@
 
 #include "app_config/AppConfig.h"
 #include "common/LogGroupContext.h"
+#include "common/RegexSet.h"
 #include "models/LogEvent.h"
 #include "plugin/interface/Processor.h"
 
@@ -127,6 +128,8 @@ private:
     struct LogFilterRule {
         std::vector<std::string> FilterKeys;
         std::vector<boost::regex> FilterRegs;
+        // for RE2 engine only, all the regexes of a key are evaluated in one pass
+        std::vector<std::pair<std::string, std::shared_ptr<RegexSet>>> KeyRegexSets;
     };
 
     bool ProcessEvent(PipelineEventPtr& e);
@@ -137,12 +140,15 @@ private:
     // Filter logs through FilterRule
     bool FilterFilterRule(LogEvent& sourceEvent, const LogFilterRule* filterRule);
     bool IsMatched(const LogEvent& contents, const LogFilterRule& rule);
+    bool IsMatchedByRegexSets(const LogEvent& contents, const LogFilterRule& rule);
+    void SendRegexMatchAlarm(const std::string& exception);
 
     bool noneUtf8(StringView& strSrc, bool modify);
     bool CheckNoneUtf8(const StringView& strSrc);
     void FilterNoneUtf8(std::string& strSrc);
 
     Mode mFilterMode = Mode::BYPASS_MODE;
+    RegexEngine mRegexEngine = RegexEngine::BOOST;
 
     std::shared_ptr<LogFilterRule> mFilterRule;
 
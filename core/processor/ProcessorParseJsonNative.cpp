@@ -16,6 +16,11 @@
 
 #include "processor/ProcessorParseJsonNative.h"
 
+#include <cstring>
+#include <vector>
+
+#include <rapidjson/memorystream.h>
+#include <rapidjson/reader.h>
 #include <rapidjson/stringbuffer.h>
 #include <rapidjson/writer.h>
 
@@ -28,6 +33,114 @@ namespace logtail {
 
 const std::string ProcessorParseJsonNative::sName = "processor_parse_json_native";
 
+// Fields of the root object are collected as views of the source buffer, so that nothing is added to the event
+// unless the whole line is parsed successfully. Strings without escapes are referenced in the original line directly,
+// and only unescaped strings, numbers and nested objects or arrays, which are serialized in compact form as before,
+// are copied into the source buffer once.
+class ProcessorParseJsonNative::JsonFieldCollector
+    : public rapidjson::BaseReaderHandler<rapidjson::UTF8<>, JsonFieldCollector> {
+public:
+    JsonFieldCollector() : mWriter(mNestedBuffer) {}
+
+    rapidjson::ParseResult Parse(StringView line, SourceBuffer* sourceBuffer) {
+        // the reader calls back with the stream in place, so that strings can be located in the line
+        rapidjson::MemoryStream stream(line.data(), line.size());
+        mLine = line;
+        mStream = &stream;
+        mSourceBuffer = sourceBuffer;
+        mDepth = 0;
+        mIsObject = false;
+        mFields.clear();
+        return mReader.Parse<rapidjson::kParseDefaultFlags>(stream, *this);
+    }
+
+    bool IsObject() const { return mIsObject; }
+    const std::vector<std::pair<StringView, StringView>>& GetFields() const { return mFields; }
+
+    bool Null() { return InNested() ? mWriter.Null() : AddValue(StringView("")); }
+    bool Bool(bool b) { return InNested() ? mWriter.Bool(b) : AddValue(b ? StringView("true") : StringView("false")); }
+    bool Int(int i) { return InNested() ? mWriter.Int(i) : AddValue(Copy(ToString(i))); }
+    bool Uint(unsigned u) { return InNested() ? mWriter.Uint(u) : AddValue(Copy(ToString(u))); }
+    bool Int64(int64_t i) { return InNested() ? mWriter.Int64(i) : AddValue(Copy(ToString(i))); }
+    bool Uint64(uint64_t u) { return InNested() ? mWriter.Uint64(u) : AddValue(Copy(ToString(u))); }
+    bool Double(double d) { return InNested() ? mWriter.Double(d) : AddValue(Copy(ToString(d))); }
+    bool String(const char* str, rapidjson::SizeType len, bool) {
+        return InNested() ? mWriter.String(str, len, true) : AddValue(ViewOrCopy(str, len));
+    }
+    bool Key(const char* str, rapidjson::SizeType len, bool) {
+        if (InNested()) {
+            return mWriter.Key(str, len, true);
+        }
+        mKey = ViewOrCopy(str, len);
+        return true;
+    }
+    bool StartObject() {
+        if (mDepth == 0) {
+            ++mDepth;
+            mIsObject = true;
+            return true;
+        }
+        return !EnterValue() || mWriter.StartObject();
+    }
+    bool EndObject(rapidjson::SizeType cnt) { return (!InNested() || mWriter.EndObject(cnt)) && LeaveValue(); }
+    bool StartArray() { return !EnterValue() || mWriter.StartArray(); }
+    bool EndArray(rapidjson::SizeType cnt) { return (!InNested() || mWriter.EndArray(cnt)) && LeaveValue(); }
+
+private:
+    // values of non-object roots are parsed only to tell invalid json from a valid non-object one
+    bool InNested() const { return mIsObject && mDepth > 1; }
+
+    // returns whether the object or array entered should be serialized
+    bool EnterValue() {
+        if (++mDepth == 2 && mIsObject) {
+            mNestedBuffer.Clear();
+            mWriter.Reset(mNestedBuffer);
+        }
+        return InNested();
+    }
+
+    bool LeaveValue() {
+        if (--mDepth == 1 && mIsObject) {
+            return AddValue(Copy(StringView(mNestedBuffer.GetString(), mNestedBuffer.GetSize())));
+        }
+        return true;
+    }
+
+    bool AddValue(StringView value) {
+        if (mIsObject && mDepth == 1) {
+            mFields.emplace_back(mKey, value);
+        }
+        return true;
+    }
+
+    StringView Copy(StringView str) {
+        StringBuffer buffer = mSourceBuffer->CopyString(str);
+        return StringView(buffer.data, buffer.size);
+    }
+
+    // The reader has just consumed the closing quote of the string. If the span of the unescaped length before the
+    // quote is preceded by a quote and contains no backslash, the string contains no escapes and is exactly the span.
+    // The quote alone is not enough, since it may be an escaped one, e.g. "\"\n".
+    StringView ViewOrCopy(const char* str, rapidjson::SizeType len) {
+        size_t end = mStream->Tell() - 1;
+        if (end > len && mLine[end - len - 1] == '"' && memchr(mLine.data() + end - len, '\\', len) == nullptr) {
+            return StringView(mLine.data() + end - len, len);
+        }
+        return Copy(StringView(str, len));
+    }
+
+    StringView mLine;
+    const rapidjson::MemoryStream* mStream = nullptr;
+    SourceBuffer* mSourceBuffer = nullptr;
+    size_t mDepth = 0;
+    bool mIsObject = false;
+    StringView mKey;
+    std::vector<std::pair<StringView, StringView>> mFields;
+    rapidjson::Reader mReader;
+    rapidjson::StringBuffer mNestedBuffer;
+    rapidjson::Writer<rapidjson::StringBuffer> mWriter;
+};
+
 bool ProcessorParseJsonNative::Init(const Json::Value& config) {
     std::string errorMsg;
 
@@ -65,10 +178,12 @@ void ProcessorParseJsonNative::Process(PipelineEventGroup& logGroup) {
 
     const StringView& logPath = logGroup.GetMetadata(EventGroupMetaKey::LOG_FILE_PATH_RESOLVED);
     EventsContainer& events = logGroup.MutableEvents();
+    // reused by all events in the group to save allocations of the parser stacks
+    JsonFieldCollector collector;
 
     size_t wIdx = 0;
     for (size_t rIdx = 0; rIdx < events.size(); ++rIdx) {
-        if (ProcessEvent(logPath, events[rIdx])) {
+        if (ProcessEvent(logPath, events[rIdx], collector)) {
             if (wIdx != rIdx) {
                 events[wIdx] = std::move(events[rIdx]);
             }
@@ -78,7 +193,9 @@ void ProcessorParseJsonNative::Process(PipelineEventGroup& logGroup) {
     events.resize(wIdx);
 }
 
-bool ProcessorParseJsonNative::ProcessEvent(const StringView& logPath, PipelineEventPtr& e) {
+bool ProcessorParseJsonNative::ProcessEvent(const StringView& logPath,
+                                            PipelineEventPtr& e,
+                                            JsonFieldCollector& collector) {
     if (!IsSupportedEvent(e)) {
         return true;
     }
@@ -90,7 +207,7 @@ bool ProcessorParseJsonNative::ProcessEvent(const StringView& logPath, PipelineE
     auto rawContent = sourceEvent.GetContent(mSourceKey);
 
     bool sourceKeyOverwritten = false;
-    bool parseSuccess = JsonLogLineParser(sourceEvent, logPath, e, sourceKeyOverwritten);
+    bool parseSuccess = JsonLogLineParser(sourceEvent, logPath, e, sourceKeyOverwritten, collector);
 
     if (!parseSuccess || !sourceKeyOverwritten) {
         sourceEvent.DelContent(mSourceKey);
@@ -111,7 +228,8 @@ bool ProcessorParseJsonNative::ProcessEvent(const StringView& logPath, PipelineE
 bool ProcessorParseJsonNative::JsonLogLineParser(LogEvent& sourceEvent,
                                                  const StringView& logPath,
                                                  PipelineEventPtr& e,
-                                                 bool& sourceKeyOverwritten) {
+                                                 bool& sourceKeyOverwritten,
+                                                 JsonFieldCollector& collector) {
     StringView buffer = sourceEvent.GetContent(mSourceKey);
 
     if (buffer.empty())
@@ -120,13 +238,12 @@ bool ProcessorParseJsonNative::JsonLogLineParser(LogEvent& sourceEvent,
     mProcParseInSizeBytes->Add(buffer.size());
 
     bool parseSuccess = true;
-    rapidjson::Document doc;
-    doc.Parse(buffer.data(), buffer.size());
-    if (doc.HasParseError()) {
+    rapidjson::ParseResult res = collector.Parse(buffer, sourceEvent.GetSourceBuffer().get());
+    if (res.IsError()) {
         if (LogtailAlarm::GetInstance()->IsLowLevelAlarmValid()) {
             LOG_WARNING(sLogger,
-                        ("parse json log fail, log", buffer)("rapidjson offset", doc.GetErrorOffset())(
-                            "rapidjson error", doc.GetParseError())("project", GetContext().GetProjectName())(
+                        ("parse json log fail, log", buffer)("rapidjson offset", res.Offset())(
+                            "rapidjson error", res.Code())("project", GetContext().GetProjectName())(
                             "logstore", GetContext().GetLogstoreName())("file", logPath));
             LogtailAlarm::GetInstance()->SendAlarm(PARSE_LOG_FAIL_ALARM,
                                                    std::string("parse json fail:") + buffer.to_string(),
@@ -137,7 +254,7 @@ bool ProcessorParseJsonNative::JsonLogLineParser(LogEvent& sourceEvent,
         ++(*mParseFailures);
         mProcParseErrorTotal->Add(1);
         parseSuccess = false;
-    } else if (!doc.IsObject()) {
+    } else if (!collector.IsObject()) {
         if (LogtailAlarm::GetInstance()->IsLowLevelAlarmValid()) {
             LOG_WARNING(sLogger,
                         ("invalid json object, log", buffer)("project", GetContext().GetProjectName())(
@@ -156,50 +273,15 @@ bool ProcessorParseJsonNative::JsonLogLineParser(LogEvent& sourceEvent,
         return false;
     }
 
-    for (rapidjson::Value::ConstMemberIterator itr = doc.MemberBegin(); itr != doc.MemberEnd(); ++itr) {
-        std::string contentKey = RapidjsonValueToString(itr->name);
-        std::string contentValue = RapidjsonValueToString(itr->value);
-
-        StringBuffer contentKeyBuffer = sourceEvent.GetSourceBuffer()->CopyString(contentKey);
-        StringBuffer contentValueBuffer = sourceEvent.GetSourceBuffer()->CopyString(contentValue);
-
-        if (contentKey.c_str() == mSourceKey) {
+    for (const auto& field : collector.GetFields()) {
+        if (field.first == mSourceKey) {
             sourceKeyOverwritten = true;
         }
-
-        AddLog(StringView(contentKeyBuffer.data, contentKeyBuffer.size),
-               StringView(contentValueBuffer.data, contentValueBuffer.size),
-               sourceEvent);
+        AddLog(field.first, field.second, sourceEvent);
     }
     return true;
 }
 
-std::string ProcessorParseJsonNative::RapidjsonValueToString(const rapidjson::Value& value) {
-    if (value.IsString())
-        return value.GetString();
-    else if (value.IsBool())
-        return ToString(value.GetBool());
-    else if (value.IsInt())
-        return ToString(value.GetInt());
-    else if (value.IsUint())
-        return ToString(value.GetUint());
-    else if (value.IsInt64())
-        return ToString(value.GetInt64());
-    else if (value.IsUint64())
-        return ToString(value.GetUint64());
-    else if (value.IsDouble())
-        return ToString(value.GetDouble());
-    else if (value.IsNull())
-        return "";
-    else // if (value.IsObject() || value.IsArray())
-    {
-        rapidjson::StringBuffer buffer;
-        rapidjson::Writer<rapidjson::StringBuffer> writer(buffer);
-        value.Accept(writer);
-        return buffer.GetString();
-    }
-}
-
 void ProcessorParseJsonNative::AddLog(const StringView& key,
                                       const StringView& value,
                                       LogEvent& targetEvent,
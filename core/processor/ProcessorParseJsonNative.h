@@ -15,8 +15,6 @@
  */
 #pragma once
 
-#include <rapidjson/document.h>
-
 #include "models/LogEvent.h"
 #include "plugin/interface/Processor.h"
 #include "processor/CommonParserOptions.h"
@@ -39,10 +37,16 @@ protected:
     bool IsSupportedEvent(const PipelineEventPtr& e) const override;
 
 private:
-    bool JsonLogLineParser(LogEvent& sourceEvent, const StringView& logPath, PipelineEventPtr& e, bool& sourceKeyOverwritten);
+    // SAX handler collecting top level fields of a json object without building a DOM
+    class JsonFieldCollector;
+
+    bool JsonLogLineParser(LogEvent& sourceEvent,
+                           const StringView& logPath,
+                           PipelineEventPtr& e,
+                           bool& sourceKeyOverwritten,
+                           JsonFieldCollector& collector);
     void AddLog(const StringView& key, const StringView& value, LogEvent& targetEvent, bool overwritten = true);
-    bool ProcessEvent(const StringView& logPath, PipelineEventPtr& e);
-    static std::string RapidjsonValueToString(const rapidjson::Value& value);
+    bool ProcessEvent(const StringView& logPath, PipelineEventPtr& e, JsonFieldCollector& collector);
 
     int* mParseFailures = nullptr;
     int* mLogGroupSize = nullptr;
@@ -62,6 +62,34 @@ bool ProcessorParseRegexNative::Init(const Json::Value& config) {
     mReg = boost::regex(mRegex);
     mIsWholeLineMode = mRegex == "(.*)";
 
+    // RegexEngine
+    if (!GetOptionalRegexEngineParam(config, "RegexEngine", mRegexEngine, errorMsg)) {
+        PARAM_WARNING_DEFAULT(mContext->GetLogger(),
+                              mContext->GetAlarm(),
+                              errorMsg,
+                              "boost",
+                              sName,
+                              mContext->GetConfigName(),
+                              mContext->GetProjectName(),
+                              mContext->GetLogstoreName(),
+                              mContext->GetRegion());
+    }
+    if (mRegexEngine == RegexEngine::RE2 && !mIsWholeLineMode) {
+        mRE2.reset(new RE2(ToBoostCompatibleRE2Pattern(mRegex), GetBoostCompatibleRE2Options()));
+        if (!mRE2->ok()) {
+            mRE2.reset();
+            PARAM_WARNING_DEFAULT(mContext->GetLogger(),
+                                  mContext->GetAlarm(),
+                                  "mandatory string param Regex is not supported by re2 engine",
+                                  "boost",
+                                  sName,
+                                  mContext->GetConfigName(),
+                                  mContext->GetProjectName(),
+                                  mContext->GetLogstoreName(),
+                                  mContext->GetRegion());
+        }
+    }
+
     // Keys
     if (!GetMandatoryListParam(config, "Keys", mKeys, errorMsg)) {
         PARAM_ERROR_RETURN(mContext->GetLogger(),
@@ -185,12 +213,28 @@ bool ProcessorParseRegexNative::RegexLogLineParser(LogEvent& sourceEvent,
                                                    const boost::regex& reg,
                                                    const std::vector<std::string>& keys,
                                                    const StringView& logPath) {
+    static thread_local std::vector<re2::StringPiece> sRE2Groups;
     boost::match_results<const char*> what;
     std::string exception;
     StringView buffer = sourceEvent.GetContent(mSourceKey);
     bool parseSuccess = true;
     mProcParseInSizeBytes->Add(buffer.size());
-    if (!BoostRegexMatch(buffer.data(), buffer.size(), reg, exception, what, boost::match_default)) {
+    bool matched = false;
+    size_t groupCount = 0;
+    if (mRE2) {
+        sRE2Groups.resize(1 + mRE2->NumberOfCapturingGroups());
+        matched = mRE2->Match(re2::StringPiece(buffer.data(), buffer.size()),
+                              0,
+                              buffer.size(),
+                              RE2::ANCHOR_BOTH,
+                              sRE2Groups.data(),
+                              static_cast<int>(sRE2Groups.size()));
+        groupCount = sRE2Groups.size();
+    } else {
+        matched = BoostRegexMatch(buffer.data(), buffer.size(), reg, exception, what, boost::match_default);
+        groupCount = what.size();
+    }
+    if (!matched) {
         if (!exception.empty()) {
             if (AppConfig::GetInstance()->IsLogParseAlarmValid()) {
                 if (GetContext().GetAlarm().IsLowLevelAlarmValid()) {
@@ -223,16 +267,16 @@ bool ProcessorParseRegexNative::RegexLogLineParser(LogEvent& sourceEvent,
         ++(*mParseFailures);
         mProcParseErrorTotal->Add(1);
         parseSuccess = false;
-    } else if (what.size() <= keys.size()) {
+    } else if (groupCount <= keys.size()) {
         if (AppConfig::GetInstance()->IsLogParseAlarmValid()) {
             if (GetContext().GetAlarm().IsLowLevelAlarmValid()) {
                 LOG_WARNING(GetContext().GetLogger(),
                             ("parse key count not match",
-                             what.size())("parse regex log fail", buffer)("project", GetContext().GetProjectName())(
+                             groupCount)("parse regex log fail", buffer)("project", GetContext().GetProjectName())(
                                 "logstore", GetContext().GetLogstoreName())("file", logPath));
             }
             GetContext().GetAlarm().SendAlarm(REGEX_MATCH_ALARM,
-                                              "parse key count not match" + ToString(what.size())
+                                              "parse key count not match" + ToString(groupCount)
                                                   + "errorlog:" + buffer.to_string(),
                                               GetContext().GetProjectName(),
                                               GetContext().GetLogstoreName(),
@@ -248,7 +292,11 @@ bool ProcessorParseRegexNative::RegexLogLineParser(LogEvent& sourceEvent,
     }
 
     for (uint32_t i = 0; i < keys.size(); i++) {
-        AddLog(keys[i], StringView(what[i + 1].begin(), what[i + 1].length()), sourceEvent);
+        if (mRE2) {
+            AddLog(keys[i], StringView(sRE2Groups[i + 1].data(), sRE2Groups[i + 1].size()), sourceEvent);
+        } else {
+            AddLog(keys[i], StringView(what[i + 1].begin(), what[i + 1].length()), sourceEvent);
+        }
     }
     return true;
 }
@@ -16,10 +16,13 @@
 
 #pragma once
 
-#include <boost/regex.hpp>
+#include <re2/re2.h>
 
+#include <boost/regex.hpp>
+#include <memory>
 #include <vector>
 
+#include "common/RegexSet.h"
 #include "models/LogEvent.h"
 #include "plugin/interface/Processor.h"
 #include "processor/CommonParserOptions.h"
@@ -40,6 +43,7 @@ public:
     std::string mRegex;
     // Extracted field list.
     std::vector<std::string> mKeys;
+    RegexEngine mRegexEngine = RegexEngine::BOOST;
     CommonParserOptions mCommonParserOptions;
 
 protected:
@@ -58,6 +62,8 @@ private:
     bool mSourceKeyOverwritten = false;
     bool mIsWholeLineMode = false;
     boost::regex mReg;
+    // for RE2 engine only, null if the regex is not supported by RE2
+    std::unique_ptr<RE2> mRE2;
 
     int* mParseFailures = nullptr;
     int* mRegexMatchFailures = nullptr;
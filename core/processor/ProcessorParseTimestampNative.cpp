@@ -87,6 +87,12 @@ bool ProcessorParseTimestampNative::Init(const Json::Value& config) {
                               mContext->GetRegion());
     }
 
+    if (!mTimeFormatParser.Compile(mSourceFormat, mSourceYear)) {
+        LOG_INFO(mContext->GetLogger(),
+                 ("time format cannot be compiled, fall back to strptime", mSourceFormat)(
+                     "config", mContext->GetConfigName()));
+    }
+
     mParseTimeFailures = &(GetContext().GetProcessProfile().parseTimeFailures);
     mHistoryFailures = &(GetContext().GetProcessProfile().historyFailures);
 
@@ -183,13 +189,20 @@ bool ProcessorParseTimestampNative::ParseLogTime(const StringView& curTimeStr, /
                                                  uint64_t& preciseTimestamp,
                                                  StringView& timeStrCache // cache
 ) {
+    int nanosecondLength = -1;
+    if (mTimeFormatParser.Parse(curTimeStr, logTime, nanosecondLength)) {
+        logTime.tv_sec = logTime.tv_sec - mLogTimeZoneOffsetSecond;
+        // logTime no longer matches the cached prefix
+        timeStrCache = StringView();
+        return true;
+    }
+
     // Second-level cache only work when:
     // 1. No %f in the time format
     // 2. The %f is at the end of the time format
     const char* compareResult = strstr(mSourceFormat.c_str(), "%f");
     bool haveNanosecond = compareResult != nullptr;
     bool endWithNanosecond = compareResult == (mSourceFormat.c_str() + mSourceFormat.size() - 2);
-    int nanosecondLength = -1;
     const char* strptimeResult = NULL;
     if ((!haveNanosecond || endWithNanosecond) && IsPrefixString(curTimeStr, timeStrCache)) {
         bool isTimestampNanosecond = (mSourceFormat == "%s") && (curTimeStr.length() > timeStrCache.length());
@@ -16,6 +16,7 @@
 
 #pragma once
 
+#include "common/TimeFormatParser.h"
 #include "common/TimeUtil.h"
 #include "plugin/interface/Processor.h"
 
@@ -52,6 +53,8 @@ private:
     bool IsPrefixString(const StringView& all, const StringView& prefix);
 
     int32_t mLogTimeZoneOffsetSecond = 0;
+    // fast path for mSourceFormat, Strptime is used only when it fails
+    TimeFormatParser mTimeFormatParser;
 
     int* mParseTimeFailures = nullptr;
     int* mHistoryFailures = nullptr;
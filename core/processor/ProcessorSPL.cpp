@@ -132,13 +132,19 @@ void ProcessorSPL::Process(PipelineEventGroup& logGroup) {
 
 
 void ProcessorSPL::Process(std::vector<PipelineEventGroup>& logGroupList) {
-    std::string errorMsg;
     if (logGroupList.empty()) {
         return;
     }
-    PipelineEventGroup logGroup = std::move(logGroupList[0]);
-    std::vector<PipelineEventGroup>().swap(logGroupList);
+    // groups of the same config may be processed in a batch, and the outputs of each group are appended in order
+    std::vector<PipelineEventGroup> inputGroupList;
+    inputGroupList.swap(logGroupList);
+    for (auto& logGroup : inputGroupList) {
+        ProcessEventGroup(logGroup, logGroupList);
+    }
+}
 
+void ProcessorSPL::ProcessEventGroup(PipelineEventGroup& logGroup, std::vector<PipelineEventGroup>& logGroupList) {
+    std::string errorMsg;
     std::vector<std::string> colNames{FIELD_CONTENT};
     // 根据spip->getInputSearches()，设置input数组
     std::vector<Input*> inputs;
@@ -43,6 +43,8 @@ protected:
     bool IsSupportedEvent(const PipelineEventPtr& e) const override;
 
 private:
+    void ProcessEventGroup(PipelineEventGroup& logGroup, std::vector<PipelineEventGroup>& logGroupList);
+
     std::shared_ptr<apsara::sls::spl::SplPipeline> mSPLPipelinePtr;
 
     CounterPtr mSplExcuteErrorCount;
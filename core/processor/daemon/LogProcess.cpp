@@ -33,6 +33,7 @@
 #include "config/IntegrityConfig.h"
 #include "config_manager/ConfigManager.h"
 #include "fuse/FuseFileBlacklist.h"
+#include "go_pipeline/LogGroupColumns.h"
 #include "go_pipeline/LogtailPlugin.h"
 #include "log_pb/sls_logs.pb.h"
 #include "logger/Logger.h"
@@ -70,6 +71,13 @@ DEFINE_FLAG_BOOL(enable_chinese_tag_path, "Enable Chinese __tag__.__path__", tru
 DEFINE_FLAG_STRING(raw_log_tag, "", "__raw__");
 DEFINE_FLAG_INT32(default_flush_merged_buffer_interval, "default flush merged buffer, seconds", 1);
 DEFINE_FLAG_BOOL(enable_new_pipeline, "use C++ pipline with refactoried plugins", true);
+DEFINE_FLAG_INT32(process_batch_max_count,
+                  "max number of event groups of the same config processed in one round, 1 disables batching",
+                  16);
+DEFINE_FLAG_INT32(process_batch_max_bytes, "max bytes of event groups processed in one round", 1024 * 1024);
+DEFINE_FLAG_BOOL(enable_go_log_group_columns,
+                 "pass event groups flushed through go pipeline as columns instead of protobuf, if supported",
+                 true);
 
 namespace logtail {
 
@@ -157,6 +165,11 @@ void LogProcess::Resume() {
     LOG_INFO(sLogger, ("process daemon resume", "succeeded"));
 }
 
+void LogProcess::WaitForPoppedItems() {
+    // event groups are popped and processed with the read lock held
+    WriteLock lock(mAccessProcessThreadRWL);
+}
+
 bool LogProcess::FlushOut(int32_t waitMs) {
     ProcessQueueManager::GetInstance()->Trigger();
     if (ProcessQueueManager::GetInstance()->IsAllQueueEmpty()) {
@@ -232,9 +245,13 @@ void* LogProcess::ProcessLoop(int32_t threadNo) {
         {
             ReadLock lock(mAccessProcessThreadRWL);
 
-            std::unique_ptr<ProcessQueueItem> item;
+            std::vector<std::unique_ptr<ProcessQueueItem>> items;
             std::string configName;
-            if (!ProcessQueueManager::GetInstance()->PopItem(threadNo, item, configName)) {
+            if (!ProcessQueueManager::GetInstance()->PopItems(threadNo,
+                                                              INT32_FLAG(process_batch_max_count),
+                                                              INT32_FLAG(process_batch_max_bytes),
+                                                              items,
+                                                              configName)) {
                 ProcessQueueManager::GetInstance()->Wait(100);
                 continue;
             }
@@ -244,134 +261,158 @@ void* LogProcess::ProcessLoop(int32_t threadNo) {
             if (!pipeline) {
                 LOG_INFO(sLogger,
                          ("pipeline not found during processing, perhaps due to config deletion",
-                          "discard data")("config", configName));
+                          "discard data")("config", configName)("event groups", items.size()));
                 continue;
             }
 
-            // record profile, must be placed here since readbytes info exists only before processing
-            auto& processProfile = pipeline->GetContext().GetProcessProfile();
-            ProcessProfile profile = processProfile;
-            bool isLog = false;
-            if (!item->mEventGroup.GetEvents().empty() && item->mEventGroup.GetEvents()[0].Is<LogEvent>()) {
-                isLog = true;
-                profile.readBytes = item->mEventGroup.GetEvents()[0].Cast<LogEvent>().GetPosition().second
-                    + 1; // may not be accurate if input is not utf8
-            }
-            processProfile.Reset();
-
-            int32_t startTime = (int32_t)time(NULL);
-            std::vector<PipelineEventGroup> eventGroupList;
-            eventGroupList.emplace_back(std::move(item->mEventGroup));
-            pipeline->Process(eventGroupList);
-            int32_t elapsedTime = (int32_t)time(NULL) - startTime;
-            if (elapsedTime > 1) {
-                LogtailAlarm::GetInstance()->SendAlarm(PROCESS_TOO_SLOW_ALARM,
-                                                       string("event processing took too long, elapsed time: ")
-                                                           + ToString(elapsedTime) + "s\tconfig: " + pipeline->Name(),
-                                                       pipeline->GetContext().GetProjectName(),
-                                                       pipeline->GetContext().GetLogstoreName(),
-                                                       pipeline->GetContext().GetRegion());
-                LOG_WARNING(sLogger,
-                            ("event processing took too long, elapsed time",
-                             ToString(elapsedTime) + "s")("config", pipeline->Name()));
+            // event groups of the same source are processed together, while those of different sources are kept apart,
+            // since profiling data is recorded per file
+            std::vector<std::pair<std::string, std::vector<PipelineEventGroup>>> batches;
+            for (auto& item : items) {
+                std::string sourceId = item->mEventGroup.GetMetadata(EventGroupMetaKey::SOURCE_ID).to_string();
+                auto iter = find_if(batches.begin(), batches.end(), [&sourceId](const auto& batch) {
+                    return batch.first == sourceId;
+                });
+                if (iter == batches.end()) {
+                    batches.emplace_back(std::move(sourceId), std::vector<PipelineEventGroup>());
+                    iter = prev(batches.end());
+                }
+                iter->second.emplace_back(std::move(item->mEventGroup));
             }
+            items.clear();
+
+            for (auto& batch : batches) {
+                auto& eventGroupList = batch.second;
+                // record profile, must be placed here since readbytes info exists only before processing
+                auto& processProfile = pipeline->GetContext().GetProcessProfile();
+                ProcessProfile profile = processProfile;
+                bool isLog = false;
+                for (const auto& eventGroup : eventGroupList) {
+                    if (!eventGroup.GetEvents().empty() && eventGroup.GetEvents()[0].Is<LogEvent>()) {
+                        isLog = true;
+                        profile.readBytes += eventGroup.GetEvents()[0].Cast<LogEvent>().GetPosition().second
+                            + 1; // may not be accurate if input is not utf8
+                    }
+                }
+                processProfile.Reset();
+
+                int32_t startTime = (int32_t)time(NULL);
+                pipeline->Process(eventGroupList);
+                int32_t elapsedTime = (int32_t)time(NULL) - startTime;
+                if (elapsedTime > 1) {
+                    LogtailAlarm::GetInstance()->SendAlarm(PROCESS_TOO_SLOW_ALARM,
+                                                           string("event processing took too long, elapsed time: ")
+                                                               + ToString(elapsedTime)
+                                                               + "s\tconfig: " + pipeline->Name(),
+                                                           pipeline->GetContext().GetProjectName(),
+                                                           pipeline->GetContext().GetLogstoreName(),
+                                                           pipeline->GetContext().GetRegion());
+                    LOG_WARNING(sLogger,
+                                ("event processing took too long, elapsed time",
+                                 ToString(elapsedTime) + "s")("config", pipeline->Name()));
+                }
 
-            s_processCount++;
-            if (isLog) {
-                s_processBytes += profile.readBytes;
-                s_processLines += profile.splitLines;
-            }
+                s_processCount += eventGroupList.size();
+                if (isLog) {
+                    s_processBytes += profile.readBytes;
+                    s_processLines += profile.splitLines;
+                }
 
-            // send part
-            std::vector<std::unique_ptr<sls_logs::LogGroup>> logGroupList;
-            bool needSend = ProcessBuffer(pipeline, eventGroupList, logGroupList);
+                // send part
+                std::vector<std::unique_ptr<SerializedLogGroup>> logGroupList;
+                bool needSend = ProcessBuffer(pipeline, eventGroupList, logGroupList);
 
-            int logSize = 0;
-            for (auto& pLogGroup : logGroupList) {
-                logSize += pLogGroup->logs_size();
-            }
-            if (logSize > 0 && needSend) { // send log group
-                const FlusherSLS* flusherSLS = static_cast<const FlusherSLS*>(pipeline->GetFlushers()[0]->GetPlugin());
-
-                string compressStr = "zstd";
-                if (flusherSLS->mCompressType == FlusherSLS::CompressType::NONE) {
-                    compressStr = "none";
-                } else if (flusherSLS->mCompressType == FlusherSLS::CompressType::LZ4) {
-                    compressStr = "lz4";
+                int logSize = 0;
+                for (auto& pLogGroup : logGroupList) {
+                    logSize += pLogGroup->logs_size();
                 }
-                sls_logs::SlsCompressType compressType = sdk::Client::GetCompressType(compressStr);
-
-                const std::string& projectName = pipeline->GetContext().GetProjectName();
-                const std::string& category = pipeline->GetContext().GetLogstoreName();
-                string convertedPath = eventGroupList[0].GetMetadata(EventGroupMetaKey::LOG_FILE_PATH).to_string();
-                string hostLogPath
-                    = eventGroupList[0].GetMetadata(EventGroupMetaKey::LOG_FILE_PATH_RESOLVED).to_string();
+                if (logSize > 0 && needSend) { // send log group
+                    const FlusherSLS* flusherSLS
+                        = static_cast<const FlusherSLS*>(pipeline->GetFlushers()[0]->GetPlugin());
+
+                    string compressStr = "zstd";
+                    if (flusherSLS->mCompressType == FlusherSLS::CompressType::NONE) {
+                        compressStr = "none";
+                    } else if (flusherSLS->mCompressType == FlusherSLS::CompressType::LZ4) {
+                        compressStr = "lz4";
+                    }
+                    sls_logs::SlsCompressType compressType = sdk::Client::GetCompressType(compressStr);
+
+                    const std::string& projectName = pipeline->GetContext().GetProjectName();
+                    const std::string& category = pipeline->GetContext().GetLogstoreName();
+                    string convertedPath
+                        = eventGroupList[0].GetMetadata(EventGroupMetaKey::LOG_FILE_PATH).to_string();
+                    string hostLogPath
+                        = eventGroupList[0].GetMetadata(EventGroupMetaKey::LOG_FILE_PATH_RESOLVED).to_string();
 #if defined(_MSC_VER)
-                if (BOOL_FLAG(enable_chinese_tag_path)) {
-                    convertedPath = EncodingConverter::GetInstance()->FromACPToUTF8(convertedPath);
-                    hostLogPath = EncodingConverter::GetInstance()->FromACPToUTF8(hostLogPath);
-                }
+                    if (BOOL_FLAG(enable_chinese_tag_path)) {
+                        convertedPath = EncodingConverter::GetInstance()->FromACPToUTF8(convertedPath);
+                        hostLogPath = EncodingConverter::GetInstance()->FromACPToUTF8(hostLogPath);
+                    }
 #endif
 
-                for (auto& pLogGroup : logGroupList) {
-                    LogGroupContext context(flusherSLS->mRegion,
-                                            projectName,
-                                            flusherSLS->mLogstore,
-                                            compressType,
-                                            FileInfoPtr(),
-                                            IntegrityConfigPtr(),
-                                            LineCountConfigPtr(),
-                                            -1,
-                                            false,
-                                            false,
-                                            eventGroupList[0].GetExactlyOnceCheckpoint());
-                    if (!Sender::Instance()->Send(
-                            projectName,
-                            eventGroupList[0].GetMetadata(EventGroupMetaKey::SOURCE_ID).to_string(),
-                            *(pLogGroup.get()),
-                            std::stol(eventGroupList[0].GetMetadata(EventGroupMetaKey::LOGGROUP_KEY).to_string()),
-                            flusherSLS,
-                            flusherSLS->mBatch.mMergeType,
-                            (uint32_t)(profile.logGroupSize * DOUBLE_FLAG(loggroup_bytes_inflation)),
-                            "",
-                            convertedPath,
-                            context)) {
-                        LogtailAlarm::GetInstance()->SendAlarm(DISCARD_DATA_ALARM,
-                                                               "push file data into batch map fail",
-                                                               projectName,
-                                                               category,
-                                                               pipeline->GetContext().GetRegion());
-                        LOG_ERROR(sLogger,
-                                  ("push file data into batch map fail, discard logs", pLogGroup->logs_size())(
-                                      "project", projectName)("logstore", category)("filename", convertedPath));
+                    // each log group is serialized from the event group at the same position
+                    for (size_t i = 0; i < logGroupList.size(); ++i) {
+                        auto& pLogGroup = logGroupList[i];
+                        LogGroupContext context(flusherSLS->mRegion,
+                                                projectName,
+                                                flusherSLS->mLogstore,
+                                                compressType,
+                                                FileInfoPtr(),
+                                                IntegrityConfigPtr(),
+                                                LineCountConfigPtr(),
+                                                -1,
+                                                false,
+                                                false,
+                                                eventGroupList[i].GetExactlyOnceCheckpoint());
+                        if (!Sender::Instance()->Send(
+                                projectName,
+                                eventGroupList[i].GetMetadata(EventGroupMetaKey::SOURCE_ID).to_string(),
+                                *(pLogGroup.get()),
+                                std::stol(eventGroupList[i].GetMetadata(EventGroupMetaKey::LOGGROUP_KEY).to_string()),
+                                flusherSLS,
+                                flusherSLS->mBatch.mMergeType,
+                                (uint32_t)(profile.logGroupSize * DOUBLE_FLAG(loggroup_bytes_inflation)),
+                                "",
+                                convertedPath,
+                                context)) {
+                            LogtailAlarm::GetInstance()->SendAlarm(DISCARD_DATA_ALARM,
+                                                                   "push file data into batch map fail",
+                                                                   projectName,
+                                                                   category,
+                                                                   pipeline->GetContext().GetRegion());
+                            LOG_ERROR(sLogger,
+                                      ("push file data into batch map fail, discard logs", pLogGroup->logs_size())(
+                                          "project", projectName)("logstore", category)("filename", convertedPath));
+                        }
                     }
-                }
 
-                if (isLog) {
-                    std::vector<sls_logs::LogTag> logTags;
-                    for (auto& item : logGroupList[0]->logtags()) {
-                        logTags.push_back(item);
+                    if (isLog) {
+                        std::vector<sls_logs::LogTag> logTags;
+                        for (auto& item : logGroupList[0]->mGroup.logtags()) {
+                            logTags.push_back(item);
+                        }
+                        LogFileProfiler::GetInstance()->AddProfilingData(
+                            pipeline->Name(),
+                            pipeline->GetContext().GetRegion(),
+                            projectName,
+                            category,
+                            convertedPath,
+                            hostLogPath,
+                            logTags, // warning: this is not the same as reader extra tags!
+                            profile.readBytes,
+                            profile.skipBytes,
+                            profile.splitLines,
+                            profile.parseFailures,
+                            profile.regexMatchFailures,
+                            profile.parseTimeFailures,
+                            profile.historyFailures,
+                            0,
+                            ""); // TODO: I don't think errorLine is useful
                     }
-                    LogFileProfiler::GetInstance()->AddProfilingData(
-                        pipeline->Name(),
-                        pipeline->GetContext().GetRegion(),
-                        projectName,
-                        category,
-                        convertedPath,
-                        hostLogPath,
-                        logTags, // warning: this is not the same as reader extra tags!
-                        profile.readBytes,
-                        profile.skipBytes,
-                        profile.splitLines,
-                        profile.parseFailures,
-                        profile.regexMatchFailures,
-                        profile.parseTimeFailures,
-                        profile.historyFailures,
-                        0,
-                        ""); // TODO: I don't think errorLine is useful
                 }
+                logGroupList.clear();
             }
-            logGroupList.clear();
         }
     }
     LOG_WARNING(sLogger, ("LogProcessThread", "Exit")("threadNo", threadNo));
@@ -380,25 +421,86 @@ void* LogProcess::ProcessLoop(int32_t threadNo) {
 
 bool LogProcess::ProcessBuffer(const std::shared_ptr<Pipeline>& pipeline,
                                std::vector<PipelineEventGroup>& eventGroupList,
-                               std::vector<std::unique_ptr<sls_logs::LogGroup>>& resultGroupList) {
-    for (auto& eventGroup : eventGroupList) {
-        // fill protobuf
-        resultGroupList.emplace_back(new sls_logs::LogGroup());
-        auto& resultGroup = resultGroupList.back();
-        FillLogGroupLogs(eventGroup, *resultGroup, pipeline->GetContext().GetGlobalConfig().mEnableTimestampNanosecond);
-        FillLogGroupTags(eventGroup, pipeline->GetContext().GetLogstoreName(), *resultGroup);
-        if (pipeline->IsFlushingThroughGoPipeline()) {
-            // LogGroup will be deleted outside
+                               std::vector<std::unique_ptr<SerializedLogGroup>>& resultGroupList) {
+    bool enableTimestampNanosecond = pipeline->GetContext().GetGlobalConfig().mEnableTimestampNanosecond;
+    if (pipeline->IsFlushingThroughGoPipeline()) {
+        if (BOOL_FLAG(enable_go_log_group_columns) && LogtailPlugin::GetInstance()->IsLogGroupColumnsSupported()) {
+            // all event groups of the round are passed in one call
+            static thread_local LogGroupColumns sColumns;
+            sColumns.Clear();
+            for (auto& eventGroup : eventGroupList) {
+                sColumns.Add(eventGroup, pipeline->GetContext().GetLogstoreName(), enableTimestampNanosecond);
+            }
+            LogtailPlugin::GetInstance()->ProcessLogGroupColumns(pipeline->GetContext().GetConfigName(), sColumns);
+            return false;
+        }
+        for (auto& eventGroup : eventGroupList) {
+            // fill protobuf
+            sls_logs::LogGroup resultGroup;
+            FillLogGroupLogs(eventGroup, resultGroup, enableTimestampNanosecond);
+            FillLogGroupTags(eventGroup, pipeline->GetContext().GetLogstoreName(), resultGroup);
             LogtailPlugin::GetInstance()->ProcessLogGroup(
                 pipeline->GetContext().GetConfigName(),
-                *resultGroup,
+                resultGroup,
                 eventGroup.GetMetadata(EventGroupMetaKey::SOURCE_ID).to_string());
-            return false;
         }
+        return false;
+    }
+    for (auto& eventGroup : eventGroupList) {
+        resultGroupList.emplace_back(new SerializedLogGroup());
+        SerializeEventGroup(
+            eventGroup, pipeline->GetContext().GetLogstoreName(), enableTimestampNanosecond, *resultGroupList.back());
     }
     return true;
 }
 
+void LogProcess::SerializeEventGroup(const PipelineEventGroup& eventGroup,
+                                     const std::string& logstore,
+                                     bool enableTimestampNanosecond,
+                                     SerializedLogGroup& resultGroup) const {
+    // calculate the size of each log first, so that the output buffer is allocated only once
+    const auto& events = eventGroup.GetEvents();
+    std::vector<size_t> logSizes(events.size(), 0);
+    size_t totalSize = 0;
+    for (size_t i = 0; i < events.size(); ++i) {
+        if (!events[i].Is<LogEvent>()) {
+            continue;
+        }
+        auto& logEvent = events[i].Cast<LogEvent>();
+        size_t contentsSize = 0;
+        for (const auto& kv : logEvent) {
+            contentsSize += LogGroupSerializer::CalculateContentSize(kv.first.size(), kv.second.size());
+        }
+        bool hasTimeNs = enableTimestampNanosecond && logEvent.GetTimestampNanosecond();
+        logSizes[i] = LogGroupSerializer::CalculateLogSize(logEvent.GetTimestamp(), contentsSize, hasTimeNs);
+        totalSize += LogGroupSerializer::CalculateLogFieldSize(logSizes[i]);
+    }
+
+    LogGroupSerializer serializer(resultGroup.mLogsData);
+    serializer.Reserve(totalSize);
+    resultGroup.mLogRanges.reserve(events.size());
+    resultGroup.mLogTimes.reserve(events.size());
+    for (size_t i = 0; i < events.size(); ++i) {
+        if (!events[i].Is<LogEvent>()) {
+            continue;
+        }
+        auto& logEvent = events[i].Cast<LogEvent>();
+        size_t offset = resultGroup.mLogsData.size();
+        serializer.StartToAddLog(logSizes[i]);
+        serializer.AddLogTime(logEvent.GetTimestamp());
+        for (const auto& kv : logEvent) {
+            serializer.AddLogContent(kv.first, kv.second);
+        }
+        if (enableTimestampNanosecond && logEvent.GetTimestampNanosecond()) {
+            serializer.AddLogTimeNs(logEvent.GetTimestampNanosecond().value());
+        }
+        resultGroup.mLogRanges.emplace_back(offset, resultGroup.mLogsData.size() - offset);
+        resultGroup.mLogTimes.push_back(logEvent.GetTimestamp());
+    }
+
+    FillLogGroupTags(eventGroup, logstore, resultGroup.mGroup);
+}
+
 void LogProcess::FillLogGroupLogs(const PipelineEventGroup& eventGroup,
                                   sls_logs::LogGroup& resultGroup,
                                   bool enableTimestampNanosecond) const {
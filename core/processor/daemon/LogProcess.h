@@ -25,6 +25,7 @@
 #include "common/Lock.h"
 #include "common/LogRunnable.h"
 #include "common/Thread.h"
+#include "log_pb/LogGroupSerializer.h"
 #include "log_pb/sls_logs.pb.h"
 #include "queue/FeedbackQueueKey.h"
 #include "pipeline/Pipeline.h"
@@ -54,6 +55,9 @@ public:
     void HoldOn();
 
     void Resume();
+    // wait until the event groups popped so far are processed, process threads are paused only meanwhile rather than
+    // until Resume is called
+    void WaitForPoppedItems();
 
     //
     //************************************
@@ -74,8 +78,12 @@ private:
      */
     bool ProcessBuffer(const std::shared_ptr<Pipeline>& pipeline,
                        std::vector<PipelineEventGroup>& eventGroupList,
-                       std::vector<std::unique_ptr<sls_logs::LogGroup>>& resultGroupList);
+                       std::vector<std::unique_ptr<SerializedLogGroup>>& resultGroupList);
     void DoFuseHandling();
+    void SerializeEventGroup(const PipelineEventGroup& eventGroup,
+                             const std::string& logstore,
+                             bool enableTimestampNanosecond,
+                             SerializedLogGroup& resultGroup) const;
     void FillLogGroupLogs(const PipelineEventGroup& eventGroup,
                           sls_logs::LogGroup& resultGroup,
                           bool enableTimestampNanosecond) const;
@@ -217,22 +217,22 @@ void ProcessorMergeMultilineLogNative::MergeLogsByRegex(PipelineEventGroup& logG
             return;
         }
         StringView sourceVal = sourceEvent->GetContent(mSourceKey);
+        MultilineOptions::LineMatchResult lineResult;
         if (!isPartialLog) {
             // it is impossible to enter this state if only end pattern is given
-            boost::regex regex;
-            if (mMultiline.GetStartPatternReg() != nullptr) {
-                regex = *mMultiline.GetStartPatternReg();
-            } else {
-                regex = *mMultiline.GetContinuePatternReg();
-            }
-            if (BoostRegexSearch(sourceVal.data(), sourceVal.size(), regex, exception)) {
+            if (mMultiline.IsLineMatched(sourceVal,
+                                         mMultiline.GetStartPatternReg() != nullptr
+                                             ? MultilineOptions::PatternType::START
+                                             : MultilineOptions::PatternType::CONTINUE,
+                                         lineResult,
+                                         exception)) {
                 events.emplace_back(sourceEvent);
                 begin = cur;
                 isPartialLog = true;
             } else if (mMultiline.GetEndPatternReg() != nullptr && mMultiline.GetStartPatternReg() == nullptr
                        && mMultiline.GetContinuePatternReg() != nullptr
-                       && BoostRegexSearch(
-                           sourceVal.data(), sourceVal.size(), *mMultiline.GetEndPatternReg(), exception)) {
+                       && mMultiline.IsLineMatched(
+                           sourceVal, MultilineOptions::PatternType::END, lineResult, exception)) {
                 // case: continue + end
                 // current line is matched against the end pattern rather than the continue pattern
                 begin = cur;
@@ -244,8 +244,8 @@ void ProcessorMergeMultilineLogNative::MergeLogsByRegex(PipelineEventGroup& logG
         } else {
             // case: start + continue or continue + end
             if (mMultiline.GetContinuePatternReg() != nullptr
-                && BoostRegexSearch(
-                    sourceVal.data(), sourceVal.size(), *mMultiline.GetContinuePatternReg(), exception)) {
+                && mMultiline.IsLineMatched(
+                    sourceVal, MultilineOptions::PatternType::CONTINUE, lineResult, exception)) {
                 events.emplace_back(sourceEvent);
                 continue;
             }
@@ -255,8 +255,8 @@ void ProcessorMergeMultilineLogNative::MergeLogsByRegex(PipelineEventGroup& logG
                 if (mMultiline.GetContinuePatternReg() != nullptr) {
                     // current line is not matched against the continue pattern, so the end pattern will decide if
                     // the current log is a match or not
-                    if (BoostRegexSearch(
-                            sourceVal.data(), sourceVal.size(), *mMultiline.GetEndPatternReg(), exception)) {
+                    if (mMultiline.IsLineMatched(
+                            sourceVal, MultilineOptions::PatternType::END, lineResult, exception)) {
                         MergeEvents(events, true);
                         sourceEvents[newSize++] = std::move(sourceEvents[begin]);
                     } else {
@@ -266,8 +266,8 @@ void ProcessorMergeMultilineLogNative::MergeLogsByRegex(PipelineEventGroup& logG
                     isPartialLog = false;
                 } else {
                     // case: start + end or end
-                    if (BoostRegexSearch(
-                            sourceVal.data(), sourceVal.size(), *mMultiline.GetEndPatternReg(), exception)) {
+                    if (mMultiline.IsLineMatched(
+                            sourceVal, MultilineOptions::PatternType::END, lineResult, exception)) {
                         MergeEvents(events, true);
                         sourceEvents[newSize++] = std::move(sourceEvents[begin]);
                         if (mMultiline.GetStartPatternReg() != nullptr) {
@@ -283,8 +283,8 @@ void ProcessorMergeMultilineLogNative::MergeLogsByRegex(PipelineEventGroup& logG
             } else {
                 if (mMultiline.GetContinuePatternReg() == nullptr) {
                     // case: start
-                    if (!BoostRegexSearch(
-                            sourceVal.data(), sourceVal.size(), *mMultiline.GetStartPatternReg(), exception)) {
+                    if (!mMultiline.IsLineMatched(
+                            sourceVal, MultilineOptions::PatternType::START, lineResult, exception)) {
                         events.emplace_back(sourceEvent);
                     } else {
                         MergeEvents(events, true);
@@ -297,8 +297,8 @@ void ProcessorMergeMultilineLogNative::MergeLogsByRegex(PipelineEventGroup& logG
                     // continue pattern is given, but current line is not matched against the continue pattern
                     MergeEvents(events, true);
                     sourceEvents[newSize++] = std::move(sourceEvents[begin]);
-                    if (!BoostRegexSearch(
-                            sourceVal.data(), sourceVal.size(), *mMultiline.GetStartPatternReg(), exception)) {
+                    if (!mMultiline.IsLineMatched(
+                            sourceVal, MultilineOptions::PatternType::START, lineResult, exception)) {
                         // when no end pattern is given, the only chance to enter unmatched state is when both start
                         // and continue pattern are given, and the current line is not matched against the start
                         // pattern
@@ -20,11 +20,11 @@
 #include <rapidjson/stringbuffer.h>
 #include <rapidjson/writer.h>
 
-#include <codecvt>
-#include <locale>
+#include <cstring>
 
 #include "common/JsonUtil.h"
 #include "common/ParamExtractor.h"
+#include "common/SimdUtil.h"
 #include "models/LogEvent.h"
 #include "monitor/MetricConstants.h"
 #include "processor/inner/ProcessorMergeMultilineLogNative.h"
@@ -187,7 +187,7 @@ bool ProcessorParseContainerLogNative::ParseContainerdTextLogLine(LogEvent& sour
 
     // 寻找第一个分隔符位置 时间 _time_
     StringView timeValue;
-    const char* pch1 = std::find(contentValue.begin(), contentValue.end(), CONTAINERD_DELIMITER);
+    const char* pch1 = FindFirstOf(contentValue.begin(), contentValue.end(), CONTAINERD_DELIMITER);
     if (pch1 == contentValue.end()) {
         std::ostringstream errorMsgStream;
         errorMsgStream << "time field cannot be found in log line."
@@ -199,7 +199,7 @@ bool ProcessorParseContainerLogNative::ParseContainerdTextLogLine(LogEvent& sour
 
     // 寻找第二个分隔符位置 容器标签 _source_
     StringView sourceValue;
-    const char* pch2 = std::find(pch1 + 1, contentValue.end(), CONTAINERD_DELIMITER);
+    const char* pch2 = FindFirstOf(pch1 + 1, contentValue.end(), CONTAINERD_DELIMITER);
     if (pch2 == contentValue.end()) {
         std::ostringstream errorMsgStream;
         errorMsgStream << "source field cannot be found in log line."
@@ -231,18 +231,20 @@ bool ProcessorParseContainerLogNative::ParseContainerdTextLogLine(LogEvent& sour
     }
 
     // 如果既不以 CONTAINERD_PART_TAG 开头，也不以 CONTAINERD_FULL_TAG 开头
-    if (*(pch2 + 1) != CONTAINERD_PART_TAG && *(pch2 + 1) != CONTAINERD_FULL_TAG) {
+    if (pch2 + 1 == contentValue.end()
+        || (*(pch2 + 1) != CONTAINERD_PART_TAG && *(pch2 + 1) != CONTAINERD_FULL_TAG)) {
         // content
         StringView content = StringView(pch2 + 1, contentValue.end() - pch2 - 1);
         ResetContainerdTextLog(timeValue, sourceValue, content, false, sourceEvent);
         return true;
     }
 
-    // 寻找第三个分隔符位置
-    const char* pch3 = std::find(pch2 + 1, contentValue.end(), CONTAINERD_DELIMITER);
-    if (pch3 == contentValue.end() || pch3 != pch2 + 2) {
+    // 第三个分隔符只能紧跟在标签之后，无需搜索；标签本身不能是分隔符
+    const char* pch3 = pch2 + 2;
+    if (pch3 >= contentValue.end() || *(pch2 + 1) == CONTAINERD_DELIMITER || *pch3 != CONTAINERD_DELIMITER) {
         // case: 2021-08-25T07:00:00.000000000Z stdout P
         // case: 2021-08-25T07:00:00.000000000Z stdout PP 1
+        // case: 2021-08-25T07:00:00.000000000Z stdout   1
         StringView content = StringView(pch2 + 1, contentValue.end() - pch2 - 1);
         ResetContainerdTextLog(timeValue, sourceValue, content, false, sourceEvent);
         return true;
@@ -298,61 +300,153 @@ static int32_t parseLogType(char* buffer, int32_t idx, int32_t size, DockerLogTy
     return idx;
 }
 
-std::wstring_convert<std::codecvt_utf8<char32_t>, char32_t> convert;
+namespace {
+
+struct HexTable {
+    int8_t mValues[256];
+
+    HexTable() {
+        memset(mValues, -1, sizeof(mValues));
+        for (int i = 0; i < 10; ++i) {
+            mValues['0' + i] = static_cast<int8_t>(i);
+        }
+        for (int i = 0; i < 6; ++i) {
+            mValues['a' + i] = static_cast<int8_t>(10 + i);
+            mValues['A' + i] = static_cast<int8_t>(10 + i);
+        }
+    }
+};
+
+const HexTable sHexTable;
+
+// returns -1 if any of the 4 chars is not a hex digit
+int32_t parseHex4(const char* data) {
+    int32_t d0 = sHexTable.mValues[static_cast<uint8_t>(data[0])];
+    int32_t d1 = sHexTable.mValues[static_cast<uint8_t>(data[1])];
+    int32_t d2 = sHexTable.mValues[static_cast<uint8_t>(data[2])];
+    int32_t d3 = sHexTable.mValues[static_cast<uint8_t>(data[3])];
+    if ((d0 | d1 | d2 | d3) < 0) {
+        return -1;
+    }
+    return (d0 << 12) | (d1 << 8) | (d2 << 4) | d3;
+}
+
+int32_t encodeUtf8(uint32_t codePoint, char* dst) {
+    if (codePoint < 0x80) {
+        dst[0] = static_cast<char>(codePoint);
+        return 1;
+    }
+    if (codePoint < 0x800) {
+        dst[0] = static_cast<char>(0xC0 | (codePoint >> 6));
+        dst[1] = static_cast<char>(0x80 | (codePoint & 0x3F));
+        return 2;
+    }
+    if (codePoint < 0x10000) {
+        dst[0] = static_cast<char>(0xE0 | (codePoint >> 12));
+        dst[1] = static_cast<char>(0x80 | ((codePoint >> 6) & 0x3F));
+        dst[2] = static_cast<char>(0x80 | (codePoint & 0x3F));
+        return 3;
+    }
+    dst[0] = static_cast<char>(0xF0 | (codePoint >> 18));
+    dst[1] = static_cast<char>(0x80 | ((codePoint >> 12) & 0x3F));
+    dst[2] = static_cast<char>(0x80 | ((codePoint >> 6) & 0x3F));
+    dst[3] = static_cast<char>(0x80 | (codePoint & 0x3F));
+    return 4;
+}
+
+// buffer[idx] is the 'u' of a \uXXXX escape. The UTF-16 code unit, or the surrogate pair formed with the next escape,
+// is written as UTF-8 at endIndex, which never overtakes idx since the output is shorter than the escape. Returns the
+// index of the last char consumed, or -1 if the escape is malformed and should be kept as it is.
+int32_t parseUnicodeEscape(char* buffer, int32_t idx, int32_t size, int32_t& endIndex) {
+    if (idx + 4 >= size) {
+        return -1;
+    }
+    int32_t codeUnit = parseHex4(buffer + idx + 1);
+    if (codeUnit < 0) {
+        return -1;
+    }
+    idx += 4;
+    uint32_t codePoint = static_cast<uint32_t>(codeUnit);
+    if (codeUnit >= 0xD800 && codeUnit <= 0xDFFF) {
+        int32_t lowUnit = -1;
+        if (codeUnit <= 0xDBFF && idx + 6 < size && buffer[idx + 1] == '\\' && buffer[idx + 2] == 'u') {
+            lowUnit = parseHex4(buffer + idx + 3);
+        }
+        if (lowUnit >= 0xDC00 && lowUnit <= 0xDFFF) {
+            codePoint = 0x10000 + ((static_cast<uint32_t>(codeUnit) - 0xD800) << 10)
+                + (static_cast<uint32_t>(lowUnit) - 0xDC00);
+            idx += 6;
+        } else {
+            // unpaired surrogate
+            codePoint = 0xFFFD;
+        }
+    }
+    endIndex += encodeUtf8(codePoint, buffer + endIndex);
+    return idx;
+}
+
+} // namespace
 
 static int32_t parseValue(char* buffer, int32_t idx, int32_t size, DockerLogType logType, int32_t& endIndex) {
-    while (idx < size && buffer[idx] != '\"') {
-        if (buffer[idx] == '\\') {
-            if (logType != DockerLogType::Log) {
-                return -1;
-            }
-            ++idx; // skip escape char
-            if (idx >= size) {
-                return -1;
-            }
-            switch (buffer[idx]) {
-                case '\"':
-                    buffer[endIndex++] = '\"';
-                    break;
-                case '\\':
-                    buffer[endIndex++] = '\\';
-                    break;
-                case '/':
-                    buffer[endIndex++] = '/';
-                    break;
-                case 'b':
-                    buffer[endIndex++] = '\b';
-                    break;
-                case 'f':
-                    buffer[endIndex++] = '\f';
-                    break;
-                case 'n':
-                    buffer[endIndex++] = '\n';
-                    break;
-                case 'r':
-                    buffer[endIndex++] = '\r';
-                    break;
-                case 't':
-                    buffer[endIndex++] = '\t';
-                    break;
-                default:
-                    if (idx + 4 < size && buffer[idx] == 'u') {
-                        std::string unicode_seq;
-                        unicode_seq.append(buffer + idx + 1, 4);
-                        char32_t unicode_char = std::stoul(unicode_seq, nullptr, 16);
-                        std::string res = convert.to_bytes(unicode_char);
-                        for (size_t i = 0; i < res.size(); ++i) {
-                            buffer[endIndex++] = res[i];
-                        }
-                        idx += 4;
-                    } else {
-                        buffer[endIndex++] = '\\';
-                        buffer[endIndex++] = buffer[idx];
-                    }
+    const char* end = buffer + size;
+    while (idx < size) {
+        // plain bytes are skipped in blocks, and are only moved once an escape has shortened the value
+        int32_t plainSize = static_cast<int32_t>(FindFirstOf(buffer + idx, end, '\"', '\\') - (buffer + idx));
+        if (endIndex != idx) {
+            memmove(buffer + endIndex, buffer + idx, plainSize);
+        }
+        endIndex += plainSize;
+        idx += plainSize;
+        if (idx >= size || buffer[idx] == '\"') {
+            break;
+        }
+
+        if (logType != DockerLogType::Log) {
+            return -1;
+        }
+        ++idx; // skip escape char
+        if (idx >= size) {
+            return -1;
+        }
+        switch (buffer[idx]) {
+            case '\"':
+                buffer[endIndex++] = '\"';
+                break;
+            case '\\':
+                buffer[endIndex++] = '\\';
+                break;
+            case '/':
+                buffer[endIndex++] = '/';
+                break;
+            case 'b':
+                buffer[endIndex++] = '\b';
+                break;
+            case 'f':
+                buffer[endIndex++] = '\f';
+                break;
+            case 'n':
+                buffer[endIndex++] = '\n';
+                break;
+            case 'r':
+                buffer[endIndex++] = '\r';
+                break;
+            case 't':
+                buffer[endIndex++] = '\t';
+                break;
+            case 'u': {
+                int32_t last = parseUnicodeEscape(buffer, idx, size, endIndex);
+                if (last != -1) {
+                    idx = last;
                     break;
+                }
+                buffer[endIndex++] = '\\';
+                buffer[endIndex++] = buffer[idx];
+                break;
             }
-        } else {
-            buffer[endIndex++] = buffer[idx];
+            default:
+                buffer[endIndex++] = '\\';
+                buffer[endIndex++] = buffer[idx];
+                break;
         }
         ++idx;
     }
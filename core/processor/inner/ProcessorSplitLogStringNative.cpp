@@ -17,6 +17,7 @@
 #include "processor/inner/ProcessorSplitLogStringNative.h"
 
 #include "common/ParamExtractor.h"
+#include "common/SimdUtil.h"
 #include "models/LogEvent.h"
 
 namespace logtail {
@@ -133,10 +134,16 @@ void ProcessorSplitLogStringNative::ProcessEvent(PipelineEventGroup& logGroup,
     StringView sourceVal = sourceEvent.GetContent(mSourceKey);
     StringBuffer sourceKey = logGroup.GetSourceBuffer()->CopyString(mSourceKey);
 
+    // find all split positions in one vectorized pass, then emit the lines in batch
+    std::vector<size_t> splitOffsets;
+    FindAllOf(sourceVal.data(), sourceVal.size(), mSplitChar, splitOffsets);
+    newEvents.reserve(newEvents.size() + splitOffsets.size() + 1);
+
     size_t begin = 0;
-    while (begin < sourceVal.size()) {
+    for (size_t i = 0; i <= splitOffsets.size() && begin < sourceVal.size(); ++i) {
+        size_t end = i < splitOffsets.size() ? splitOffsets[i] : sourceVal.size();
         std::unique_ptr<LogEvent> targetEvent = logGroup.CreateLogEvent();
-        StringView content = GetNextLine(sourceVal, begin);
+        StringView content(sourceVal.data() + begin, end - begin);
         targetEvent->SetContentNoCopy(StringView(sourceKey.data, sourceKey.size), content);
         targetEvent->SetTimestamp(
             sourceEvent.GetTimestamp(),
@@ -155,21 +162,8 @@ void ProcessorSplitLogStringNative::ProcessEvent(PipelineEventGroup& logGroup,
             logGroup.GetExactlyOnceCheckpoint()->positions.emplace_back(offset, content.size());
         }
         newEvents.emplace_back(std::move(targetEvent));
-        begin += content.size() + 1;
-    }
-}
-
-StringView ProcessorSplitLogStringNative::GetNextLine(StringView log, size_t begin) {
-    if (begin >= log.size()) {
-        return StringView();
-    }
-
-    for (size_t end = begin; end < log.size(); ++end) {
-        if (log[end] == mSplitChar) {
-            return StringView(log.data() + begin, end - begin);
-        }
+        begin = end + 1;
     }
-    return StringView(log.data() + begin, log.size() - begin);
 }
 
 } // namespace logtail
@@ -41,7 +41,6 @@ protected:
 
 private:
     void ProcessEvent(PipelineEventGroup& logGroup, PipelineEventPtr&& e, EventsContainer& newEvents);
-    StringView GetNextLine(StringView log, size_t begin);
 
     int* mSplitLines = nullptr;
 
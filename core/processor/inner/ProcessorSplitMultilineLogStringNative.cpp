@@ -22,6 +22,7 @@
 #include "app_config/AppConfig.h"
 #include "common/Constants.h"
 #include "common/ParamExtractor.h"
+#include "common/SimdUtil.h"
 #include "logger/Logger.h"
 #include "models/LogEvent.h"
 #include "monitor/MetricConstants.h"
@@ -159,20 +160,21 @@ void ProcessorSplitMultilineLogStringNative::ProcessEvent(PipelineEventGroup& lo
         StringView content = GetNextLine(sourceVal, begin);
         bool isLastLog = begin + content.size() == sourceVal.size();
         ++(*inputLines);
+        MultilineOptions::LineMatchResult lineResult;
         if (!isPartialLog) {
             // it is impossible to enter this state if only end pattern is given
-            boost::regex regex;
-            if (mMultiline.GetStartPatternReg() != nullptr) {
-                regex = *mMultiline.GetStartPatternReg();
-            } else {
-                regex = *mMultiline.GetContinuePatternReg();
-            }
-            if (BoostRegexSearch(content.data(), content.size(), regex, exception)) {
+            if (mMultiline.IsLineMatched(content,
+                                         mMultiline.GetStartPatternReg() != nullptr
+                                             ? MultilineOptions::PatternType::START
+                                             : MultilineOptions::PatternType::CONTINUE,
+                                         lineResult,
+                                         exception)) {
                 multiStartIndex = content.data();
                 isPartialLog = true;
             } else if (mMultiline.GetEndPatternReg() != nullptr && mMultiline.GetStartPatternReg() == nullptr
                        && mMultiline.GetContinuePatternReg() != nullptr
-                       && BoostRegexSearch(content.data(), content.size(), *mMultiline.GetEndPatternReg(), exception)) {
+                       && mMultiline.IsLineMatched(
+                           content, MultilineOptions::PatternType::END, lineResult, exception)) {
                 // case: continue + end
                 CreateNewEvent(content, isLastLog, sourceKey, sourceEvent, logGroup, newEvents);
                 multiStartIndex = content.data() + content.size() + 1;
@@ -184,7 +186,7 @@ void ProcessorSplitMultilineLogStringNative::ProcessEvent(PipelineEventGroup& lo
         } else {
             // case: start + continue or continue + end
             if (mMultiline.GetContinuePatternReg() != nullptr
-                && BoostRegexSearch(content.data(), content.size(), *mMultiline.GetContinuePatternReg(), exception)) {
+                && mMultiline.IsLineMatched(content, MultilineOptions::PatternType::CONTINUE, lineResult, exception)) {
                 begin += content.size() + 1;
                 continue;
             }
@@ -193,7 +195,7 @@ void ProcessorSplitMultilineLogStringNative::ProcessEvent(PipelineEventGroup& lo
                 if (mMultiline.GetContinuePatternReg() != nullptr) {
                     // current line is not matched against the continue pattern, so the end pattern will decide
                     // if the current log is a match or not
-                    if (BoostRegexSearch(content.data(), content.size(), *mMultiline.GetEndPatternReg(), exception)) {
+                    if (mMultiline.IsLineMatched(content, MultilineOptions::PatternType::END, lineResult, exception)) {
                         CreateNewEvent(StringView(multiStartIndex, content.data() + content.size() - multiStartIndex),
                                        isLastLog,
                                        sourceKey,
@@ -215,7 +217,7 @@ void ProcessorSplitMultilineLogStringNative::ProcessEvent(PipelineEventGroup& lo
                     isPartialLog = false;
                 } else {
                     // case: start + end or end
-                    if (BoostRegexSearch(content.data(), content.size(), *mMultiline.GetEndPatternReg(), exception)) {
+                    if (mMultiline.IsLineMatched(content, MultilineOptions::PatternType::END, lineResult, exception)) {
                         CreateNewEvent(StringView(multiStartIndex, content.data() + content.size() - multiStartIndex),
                                        isLastLog,
                                        sourceKey,
@@ -236,7 +238,8 @@ void ProcessorSplitMultilineLogStringNative::ProcessEvent(PipelineEventGroup& lo
             } else {
                 if (mMultiline.GetContinuePatternReg() == nullptr) {
                     // case: start
-                    if (BoostRegexSearch(content.data(), content.size(), *mMultiline.GetStartPatternReg(), exception)) {
+                    if (mMultiline.IsLineMatched(
+                            content, MultilineOptions::PatternType::START, lineResult, exception)) {
                         CreateNewEvent(StringView(multiStartIndex, content.data() - 1 - multiStartIndex),
                                        isLastLog,
                                        sourceKey,
@@ -256,8 +259,8 @@ void ProcessorSplitMultilineLogStringNative::ProcessEvent(PipelineEventGroup& lo
                                    logGroup,
                                    newEvents);
                     mProcMatchedEventsCnt->Add(1);
-                    if (!BoostRegexSearch(
-                            content.data(), content.size(), *mMultiline.GetStartPatternReg(), exception)) {
+                    if (!mMultiline.IsLineMatched(
+                            content, MultilineOptions::PatternType::START, lineResult, exception)) {
                         // when no end pattern is given, the only chance to enter unmatched state is when both
                         // start and continue pattern are given, and the current line is not matched against the
                         // start pattern
@@ -367,12 +370,8 @@ StringView ProcessorSplitMultilineLogStringNative::GetNextLine(StringView log, s
         return StringView();
     }
 
-    for (size_t end = begin; end < log.size(); ++end) {
-        if (log[end] == '\n') {
-            return StringView(log.data() + begin, end - begin);
-        }
-    }
-    return StringView(log.data() + begin, log.size() - begin);
+    const char* end = FindFirstOf(log.data() + begin, log.data() + log.size(), '\n');
+    return StringView(log.data() + begin, end - log.data() - begin);
 }
 
 } // namespace logtail
@@ -0,0 +1,95 @@
+// Copyright 2024 iLogtail Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "queue/ConcurrentProcessQueue.h"
+
+using namespace std;
+
+namespace logtail {
+
+ConcurrentProcessQueue::ConcurrentProcessQueue(
+    size_t cap, size_t low, size_t high, QueueKey key, uint32_t priority, const string& config)
+    : mQueue(cap), mKey(key), mLowWatermark(low), mHighWatermark(high), mPriority(priority), mConfigName(config) {
+}
+
+bool ConcurrentProcessQueue::Push(unique_ptr<ProcessQueueItem>&& item) {
+    if (!IsValidToPush()) {
+        return false;
+    }
+    // charged in advance, since the item may be popped and processed by others as soon as it is pushed
+    item->ChargeMemoryBudget(mMemoryBudget);
+    if (!mQueue.TryPush(std::move(item))) {
+        item->ReleaseMemoryBudget();
+        return false;
+    }
+    if (mSize.fetch_add(1, memory_order_acq_rel) + 1 >= mHighWatermark) {
+        mValidToPush.store(false, memory_order_release);
+        // pops may have brought the size down to the low watermark before the state is changed
+        ValidatePushIfNeeded();
+    }
+    return true;
+}
+
+bool ConcurrentProcessQueue::Pop(unique_ptr<ProcessQueueItem>& item) {
+    if (!mValidToPop || Empty() || !IsDownStreamQueuesValidToPush()) {
+        return false;
+    }
+    if (!mQueue.TryPop(item)) {
+        return false;
+    }
+    mSize.fetch_sub(1, memory_order_acq_rel);
+    ValidatePushIfNeeded();
+    return true;
+}
+
+void ConcurrentProcessQueue::SetDownStreamQueues(vector<SingleLogstoreSenderManager<SenderQueueParam>*>& ques) {
+    ScopedSpinLock lock(mStreamLock);
+    mDownStreamQueues.swap(ques);
+}
+
+void ConcurrentProcessQueue::SetUpStreamFeedbacks(vector<FeedbackInterface*>& feedbacks) {
+    ScopedSpinLock lock(mStreamLock);
+    mUpStreamFeedbacks.swap(feedbacks);
+}
+
+bool ConcurrentProcessQueue::IsDownStreamQueuesValidToPush() const {
+    ScopedSpinLock lock(mStreamLock);
+    // TODO: support other strategy
+    for (const auto& q : mDownStreamQueues) {
+        // TODO: replace IsValid with IsValidToPush
+        if (!q->IsValid()) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void ConcurrentProcessQueue::ValidatePushIfNeeded() {
+    if (mValidToPush.load(memory_order_acquire) || mSize.load(memory_order_acquire) > mLowWatermark) {
+        return;
+    }
+    bool expected = false;
+    if (mValidToPush.compare_exchange_strong(expected, true, memory_order_acq_rel)) {
+        GiveFeedback();
+    }
+}
+
+void ConcurrentProcessQueue::GiveFeedback() const {
+    ScopedSpinLock lock(mStreamLock);
+    for (auto& item : mUpStreamFeedbacks) {
+        item->Feedback(mKey);
+    }
+}
+
+} // namespace logtail
@@ -0,0 +1,99 @@
+/*
+ * Copyright 2024 iLogtail Authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "common/FeedbackInterface.h"
+#include "common/Lock.h"
+#include "queue/FeedbackQueueKey.h"
+#include "queue/LockFreeRingBuffer.h"
+#include "queue/ProcessQueueItem.h"
+// TODO: temporarily used
+#include "common/LogstoreSenderQueue.h"
+#include "sender/SenderQueueParam.h"
+
+namespace logtail {
+
+// Thread-safe counterpart of ProcessQueue. Items are kept in a lock-free ring buffer and the states are atomic, so
+// pushing to and popping from the queue never take a lock. The watermark and feedback semantics are the same as
+// ProcessQueue: pushing is forbidden once the size reaches the high watermark, and is allowed again with feedback given
+// to upstreams when the size drops to the low watermark.
+class ConcurrentProcessQueue {
+public:
+    ConcurrentProcessQueue(
+        size_t cap, size_t low, size_t high, QueueKey key, uint32_t priority, const std::string& config);
+
+    ConcurrentProcessQueue(const ConcurrentProcessQueue&) = delete;
+    ConcurrentProcessQueue& operator=(const ConcurrentProcessQueue&) = delete;
+
+    // @item is left untouched if false is returned
+    bool Push(std::unique_ptr<ProcessQueueItem>&& item);
+    bool Pop(std::unique_ptr<ProcessQueueItem>& item);
+
+    bool IsValidToPush() const { return mValidToPush.load(std::memory_order_acquire); }
+    bool Empty() const { return mSize.load(std::memory_order_acquire) == 0; }
+
+    QueueKey GetKey() const { return mKey; }
+
+    void SetPriority(uint32_t priority) { mPriority = priority; }
+    uint32_t GetPriority() const { return mPriority; }
+
+    const std::string& GetConfigName() const { return mConfigName; }
+
+    void InvalidatePop() { mValidToPop = false; }
+    void ValidatePop() { mValidToPop = true; }
+
+    void SetDownStreamQueues(std::vector<SingleLogstoreSenderManager<SenderQueueParam>*>& ques);
+    void SetUpStreamFeedbacks(std::vector<FeedbackInterface*>& feedbacks);
+
+    // items pushed are charged to the budget until processed, which should be set before the queue is pushed to
+    void SetMemoryBudget(const std::shared_ptr<PipelineMemoryBudget>& budget) { mMemoryBudget = budget; }
+    const std::shared_ptr<PipelineMemoryBudget>& GetMemoryBudget() const { return mMemoryBudget; }
+
+private:
+    bool IsDownStreamQueuesValidToPush() const;
+    // the last one that brings the size to the low watermark restores the push state and gives feedback
+    void ValidatePushIfNeeded();
+    void GiveFeedback() const;
+
+    LockFreeRingBuffer<std::unique_ptr<ProcessQueueItem>> mQueue;
+    const QueueKey mKey;
+    const size_t mLowWatermark;
+    const size_t mHighWatermark;
+    std::atomic_size_t mSize{0};
+    std::atomic_bool mValidToPush{true};
+    std::atomic_bool mValidToPop{true};
+    std::atomic_uint32_t mPriority;
+    const std::string mConfigName;
+
+    // streams are only changed on config update
+    mutable SpinLock mStreamLock;
+    // TODO: replace the sender queue type
+    std::vector<SingleLogstoreSenderManager<SenderQueueParam>*> mDownStreamQueues;
+    std::vector<FeedbackInterface*> mUpStreamFeedbacks;
+    std::shared_ptr<PipelineMemoryBudget> mMemoryBudget;
+
+#ifdef APSARA_UNIT_TEST_MAIN
+    friend class ConcurrentProcessQueueManagerUnittest;
+#endif
+};
+
+} // namespace logtail
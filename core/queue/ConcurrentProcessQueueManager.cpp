@@ -0,0 +1,234 @@
+// Copyright 2024 iLogtail Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "queue/ConcurrentProcessQueueManager.h"
+
+#include <algorithm>
+
+#include "queue/QueueKeyManager.h"
+#include "queue/QueueParam.h"
+
+using namespace std;
+
+namespace logtail {
+
+// versions are unique among all managers, so a local state never mistakes a snapshot of another manager for its own
+static atomic_uint64_t sNextVersion{1};
+static atomic_uint64_t sNextId{1};
+
+ConcurrentProcessQueueManager::ConcurrentProcessQueueManager(uint32_t maxPriority)
+    : mId(sNextId++), mMaxPriority(maxPriority) {
+    auto snapshot = make_shared<Snapshot>();
+    snapshot->mPriorityQueues.resize(mMaxPriority + 1);
+    lock_guard<mutex> lock(mMux);
+    Publish(std::move(snapshot));
+}
+
+bool ConcurrentProcessQueueManager::CreateOrUpdateQueue(QueueKey key, uint32_t priority) {
+    lock_guard<mutex> lock(mMux);
+    auto snapshot = make_shared<Snapshot>(*mSnapshot);
+    auto iter = snapshot->mQueues.find(key);
+    if (iter != snapshot->mQueues.end()) {
+        const auto& que = iter->second;
+        if (que->GetPriority() == priority) {
+            return false;
+        }
+        auto& oldQueues = snapshot->mPriorityQueues[que->GetPriority()];
+        oldQueues.erase(find(oldQueues.begin(), oldQueues.end(), que));
+        que->SetPriority(priority);
+        snapshot->mPriorityQueues[priority].push_back(que);
+    } else {
+        auto que = make_shared<ConcurrentProcessQueue>(ProcessQueueParam::GetInstance()->mCapacity,
+                                                       ProcessQueueParam::GetInstance()->mLowWatermark,
+                                                       ProcessQueueParam::GetInstance()->mHighWatermark,
+                                                       key,
+                                                       priority,
+                                                       QueueKeyManager::GetInstance()->GetName(key));
+        snapshot->mQueues[key] = que;
+        snapshot->mPriorityQueues[priority].push_back(que);
+    }
+    Publish(std::move(snapshot));
+    return true;
+}
+
+bool ConcurrentProcessQueueManager::DeleteQueue(QueueKey key) {
+    lock_guard<mutex> lock(mMux);
+    auto iter = mSnapshot->mQueues.find(key);
+    if (iter == mSnapshot->mQueues.end()) {
+        return false;
+    }
+    auto snapshot = make_shared<Snapshot>(*mSnapshot);
+    auto& queues = snapshot->mPriorityQueues[iter->second->GetPriority()];
+    queues.erase(find(queues.begin(), queues.end(), iter->second));
+    snapshot->mQueues.erase(key);
+    Publish(std::move(snapshot));
+    return true;
+}
+
+shared_ptr<ConcurrentProcessQueue> ConcurrentProcessQueueManager::FindQueue(QueueKey key) const {
+    const Snapshot& snapshot = GetSnapshot();
+    auto iter = snapshot.mQueues.find(key);
+    if (iter == snapshot.mQueues.end()) {
+        return nullptr;
+    }
+    return iter->second;
+}
+
+int ConcurrentProcessQueueManager::PushQueue(QueueKey key, unique_ptr<ProcessQueueItem>&& item) {
+    // the queue is kept alive by the local snapshot, so there is no need to copy the shared pointer, which would make
+    // all pushing threads contend on the reference count
+    const Snapshot& snapshot = GetSnapshot();
+    auto iter = snapshot.mQueues.find(key);
+    if (iter == snapshot.mQueues.end()) {
+        return 2;
+    }
+    if (!iter->second->Push(std::move(item))) {
+        return 1;
+    }
+    return 0;
+}
+
+bool ConcurrentProcessQueueManager::PopItem(
+    int64_t threadNo, int64_t threadCount, uint32_t priority, unique_ptr<ProcessQueueItem>& item, string& configName) {
+    ConcurrentProcessQueue* que = PopFirstItem(threadNo, threadCount, priority, item);
+    if (!que) {
+        return false;
+    }
+    configName = que->GetConfigName();
+    return true;
+}
+
+bool ConcurrentProcessQueueManager::PopItems(int64_t threadNo,
+                                             int64_t threadCount,
+                                             uint32_t priority,
+                                             size_t maxCnt,
+                                             size_t maxBytes,
+                                             vector<unique_ptr<ProcessQueueItem>>& items,
+                                             string& configName) {
+    unique_ptr<ProcessQueueItem> item;
+    ConcurrentProcessQueue* que = PopFirstItem(threadNo, threadCount, priority, item);
+    if (!que) {
+        return false;
+    }
+    configName = que->GetConfigName();
+    size_t bytes = maxCnt > 1 ? item->mEventGroup.DataSize() : 0;
+    items.emplace_back(std::move(item));
+    for (size_t cnt = 1; cnt < maxCnt && bytes < maxBytes && que->Pop(item); ++cnt) {
+        bytes += item->mEventGroup.DataSize();
+        items.emplace_back(std::move(item));
+    }
+    return true;
+}
+
+ConcurrentProcessQueue* ConcurrentProcessQueueManager::PopFirstItem(int64_t threadNo,
+                                                                    int64_t threadCount,
+                                                                    uint32_t priority,
+                                                                    unique_ptr<ProcessQueueItem>& item) {
+    LocalState& state = GetLocalState();
+    const auto& queues = state.mSnapshot->mPriorityQueues[priority];
+    size_t size = queues.size();
+    if (size == 0) {
+        return nullptr;
+    }
+
+    // queues owned by the thread are those at position threadNo, threadNo + threadCount, ...
+    size_t stride = threadCount > 0 ? static_cast<size_t>(threadCount) : 1;
+    size_t ownBegin = static_cast<size_t>(threadNo) % stride;
+    size_t ownCnt = size > ownBegin ? (size - ownBegin + stride - 1) / stride : 0;
+    size_t& ownCursor = state.mOwnCursors[priority];
+    for (size_t i = 0; i < ownCnt; ++i) {
+        size_t idx = (ownCursor + i) % ownCnt;
+        const auto& que = queues[ownBegin + idx * stride];
+        if (que->Pop(item)) {
+            ownCursor = (idx + 1) % ownCnt;
+            return que.get();
+        }
+    }
+
+    // all owned queues are empty or blocked, steal from others
+    size_t& stealCursor = state.mStealCursors[priority];
+    for (size_t i = 0; i < size; ++i) {
+        size_t idx = (stealCursor + i) % size;
+        if (idx % stride == ownBegin) {
+            continue;
+        }
+        const auto& que = queues[idx];
+        if (que->Pop(item)) {
+            stealCursor = (idx + 1) % size;
+            return que.get();
+        }
+    }
+    return nullptr;
+}
+
+bool ConcurrentProcessQueueManager::IsAllQueueEmpty() const {
+    lock_guard<mutex> lock(mMux);
+    for (const auto& q : mSnapshot->mQueues) {
+        if (!q.second->Empty()) {
+            return false;
+        }
+    }
+    return true;
+}
+
+uint32_t ConcurrentProcessQueueManager::GetInvalidCnt() const {
+    uint32_t res = 0;
+    lock_guard<mutex> lock(mMux);
+    for (const auto& q : mSnapshot->mQueues) {
+        if (q.second->IsValidToPush()) {
+            ++res;
+        }
+    }
+    return res;
+}
+
+uint32_t ConcurrentProcessQueueManager::GetCnt() const {
+    lock_guard<mutex> lock(mMux);
+    return mSnapshot->mQueues.size();
+}
+
+const ConcurrentProcessQueueManager::Snapshot& ConcurrentProcessQueueManager::GetSnapshot() const {
+    return *GetLocalState().mSnapshot;
+}
+
+ConcurrentProcessQueueManager::LocalState& ConcurrentProcessQueueManager::GetLocalState() const {
+    static thread_local LocalState sState;
+    if (sState.mManagerId != mId || sState.mVersion != mVersion.load(memory_order_acquire)) {
+        lock_guard<mutex> lock(mMux);
+        if (sState.mManagerId != mId) {
+            sState.mManagerId = mId;
+            sState.mOwnCursors.assign(mMaxPriority + 1, 0);
+            sState.mStealCursors.assign(mMaxPriority + 1, 0);
+        }
+        sState.mVersion = mVersion.load(memory_order_relaxed);
+        sState.mSnapshot = mSnapshot;
+    }
+    return sState;
+}
+
+void ConcurrentProcessQueueManager::Publish(shared_ptr<const Snapshot>&& snapshot) {
+    mSnapshot = std::move(snapshot);
+    mVersion.store(sNextVersion++, memory_order_release);
+}
+
+#ifdef APSARA_UNIT_TEST_MAIN
+void ConcurrentProcessQueueManager::Clear() {
+    auto snapshot = make_shared<Snapshot>();
+    snapshot->mPriorityQueues.resize(mMaxPriority + 1);
+    lock_guard<mutex> lock(mMux);
+    Publish(std::move(snapshot));
+}
+#endif
+
+} // namespace logtail
@@ -0,0 +1,118 @@
+/*
+ * Copyright 2024 iLogtail Authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "queue/ConcurrentProcessQueue.h"
+
+namespace logtail {
+
+// Process queues without a lock shared by all queues, used by ProcessQueueManager when concurrent process queue is
+// enabled.
+//
+// The set of queues is published as an immutable snapshot, which is replaced on config update and cached by each
+// thread, so looking up a queue on push or pop only costs an atomic load of the snapshot version.
+//
+// Queues of each priority are distributed among process threads. A process thread first pops from the queues it owns
+// in round robin, and steals from queues owned by others only when all of its own are empty. So process threads mostly
+// work on different queues and seldom contend on the same ring buffer. Items never leave the queue of their config
+// until popped, so that watermarks and feedback still take all pending items into account.
+class ConcurrentProcessQueueManager {
+public:
+    explicit ConcurrentProcessQueueManager(uint32_t maxPriority);
+
+    ConcurrentProcessQueueManager(const ConcurrentProcessQueueManager&) = delete;
+    ConcurrentProcessQueueManager& operator=(const ConcurrentProcessQueueManager&) = delete;
+
+    bool CreateOrUpdateQueue(QueueKey key, uint32_t priority);
+    bool DeleteQueue(QueueKey key);
+    // nullptr is returned if the queue does not exist
+    std::shared_ptr<ConcurrentProcessQueue> FindQueue(QueueKey key) const;
+    // 0: success, 1: queue is full, 2: queue not found, @item is left untouched unless 0 is returned
+    int PushQueue(QueueKey key, std::unique_ptr<ProcessQueueItem>&& item);
+    // pop from queues of the given priority only, @threadCount is the number of threads calling this method
+    bool PopItem(int64_t threadNo,
+                 int64_t threadCount,
+                 uint32_t priority,
+                 std::unique_ptr<ProcessQueueItem>& item,
+                 std::string& configName);
+    // same as PopItem, but keeps popping from the queue of the first item until @maxCnt items or at least @maxBytes
+    // bytes are popped, popped items are appended to @items
+    bool PopItems(int64_t threadNo,
+                  int64_t threadCount,
+                  uint32_t priority,
+                  size_t maxCnt,
+                  size_t maxBytes,
+                  std::vector<std::unique_ptr<ProcessQueueItem>>& items,
+                  std::string& configName);
+    bool IsAllQueueEmpty() const;
+
+    // TODO: should be removed when self-telemetry is refactored
+    uint32_t GetInvalidCnt() const;
+    uint32_t GetCnt() const;
+
+#ifdef APSARA_UNIT_TEST_MAIN
+    void Clear();
+#endif
+
+private:
+    struct Snapshot {
+        std::unordered_map<QueueKey, std::shared_ptr<ConcurrentProcessQueue>> mQueues;
+        std::vector<std::vector<std::shared_ptr<ConcurrentProcessQueue>>> mPriorityQueues;
+    };
+
+    // per thread view of the manager
+    struct LocalState {
+        // id instead of address of the manager, since a new manager may be allocated where a deleted one was
+        uint64_t mManagerId = 0;
+        uint64_t mVersion = 0;
+        std::shared_ptr<const Snapshot> mSnapshot;
+        // round robin position among owned queues and other queues of each priority
+        std::vector<size_t> mOwnCursors;
+        std::vector<size_t> mStealCursors;
+    };
+
+    // returns the queue where @item is popped from, or nullptr if no item is available
+    ConcurrentProcessQueue* PopFirstItem(int64_t threadNo,
+                                         int64_t threadCount,
+                                         uint32_t priority,
+                                         std::unique_ptr<ProcessQueueItem>& item);
+    const Snapshot& GetSnapshot() const;
+    LocalState& GetLocalState() const;
+    // must be called with mMux held
+    void Publish(std::shared_ptr<const Snapshot>&& snapshot);
+
+    const uint64_t mId;
+    const uint32_t mMaxPriority;
+    mutable std::mutex mMux;
+    std::shared_ptr<const Snapshot> mSnapshot;
+    // version 0 is never published, so that a new local state always loads the snapshot first
+    std::atomic_uint64_t mVersion{0};
+
+#ifdef APSARA_UNIT_TEST_MAIN
+    friend class ConcurrentProcessQueueManagerUnittest;
+#endif
+};
+
+} // namespace logtail
@@ -0,0 +1,112 @@
+/*
+ * Copyright 2024 iLogtail Authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+namespace logtail {
+
+// Bounded multi-producer multi-consumer queue based on the algorithm of Dmitry Vyukov. Each cell carries a sequence
+// number telling whether it is ready to be written or read in the current lap, so producers and consumers only contend
+// on the CAS of their own position and never block each other.
+template <typename T>
+class LockFreeRingBuffer {
+public:
+    // capacity is rounded up to a power of 2
+    explicit LockFreeRingBuffer(size_t capacity)
+        : mMask(RoundUpPowerOfTwo(capacity) - 1), mCells(new Cell[mMask + 1]) {
+        for (size_t i = 0; i <= mMask; ++i) {
+            mCells[i].mSeq.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    LockFreeRingBuffer(const LockFreeRingBuffer&) = delete;
+    LockFreeRingBuffer& operator=(const LockFreeRingBuffer&) = delete;
+
+    // @item is left untouched if the buffer is full
+    bool TryPush(T&& item) {
+        size_t pos = mTail.load(std::memory_order_relaxed);
+        Cell* cell = nullptr;
+        while (true) {
+            cell = &mCells[pos & mMask];
+            size_t seq = cell->mSeq.load(std::memory_order_acquire);
+            intptr_t diff = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos);
+            if (diff == 0) {
+                if (mTail.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    break;
+                }
+            } else if (diff < 0) {
+                return false;
+            } else {
+                pos = mTail.load(std::memory_order_relaxed);
+            }
+        }
+        cell->mData = std::move(item);
+        cell->mSeq.store(pos + 1, std::memory_order_release);
+        return true;
+    }
+
+    // false is returned if the buffer is empty, or the oldest item is still being written
+    bool TryPop(T& item) {
+        size_t pos = mHead.load(std::memory_order_relaxed);
+        Cell* cell = nullptr;
+        while (true) {
+            cell = &mCells[pos & mMask];
+            size_t seq = cell->mSeq.load(std::memory_order_acquire);
+            intptr_t diff = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos + 1);
+            if (diff == 0) {
+                if (mHead.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    break;
+                }
+            } else if (diff < 0) {
+                return false;
+            } else {
+                pos = mHead.load(std::memory_order_relaxed);
+            }
+        }
+        item = std::move(cell->mData);
+        cell->mSeq.store(pos + mMask + 1, std::memory_order_release);
+        return true;
+    }
+
+    size_t Capacity() const { return mMask + 1; }
+
+private:
+    struct Cell {
+        std::atomic<size_t> mSeq;
+        T mData;
+    };
+
+    static size_t RoundUpPowerOfTwo(size_t n) {
+        size_t res = 2;
+        while (res < n) {
+            res <<= 1;
+        }
+        return res;
+    }
+
+    const size_t mMask;
+    std::unique_ptr<Cell[]> mCells;
+    // head and tail are placed in different cache lines to avoid false sharing between producers and consumers
+    alignas(64) std::atomic<size_t> mHead{0};
+    alignas(64) std::atomic<size_t> mTail{0};
+};
+
+} // namespace logtail
@@ -22,6 +22,7 @@ bool ProcessQueue::Push(unique_ptr<ProcessQueueItem>&& item) {
     if (!IsValidToPush()) {
         return false;
     }
+    item->ChargeMemoryBudget(mMemoryBudget);
     mQueue.push(std::move(item));
     ChangeStateIfNeededAfterPush();
     return true;
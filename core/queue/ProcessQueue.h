@@ -50,6 +50,10 @@ public:
     }
     void SetUpStreamFeedbacks(std::vector<FeedbackInterface*>& feedbacks) { mUpStreamFeedbacks.swap(feedbacks); }
 
+    // items pushed are charged to the budget until processed
+    void SetMemoryBudget(const std::shared_ptr<PipelineMemoryBudget>& budget) { mMemoryBudget = budget; }
+    const std::shared_ptr<PipelineMemoryBudget>& GetMemoryBudget() const { return mMemoryBudget; }
+
 private:
     size_t Size() const override { return mQueue.size(); }
 
@@ -64,6 +68,7 @@ private:
     std::vector<SingleLogstoreSenderManager<SenderQueueParam>*> mDownStreamQueues;
     // std::vector<SenderQueue> mDownStreamQueues;
     std::vector<FeedbackInterface*> mUpStreamFeedbacks;
+    std::shared_ptr<PipelineMemoryBudget> mMemoryBudget;
 
 #ifdef APSARA_UNIT_TEST_MAIN
     friend class ProcessQueueManagerUnittest;
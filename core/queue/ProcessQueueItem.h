@@ -16,6 +16,7 @@
 
 #pragma once
 
+#include "common/memory/MemoryBudgetManager.h"
 #include "models/PipelineEventGroup.h"
 #include "pipeline/Pipeline.h"
 
@@ -27,6 +28,29 @@ struct ProcessQueueItem {
     size_t mInputIndex = 0; // index of the input in the pipeline
 
     ProcessQueueItem(PipelineEventGroup&& group, size_t index) : mEventGroup(std::move(group)), mInputIndex(index) {}
+    ~ProcessQueueItem() { ReleaseMemoryBudget(); }
+
+    // the source buffer of the group is charged to @budget until the item is destroyed, i.e. after it is processed
+    void ChargeMemoryBudget(const std::shared_ptr<PipelineMemoryBudget>& budget) {
+        if (!budget || mMemoryBudget) {
+            return;
+        }
+        const auto& sourceBuffer = mEventGroup.GetSourceBuffer();
+        mChargedBytes = sourceBuffer ? sourceBuffer->GetAllocatedSize() : 0;
+        mMemoryBudget = budget;
+        mMemoryBudget->Reserve(mChargedBytes);
+    }
+
+    void ReleaseMemoryBudget() {
+        if (mMemoryBudget) {
+            mMemoryBudget->Release(mChargedBytes);
+            mMemoryBudget.reset();
+        }
+    }
+
+private:
+    std::shared_ptr<PipelineMemoryBudget> mMemoryBudget;
+    int64_t mChargedBytes = 0;
 };
 
 } // namespace logtail
@@ -15,21 +15,61 @@
 #include "queue/ProcessQueueManager.h"
 
 #include "common/Flags.h"
+#include "common/memory/MemoryBudgetManager.h"
 #include "queue/ExactlyOnceQueueManager.h"
 #include "queue/QueueKeyManager.h"
 #include "queue/QueueParam.h"
 
+DEFINE_FLAG_BOOL(enable_concurrent_process_queue,
+                 "use lock-free process queues with work stealing, which reduces contention among process threads",
+                 false);
 DECLARE_FLAG_INT32(process_thread_count);
 
 using namespace std;
 
 namespace logtail {
 
+static bool IsMemoryBudgetValidToPush(const shared_ptr<PipelineMemoryBudget>& budget) {
+    return !budget || budget->IsValidToPush();
+}
+
+// append @first and following items in @que to @items, until @maxCnt items or at least @maxBytes bytes are popped
+template <class Q>
+static void PopMoreItems(Q& que,
+                         size_t maxCnt,
+                         size_t maxBytes,
+                         unique_ptr<ProcessQueueItem>&& first,
+                         vector<unique_ptr<ProcessQueueItem>>& items) {
+    size_t bytes = maxCnt > 1 ? first->mEventGroup.DataSize() : 0;
+    items.emplace_back(std::move(first));
+    unique_ptr<ProcessQueueItem> item;
+    for (size_t cnt = 1; cnt < maxCnt && bytes < maxBytes && que.Pop(item); ++cnt) {
+        bytes += item->mEventGroup.DataSize();
+        items.emplace_back(std::move(item));
+    }
+}
+
 ProcessQueueManager::ProcessQueueManager() {
     ResetCurrentQueueIndex();
+    if (BOOL_FLAG(enable_concurrent_process_queue)) {
+        mConcurrentQueueManager.reset(new ConcurrentProcessQueueManager(sMaxPriority));
+    }
 }
 
-bool ProcessQueueManager::CreateOrUpdateQueue(QueueKey key, uint32_t priority) {
+bool ProcessQueueManager::CreateOrUpdateQueue(QueueKey key, uint32_t priority, bool lowPriority) {
+    shared_ptr<PipelineMemoryBudget> budget;
+    const string& configName = QueueKeyManager::GetInstance()->GetName(key);
+    if (!configName.empty()) {
+        budget = MemoryBudgetManager::GetInstance()->CreateOrUpdateBudget(configName, lowPriority);
+    }
+    if (mConcurrentQueueManager) {
+        bool res = mConcurrentQueueManager->CreateOrUpdateQueue(key, priority);
+        auto que = mConcurrentQueueManager->FindQueue(key);
+        if (que && !que->GetMemoryBudget()) {
+            que->SetMemoryBudget(budget);
+        }
+        return res;
+    }
     lock_guard<mutex> lock(mQueueMux);
     auto iter = mQueues.find(key);
     if (iter != mQueues.end()) {
@@ -56,6 +96,7 @@ bool ProcessQueueManager::CreateOrUpdateQueue(QueueKey key, uint32_t priority) {
                                               priority,
                                               QueueKeyManager::GetInstance()->GetName(key));
         mQueues[key] = prev(mPriorityQueue[priority].end());
+        mQueues[key]->SetMemoryBudget(budget);
     }
     if (mCurrentQueueIndex.second == mPriorityQueue[mCurrentQueueIndex.first].end()) {
         mCurrentQueueIndex.second = mPriorityQueue[mCurrentQueueIndex.first].begin();
@@ -64,11 +105,19 @@ bool ProcessQueueManager::CreateOrUpdateQueue(QueueKey key, uint32_t priority) {
 }
 
 bool ProcessQueueManager::DeleteQueue(QueueKey key) {
+    if (mConcurrentQueueManager) {
+        if (!mConcurrentQueueManager->DeleteQueue(key)) {
+            return false;
+        }
+        MemoryBudgetManager::GetInstance()->DeleteBudget(QueueKeyManager::GetInstance()->GetName(key));
+        return true;
+    }
     lock_guard<mutex> lock(mQueueMux);
     auto iter = mQueues.find(key);
     if (iter == mQueues.end()) {
         return false;
     }
+    MemoryBudgetManager::GetInstance()->DeleteBudget(iter->second->GetConfigName());
     uint32_t priority = iter->second->GetPriority();
     auto queIter = iter->second;
     auto nextQueIter = mPriorityQueue[priority].erase(iter->second);
@@ -84,15 +133,33 @@ bool ProcessQueueManager::DeleteQueue(QueueKey key) {
 }
 
 bool ProcessQueueManager::IsValidToPush(QueueKey key) const {
+    if (mConcurrentQueueManager) {
+        auto que = mConcurrentQueueManager->FindQueue(key);
+        if (que) {
+            return que->IsValidToPush() && IsMemoryBudgetValidToPush(que->GetMemoryBudget());
+        }
+        return ExactlyOnceQueueManager::GetInstance()->IsValidToPushProcessQueue(key);
+    }
     lock_guard<mutex> lock(mQueueMux);
     auto iter = mQueues.find(key);
     if (iter != mQueues.end()) {
-        return iter->second->IsValidToPush();
+        return iter->second->IsValidToPush() && IsMemoryBudgetValidToPush(iter->second->GetMemoryBudget());
     }
     return ExactlyOnceQueueManager::GetInstance()->IsValidToPushProcessQueue(key);
 }
 
 int ProcessQueueManager::PushQueue(QueueKey key, unique_ptr<ProcessQueueItem>&& item) {
+    if (mConcurrentQueueManager) {
+        int res = mConcurrentQueueManager->PushQueue(key, std::move(item));
+        if (res == 2) {
+            res = ExactlyOnceQueueManager::GetInstance()->PushProcessQueue(key, std::move(item));
+        }
+        if (res != 0) {
+            return res;
+        }
+        Trigger();
+        return 0;
+    }
     {
         lock_guard<mutex> lock(mQueueMux);
         auto iter = mQueues.find(key);
@@ -112,7 +179,24 @@ int ProcessQueueManager::PushQueue(QueueKey key, unique_ptr<ProcessQueueItem>&&
 }
 
 bool ProcessQueueManager::PopItem(int64_t threadNo, unique_ptr<ProcessQueueItem>& item, string& configName) {
+    vector<unique_ptr<ProcessQueueItem>> items;
+    if (!PopItems(threadNo, 1, 0, items, configName)) {
+        return false;
+    }
+    item = std::move(items[0]);
+    return true;
+}
+
+bool ProcessQueueManager::PopItems(int64_t threadNo,
+                                   size_t maxCnt,
+                                   size_t maxBytes,
+                                   vector<unique_ptr<ProcessQueueItem>>& items,
+                                   string& configName) {
     configName.clear();
+    if (mConcurrentQueueManager) {
+        return PopConcurrentItems(threadNo, maxCnt, maxBytes, items, configName);
+    }
+    unique_ptr<ProcessQueueItem> item;
     lock_guard<mutex> lock(mQueueMux);
     for (size_t i = 0; i <= sMaxPriority; ++i) {
         list<ProcessQueue>::iterator iter;
@@ -143,6 +227,7 @@ bool ProcessQueueManager::PopItem(int64_t threadNo, unique_ptr<ProcessQueueItem>
             }
         }
         if (!configName.empty()) {
+            PopMoreItems(*iter, maxCnt, maxBytes, std::move(item), items);
             mCurrentQueueIndex.first = i;
             mCurrentQueueIndex.second = ++iter;
             if (mCurrentQueueIndex.second == mPriorityQueue[i].end()) {
@@ -151,29 +236,64 @@ bool ProcessQueueManager::PopItem(int64_t threadNo, unique_ptr<ProcessQueueItem>
             return true;
         }
         // find exactly once queues next
-        {
-            lock_guard<mutex> lock(ExactlyOnceQueueManager::GetInstance()->mProcessQueueMux);
-            for (auto iter = ExactlyOnceQueueManager::GetInstance()->mProcessPriorityQueue[i].begin();
-                 iter != ExactlyOnceQueueManager::GetInstance()->mProcessPriorityQueue[i].end();
-                 ++iter) {
-                // process queue for exactly once can only be assgined to one specific thread
-                if (iter->GetKey() % INT32_FLAG(process_thread_count) != threadNo) {
-                    continue;
-                }
-                if (!iter->Pop(item)) {
-                    continue;
-                }
-                configName = iter->GetConfigName();
-                ResetCurrentQueueIndex();
-                return true;
-            }
+        if (PopExactlyOnceItems(threadNo, i, maxCnt, maxBytes, items, configName)) {
+            ResetCurrentQueueIndex();
+            return true;
         }
     }
     ResetCurrentQueueIndex();
     return false;
 }
 
+bool ProcessQueueManager::PopExactlyOnceItems(int64_t threadNo,
+                                              uint32_t priority,
+                                              size_t maxCnt,
+                                              size_t maxBytes,
+                                              vector<unique_ptr<ProcessQueueItem>>& items,
+                                              string& configName) {
+    unique_ptr<ProcessQueueItem> item;
+    lock_guard<mutex> lock(ExactlyOnceQueueManager::GetInstance()->mProcessQueueMux);
+    for (auto iter = ExactlyOnceQueueManager::GetInstance()->mProcessPriorityQueue[priority].begin();
+         iter != ExactlyOnceQueueManager::GetInstance()->mProcessPriorityQueue[priority].end();
+         ++iter) {
+        // process queue for exactly once can only be assgined to one specific thread
+        if (iter->GetKey() % INT32_FLAG(process_thread_count) != threadNo) {
+            continue;
+        }
+        if (!iter->Pop(item)) {
+            continue;
+        }
+        configName = iter->GetConfigName();
+        PopMoreItems(*iter, maxCnt, maxBytes, std::move(item), items);
+        return true;
+    }
+    return false;
+}
+
+bool ProcessQueueManager::PopConcurrentItems(int64_t threadNo,
+                                             size_t maxCnt,
+                                             size_t maxBytes,
+                                             vector<unique_ptr<ProcessQueueItem>>& items,
+                                             string& configName) {
+    for (uint32_t i = 0; i <= sMaxPriority; ++i) {
+        if (mConcurrentQueueManager->PopItems(
+                threadNo, INT32_FLAG(process_thread_count), i, maxCnt, maxBytes, items, configName)) {
+            return true;
+        }
+        if (PopExactlyOnceItems(threadNo, i, maxCnt, maxBytes, items, configName)) {
+            return true;
+        }
+    }
+    return false;
+}
+
 bool ProcessQueueManager::IsAllQueueEmpty() const {
+    if (mConcurrentQueueManager) {
+        if (!mConcurrentQueueManager->IsAllQueueEmpty()) {
+            return false;
+        }
+        return ExactlyOnceQueueManager::GetInstance()->IsAllProcessQueueEmpty();
+    }
     {
         lock_guard<mutex> lock(mQueueMux);
         for (const auto& q : mQueues) {
@@ -187,6 +307,14 @@ bool ProcessQueueManager::IsAllQueueEmpty() const {
 
 bool ProcessQueueManager::SetDownStreamQueues(QueueKey key,
                                               vector<SingleLogstoreSenderManager<SenderQueueParam>*>& ques) {
+    if (mConcurrentQueueManager) {
+        auto que = mConcurrentQueueManager->FindQueue(key);
+        if (!que) {
+            return false;
+        }
+        que->SetDownStreamQueues(ques);
+        return true;
+    }
     lock_guard<mutex> lock(mQueueMux);
     auto iter = mQueues.find(key);
     if (iter == mQueues.end()) {
@@ -197,11 +325,25 @@ bool ProcessQueueManager::SetDownStreamQueues(QueueKey key,
 }
 
 bool ProcessQueueManager::SetFeedbackInterface(QueueKey key, std::vector<FeedbackInterface*>& feedback) {
+    if (mConcurrentQueueManager) {
+        auto que = mConcurrentQueueManager->FindQueue(key);
+        if (!que) {
+            return false;
+        }
+        if (que->GetMemoryBudget()) {
+            que->GetMemoryBudget()->SetUpStreamFeedbacks(key, feedback);
+        }
+        que->SetUpStreamFeedbacks(feedback);
+        return true;
+    }
     lock_guard<mutex> lock(mQueueMux);
     auto iter = mQueues.find(key);
     if (iter == mQueues.end()) {
         return false;
     }
+    if (iter->second->GetMemoryBudget()) {
+        iter->second->GetMemoryBudget()->SetUpStreamFeedbacks(key, feedback);
+    }
     iter->second->SetUpStreamFeedbacks(feedback);
     return true;
 }
@@ -209,6 +351,13 @@ bool ProcessQueueManager::SetFeedbackInterface(QueueKey key, std::vector<Feedbac
 void ProcessQueueManager::InvalidatePop(const std::string& configName) {
     if (QueueKeyManager::GetInstance()->HasKey(configName)) {
         auto key = QueueKeyManager::GetInstance()->GetKey(configName);
+        if (mConcurrentQueueManager) {
+            auto que = mConcurrentQueueManager->FindQueue(key);
+            if (que) {
+                que->InvalidatePop();
+            }
+            return;
+        }
         lock_guard<mutex> lock(mQueueMux);
         auto iter = mQueues.find(key);
         if (iter != mQueues.end()) {
@@ -222,6 +371,13 @@ void ProcessQueueManager::InvalidatePop(const std::string& configName) {
 void ProcessQueueManager::ValidatePop(const std::string& configName) {
     if (QueueKeyManager::GetInstance()->HasKey(configName)) {
         auto key = QueueKeyManager::GetInstance()->GetKey(configName);
+        if (mConcurrentQueueManager) {
+            auto que = mConcurrentQueueManager->FindQueue(key);
+            if (que) {
+                que->ValidatePop();
+            }
+            return;
+        }
         lock_guard<mutex> lock(mQueueMux);
         auto iter = mQueues.find(key);
         if (iter != mQueues.end()) {
@@ -253,6 +409,9 @@ void ProcessQueueManager::ResetCurrentQueueIndex() {
 }
 
 uint32_t ProcessQueueManager::GetInvalidCnt() const {
+    if (mConcurrentQueueManager) {
+        return mConcurrentQueueManager->GetInvalidCnt();
+    }
     uint32_t res = 0;
     lock_guard<mutex> lock(mQueueMux);
     for (const auto& q : mQueues) {
@@ -264,12 +423,18 @@ uint32_t ProcessQueueManager::GetInvalidCnt() const {
 }
 
 uint32_t ProcessQueueManager::GetCnt() const {
+    if (mConcurrentQueueManager) {
+        return mConcurrentQueueManager->GetCnt();
+    }
     lock_guard<mutex> lock(mQueueMux);
     return mQueues.size();
 }
 
 #ifdef APSARA_UNIT_TEST_MAIN
 void ProcessQueueManager::Clear() {
+    if (mConcurrentQueueManager) {
+        mConcurrentQueueManager->Clear();
+    }
     lock_guard<mutex> lock(mQueueMux);
     mQueues.clear();
     for (size_t i = 0; i <= sMaxPriority; ++i) {
@@ -24,6 +24,7 @@
 #include <vector>
 
 #include "common/FeedbackInterface.h"
+#include "queue/ConcurrentProcessQueueManager.h"
 #include "queue/ProcessQueue.h"
 #include "queue/ProcessQueueItem.h"
 
@@ -41,12 +42,21 @@ public:
 
     void Feedback(QueueKey key) override { Trigger(); }
 
-    bool CreateOrUpdateQueue(QueueKey key, uint32_t priority);
+    // @lowPriority marks the pipelines paused first when memory runs short, i.e. the ones configured with the lowest
+    // priority explicitly
+    bool CreateOrUpdateQueue(QueueKey key, uint32_t priority, bool lowPriority = false);
     bool DeleteQueue(QueueKey key);
     bool IsValidToPush(QueueKey key) const override;
     // 0: success, 1: queue is full, 2: queue not found
     int PushQueue(QueueKey key, std::unique_ptr<ProcessQueueItem>&& item);
     bool PopItem(int64_t threadNo, std::unique_ptr<ProcessQueueItem>& item, std::string& configName);
+    // pop up to @maxCnt items from the same queue, stop early once at least @maxBytes bytes are popped, popped items
+    // are appended to @items and all of them belong to @configName
+    bool PopItems(int64_t threadNo,
+                  size_t maxCnt,
+                  size_t maxBytes,
+                  std::vector<std::unique_ptr<ProcessQueueItem>>& items,
+                  std::string& configName);
     bool IsAllQueueEmpty() const;
     bool SetDownStreamQueues(QueueKey key, std::vector<SingleLogstoreSenderManager<SenderQueueParam>*>& ques);
     bool SetFeedbackInterface(QueueKey key, std::vector<FeedbackInterface*>& feedback);
@@ -67,6 +77,21 @@ private:
     ~ProcessQueueManager() = default;
 
     void ResetCurrentQueueIndex();
+    bool PopExactlyOnceItems(int64_t threadNo,
+                             uint32_t priority,
+                             size_t maxCnt,
+                             size_t maxBytes,
+                             std::vector<std::unique_ptr<ProcessQueueItem>>& items,
+                             std::string& configName);
+    bool PopConcurrentItems(int64_t threadNo,
+                            size_t maxCnt,
+                            size_t maxBytes,
+                            std::vector<std::unique_ptr<ProcessQueueItem>>& items,
+                            std::string& configName);
+
+    // not null if concurrent process queue is enabled, in which case all non exactly once queues are managed by it
+    // instead of the following members
+    std::unique_ptr<ConcurrentProcessQueueManager> mConcurrentQueueManager;
 
     mutable std::mutex mQueueMux;
     std::unordered_map<QueueKey, std::list<ProcessQueue>::iterator> mQueues;
@@ -81,6 +106,7 @@ private:
     void Clear();
     friend class ProcessQueueManagerUnittest;
     friend class PipelineUnittest;
+    friend class ProcessQueueManagerBenchmark;
 #endif
 };
 
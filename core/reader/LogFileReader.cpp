@@ -837,8 +837,9 @@ void LogFileReader::FixLastFilePos(LogFileOperator& op, int64_t endOffset) {
         for (size_t endPs = 0; endPs < readSizeReal - 1; ++endPs) {
             if (readBuf[endPs] == '\n') {
                 LineInfo line = GetLastLine(StringView(readBuf, readSizeReal - 1), endPs, true);
-                if (BoostRegexSearch(
-                        line.data.data(), line.data.size(), *mMultilineConfig.first->GetStartPatternReg(), exception)) {
+                MultilineOptions::LineMatchResult lineResult;
+                if (mMultilineConfig.first->IsLineMatched(
+                        line.data, MultilineOptions::PatternType::START, lineResult, exception)) {
                     mLastFilePos += line.lineBegin;
                     mCache.clear();
                     free(readBuf);
@@ -2098,22 +2099,19 @@ LogFileReader::RemoveLastIncompleteLog(char* buffer, int32_t size, int32_t& roll
         std::string exception;
         while (endPs >= 0) {
             LineInfo content = GetLastLine(StringView(buffer, size), endPs, false);
+            MultilineOptions::LineMatchResult lineResult;
             if (mMultilineConfig.first->GetEndPatternReg()) {
                 // start + end, continue + end, end
-                if (BoostRegexSearch(content.data.data(),
-                                     content.data.size(),
-                                     *mMultilineConfig.first->GetEndPatternReg(),
-                                     exception)) {
+                if (mMultilineConfig.first->IsLineMatched(
+                        content.data, MultilineOptions::PatternType::END, lineResult, exception)) {
                     // Ensure the end line is complete
                     if (buffer[content.lineEnd] == '\n') {
                         return content.lineEnd + 1;
                     }
                 }
             } else if (mMultilineConfig.first->GetStartPatternReg()
-                       && BoostRegexSearch(content.data.data(),
-                                           content.data.size(),
-                                           *mMultilineConfig.first->GetStartPatternReg(),
-                                           exception)) {
+                       && mMultilineConfig.first->IsLineMatched(
+                           content.data, MultilineOptions::PatternType::START, lineResult, exception)) {
                 // start + continue, start
                 rollbackLineFeedCount += content.rollbackLineFeedCount;
                 // Keep all the buffer if rollback all
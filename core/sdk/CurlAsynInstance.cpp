@@ -18,6 +18,14 @@
 #include "Result.h"
 #include <curl/curl.h>
 #include <curl/multi.h>
+#if defined(__linux__)
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
+#include <algorithm>
+#include <chrono>
+#endif
+#include <unordered_map>
 #include "logger/Logger.h"
 #include "app_config/AppConfig.h"
 #include "common/TimeUtil.h"
@@ -39,10 +47,57 @@ namespace sdk {
                           HttpMessage& httpMessage,
                           const std::string& intf,
                           const bool httpsFlag,
-                          curl_slist*& headers);
+                          curl_slist*& headers,
+                          CURL* reusedCurl);
+
+    // Idle easy handles of finished requests, grouped by the endpoint they talked to. A reused handle keeps its TLS
+    // session cache, and finds the connection it left in the connection cache of the multi handle. Only accessed by the
+    // thread owning the multi handle.
+    class CurlHandlePool {
+    public:
+        ~CurlHandlePool() {
+            for (auto& item : mIdleHandles) {
+                for (CURL* curl : item.second) {
+                    curl_easy_cleanup(curl);
+                }
+            }
+        }
 
+        static std::string GetKey(const AsynRequest* request) {
+            return (request->mHTTPSFlag ? "https://" : "http://") + request->mHost + ":"
+                + std::to_string(request->mPort) + "/" + request->mInterface;
+        }
+
+        CURL* Get(const std::string& key) {
+            auto iter = mIdleHandles.find(key);
+            if (iter == mIdleHandles.end() || iter->second.empty()) {
+                return NULL;
+            }
+            CURL* curl = iter->second.back();
+            iter->second.pop_back();
+            return curl;
+        }
+
+        void Put(const std::string& key, CURL* curl) {
+            auto& handles = mIdleHandles[key];
+            if (handles.size() >= LOGTAIL_SDK_CURL_MAX_IDLE_HANDLE_PER_HOST) {
+                curl_easy_cleanup(curl);
+                return;
+            }
+            handles.push_back(curl);
+        }
+
+    private:
+        std::unordered_map<std::string, std::vector<CURL*>> mIdleHandles;
+    };
 
     CurlAsynInstance::CurlAsynInstance() {
+#if defined(__linux__)
+        mWakeupFd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+        if (mWakeupFd < 0) {
+            LOG_ERROR(sLogger, ("failed to create eventfd for curl event loop", strerror(errno)));
+        }
+#endif
         for (int i = 0; i < LOGTAIL_SDK_CURL_THREAD_POOL_SIZE; ++i) {
             mMainThreads.push_back(new boost::thread(boost::bind(&CurlAsynInstance::Run, this)));
         }
@@ -53,9 +108,26 @@ namespace sdk {
             mMainThreads[i]->join();
             delete mMainThreads[i];
         }
+#if defined(__linux__)
+        if (mWakeupFd >= 0) {
+            close(mWakeupFd);
+        }
+#endif
+    }
+
+    void CurlAsynInstance::AddRequest(AsynRequest* request) {
+        mRequestQueue.push(request);
+#if defined(__linux__)
+        uint64_t one = 1;
+        if (mWakeupFd >= 0 && write(mWakeupFd, &one, sizeof(one)) < 0 && errno != EAGAIN) {
+            LOG_WARNING(sLogger, ("failed to wake up curl event loop", strerror(errno)));
+        }
+#endif
     }
 
-    static bool AddRequestToMultiHandler(CURLM* multi_handle, AsynRequest* request) {
+    bool CurlAsynInstance::AddRequestToMultiHandler(CURLM* multi_handle,
+                                                    CurlHandlePool& handlePool,
+                                                    AsynRequest* request) {
         curl_slist* headers = NULL;
         CURL* curl = PackCurlRequest(request->mHTTPMethod,
                                      request->mHost,
@@ -68,7 +140,8 @@ namespace sdk {
                                      request->mCallBack->mHTTPMessage,
                                      request->mInterface,
                                      request->mHTTPSFlag,
-                                     headers);
+                                     headers,
+                                     handlePool.Get(CurlHandlePool::GetKey(request)));
         if (curl == NULL) {
             request->mCallBack->OnFail(request->mResponse, LOGE_UNKNOWN_ERROR, "Init curl fail.");
             delete request;
@@ -80,13 +153,18 @@ namespace sdk {
         if (addRst != CURLM_OK) {
             request->mCallBack->OnFail(
                 request->mResponse, LOGE_UNKNOWN_ERROR, "curl_multi_add_handle failed: " + std::to_string(addRst));
+            if (headers != NULL) {
+                curl_slist_free_all(headers);
+            }
             curl_easy_cleanup(curl);
             delete request;
             return false;
         }
+        ++mInFlightRequestCount;
         return true;
     }
 
+    // the easy handle is left to the caller, which returns it to the pool or cleans it up
     static void on_handle_done(CURL* curl, curl_slist* headers, AsynRequest* request, CURLcode res) {
         if (headers != NULL) {
             curl_slist_free_all(headers);
@@ -96,15 +174,12 @@ namespace sdk {
             case CURLE_OK:
                 break;
             case CURLE_OPERATION_TIMEDOUT:
-                curl_easy_cleanup(curl);
                 request->mCallBack->OnFail(request->mResponse, LOGE_REQUEST_TIMEOUT, "Request operation timeout.");
                 return;
             case CURLE_COULDNT_CONNECT:
-                curl_easy_cleanup(curl);
                 request->mCallBack->OnFail(request->mResponse, LOGE_REQUEST_ERROR, "Can not connect to server.");
                 return;
             default:
-                curl_easy_cleanup(curl);
                 request->mCallBack->OnFail(request->mResponse,
                                            LOGE_REQUEST_ERROR,
                                            string("Request operation failed, curl error code : ")
@@ -114,7 +189,6 @@ namespace sdk {
 
         long http_code = 0;
         if ((res = curl_easy_getinfo(curl, CURLINFO_RESPONSE_CODE, &http_code)) != CURLE_OK) {
-            curl_easy_cleanup(curl);
             request->mCallBack->OnFail(request->mResponse,
                                        LOGE_UNKNOWN_ERROR,
                                        string("Get curl response code error, curl error code : ")
@@ -122,7 +196,6 @@ namespace sdk {
             return;
         }
         request->mCallBack->mHTTPMessage.statusCode = (int32_t)http_code;
-        curl_easy_cleanup(curl);
         if (!request->mCallBack->mHTTPMessage.IsLogServiceResponse()) {
             request->mCallBack->OnFail(request->mResponse, LOGE_REQUEST_ERROR, "Get invalid response");
             return;
@@ -165,7 +238,7 @@ namespace sdk {
     }
 
     /* Check for completed transfers, and remove their easy handles */
-    static void check_multi_info(CURLM* multi_handle) {
+    void CurlAsynInstance::CheckMultiInfo(CURLM* multi_handle, CurlHandlePool& handlePool) {
         int msgs_left;
         CURL* easy;
         CURLcode res;
@@ -178,7 +251,21 @@ namespace sdk {
                 curl_easy_getinfo(easy, CURLINFO_PRIVATE, &request);
                 LOG_DEBUG(sLogger, ("DONE: ", res)(request->mHost + request->mUrl, curl_easy_strerror(res)));
                 curl_multi_remove_handle(multi_handle, easy);
+                --mInFlightRequestCount;
+                if (res == CURLE_OK) {
+                    long newConnectionCount = 0;
+                    if (curl_easy_getinfo(easy, CURLINFO_NUM_CONNECTS, &newConnectionCount) == CURLE_OK
+                        && newConnectionCount == 0) {
+                        ++mHandshakeAvoidedCount;
+                    }
+                }
                 on_handle_done(easy, (curl_slist*)request->mPrivateData, request, res);
+                // handles of failed transfers may be left in a bad state, do not reuse them
+                if (res == CURLE_OK) {
+                    handlePool.Put(CurlHandlePool::GetKey(request), easy);
+                } else {
+                    curl_easy_cleanup(easy);
+                }
                 delete request;
             }
             msg = curl_multi_info_read(multi_handle, &msgs_left);
@@ -191,25 +278,143 @@ namespace sdk {
             LOG_ERROR(sLogger, ("Init multi curl error", ""));
             return;
         }
+        curl_multi_setopt(multi_handle, CURLMOPT_MAXCONNECTS, (long)LOGTAIL_SDK_CURL_MAX_CACHED_CONNECTIONS);
+        CurlHandlePool handlePool;
+#if defined(__linux__)
+        EventLoop(multi_handle, handlePool);
+#else
         while (true) {
             AsynRequest* request = NULL;
             if (mRequestQueue.wait_and_pop(request)) {
-                if (!AddRequestToMultiHandler(multi_handle, request)) {
+                if (!AddRequestToMultiHandler(multi_handle, handlePool, request)) {
                     continue;
                 }
             }
-            MultiHandlerLoop(multi_handle);
+            MultiHandlerLoop(multi_handle, handlePool);
         }
+#endif
         curl_multi_cleanup(multi_handle);
     }
 
-    bool CurlAsynInstance::MultiHandlerLoop(CURLM* multi_handle) {
+#if defined(__linux__)
+    namespace {
+        struct EpollState {
+            int mEpollFd = -1;
+            // deadline of the timer requested by curl in steady clock milliseconds, -1 if there is no timer
+            int64_t mTimerDeadline = -1;
+        };
+
+        int64_t GetSteadyTimeInMilliSeconds() {
+            return std::chrono::duration_cast<std::chrono::milliseconds>(
+                       std::chrono::steady_clock::now().time_since_epoch())
+                .count();
+        }
+
+        int OnCurlSocket(CURL* easy, curl_socket_t s, int what, void* userp, void* socketp) {
+            EpollState* state = static_cast<EpollState*>(userp);
+            if (what == CURL_POLL_REMOVE) {
+                epoll_ctl(state->mEpollFd, EPOLL_CTL_DEL, s, NULL);
+                return 0;
+            }
+            struct epoll_event event;
+            memset(&event, 0, sizeof(event));
+            event.data.fd = s;
+            if (what & CURL_POLL_IN) {
+                event.events |= EPOLLIN;
+            }
+            if (what & CURL_POLL_OUT) {
+                event.events |= EPOLLOUT;
+            }
+            if (epoll_ctl(state->mEpollFd, EPOLL_CTL_MOD, s, &event) != 0) {
+                if (errno != ENOENT || epoll_ctl(state->mEpollFd, EPOLL_CTL_ADD, s, &event) != 0) {
+                    LOG_WARNING(sLogger, ("failed to watch curl socket", strerror(errno))("socket", s));
+                    return -1;
+                }
+            }
+            return 0;
+        }
+
+        int OnCurlTimer(CURLM* multi, long timeoutMs, void* userp) {
+            EpollState* state = static_cast<EpollState*>(userp);
+            state->mTimerDeadline = timeoutMs < 0 ? -1 : GetSteadyTimeInMilliSeconds() + timeoutMs;
+            return 0;
+        }
+    } // namespace
+
+    void CurlAsynInstance::EventLoop(CURLM* multi_handle, CurlHandlePool& handlePool) {
+        static const int kMaxEventCount = 256;
+        // wake up periodically in case a request is added without waking up the loop
+        static const int64_t kMaxWaitMs = 500;
+
+        EpollState state;
+        state.mEpollFd = epoll_create1(EPOLL_CLOEXEC);
+        if (state.mEpollFd < 0) {
+            LOG_ERROR(sLogger, ("failed to create epoll for curl event loop", strerror(errno)));
+            return;
+        }
+        if (mWakeupFd >= 0) {
+            struct epoll_event event;
+            memset(&event, 0, sizeof(event));
+            event.events = EPOLLIN;
+            event.data.fd = mWakeupFd;
+            epoll_ctl(state.mEpollFd, EPOLL_CTL_ADD, mWakeupFd, &event);
+        }
+        curl_multi_setopt(multi_handle, CURLMOPT_SOCKETFUNCTION, OnCurlSocket);
+        curl_multi_setopt(multi_handle, CURLMOPT_SOCKETDATA, &state);
+        curl_multi_setopt(multi_handle, CURLMOPT_TIMERFUNCTION, OnCurlTimer);
+        curl_multi_setopt(multi_handle, CURLMOPT_TIMERDATA, &state);
+
+        struct epoll_event events[kMaxEventCount];
+        int running = 0;
+        while (true) {
+            AsynRequest* request = NULL;
+            while (mRequestQueue.try_pop(request)) {
+                AddRequestToMultiHandler(multi_handle, handlePool, request);
+            }
+
+            int64_t waitMs = kMaxWaitMs;
+            if (state.mTimerDeadline >= 0) {
+                waitMs = std::max(std::min(state.mTimerDeadline - GetSteadyTimeInMilliSeconds(), kMaxWaitMs), int64_t(0));
+            }
+            int eventCount = epoll_wait(state.mEpollFd, events, kMaxEventCount, static_cast<int>(waitMs));
+            for (int i = 0; i < eventCount; ++i) {
+                int fd = events[i].data.fd;
+                if (fd == mWakeupFd) {
+                    uint64_t value = 0;
+                    if (read(mWakeupFd, &value, sizeof(value)) < 0 && errno != EAGAIN) {
+                        LOG_WARNING(sLogger, ("failed to read eventfd of curl event loop", strerror(errno)));
+                    }
+                    continue;
+                }
+                int action = 0;
+                if (events[i].events & EPOLLIN) {
+                    action |= CURL_CSELECT_IN;
+                }
+                if (events[i].events & EPOLLOUT) {
+                    action |= CURL_CSELECT_OUT;
+                }
+                if (events[i].events & (EPOLLERR | EPOLLHUP)) {
+                    action |= CURL_CSELECT_ERR;
+                }
+                curl_multi_socket_action(multi_handle, fd, action, &running);
+            }
+            if (state.mTimerDeadline >= 0 && GetSteadyTimeInMilliSeconds() >= state.mTimerDeadline) {
+                // the timer may be set again during the action
+                state.mTimerDeadline = -1;
+                curl_multi_socket_action(multi_handle, CURL_SOCKET_TIMEOUT, 0, &running);
+            }
+            CheckMultiInfo(multi_handle, handlePool);
+        }
+        close(state.mEpollFd);
+    }
+#else
+    bool CurlAsynInstance::MultiHandlerLoop(CURLM* multi_handle, CurlHandlePool& handlePool) {
         int still_running = 1;
         /* we start some action by calling perform right away */
 
         while (still_running) {
             curl_multi_perform(multi_handle, &still_running);
-            check_multi_info(multi_handle);
+            CheckMultiInfo(multi_handle, handlePool);
 
             struct timeval timeout;
             int rc; /* select() return code */
@@ -254,7 +459,7 @@ namespace sdk {
            curl_multi_fdset() doc. */
             AsynRequest* request = NULL;
             if (mRequestQueue.try_pop(request)) {
-                if (AddRequestToMultiHandler(multi_handle, request)) {
+                if (AddRequestToMultiHandler(multi_handle, handlePool, request)) {
                     ++still_running;
                     continue;
                 }
@@ -288,7 +493,7 @@ namespace sdk {
         }
         return true;
     }
-
+#endif
 
 } // namespace sdk
 } // namespace logtail
@@ -16,6 +16,7 @@
 
 #pragma once
 #include "Common.h"
+#include <atomic>
 #include <queue>
 #include <boost/thread.hpp>
 #include <curl/curl.h>
@@ -24,6 +25,12 @@ namespace logtail {
 namespace sdk {
 
 #define LOGTAIL_SDK_CURL_THREAD_POOL_SIZE (1)
+// idle easy handles kept for each endpoint, which are reused by following requests to save handshakes
+#define LOGTAIL_SDK_CURL_MAX_IDLE_HANDLE_PER_HOST (16)
+// connections kept alive in the connection cache of each multi handle
+#define LOGTAIL_SDK_CURL_MAX_CACHED_CONNECTIONS (64)
+
+    class CurlHandlePool;
 
     class CurlAsynInstance {
     public:
@@ -82,15 +89,34 @@ namespace sdk {
             }
         };
 
-        void AddRequest(AsynRequest* request) { mRequestQueue.push(request); }
+        void AddRequest(AsynRequest* request);
 
         void Run();
 
-        bool MultiHandlerLoop(CURLM* multiHandler);
+#if defined(__linux__)
+        // drive transfers by curl_multi_socket_action on sockets watched by epoll
+        void EventLoop(CURLM* multiHandler, CurlHandlePool& handlePool);
+#else
+        bool MultiHandlerLoop(CURLM* multiHandler, CurlHandlePool& handlePool);
+#endif
+
+        // requests added to multi handles but not finished yet
+        int64_t GetInFlightRequestCount() const { return mInFlightRequestCount.load(); }
+        // requests finished on a cached connection since last call, each of which saved TCP and TLS handshakes
+        uint64_t ExchangeHandshakeAvoidedCount() { return mHandshakeAvoidedCount.exchange(0); }
 
     private:
+        bool AddRequestToMultiHandler(CURLM* multiHandler, CurlHandlePool& handlePool, AsynRequest* request);
+        void CheckMultiInfo(CURLM* multiHandler, CurlHandlePool& handlePool);
+
         RequestQueue<AsynRequest*> mRequestQueue;
         std::vector<boost::thread*> mMainThreads;
+        std::atomic_int64_t mInFlightRequestCount{0};
+        std::atomic_uint64_t mHandshakeAvoidedCount{0};
+#if defined(__linux__)
+        // eventfd written when a request is added, so that event loops blocked in epoll_wait pick it up at once
+        int mWakeupFd = -1;
+#endif
     };
 
 } // namespace sdk
@@ -84,10 +84,17 @@ namespace sdk {
                           HttpMessage& httpMessage,
                           const std::string& intf,
                           const bool httpsFlag,
-                          curl_slist*& headers) {
+                          curl_slist*& headers,
+                          CURL* reusedCurl) {
         static DnsCache* dnsCache = DnsCache::GetInstance();
 
-        CURL* curl = curl_easy_init();
+        CURL* curl = reusedCurl;
+        if (curl != NULL) {
+            // options are cleared, while connections, session ID and DNS caches are kept
+            curl_easy_reset(curl);
+        } else {
+            curl = curl_easy_init();
+        }
         if (curl == NULL)
             return NULL;
 
@@ -149,8 +156,19 @@ namespace sdk {
                           const std::string& intf,
                           const bool httpsFlag) {
         curl_slist* headers = NULL;
-        CURL* curl = PackCurlRequest(
-            httpMethod, host, port, url, queryString, header, body, timeout, httpMessage, intf, httpsFlag, headers);
+        CURL* curl = PackCurlRequest(httpMethod,
+                                     host,
+                                     port,
+                                     url,
+                                     queryString,
+                                     header,
+                                     body,
+                                     timeout,
+                                     httpMessage,
+                                     intf,
+                                     httpsFlag,
+                                     headers,
+                                     NULL);
         if (curl == NULL) {
             throw LOGException(LOGE_UNKNOWN_ERROR, "Init curl instance error.");
         }
@@ -0,0 +1,127 @@
+// Copyright 2024 iLogtail Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "sender/BufferFileReader.h"
+
+#if defined(__linux__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include <cstdio>
+
+#include "common/FileSystemUtil.h"
+
+namespace logtail {
+
+#if defined(__linux__)
+bool BufferFileReader::Open(const std::string& fileName) {
+    Close();
+    mFd = open(fileName.c_str(), O_RDWR);
+    if (mFd < 0) {
+        return false;
+    }
+    struct stat buf;
+    if (fstat(mFd, &buf) != 0) {
+        Close();
+        return false;
+    }
+    mFileSize = buf.st_size;
+    if (mFileSize > 0) {
+        void* data = mmap(nullptr, static_cast<size_t>(mFileSize), PROT_READ, MAP_SHARED, mFd, 0);
+        if (data == MAP_FAILED) {
+            Close();
+            return false;
+        }
+        mData = static_cast<char*>(data);
+    }
+    mFileName = fileName;
+    return true;
+}
+
+void BufferFileReader::Close() {
+    if (mData != nullptr) {
+        munmap(mData, static_cast<size_t>(mFileSize));
+        mData = nullptr;
+    }
+    if (mFd >= 0) {
+        close(mFd);
+        mFd = -1;
+    }
+    mFileName.clear();
+    mFileSize = 0;
+}
+
+const char* BufferFileReader::GetData(int64_t pos, size_t size) const {
+    if (pos < 0 || pos > mFileSize || size > static_cast<size_t>(mFileSize - pos) || mData == nullptr) {
+        return nullptr;
+    }
+    return mData + pos;
+}
+
+bool BufferFileReader::Write(int64_t pos, const void* buf, size_t size) {
+    if (mFd < 0) {
+        return false;
+    }
+    return pwrite(mFd, buf, size, pos) == static_cast<ssize_t>(size);
+}
+#else
+bool BufferFileReader::Open(const std::string& fileName) {
+    Close();
+    FILE* f = FileReadOnlyOpen(fileName.c_str(), "rb");
+    if (f == nullptr) {
+        return false;
+    }
+    fseek(f, 0, SEEK_END);
+    mFileSize = ftell(f);
+    fseek(f, 0, SEEK_SET);
+    mContent.resize(static_cast<size_t>(mFileSize));
+    bool res = fread(&mContent[0], 1, mContent.size(), f) == mContent.size();
+    fclose(f);
+    if (!res) {
+        Close();
+        return false;
+    }
+    mFileName = fileName;
+    return true;
+}
+
+void BufferFileReader::Close() {
+    std::string().swap(mContent);
+    mFileName.clear();
+    mFileSize = 0;
+}
+
+const char* BufferFileReader::GetData(int64_t pos, size_t size) const {
+    if (pos < 0 || pos > mFileSize || size > static_cast<size_t>(mFileSize - pos)) {
+        return nullptr;
+    }
+    return mContent.data() + pos;
+}
+
+bool BufferFileReader::Write(int64_t pos, const void* buf, size_t size) {
+    FILE* f = FileWriteOnlyOpen(mFileName.c_str(), "wb");
+    if (f == nullptr) {
+        return false;
+    }
+    fseek(f, static_cast<long>(pos), SEEK_SET);
+    bool res = fwrite(buf, 1, size, f) == size;
+    fclose(f);
+    return res;
+}
+#endif
+
+} // namespace logtail
@@ -0,0 +1,57 @@
+/*
+ * Copyright 2024 iLogtail Authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace logtail {
+
+// Reads a buffer file of the secondary storage for replay, which is no longer appended by then.
+//
+// On Linux the file is mapped into memory once, instead of being opened and sought for each record, elsewhere it is
+// read into memory at once. Writes, i.e. the metas of records written back, go to the file directly, and are seen
+// through the shared mapping. Buffer files are not truncated while being replayed, so the mapping is never accessed
+// beyond the end of file.
+class BufferFileReader {
+public:
+    BufferFileReader() = default;
+    BufferFileReader(const BufferFileReader&) = delete;
+    BufferFileReader& operator=(const BufferFileReader&) = delete;
+    ~BufferFileReader() { Close(); }
+
+    bool Open(const std::string& fileName);
+    void Close();
+
+    int64_t GetFileSize() const { return mFileSize; }
+    // @return [pos, pos + size) of the file, or nullptr if it is beyond the end of file
+    const char* GetData(int64_t pos, size_t size) const;
+    bool Write(int64_t pos, const void* buf, size_t size);
+
+private:
+    std::string mFileName;
+    int64_t mFileSize = 0;
+#if defined(__linux__)
+    int mFd = -1;
+    char* mData = nullptr;
+#else
+    std::string mContent;
+#endif
+};
+
+} // namespace logtail
@@ -0,0 +1,118 @@
+// Copyright 2024 iLogtail Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "sender/BufferFileWriter.h"
+
+#if defined(__linux__)
+#include <unistd.h>
+#endif
+
+#include <algorithm>
+
+#include "common/ErrorUtil.h"
+#include "common/FileSystemUtil.h"
+#include "common/Flags.h"
+#include "logger/Logger.h"
+
+DEFINE_FLAG_INT32(buffer_file_write_batch_size, "bytes, records are written to buffer files in batches", 1024 * 1024);
+
+namespace logtail {
+
+// the write buffer is allocated in whole pages
+static const size_t kWriteBufferAlignment = 4096;
+
+bool BufferFileWriter::Open(const std::string& fileName) {
+    if (mFile != nullptr && mFileName == fileName) {
+        return true;
+    }
+    Close();
+    mFile = FileAppendOpen(fileName.c_str(), "ab");
+    if (mFile == nullptr) {
+        return false;
+    }
+    // records are batched in mBuffer already
+    setvbuf(mFile, nullptr, _IONBF, 0);
+    fseek(mFile, 0, SEEK_END);
+    mFileSize = ftell(mFile);
+    mFileName = fileName;
+    if (mBuffer.capacity() == 0) {
+        size_t capacity = static_cast<size_t>(std::max(INT32_FLAG(buffer_file_write_batch_size), 1));
+        mBuffer.reserve((capacity + kWriteBufferAlignment - 1) / kWriteBufferAlignment * kWriteBufferAlignment);
+    }
+    return true;
+}
+
+bool BufferFileWriter::Append(std::initializer_list<StringView> pieces) {
+    if (mFile == nullptr) {
+        return false;
+    }
+    size_t size = 0;
+    for (const auto& piece : pieces) {
+        size += piece.size();
+    }
+    size_t batchSize = static_cast<size_t>(std::max(INT32_FLAG(buffer_file_write_batch_size), 1));
+    if (!mBuffer.empty() && mBuffer.size() + size > batchSize && !Flush(false)) {
+        return false;
+    }
+    for (const auto& piece : pieces) {
+        mBuffer.append(piece.data(), piece.size());
+    }
+    if (mBuffer.size() >= batchSize) {
+        return Flush(false);
+    }
+    return true;
+}
+
+bool BufferFileWriter::Flush(bool sync) {
+    if (mFile == nullptr) {
+        return false;
+    }
+    if (!mBuffer.empty()) {
+        size_t nbytes = fwrite(mBuffer.data(), 1, mBuffer.size(), mFile);
+        mFileSize += nbytes;
+        mWrittenBytes += nbytes;
+        if (nbytes != mBuffer.size()) {
+            LOG_ERROR(sLogger,
+                      ("write buffer file fail", mFileName)("error", ErrnoToString(GetErrno()))(
+                          "bytes", mBuffer.size())("written", nbytes));
+            mBuffer.clear();
+            return false;
+        }
+        mBuffer.clear();
+    }
+    if (sync) {
+#if defined(__linux__)
+        if (fdatasync(fileno(mFile)) != 0) {
+            LOG_ERROR(sLogger, ("sync buffer file fail", mFileName)("error", ErrnoToString(GetErrno())));
+            return false;
+        }
+#else
+        fflush(mFile);
+#endif
+    }
+    return true;
+}
+
+void BufferFileWriter::Close() {
+    if (mFile == nullptr) {
+        return;
+    }
+    Flush(true);
+    fclose(mFile);
+    mFile = nullptr;
+    mFileName.clear();
+    mFileSize = 0;
+}
+
+} // namespace logtail
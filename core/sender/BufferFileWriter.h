@@ -0,0 +1,68 @@
+/*
+ * Copyright 2024 iLogtail Authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <initializer_list>
+#include <string>
+
+#include "models/StringView.h"
+
+namespace logtail {
+
+// Appends records to the buffer files of the secondary storage.
+//
+// The file being written is kept open across records. Records are collected in a write buffer and written with one
+// call when the buffer is full, and a flush with sync is a group commit which makes all the records written since the
+// last one durable with a single fdatasync. Not thread safe, except for ExchangeWrittenBytes.
+class BufferFileWriter {
+public:
+    BufferFileWriter() = default;
+    BufferFileWriter(const BufferFileWriter&) = delete;
+    BufferFileWriter& operator=(const BufferFileWriter&) = delete;
+    ~BufferFileWriter() { Close(); }
+
+    // switches to fileName, the last file is flushed with sync and closed if it is a different one
+    bool Open(const std::string& fileName);
+    // appends one record made of the pieces, which is never split across writes unless larger than the write buffer
+    bool Append(std::initializer_list<StringView> pieces);
+    bool Flush(bool sync);
+    void Close();
+
+    bool IsOpen() const { return mFile != nullptr; }
+    const std::string& GetFileName() const { return mFileName; }
+    // bytes of the file, including the ones still in the write buffer
+    int64_t GetFileSize() const { return mFileSize + static_cast<int64_t>(mBuffer.size()); }
+    // bytes written to files since last call
+    uint64_t ExchangeWrittenBytes() { return mWrittenBytes.exchange(0); }
+
+private:
+    FILE* mFile = nullptr;
+    std::string mFileName;
+    // bytes of the file written, excluding the ones in mBuffer
+    int64_t mFileSize = 0;
+    std::string mBuffer;
+    std::atomic<uint64_t> mWrittenBytes{0};
+
+#ifdef APSARA_UNIT_TEST_MAIN
+    friend class BufferFileUnittest;
+#endif
+};
+
+} // namespace logtail
@@ -40,6 +40,8 @@
 #include "common/SlidingWindowCounter.h"
 #include "common/StringTools.h"
 #include "common/TimeUtil.h"
+#include "common/ZstdDictionary.h"
+#include "common/memory/MemoryBudgetManager.h"
 #include "config_manager/ConfigManager.h"
 #include "fuse/UlogfsHandler.h"
 #include "monitor/LogFileProfiler.h"
@@ -49,7 +51,9 @@
 #include "monitor/Monitor.h"
 #include "processor/daemon/LogProcess.h"
 #include "sdk/Client.h"
+#include "sdk/CurlAsynInstance.h"
 #include "sdk/Exception.h"
+#include "sender/BufferFileReader.h"
 #ifdef __ENTERPRISE__
 #include "config/provider/EnterpriseConfigProvider.h"
 #endif
@@ -60,6 +64,10 @@ using namespace sls_logs;
 DEFINE_FLAG_INT32(buffer_check_period, "check logtail local storage buffer period", 60);
 DEFINE_FLAG_INT32(quota_exceed_wait_interval, "when daemon buffer thread get quotaExceed error, sleep 5 seconds", 5);
 DEFINE_FLAG_INT32(secondary_buffer_count_limit, "data ready for write buffer file", 20);
+DEFINE_FLAG_BOOL(memory_budget_spill_to_disk,
+                 "write log groups to buffer files instead of holding them in memory once the memory budget of the "
+                 "pipeline is exhausted",
+                 true);
 DEFINE_FLAG_BOOL(enable_mock_send, "if enable mock send in ut", false);
 DEFINE_FLAG_INT32(merge_log_count_limit, "log count in one logGroup at most", 4000);
 DEFINE_FLAG_INT32(buffer_file_alive_interval, "the max alive time of a bufferfile, 5 minutes", 300);
@@ -172,6 +180,16 @@ static const char* GetOperationString(OperationOnFail op) {
     }
 }
 
+// ratio is raw bytes per compressed byte, cost is cpu nanoseconds per raw byte
+static void UpdateCompressMetric(const std::string& name, const CompressStatistics& stat) {
+    if (stat.mRawBytes == 0 || stat.mCompressedBytes == 0) {
+        return;
+    }
+    static auto sMonitor = LogtailMonitor::GetInstance();
+    sMonitor->UpdateMetric("send_" + name + "_compress_ratio", 1.0 * stat.mRawBytes / stat.mCompressedBytes);
+    sMonitor->UpdateMetric("send_" + name + "_compress_ns_per_byte", 1.0 * stat.mCpuTimeNs / stat.mRawBytes);
+}
+
 /*
  * @brief OnFail callback if send failed
  * There are 3 possible outcomes:
@@ -940,7 +958,26 @@ bool Sender::LoadFileToSend(time_t timeLine, std::vector<std::string>& filesToSe
     sort(filesToSend.begin(), filesToSend.end());
     return true;
 }
+int64_t Sender::GetBufferFileBacklogBytes() {
+    string bufferFilePath = GetBufferFilePath();
+    fsutil::Dir dir(bufferFilePath);
+    if (!dir.Open()) {
+        return 0;
+    }
+    int64_t totalSize = 0;
+    fsutil::Entry ent;
+    while ((ent = dir.ReadNext())) {
+        string filename = ent.Name();
+        fsutil::PathStat ps;
+        if (filename.find(BUFFER_FILE_NAME_PREFIX) == 0 && fsutil::PathStat::stat(bufferFilePath + filename, ps)) {
+            totalSize += ps.GetFileSize();
+        }
+    }
+    return totalSize;
+}
+
 bool Sender::ReadNextEncryption(int32_t& pos,
+                                const BufferFileReader& reader,
                                 const std::string& filename,
                                 std::string& encryption,
                                 EncryptionStateMeta& meta,
@@ -949,44 +986,21 @@ bool Sender::ReadNextEncryption(int32_t& pos,
     bufferMeta.Clear();
     readResult = false;
     encryption.clear();
-    int retryTimes = 0;
 
-    FILE* fin = NULL;
-    while (true) {
-        retryTimes++;
-        fin = FileReadOnlyOpen(filename.c_str(), "rb");
-        if (fin)
-            break;
-        if (retryTimes >= 3) {
-            string errorStr = ErrnoToString(GetErrno());
-            LogtailAlarm::GetInstance()->SendAlarm(SECONDARY_READ_WRITE_ALARM,
-                                                   string("open file error:") + filename + ",error:" + errorStr);
-            LOG_ERROR(sLogger, ("open file error", filename)("error", errorStr));
-            return false;
-        }
-        usleep(5000);
-    }
-    fseek(fin, 0, SEEK_END);
-    auto const currentSize = ftell(fin);
+    auto const currentSize = reader.GetFileSize();
     if (currentSize == pos) {
-        fclose(fin);
         return false;
     }
-    fseek(fin, pos, SEEK_SET);
-    auto nbytes = fread(static_cast<void*>(&meta), sizeof(char), sizeof(meta), fin);
-    if (nbytes != sizeof(meta)) {
-        string errorStr = ErrnoToString(GetErrno());
+    const int32_t recordPos = pos;
+    const char* data = reader.GetData(recordPos, sizeof(meta));
+    if (data == nullptr) {
         LogtailAlarm::GetInstance()->SendAlarm(SECONDARY_READ_WRITE_ALARM,
                                                string("read encryption file meta error:") + filename
-                                                   + ", error:" + errorStr + ", meta.mEncryptionSize:"
-                                                   + ToString(meta.mEncryptionSize) + ", nbytes: " + ToString(nbytes)
-                                                   + ", pos: " + ToString(pos) + ", ftell: " + ToString(currentSize));
-        LOG_ERROR(sLogger,
-                  ("read encryption file meta error",
-                   filename)("error", errorStr)("nbytes", nbytes)("pos", pos)("ftell", currentSize));
-        fclose(fin);
+                                                   + ", pos: " + ToString(pos) + ", size: " + ToString(currentSize));
+        LOG_ERROR(sLogger, ("read encryption file meta error", filename)("pos", pos)("size", currentSize));
         return false;
     }
+    memcpy(static_cast<void*>(&meta), data, sizeof(meta));
 
     bool pbMeta = false;
     int32_t encodedInfoSize = meta.mEncodedInfoSize;
@@ -1003,13 +1017,12 @@ bool Sender::ReadNextEncryption(int32_t& pos,
         LOG_ERROR(sLogger,
                   ("meta of encryption file invalid", filename)("meta.mEncryptionSize", meta.mEncryptionSize)(
                       "meta.mEncodedInfoSize", meta.mEncodedInfoSize));
-        fclose(fin);
         return false;
     }
 
     pos += sizeof(meta) + encodedInfoSize + meta.mEncryptionSize;
+    mBufferFileReadBytes += sizeof(meta) + encodedInfoSize + meta.mEncryptionSize;
     if ((time(NULL) - meta.mTimeStamp) > INT32_FLAG(log_expire_time) || meta.mHandled == 1) {
-        fclose(fin);
         if (meta.mHandled != 1) {
             LOG_WARNING(sLogger, ("timeout buffer file, meta.mTimeStamp", meta.mTimeStamp));
             LogtailAlarm::GetInstance()->SendAlarm(DISCARD_SECONDARY_ALARM,
@@ -1018,26 +1031,20 @@ bool Sender::ReadNextEncryption(int32_t& pos,
         return true;
     }
 
-    char* buffer = new char[encodedInfoSize + 1];
-    nbytes = fread(buffer, sizeof(char), encodedInfoSize, fin);
-    if (nbytes != static_cast<size_t>(encodedInfoSize)) {
-        fclose(fin);
-        string errorStr = ErrnoToString(GetErrno());
+    data = reader.GetData(recordPos + sizeof(meta), encodedInfoSize);
+    if (data == nullptr) {
         LogtailAlarm::GetInstance()->SendAlarm(SECONDARY_READ_WRITE_ALARM,
                                                string("read projectname from file error:") + filename
-                                                   + ", error:" + errorStr + ", meta.mEncodedInfoSize:"
-                                                   + ToString(meta.mEncodedInfoSize) + ", nbytes:" + ToString(nbytes));
+                                                   + ", meta.mEncodedInfoSize:" + ToString(meta.mEncodedInfoSize)
+                                                   + ", size:" + ToString(currentSize));
         LOG_ERROR(sLogger,
                   ("read encodedInfo from file error",
-                   filename)("error", errorStr)("meta.mEncodedInfoSize", meta.mEncodedInfoSize)("nbytes", nbytes));
-        delete[] buffer;
+                   filename)("meta.mEncodedInfoSize", meta.mEncodedInfoSize)("size", currentSize));
         return true;
     }
-    string encodedInfo = string(buffer, encodedInfoSize);
-    delete[] buffer;
+    string encodedInfo(data, encodedInfoSize);
     if (pbMeta) {
         if (!bufferMeta.ParseFromString(encodedInfo)) {
-            fclose(fin);
             LogtailAlarm::GetInstance()->SendAlarm(SECONDARY_READ_WRITE_ALARM,
                                                    string("parse buffer meta from file error:") + filename);
             LOG_ERROR(sLogger, ("parse buffer meta from file error", filename)("buffer meta", encodedInfo));
@@ -1053,25 +1060,19 @@ bool Sender::ReadNextEncryption(int32_t& pos,
         bufferMeta.set_compresstype(SlsCompressType::SLS_CMP_LZ4);
     }
 
-    buffer = new char[meta.mEncryptionSize + 1];
-    nbytes = fread(buffer, sizeof(char), meta.mEncryptionSize, fin);
-    if (nbytes != static_cast<size_t>(meta.mEncryptionSize)) {
-        fclose(fin);
-        string errorStr = ErrnoToString(GetErrno());
+    data = reader.GetData(recordPos + sizeof(meta) + encodedInfoSize, meta.mEncryptionSize);
+    if (data == nullptr) {
         LogtailAlarm::GetInstance()->SendAlarm(SECONDARY_READ_WRITE_ALARM,
                                                string("read encryption from file error:") + filename
-                                                   + ",error:" + errorStr + ",meta.mEncryptionSize:"
-                                                   + ToString(meta.mEncryptionSize) + ", nbytes:" + ToString(nbytes));
+                                                   + ",meta.mEncryptionSize:" + ToString(meta.mEncryptionSize)
+                                                   + ", size:" + ToString(currentSize));
         LOG_ERROR(sLogger,
                   ("read encryption from file error",
-                   filename)("error", errorStr)("meta.mEncryptionSize", meta.mEncryptionSize)("nbytes", nbytes));
-        delete[] buffer;
+                   filename)("meta.mEncryptionSize", meta.mEncryptionSize)("size", currentSize));
         return true;
     }
-    encryption = string(buffer, meta.mEncryptionSize);
+    encryption.assign(data, meta.mEncryptionSize);
     readResult = true;
-    delete[] buffer;
-    fclose(fin);
     return true;
 }
 
@@ -1150,7 +1151,19 @@ void Sender::SendEncryptionBuffer(const std::string& filename, int32_t keyVersio
     int32_t pos = INT32_FLAG(file_encryption_header_length);
     LogtailBufferMeta bufferMeta;
     int32_t discardCount = 0;
-    while (ReadNextEncryption(pos, filename, encryption, meta, readResult, bufferMeta)) {
+    // the file is mapped once and read record by record
+    BufferFileReader reader;
+    for (int retryTimes = 1; !reader.Open(filename); ++retryTimes) {
+        if (retryTimes >= 3) {
+            string errorStr = ErrnoToString(GetErrno());
+            LogtailAlarm::GetInstance()->SendAlarm(SECONDARY_READ_WRITE_ALARM,
+                                                   string("open file error:") + filename + ",error:" + errorStr);
+            LOG_ERROR(sLogger, ("open file error", filename)("error", errorStr));
+            return;
+        }
+        usleep(5000);
+    }
+    while (ReadNextEncryption(pos, reader, filename, encryption, meta, readResult, bufferMeta)) {
         logData.clear();
         bool sendResult = false;
         if (!readResult || bufferMeta.project().empty()) {
@@ -1227,7 +1240,8 @@ void Sender::SendEncryptionBuffer(const std::string& filename, int32_t keyVersio
         LOG_DEBUG(sLogger,
                   ("send LogGroup from local buffer file", filename)("rawsize", bufferMeta.rawsize())("sendResult",
                                                                                                       sendResult));
-        WriteBackMeta(pos - meta.mEncryptionSize - sizeof(meta)
+        WriteBackMeta(reader,
+                      pos - meta.mEncryptionSize - sizeof(meta)
                           - (meta.mEncodedInfoSize > BUFFER_META_BASE_SIZE
                                  ? (meta.mEncodedInfoSize - BUFFER_META_BASE_SIZE)
                                  : meta.mEncodedInfoSize),
@@ -1237,6 +1251,7 @@ void Sender::SendEncryptionBuffer(const std::string& filename, int32_t keyVersio
         if (!sendResult)
             writeBack = true;
     }
+    reader.Close();
     if (!writeBack) {
         remove(filename.c_str());
         if (discardCount > 0) {
@@ -1273,52 +1288,19 @@ bool Sender::CreateNewFile() {
     return true;
 }
 
-bool Sender::WriteBackMeta(int32_t pos, const void* buf, int32_t length, const string& filename) {
-    // TODO: Why not use fopen or fstream???
-    // TODO: Make sure and merge them.
-#if defined(__linux__)
-    int fd = open(filename.c_str(), O_WRONLY);
-    if (fd < 0) {
-        string errorStr = ErrnoToString(GetErrno());
-        LogtailAlarm::GetInstance()->SendAlarm(SECONDARY_READ_WRITE_ALARM,
-                                               string("open secondary file for write meta fail:") + filename
-                                                   + ",reason:" + errorStr);
-        LOG_ERROR(sLogger, ("open file error", filename));
-        return false;
-    }
-    lseek(fd, pos, SEEK_SET);
-    if (write(fd, buf, length) < 0) {
+bool Sender::WriteBackMeta(
+    BufferFileReader& reader, int32_t pos, const void* buf, int32_t length, const string& filename) {
+    if (!reader.Write(pos, buf, length)) {
         string errorStr = ErrnoToString(GetErrno());
         LogtailAlarm::GetInstance()->SendAlarm(SECONDARY_READ_WRITE_ALARM,
                                                string("write secondary file for write meta fail:") + filename
                                                    + ",reason:" + errorStr);
         LOG_ERROR(sLogger, ("can not write back meta", filename));
-    }
-    close(fd);
-    return true;
-#elif defined(_MSC_VER)
-    FILE* f = FileWriteOnlyOpen(filename.c_str(), "wb");
-    if (!f) {
-        string errorStr = ErrnoToString(GetErrno());
-        LogtailAlarm::GetInstance()->SendAlarm(SECONDARY_READ_WRITE_ALARM,
-                                               string("open secondary file for write meta fail:") + filename
-                                                   + ",reason:" + errorStr);
-        LOG_ERROR(sLogger, ("open file error", filename));
         return false;
     }
-    fseek(f, pos, SEEK_SET);
-    auto nbytes = fwrite(buf, 1, length, f);
-    if (nbytes != length) {
-        string errorStr = ErrnoToString(GetErrno());
-        LogtailAlarm::GetInstance()->SendAlarm(SECONDARY_READ_WRITE_ALARM,
-                                               string("write secondary file for write meta fail:") + filename
-                                                   + ",reason:" + errorStr);
-        LOG_ERROR(sLogger, ("can not write back meta", filename));
-    }
-    fclose(f);
     return true;
-#endif
 }
+
 bool Sender::RemoveSender() {
     mBufferSenderThreadIsRunning = false;
     mSenderQueue.Signal();
@@ -1357,8 +1339,11 @@ void Sender::WriteSecondary() {
             mWriteSecondaryWait.wait(lock, INT32_FLAG(write_secondary_wait_timeout) * 1000000);
         }
         // update bufferDiveideTime to flush data; buffer file before bufferDiveideTime will be ready for read
-        if (time(NULL) - mBufferDivideTime > INT32_FLAG(buffer_file_alive_interval))
+        if (time(NULL) - mBufferDivideTime > INT32_FLAG(buffer_file_alive_interval)) {
+            // the file must be complete on disk before it is ready for read
+            mBufferFileWriter.Close();
             CreateNewFile();
+        }
 
         {
             PTScopedLock lock(mSecondaryMutexLock);
@@ -1376,6 +1361,8 @@ void Sender::WriteSecondary() {
                 delete *itr;
             }
             logGroupToDump.clear();
+            // group commit, one sync for all the log groups dumped
+            mBufferFileWriter.Flush(true);
         }
     }
     LOG_INFO(sLogger, ("DumpSecondaryThread", "exit"));
@@ -1449,6 +1436,12 @@ void Sender::DaemonSender() {
             sMonitor->UpdateMetric("send_bytes_ps", 1.0 * sendBufferBytes / (curTime - lastUpdateMetricTime));
             sMonitor->UpdateMetric("send_net_bytes_ps", 1.0 * sendNetBodyBytes / (curTime - lastUpdateMetricTime));
             sMonitor->UpdateMetric("send_lines_ps", 1.0 * sendLines / (curTime - lastUpdateMetricTime));
+            // secondary storage
+            sMonitor->UpdateMetric("send_buffer_file_write_bytes_ps",
+                                   1.0 * mBufferFileWriter.ExchangeWrittenBytes() / (curTime - lastUpdateMetricTime));
+            sMonitor->UpdateMetric("send_buffer_file_read_bytes_ps",
+                                   1.0 * mBufferFileReadBytes.exchange(0) / (curTime - lastUpdateMetricTime));
+            sMonitor->UpdateMetric("send_buffer_file_backlog_bytes", GetBufferFileBacklogBytes());
             lastUpdateMetricTime = curTime;
             sendBufferCount = 0;
             sendLines = 0;
@@ -1476,6 +1469,18 @@ void Sender::DaemonSender() {
             // Collect at most 15 stats, similar to Linux load 1,5,15.
             static SlidingWindowCounter sNetErrCounter = CreateLoadCounter();
             sMonitor->UpdateMetric("net_err_stat", sNetErrCounter.Add(gNetworkErrorCount.exchange(0)));
+
+            // connection reuse of asynchronous requests
+            sMonitor->UpdateMetric("send_inflight_requests",
+                                   sdk::CurlAsynInstance::GetInstance()->GetInFlightRequestCount());
+            sMonitor->UpdateMetric("send_handshake_avoided",
+                                   sdk::CurlAsynInstance::GetInstance()->ExchangeHandshakeAvoidedCount());
+
+            // compression ratio and cpu cost, dictionary ones are evaluated on sampled log groups only
+            UpdateCompressMetric("zstd", ExchangeCompressStatistics(sls_logs::SLS_CMP_ZSTD));
+            UpdateCompressMetric("lz4", ExchangeCompressStatistics(sls_logs::SLS_CMP_LZ4));
+            UpdateCompressMetric("zstd_dict", ZstdDictionaryManager::GetInstance()->ExchangeStatistics());
+            ZstdDictionaryManager::GetInstance()->RemoveExpired(curTime);
         }
 
         ///////////////////////////////////////
@@ -1614,6 +1619,19 @@ void Sender::PutIntoSecondaryBuffer(LoggroupTimeValue* dataPtr, int32_t retryTim
     }
 }
 
+bool Sender::SpillToSecondaryBuffer(LoggroupTimeValue* dataPtr) {
+    {
+        PTScopedLock lock(mSecondaryMutexLock);
+        if (mSecondaryBuffer.size() >= (uint32_t)INT32_FLAG(secondary_buffer_count_limit)) {
+            return false;
+        }
+        mSecondaryBuffer.push_back(dataPtr);
+    }
+    WaitObject::Lock lock(mWriteSecondaryWait);
+    mWriteSecondaryWait.signal();
+    return true;
+}
+
 string Sender::GetBufferFileHeader() {
     string reserve = STRING_FLAG(file_encryption_field_key_version) + STRING_FLAG(file_encryption_key_value_splitter)
         + ToString(FileEncryption::GetInstance()->GetDefaultKeyVersion());
@@ -1629,9 +1647,8 @@ bool Sender::SendToBufferFile(LoggroupTimeValue* dataPtr) {
         CreateNewFile();
         bufferFileName = GetBufferFileName();
     }
-    // if file not exist, create it new
-    FILE* fout = FileAppendOpen(bufferFileName.c_str(), "ab");
-    if (!fout) {
+    // if file not exist, create it new; the file is kept open until the buffer file name changes
+    if (!mBufferFileWriter.Open(bufferFileName)) {
         string errorStr = ErrnoToString(GetErrno());
         LogtailAlarm::GetInstance()->SendAlarm(SECONDARY_READ_WRITE_ALARM,
                                                string("open file error:") + bufferFileName + ",error:" + errorStr);
@@ -1639,16 +1656,14 @@ bool Sender::SendToBufferFile(LoggroupTimeValue* dataPtr) {
         return false;
     }
 
-    if (ftell(fout) == (streampos)0) {
+    if (mBufferFileWriter.GetFileSize() == 0) {
         string header = GetBufferFileHeader();
-        auto nbytes = fwrite(header.c_str(), 1, header.size(), fout);
-        if (header.size() != nbytes) {
+        if (!mBufferFileWriter.Append({StringView(header)})) {
             string errorStr = ErrnoToString(GetErrno());
             LogtailAlarm::GetInstance()->SendAlarm(SECONDARY_READ_WRITE_ALARM,
-                                                   string("write file error:") + bufferFileName + ", error:" + errorStr
-                                                       + ", nbytes:" + ToString(nbytes));
-            LOG_ERROR(sLogger, ("error write encryption header", bufferFileName)("error", errorStr)("nbytes", nbytes));
-            fclose(fout);
+                                                   string("write file error:") + bufferFileName + ", error:" + errorStr);
+            LOG_ERROR(sLogger, ("error write encryption header", bufferFileName)("error", errorStr));
+            mBufferFileWriter.Close();
             return false;
         }
     }
@@ -1656,7 +1671,6 @@ bool Sender::SendToBufferFile(LoggroupTimeValue* dataPtr) {
     char* des;
     int32_t desLength;
     if (!FileEncryption::GetInstance()->Encrypt(dataPtr->mLogData.c_str(), dataPtr->mLogData.size(), des, desLength)) {
-        fclose(fout);
         LOG_ERROR(sLogger, ("encrypt error, project_name", dataPtr->mProjectName));
         LogtailAlarm::GetInstance()->SendAlarm(ENCRYPT_DECRYPT_FAIL_ALARM,
                                                string("encrypt error, project_name:" + dataPtr->mProjectName));
@@ -1683,31 +1697,25 @@ bool Sender::SendToBufferFile(LoggroupTimeValue* dataPtr) {
     meta.mHandled = 0;
     meta.mRetryTime = 0;
     meta.mEncryptionSize = desLength;
-    char* buffer = new char[sizeof(meta) + encodedInfoSize + meta.mEncryptionSize];
-    memcpy(buffer, (char*)&meta, sizeof(meta));
-    memcpy(buffer + sizeof(meta), encodedInfo.c_str(), encodedInfoSize);
-    memcpy(buffer + sizeof(meta) + encodedInfoSize, des, desLength);
+    bool res = mBufferFileWriter.Append({StringView(reinterpret_cast<const char*>(&meta), sizeof(meta)),
+                                         StringView(encodedInfo),
+                                         StringView(des, desLength)});
     delete[] des;
-    const auto bytesToWrite = sizeof(meta) + encodedInfoSize + meta.mEncryptionSize;
-    auto nbytes = fwrite(buffer, 1, bytesToWrite, fout);
-    if (nbytes != bytesToWrite) {
+    if (!res) {
         string errorStr = ErrnoToString(GetErrno());
         LogtailAlarm::GetInstance()->SendAlarm(SECONDARY_READ_WRITE_ALARM,
-                                               string("write file error:") + bufferFileName + ", error:" + errorStr
-                                                   + ", nbytes:" + ToString(nbytes));
-        LOG_ERROR(
-            sLogger,
-            ("write meta of buffer file", "fail")("filename", bufferFileName)("errorStr", errorStr)("nbytes", nbytes));
-        delete[] buffer;
-        fclose(fout);
+                                               string("write file error:") + bufferFileName + ", error:" + errorStr);
+        LOG_ERROR(sLogger,
+                  ("write meta of buffer file", "fail")("filename", bufferFileName)("errorStr", errorStr));
+        mBufferFileWriter.Close();
         return false;
     }
-    delete[] buffer;
     if (BOOL_FLAG(enable_mock_send))
-        fflush(fout);
-    if (ftell(fout) > AppConfig::GetInstance()->GetLocalFileSize())
+        mBufferFileWriter.Flush(false);
+    if (mBufferFileWriter.GetFileSize() > AppConfig::GetInstance()->GetLocalFileSize()) {
+        mBufferFileWriter.Close();
         CreateNewFile();
-    fclose(fout);
+    }
     LOG_DEBUG(sLogger, ("write buffer file", bufferFileName)("loglines", dataPtr->mLogLines));
     return true;
 }
@@ -1764,6 +1772,7 @@ bool Sender::SendPb(const FlusherSLS* pConfig,
                                                      shardHash,
                                                      pConfig->GetLogstoreKey(),
                                                      logGroupContext);
+    ZstdDictionaryManager::GetInstance()->Feed(pData->mLogstoreKey, pbBuffer, pbSize);
     // apsara::timing::TimeInNsec startT = apsara::timing::GetCurrentTimeInNanoSeconds();
     if (!CompressData(logGroupContext.mCompressType, pbBuffer, pbSize, pData->mLogData)) {
         LOG_ERROR(
@@ -2205,6 +2214,29 @@ bool Sender::Send(const std::string& projectName,
                            context);
 }
 
+bool Sender::Send(const std::string& projectName,
+                  const std::string& sourceId,
+                  SerializedLogGroup& logGroup,
+                  int64_t logGroupKey,
+                  const FlusherSLS* config,
+                  FlusherSLS::Batch::MergeType mergeType,
+                  const uint32_t logGroupSize,
+                  const string& defaultRegion,
+                  const string& filename,
+                  const LogGroupContext& context) {
+    static Aggregator* aggregator = Aggregator::GetInstance();
+    return aggregator->Add(projectName,
+                           sourceId,
+                           logGroup,
+                           logGroupKey,
+                           config,
+                           mergeType,
+                           logGroupSize,
+                           defaultRegion,
+                           filename,
+                           context);
+}
+
 bool Sender::SendInstantly(sls_logs::LogGroup& logGroup,
                            const std::string& aliuid,
                            const std::string& region,
@@ -2246,6 +2278,7 @@ bool Sender::SendInstantly(sls_logs::LogGroup& logGroup,
                                                     shardHashKey,
                                                     feedBackKey);
 
+    ZstdDictionaryManager::GetInstance()->Feed(feedBackKey, oriData.data(), oriData.size());
     if (!CompressData(data->mLogGroupContext.mCompressType, oriData, data->mLogData)) {
         LOG_ERROR(sLogger, ("compress data fail", "discard data")("projectName", projectName)("logstore", logstore));
         LogtailAlarm::GetInstance()->SendAlarm(
@@ -2294,10 +2327,63 @@ void Sender::SendCompressed(const std::string& projectName,
         filteredLogGroup.SerializeToString(&oriData);
         logTimeInMinute = filteredLogGroup.logs(0).time() - filteredLogGroup.logs(0).time() % 60;
     }
+    SendCompressedData(projectName,
+                       logGroup.category(),
+                       oriData,
+                       lines,
+                       logTimeInMinute,
+                       configName,
+                       aliuid,
+                       region,
+                       filename,
+                       context);
+}
 
+void Sender::SendCompressed(const std::string& projectName,
+                            SerializedLogGroup& logGroup,
+                            const std::vector<int32_t>& neededLogIndex,
+                            const std::string& configName,
+                            const std::string& aliuid,
+                            const std::string& region,
+                            const std::string& filename,
+                            const LogGroupContext& context) {
+    string oriData;
+    auto const lines = static_cast<int32_t>(neededLogIndex.size());
+    if (lines == logGroup.logs_size()) {
+        logGroup.AppendToString(&oriData);
+    } else {
+        for (auto idx : neededLogIndex) {
+            StringView data = logGroup.GetLogData(idx);
+            oriData.append(data.data(), data.size());
+        }
+        logGroup.mGroup.AppendToString(&oriData);
+    }
+    uint32_t logTime = logGroup.mLogTimes[neededLogIndex[0]];
+    SendCompressedData(projectName,
+                       logGroup.mGroup.category(),
+                       oriData,
+                       lines,
+                       logTime - logTime % 60,
+                       configName,
+                       aliuid,
+                       region,
+                       filename,
+                       context);
+}
+
+void Sender::SendCompressedData(const std::string& projectName,
+                                const std::string& logstore,
+                                const std::string& oriData,
+                                int32_t lines,
+                                int32_t logTimeInMinute,
+                                const std::string& configName,
+                                const std::string& aliuid,
+                                const std::string& region,
+                                const std::string& filename,
+                                const LogGroupContext& context) {
     auto& cpt = context.mExactlyOnceCheckpoint;
     auto data = new LoggroupTimeValue(projectName,
-                                      logGroup.category(),
+                                      logstore,
                                       configName,
                                       filename,
                                       false,
@@ -2313,11 +2399,11 @@ void Sender::SendCompressed(const std::string& projectName,
     data->mLogTimeInMinute = logTimeInMinute;
     data->mLogGroupContext.mSeqNum = ++mLogGroupContextSeq;
 
+    ZstdDictionaryManager::GetInstance()->Feed(data->mLogstoreKey, oriData.data(), oriData.size());
     if (!CompressData(data->mLogGroupContext.mCompressType, oriData, data->mLogData)) {
-        LOG_ERROR(sLogger,
-                  ("compress data fail", "discard data")("projectName", projectName)("logstore", logGroup.category()));
+        LOG_ERROR(sLogger, ("compress data fail", "discard data")("projectName", projectName)("logstore", logstore));
         LogtailAlarm::GetInstance()->SendAlarm(
-            SEND_COMPRESS_FAIL_ALARM, string("lines :") + ToString(lines), projectName, logGroup.category(), region);
+            SEND_COMPRESS_FAIL_ALARM, string("lines :") + ToString(lines), projectName, logstore, region);
         delete data;
     } else {
         PutIntoBatchMap(data);
@@ -2327,7 +2413,7 @@ void Sender::SendCompressed(const std::string& projectName,
 void Sender::SendCompressed(std::vector<MergeItem*>& sendDataVec) {
     for (auto item : sendDataVec) {
         string oriData;
-        item->mLogGroup.SerializeToString(&oriData);
+        item->SerializeToString(&oriData);
         mLogGroupContextSeq++;
         auto& context = item->mLogGroupContext;
         auto& cpt = context.mExactlyOnceCheckpoint;
@@ -2348,6 +2434,7 @@ void Sender::SendCompressed(std::vector<MergeItem*>& sendDataVec) {
                                                         context);
         data->mLogTimeInMinute = item->mLogTimeInMinute;
 
+        ZstdDictionaryManager::GetInstance()->Feed(data->mLogstoreKey, oriData.data(), oriData.size());
         if (!CompressData(data->mLogGroupContext.mCompressType, oriData, data->mLogData)) {
             LOG_ERROR(sLogger,
                       ("compress data fail",
@@ -2381,7 +2468,7 @@ void Sender::SendLogPackageList(std::vector<MergeItem*>& sendDataVec) {
     for (uint32_t idx = 0; idx < totalLogGroupCount; ++idx) {
         string compressedData;
         string oriData;
-        sendDataVec[idx]->mLogGroup.SerializeToString(&oriData);
+        sendDataVec[idx]->SerializeToString(&oriData);
         if (!CompressData(sendDataVec[idx]->mLogGroupContext.mCompressType, oriData, compressedData)) {
             LOG_ERROR(sLogger,
                       ("compress data fail", "discard data")("projectName", sendDataVec[idx]->mProjectName)(
@@ -2437,6 +2524,15 @@ void Sender::SendLogPackageList(std::vector<MergeItem*>& sendDataVec) {
 }
 
 void Sender::PutIntoBatchMap(LoggroupTimeValue* data) {
+    auto budget = MemoryBudgetManager::GetInstance()->GetBudget(data->mConfigName);
+    if (budget && !budget->IsValidToPush() && BOOL_FLAG(memory_budget_spill_to_disk) && data->mBufferOrNot
+        && !data->mLogGroupContext.mExactlyOnceCheckpoint && !data->mLogGroupContext.mMarkOffsetFlag) {
+        // sent from buffer files later, which are read one at a time
+        if (SpillToSecondaryBuffer(data)) {
+            return;
+        }
+    }
+    data->ChargeMemoryBudget(budget);
     int32_t tryTime = 0;
     while (tryTime < 1000) {
         if (mSenderQueue.PushItem(data->mLogstoreKey, data)) {
@@ -31,6 +31,7 @@
 #include "log_pb/sls_logs.pb.h"
 #include "sdk/Closure.h"
 #include "common/LogstoreFeedbackQueue.h"
+#include "sender/BufferFileWriter.h"
 
 namespace logtail {
 
@@ -38,6 +39,8 @@ namespace sdk {
     class Client;
 }
 
+class BufferFileReader;
+
 enum OperationOnFail { RETRY_ASYNC_WHEN_FAIL, RECORD_ERROR_WHEN_FAIL, DISCARD_WHEN_FAIL };
 
 enum SEND_THREAD_TYPE { REALTIME_SEND_THREAD = 0, REPLAY_SEND_THREAD = 1, SEND_THREAD_TYPE_COUNT = 2 };
@@ -184,6 +187,16 @@ private:
                                   std::string& errorCode);
     bool SendToBufferFile(LoggroupTimeValue* dataPtr);
     void FlowControl(int32_t dataSize, SEND_THREAD_TYPE type);
+    void SendCompressedData(const std::string& projectName,
+                            const std::string& logstore,
+                            const std::string& oriData,
+                            int32_t lines,
+                            int32_t logTimeInMinute,
+                            const std::string& configName,
+                            const std::string& aliuid,
+                            const std::string& region,
+                            const std::string& filename,
+                            const LogGroupContext& context);
 
     bool IsValidToSend(const LogstoreFeedBackKey& logstoreKey);
 
@@ -193,6 +206,8 @@ private:
     WaitObject mWriteSecondaryWait; // semaphore between SendThreads & DumpSecondaryThread
     PTMutex mSecondaryMutexLock; // lock for mSecondaryBuffer
     std::vector<LoggroupTimeValue*> mSecondaryBuffer;
+    BufferFileWriter mBufferFileWriter; // used by DumpSecondaryThread only
+    std::atomic<uint64_t> mBufferFileReadBytes{0};
 
     // for flow control: value[0] for realtime thread, value[1] for replay thread
     int64_t mSendLastTime[SEND_THREAD_TYPE_COUNT];
@@ -302,14 +317,18 @@ private:
     void WriteSecondary();
     bool LoadFileToSend(time_t timeLine, std::vector<std::string>& filesToSend);
     bool CreateNewFile();
-    bool WriteBackMeta(const int32_t pos, const void* buf, int32_t length, const std::string& filename);
+    bool WriteBackMeta(
+        BufferFileReader& reader, const int32_t pos, const void* buf, int32_t length, const std::string& filename);
     bool ReadNextEncryption(int32_t& pos,
+                            const BufferFileReader& reader,
                             const std::string& filename,
                             std::string& encryption,
                             EncryptionStateMeta& meta,
                             bool& readResult,
                             sls_logs::LogtailBufferMeta& bufferMeta);
     void SendEncryptionBuffer(const std::string& filename, int32_t keyVersion);
+    // total bytes of buffer files, including the one being written
+    int64_t GetBufferFileBacklogBytes();
 
     void ResetSendingCount();
     void IncSendingCount(int32_t val = 1);
@@ -322,6 +341,9 @@ private:
 
     bool IsBatchMapEmpty();
     void PutIntoSecondaryBuffer(LoggroupTimeValue* dataPtr, int32_t retryTimes);
+    // write @dataPtr to buffer files instead of holding it in memory, false is returned if the secondary buffer is full
+    // and @dataPtr is left untouched
+    bool SpillToSecondaryBuffer(LoggroupTimeValue* dataPtr);
 
     /*
      * add memory barrier for config varibles.
@@ -377,6 +399,17 @@ public:
               const std::string& defaultRegion = "",
               const std::string& filename = "",
               const LogGroupContext& context = LogGroupContext());
+    // same as above, but logs are already in wire format, which is the default path for the C++ pipeline
+    bool Send(const std::string& projectName,
+              const std::string& sourceId,
+              SerializedLogGroup& logGroup,
+              int64_t logGroupKey,
+              const FlusherSLS* config,
+              FlusherSLS::Batch::MergeType mergeType,
+              const uint32_t logGroupSize,
+              const std::string& defaultRegion = "",
+              const std::string& filename = "",
+              const LogGroupContext& context = LogGroupContext());
 
     // bool LoadConfig(const Json::Value& secondary);
 
@@ -485,6 +518,14 @@ public:
                         const std::string& region,
                         const std::string& filename,
                         const LogGroupContext& context);
+    void SendCompressed(const std::string& projectName,
+                        SerializedLogGroup& logGroup,
+                        const std::vector<int32_t>& neededLogIndex,
+                        const std::string& configName,
+                        const std::string& aliuid,
+                        const std::string& region,
+                        const std::string& filename,
+                        const LogGroupContext& context);
 
     void SendCompressed(std::vector<MergeItem*>& sendDataVec);
     void SendLogPackageList(std::vector<MergeItem*>& sendDataVec);
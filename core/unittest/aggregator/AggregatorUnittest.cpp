@@ -13,6 +13,7 @@
 // limitations under the License.
 
 #include <cstdlib>
+#include <numeric>
 #include "unittest/Unittest.h"
 #include "Aggregator.h"
 #include "flusher/FlusherSLS.h"
@@ -35,19 +36,37 @@ public:
 
     void TearDown() override {
         Aggregator* aggregator = Aggregator::GetInstance();
-        aggregator->mPackageListMergeMap.clear();
-        aggregator->mMergeMap.clear();
+        for (auto& shard : aggregator->mMergeShards) {
+            shard->mPackageListMergeMap.clear();
+            shard->mMergeMap.clear();
+        }
         aggregator->mSendVectorSize = 0;
     }
+    size_t MergeMapSize() {
+        size_t size = 0;
+        for (auto& shard : Aggregator::GetInstance()->mMergeShards) {
+            size += shard->mMergeMap.size();
+        }
+        return size;
+    }
+    size_t PackageListMergeMapSize() {
+        size_t size = 0;
+        for (auto& shard : Aggregator::GetInstance()->mMergeShards) {
+            size += shard->mPackageListMergeMap.size();
+        }
+        return size;
+    }
     void TestLogstoreMergeTypeAdd();
     void TestLogstoreMergeTypeAddLargeGroup();
     void TestTopicMergeTypeAdd();
+    void TestShardStatistics();
 private:
 };
 
 APSARA_UNIT_TEST_CASE(AggregatorUnittest, TestLogstoreMergeTypeAdd, 0);
 APSARA_UNIT_TEST_CASE(AggregatorUnittest, TestLogstoreMergeTypeAddLargeGroup, 1);
 APSARA_UNIT_TEST_CASE(AggregatorUnittest, TestTopicMergeTypeAdd, 2);
+APSARA_UNIT_TEST_CASE(AggregatorUnittest, TestShardStatistics, 3);
 
 
 void AggregatorUnittest::TestLogstoreMergeTypeAdd() {
@@ -97,21 +116,21 @@ void AggregatorUnittest::TestLogstoreMergeTypeAdd() {
         aggregator->Add(
             projectName, sourceId, logGroup, logGroupKey, flusher.get(), mergeType, logGroupSize, defaultRegion, filename, context);
         APSARA_TEST_EQUAL(aggregator->mSendVectorSize, 0);
-        APSARA_TEST_EQUAL(aggregator->mPackageListMergeMap.size(), 1);
-        APSARA_TEST_EQUAL(aggregator->mMergeMap.size(), 0);
+        APSARA_TEST_EQUAL(PackageListMergeMapSize(), 1);
+        APSARA_TEST_EQUAL(MergeMapSize(), 0);
     }
 
     // mPackageListMergeMap key
     int64_t logstoreKey = HashString(projectName + "_" + logstore);
     std::unordered_map<int64_t, PackageListMergeBuffer*>::iterator pIter;
-    pIter = aggregator->mPackageListMergeMap.find(logstoreKey); 
-    APSARA_TEST_NOT_EQUAL(pIter, aggregator->mPackageListMergeMap.end());
-    if (pIter != aggregator->mPackageListMergeMap.end()) {
+    pIter = aggregator->GetMergeShard(logstoreKey).mPackageListMergeMap.find(logstoreKey); 
+    APSARA_TEST_NOT_EQUAL(pIter, aggregator->GetMergeShard(logstoreKey).mPackageListMergeMap.end());
+    if (pIter != aggregator->GetMergeShard(logstoreKey).mPackageListMergeMap.end()) {
         APSARA_TEST_EQUAL((pIter->second)->mMergeItems.size(), 10);
     }
 
-    APSARA_TEST_EQUAL(aggregator->mPackageListMergeMap.size(), 1);
-    APSARA_TEST_EQUAL(aggregator->mMergeMap.size(), 0);
+    APSARA_TEST_EQUAL(PackageListMergeMapSize(), 1);
+    APSARA_TEST_EQUAL(MergeMapSize(), 0);
 
     // sleep until PackageListMergeBuffer::IsReady
     sleep(5);
@@ -138,8 +157,8 @@ void AggregatorUnittest::TestLogstoreMergeTypeAdd() {
     }
     // the 10 old logs and 1 new log will be added to sendDataVec
     APSARA_TEST_EQUAL(aggregator->mSendVectorSize, 11);
-    APSARA_TEST_EQUAL(aggregator->mPackageListMergeMap.size(), 0);
-    APSARA_TEST_EQUAL(aggregator->mMergeMap.size(), 0);
+    APSARA_TEST_EQUAL(PackageListMergeMapSize(), 0);
+    APSARA_TEST_EQUAL(MergeMapSize(), 0);
 
     for (int i = 0; i < count; i ++) {
         sls_logs::LogGroup logGroup;
@@ -161,13 +180,13 @@ void AggregatorUnittest::TestLogstoreMergeTypeAdd() {
         aggregator->Add(
             projectName, sourceId, logGroup, logGroupKey, flusher.get(), mergeType, logGroupSize, defaultRegion, filename, context);
         APSARA_TEST_EQUAL(aggregator->mSendVectorSize, 0);
-        APSARA_TEST_EQUAL(aggregator->mPackageListMergeMap.size(), 1);
-        APSARA_TEST_EQUAL(aggregator->mMergeMap.size(), 0);
+        APSARA_TEST_EQUAL(PackageListMergeMapSize(), 1);
+        APSARA_TEST_EQUAL(MergeMapSize(), 0);
     }
 
-    pIter = aggregator->mPackageListMergeMap.find(logstoreKey); 
-    APSARA_TEST_NOT_EQUAL(pIter, aggregator->mPackageListMergeMap.end());
-    if (pIter != aggregator->mPackageListMergeMap.end()) {
+    pIter = aggregator->GetMergeShard(logstoreKey).mPackageListMergeMap.find(logstoreKey); 
+    APSARA_TEST_NOT_EQUAL(pIter, aggregator->GetMergeShard(logstoreKey).mPackageListMergeMap.end());
+    if (pIter != aggregator->GetMergeShard(logstoreKey).mPackageListMergeMap.end()) {
         APSARA_TEST_EQUAL((pIter->second)->mMergeItems.size(), 10);
     }
 }
@@ -241,9 +260,9 @@ void AggregatorUnittest::TestLogstoreMergeTypeAddLargeGroup() {
             projectName, sourceId, logGroup, logGroupKey, flusher.get(), mergeType, logGroupSize, defaultRegion, filename, context);
         
         std::unordered_map<int64_t, PackageListMergeBuffer*>::iterator pIter;
-        pIter = aggregator->mPackageListMergeMap.find(logstoreKey); 
-        APSARA_TEST_NOT_EQUAL(pIter, aggregator->mPackageListMergeMap.end());
-        if (pIter != aggregator->mPackageListMergeMap.end()) {
+        pIter = aggregator->GetMergeShard(logstoreKey).mPackageListMergeMap.find(logstoreKey); 
+        APSARA_TEST_NOT_EQUAL(pIter, aggregator->GetMergeShard(logstoreKey).mPackageListMergeMap.end());
+        if (pIter != aggregator->GetMergeShard(logstoreKey).mPackageListMergeMap.end()) {
             APSARA_TEST_EQUAL((pIter->second)->mMergeItems.size(), 2);
         }
 
@@ -305,12 +324,12 @@ void AggregatorUnittest::TestTopicMergeTypeAdd() {
         aggregator->Add(
             projectName, sourceId, logGroup, logGroupKey, flusher.get(), mergeType, logGroupSize, defaultRegion, filename, context);
         APSARA_TEST_EQUAL(aggregator->mSendVectorSize, 0);
-        APSARA_TEST_EQUAL(aggregator->mPackageListMergeMap.size(), 0);
-        APSARA_TEST_EQUAL(aggregator->mMergeMap.size(), 1);
+        APSARA_TEST_EQUAL(PackageListMergeMapSize(), 0);
+        APSARA_TEST_EQUAL(MergeMapSize(), 1);
     }
-    std::unordered_map<int64_t, MergeItem*>::iterator itr = aggregator->mMergeMap.find(logGroupKey);
-    APSARA_TEST_NOT_EQUAL(itr, aggregator->mMergeMap.end());
-    if (itr != aggregator->mMergeMap.end()) {
+    std::unordered_map<int64_t, MergeItem*>::iterator itr = aggregator->GetMergeShard(logGroupKey).mMergeMap.find(logGroupKey);
+    APSARA_TEST_NOT_EQUAL(itr, aggregator->GetMergeShard(logGroupKey).mMergeMap.end());
+    if (itr != aggregator->GetMergeShard(logGroupKey).mMergeMap.end()) {
         APSARA_TEST_EQUAL((itr->second)->mLogGroup.logs_size(), 10);
     }
 
@@ -336,13 +355,13 @@ void AggregatorUnittest::TestTopicMergeTypeAdd() {
     }
     // the 10 old logs will merge to 1, and will be added to sendDataVec
     APSARA_TEST_EQUAL(aggregator->mSendVectorSize, 1);
-    APSARA_TEST_EQUAL(aggregator->mPackageListMergeMap.size(), 0);
+    APSARA_TEST_EQUAL(PackageListMergeMapSize(), 0);
 
     // the 1 new log will keey in mMergeMap
-    APSARA_TEST_EQUAL(aggregator->mMergeMap.size(), 1);
-    itr = aggregator->mMergeMap.find(logGroupKey);
-    APSARA_TEST_NOT_EQUAL(itr, aggregator->mMergeMap.end());
-    if (itr != aggregator->mMergeMap.end()) {
+    APSARA_TEST_EQUAL(MergeMapSize(), 1);
+    itr = aggregator->GetMergeShard(logGroupKey).mMergeMap.find(logGroupKey);
+    APSARA_TEST_NOT_EQUAL(itr, aggregator->GetMergeShard(logGroupKey).mMergeMap.end());
+    if (itr != aggregator->GetMergeShard(logGroupKey).mMergeMap.end()) {
         APSARA_TEST_EQUAL((itr->second)->mLogGroup.logs_size(), 1);
     }
 
@@ -368,17 +387,69 @@ void AggregatorUnittest::TestTopicMergeTypeAdd() {
         aggregator->Add(
             projectName, sourceId, logGroup, logGroupKey, flusher.get(), mergeType, logGroupSize, defaultRegion, filename, context);
         APSARA_TEST_EQUAL(aggregator->mSendVectorSize, 0);
-        APSARA_TEST_EQUAL(aggregator->mPackageListMergeMap.size(), 0);
-        APSARA_TEST_EQUAL(aggregator->mMergeMap.size(), 1);
+        APSARA_TEST_EQUAL(PackageListMergeMapSize(), 0);
+        APSARA_TEST_EQUAL(MergeMapSize(), 1);
     }
-    itr = aggregator->mMergeMap.find(logGroupKey);
-    APSARA_TEST_NOT_EQUAL(itr, aggregator->mMergeMap.end());
+    itr = aggregator->GetMergeShard(logGroupKey).mMergeMap.find(logGroupKey);
+    APSARA_TEST_NOT_EQUAL(itr, aggregator->GetMergeShard(logGroupKey).mMergeMap.end());
 
     // mMergeMap should keep 10 logs
-    if (itr != aggregator->mMergeMap.end()) {
+    if (itr != aggregator->GetMergeShard(logGroupKey).mMergeMap.end()) {
         APSARA_TEST_EQUAL((itr->second)->mLogGroup.logs_size(), 10);
     }
 }
+
+void AggregatorUnittest::TestShardStatistics() {
+    std::string projectName = "testProject";
+    INT32_FLAG(batch_send_interval) = 100;
+
+    std::unique_ptr<FlusherSLS> flusher;
+    {
+        PipelineContext ctx;
+        ctx.SetConfigName("test_config");
+        flusher.reset(new FlusherSLS());
+        flusher->SetContext(ctx);
+        flusher->SetMetricsRecordRef(FlusherSLS::sName, "1");
+    }
+
+    Aggregator* aggregator = Aggregator::GetInstance();
+    std::vector<std::string> logstores = {"testLogstore0", "testLogstore1", "testLogstore2"};
+    for (const auto& logstore : logstores) {
+        for (int i = 0; i < 2; ++i) {
+            sls_logs::LogGroup logGroup;
+            logGroup.set_category(logstore);
+            sls_logs::Log* log = logGroup.add_logs();
+            log->set_time(time(NULL));
+            sls_logs::Log_Content* content = log->add_contents();
+            content->set_key("testKey");
+            content->set_value("testValue");
+            aggregator->Add(projectName,
+                            "test",
+                            logGroup,
+                            123,
+                            flusher.get(),
+                            FlusherSLS::Batch::MergeType::LOGSTORE,
+                            24,
+                            "testRegion",
+                            "testFile");
+        }
+    }
+    APSARA_TEST_EQUAL(PackageListMergeMapSize(), logstores.size());
+    // each logstore is kept by the shard of its key
+    for (const auto& logstore : logstores) {
+        int64_t logstoreKey = HashString(projectName + "_" + logstore);
+        auto& packageListMergeMap = aggregator->GetMergeShard(logstoreKey).mPackageListMergeMap;
+        APSARA_TEST_EQUAL(packageListMergeMap.count(logstoreKey), 1U);
+    }
+
+    std::vector<size_t> itemCounts;
+    std::vector<uint64_t> lockWaitTimeUs;
+    aggregator->FetchShardStatistics(itemCounts, lockWaitTimeUs);
+    APSARA_TEST_EQUAL(itemCounts.size(), aggregator->mMergeShards.size());
+    APSARA_TEST_EQUAL(lockWaitTimeUs.size(), aggregator->mMergeShards.size());
+    APSARA_TEST_EQUAL(std::accumulate(itemCounts.begin(), itemCounts.end(), size_t(0)), 2 * logstores.size());
+    APSARA_TEST_FALSE(aggregator->IsMergeMapEmpty());
+}
 }
 
 int main(int argc, char** argv) {
@@ -0,0 +1,217 @@
+// Copyright 2024 iLogtail Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <map>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "checkpoint/BinaryCheckPointStore.h"
+#include "checkpoint/CheckPointManager.h"
+#include "common/Flags.h"
+#include "unittest/Unittest.h"
+
+DECLARE_FLAG_INT32(check_point_compaction_ratio);
+
+namespace logtail {
+
+class BinaryCheckPointStoreUnittest : public ::testing::Test {
+public:
+    void TestDumpAndLoad();
+    void TestIncrementalDump();
+    void TestCompaction();
+    void TestBrokenFile();
+
+protected:
+    void SetUp() override {
+        mFilePath = "BinaryCheckPointStoreUnittest.bin";
+        remove(mFilePath.c_str());
+        for (uint64_t i = 0; i < 10; ++i) {
+            mCheckPoints.emplace_back(new CheckPoint("/var/log/app" + std::to_string(i) + ".log",
+                                                     i * 1000,
+                                                     1024,
+                                                     i * 7,
+                                                     DevInode(1, 100 + i),
+                                                     "config",
+                                                     i % 2 ? "/var/log/app.log.1" : "",
+                                                     i % 2,
+                                                     i % 3 == 0,
+                                                     i % 5 == 0));
+            mCheckPoints.back()->mLastUpdateTime = 1700000000 + i;
+        }
+        DirCheckPointPtr dir(new DirCheckPoint("/var"));
+        dir->mSubDir.insert("/var/log");
+        mDirCheckPoints["/var"] = dir;
+        INT32_FLAG(check_point_compaction_ratio) = 4;
+    }
+
+    void TearDown() override { remove(mFilePath.c_str()); }
+
+    std::vector<const CheckPoint*> GetCheckPoints() const {
+        std::vector<const CheckPoint*> res;
+        for (const auto& cpt : mCheckPoints) {
+            res.push_back(cpt.get());
+        }
+        return res;
+    }
+
+    size_t GetFileSize() const { return std::ifstream(mFilePath, std::ios::binary | std::ios::ate).tellg(); }
+
+    // load the file and compare with the check points to dump
+    void CheckLoad() {
+        BinaryCheckPointStore store;
+        int32_t version = 0;
+        std::vector<CheckPointPtr> fileCheckPoints;
+        std::vector<DirCheckPointPtr> dirCheckPoints;
+        APSARA_TEST_TRUE_FATAL(store.Load(mFilePath, version, fileCheckPoints, dirCheckPoints));
+        APSARA_TEST_EQUAL(200, version);
+        APSARA_TEST_EQUAL_FATAL(mCheckPoints.size(), fileCheckPoints.size());
+        std::map<uint64_t, const CheckPoint*> expected;
+        for (const auto& cpt : mCheckPoints) {
+            expected[cpt->mDevInode.inode] = cpt.get();
+        }
+        for (const auto& cpt : fileCheckPoints) {
+            const CheckPoint* exp = expected[cpt->mDevInode.inode];
+            APSARA_TEST_TRUE_FATAL(exp != nullptr);
+            APSARA_TEST_EQUAL(exp->mFileName, cpt->mFileName);
+            APSARA_TEST_EQUAL(exp->mRealFileName, cpt->mRealFileName);
+            APSARA_TEST_EQUAL(exp->mConfigName, cpt->mConfigName);
+            APSARA_TEST_EQUAL(exp->mOffset, cpt->mOffset);
+            APSARA_TEST_EQUAL(exp->mSignatureHash, cpt->mSignatureHash);
+            APSARA_TEST_EQUAL(exp->mSignatureSize, cpt->mSignatureSize);
+            APSARA_TEST_EQUAL(exp->mLastUpdateTime, cpt->mLastUpdateTime);
+            APSARA_TEST_EQUAL(exp->mFileOpenFlag, cpt->mFileOpenFlag);
+            APSARA_TEST_EQUAL(exp->mContainerStopped, cpt->mContainerStopped);
+            APSARA_TEST_EQUAL(exp->mLastForceRead, cpt->mLastForceRead);
+        }
+        APSARA_TEST_EQUAL_FATAL(mDirCheckPoints.size(), dirCheckPoints.size());
+        for (const auto& dir : dirCheckPoints) {
+            APSARA_TEST_TRUE_FATAL(mDirCheckPoints.find(dir->mParentName) != mDirCheckPoints.end());
+            APSARA_TEST_EQUAL(mDirCheckPoints[dir->mParentName]->mSubDir, dir->mSubDir);
+            APSARA_TEST_EQUAL(mDirCheckPoints[dir->mParentName]->mUpdateTime, dir->mUpdateTime);
+        }
+    }
+
+    std::string mFilePath;
+    std::vector<CheckPointPtr> mCheckPoints;
+    std::unordered_map<std::string, DirCheckPointPtr> mDirCheckPoints;
+};
+
+void BinaryCheckPointStoreUnittest::TestDumpAndLoad() {
+    BinaryCheckPointStore store;
+    int32_t version = 0;
+    std::vector<CheckPointPtr> fileCheckPoints;
+    std::vector<DirCheckPointPtr> dirCheckPoints;
+    APSARA_TEST_FALSE(store.Load(mFilePath, version, fileCheckPoints, dirCheckPoints));
+    std::ofstream(mFilePath) << R"({"check_point":{}})";
+    APSARA_TEST_FALSE(store.Load(mFilePath, version, fileCheckPoints, dirCheckPoints));
+
+    APSARA_TEST_TRUE(store.Dump(mFilePath, 200, GetCheckPoints(), mDirCheckPoints));
+    CheckLoad();
+}
+
+void BinaryCheckPointStoreUnittest::TestIncrementalDump() {
+    BinaryCheckPointStore store;
+    APSARA_TEST_TRUE(store.Dump(mFilePath, 200, GetCheckPoints(), mDirCheckPoints));
+    size_t fileSize = GetFileSize();
+    // nothing changed, nothing appended
+    APSARA_TEST_TRUE(store.Dump(mFilePath, 200, GetCheckPoints(), mDirCheckPoints));
+    APSARA_TEST_EQUAL(fileSize, GetFileSize());
+
+    // only the changed one is appended
+    mCheckPoints[3]->mOffset += 100;
+    APSARA_TEST_TRUE(store.Dump(mFilePath, 200, GetCheckPoints(), mDirCheckPoints));
+    size_t recordSize = GetFileSize() - fileSize;
+    APSARA_TEST_TRUE(recordSize > 0 && recordSize < fileSize / 4);
+    CheckLoad();
+
+    // deleted and added
+    mCheckPoints.erase(mCheckPoints.begin());
+    mCheckPoints.emplace_back(
+        new CheckPoint("/var/log/new.log", 1, 1, 1, DevInode(2, 1), "config", "", false, false, false));
+    mDirCheckPoints["/var"]->mSubDir.insert("/var/log2");
+    APSARA_TEST_TRUE(store.Dump(mFilePath, 200, GetCheckPoints(), mDirCheckPoints));
+    CheckLoad();
+
+    // a loaded store continues appending
+    BinaryCheckPointStore loadedStore;
+    int32_t version = 0;
+    std::vector<CheckPointPtr> fileCheckPoints;
+    std::vector<DirCheckPointPtr> dirCheckPoints;
+    APSARA_TEST_TRUE(loadedStore.Load(mFilePath, version, fileCheckPoints, dirCheckPoints));
+    fileSize = GetFileSize();
+    APSARA_TEST_TRUE(loadedStore.Dump(mFilePath, 200, GetCheckPoints(), mDirCheckPoints));
+    APSARA_TEST_EQUAL(fileSize, GetFileSize());
+}
+
+void BinaryCheckPointStoreUnittest::TestCompaction() {
+    BinaryCheckPointStore store;
+    APSARA_TEST_TRUE(store.Dump(mFilePath, 200, GetCheckPoints(), mDirCheckPoints));
+    size_t fileSize = GetFileSize();
+    for (int i = 0; i < 3; ++i) {
+        for (auto& cpt : mCheckPoints) {
+            cpt->mOffset += 10;
+        }
+        APSARA_TEST_TRUE(store.Dump(mFilePath, 200, GetCheckPoints(), mDirCheckPoints));
+    }
+    APSARA_TEST_TRUE(GetFileSize() > 3 * fileSize);
+    for (auto& cpt : mCheckPoints) {
+        cpt->mOffset += 10;
+    }
+    APSARA_TEST_TRUE(store.Dump(mFilePath, 200, GetCheckPoints(), mDirCheckPoints));
+    APSARA_TEST_EQUAL(fileSize, GetFileSize());
+    CheckLoad();
+}
+
+void BinaryCheckPointStoreUnittest::TestBrokenFile() {
+    BinaryCheckPointStore store;
+    APSARA_TEST_TRUE(store.Dump(mFilePath, 200, GetCheckPoints(), mDirCheckPoints));
+    size_t fileSize = GetFileSize();
+    auto lastCheckPoint = *mCheckPoints.back();
+    mCheckPoints.back()->mOffset += 100;
+    APSARA_TEST_TRUE(store.Dump(mFilePath, 200, GetCheckPoints(), mDirCheckPoints));
+
+    // the torn record appended last is dropped
+    std::string content;
+    {
+        std::ifstream fin(mFilePath, std::ios::binary);
+        content.assign(std::istreambuf_iterator<char>(fin), std::istreambuf_iterator<char>());
+    }
+    std::ofstream(mFilePath, std::ios::binary | std::ios::trunc).write(content.data(), content.size() - 1);
+    *mCheckPoints.back() = lastCheckPoint;
+    CheckLoad();
+
+    // and the file is rewritten on next dump
+    BinaryCheckPointStore loadedStore;
+    int32_t version = 0;
+    std::vector<CheckPointPtr> fileCheckPoints;
+    std::vector<DirCheckPointPtr> dirCheckPoints;
+    APSARA_TEST_TRUE(loadedStore.Load(mFilePath, version, fileCheckPoints, dirCheckPoints));
+    APSARA_TEST_EQUAL(0U, loadedStore.mFileSize);
+    APSARA_TEST_TRUE(loadedStore.Dump(mFilePath, 200, GetCheckPoints(), mDirCheckPoints));
+    APSARA_TEST_EQUAL(fileSize, GetFileSize());
+    CheckLoad();
+}
+
+UNIT_TEST_CASE(BinaryCheckPointStoreUnittest, TestDumpAndLoad)
+UNIT_TEST_CASE(BinaryCheckPointStoreUnittest, TestIncrementalDump)
+UNIT_TEST_CASE(BinaryCheckPointStoreUnittest, TestCompaction)
+UNIT_TEST_CASE(BinaryCheckPointStoreUnittest, TestBrokenFile)
+
+} // namespace logtail
+
+UNIT_TEST_MAIN
@@ -0,0 +1,204 @@
+// Copyright 2024 iLogtail Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <chrono>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "common/CompressTools.h"
+#include "common/ZstdDictionary.h"
+#include "unittest/Unittest.h"
+
+DECLARE_FLAG_BOOL(enable_zstd_dictionary_evaluation);
+DECLARE_FLAG_INT32(zstd_dictionary_sample_interval);
+DECLARE_FLAG_INT32(zstd_dictionary_sample_count);
+
+namespace logtail {
+
+// a serialized-like log group, with the same keys and tags in each one
+static std::string MakeLogGroup(int seq) {
+    std::string data;
+    for (int i = 0; i < 20; ++i) {
+        data += "__time__" + std::to_string(1700000000 + seq * 20 + i) + "level" + (i % 3 ? "INFO" : "WARN")
+            + "thread" + "http-nio-8080-exec-" + std::to_string(i % 8) + "logger" + "com.example.BookController"
+            + "message" + "request " + std::to_string(seq * 131 + i * 7) + " done, cost " + std::to_string(i) + "ms";
+    }
+    data += "__tag__:__hostname__host-192-168-0-1__tag__:__path__/var/log/app/app.log__topic__app";
+    return data;
+}
+
+class CompressToolsUnittest : public ::testing::Test {
+public:
+    void TestCompressData();
+    void TestCompressInThreads();
+    void TestStatistics();
+};
+
+class ZstdDictionaryUnittest : public ::testing::Test {
+public:
+    void TestTrain();
+    void TestFeed();
+
+protected:
+    void SetUp() override {
+        INT32_FLAG(zstd_dictionary_sample_interval) = 2;
+        INT32_FLAG(zstd_dictionary_sample_count) = 20;
+    }
+    void TearDown() override { BOOL_FLAG(enable_zstd_dictionary_evaluation) = false; }
+};
+
+void CompressToolsUnittest::TestCompressData() {
+    std::vector<sls_logs::SlsCompressType> types
+        = {sls_logs::SLS_CMP_NONE, sls_logs::SLS_CMP_LZ4, sls_logs::SLS_CMP_DEFLATE, sls_logs::SLS_CMP_ZSTD};
+    for (auto type : types) {
+        // the reused contexts should not leak anything from the last payload
+        for (int i = 0; i < 3; ++i) {
+            std::string src = i == 1 ? std::string() : MakeLogGroup(i);
+            std::string compressed, uncompressed;
+            APSARA_TEST_TRUE(CompressData(type, src, compressed));
+            APSARA_TEST_TRUE(UncompressData(type, compressed, src.size(), uncompressed));
+            APSARA_TEST_EQUAL(src, uncompressed);
+        }
+    }
+    std::string compressed, uncompressed;
+    APSARA_TEST_TRUE(CompressZstd(MakeLogGroup(0), compressed, 3));
+    APSARA_TEST_FALSE(UncompressZstd(compressed, MakeLogGroup(0).size() - 1, uncompressed));
+    APSARA_TEST_FALSE(UncompressZstd(compressed.substr(1), MakeLogGroup(0).size(), uncompressed));
+    APSARA_TEST_TRUE(UncompressZstd(compressed, MakeLogGroup(0).size(), uncompressed));
+    APSARA_TEST_EQUAL(MakeLogGroup(0), uncompressed);
+}
+
+void CompressToolsUnittest::TestCompressInThreads() {
+    std::vector<std::thread> threads;
+    std::vector<int> results(4, 0);
+    for (size_t t = 0; t < results.size(); ++t) {
+        threads.emplace_back([t, &results]() {
+            for (int i = 0; i < 100; ++i) {
+                std::string src = MakeLogGroup(t * 100 + i);
+                std::string compressed, uncompressed;
+                if (CompressData(t % 2 ? sls_logs::SLS_CMP_ZSTD : sls_logs::SLS_CMP_LZ4, src, compressed)
+                    && UncompressData(
+                        t % 2 ? sls_logs::SLS_CMP_ZSTD : sls_logs::SLS_CMP_LZ4, compressed, src.size(), uncompressed)
+                    && src == uncompressed) {
+                    ++results[t];
+                }
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    for (auto result : results) {
+        APSARA_TEST_EQUAL(100, result);
+    }
+}
+
+void CompressToolsUnittest::TestStatistics() {
+    ExchangeCompressStatistics(sls_logs::SLS_CMP_ZSTD);
+    std::string src = MakeLogGroup(0);
+    std::string compressed;
+    APSARA_TEST_TRUE(CompressData(sls_logs::SLS_CMP_ZSTD, src, compressed));
+    APSARA_TEST_TRUE(CompressData(sls_logs::SLS_CMP_ZSTD, src.data(), src.size(), compressed));
+    auto stat = ExchangeCompressStatistics(sls_logs::SLS_CMP_ZSTD);
+    APSARA_TEST_EQUAL(2 * src.size(), stat.mRawBytes);
+    APSARA_TEST_EQUAL(2 * compressed.size(), stat.mCompressedBytes);
+    stat = ExchangeCompressStatistics(sls_logs::SLS_CMP_ZSTD);
+    APSARA_TEST_EQUAL(0U, stat.mRawBytes);
+    APSARA_TEST_EQUAL(0U, stat.mCompressedBytes);
+    APSARA_TEST_EQUAL(0U, stat.mCpuTimeNs);
+}
+
+void ZstdDictionaryUnittest::TestTrain() {
+    std::vector<std::string> samples;
+    for (int i = 0; i < 100; ++i) {
+        samples.push_back(MakeLogGroup(i));
+    }
+    std::vector<std::string> fewSamples(samples.begin(), samples.begin() + 2);
+    APSARA_TEST_EQUAL(nullptr, ZstdDictionary::Train(fewSamples, 4096));
+    auto dict = ZstdDictionary::Train(samples, 4096);
+    APSARA_TEST_NOT_EQUAL(nullptr, dict);
+    APSARA_TEST_TRUE(dict->GetContent().size() <= 4096U);
+    APSARA_TEST_NOT_EQUAL(0U, dict->GetId());
+
+    std::string src = MakeLogGroup(1000);
+    std::string compressed, compressedWithDict, uncompressed;
+    APSARA_TEST_TRUE(CompressZstd(src, compressed, ZSTD_DEFAULT_LEVEL));
+    APSARA_TEST_TRUE(dict->Compress(src.data(), src.size(), compressedWithDict));
+    APSARA_TEST_TRUE(compressedWithDict.size() < compressed.size());
+    APSARA_TEST_TRUE(dict->Uncompress(compressedWithDict.data(), compressedWithDict.size(), src.size(), uncompressed));
+    APSARA_TEST_EQUAL(src, uncompressed);
+    // the dictionary is required to decompress
+    APSARA_TEST_FALSE(UncompressZstd(compressedWithDict, src.size(), uncompressed));
+}
+
+void ZstdDictionaryUnittest::TestFeed() {
+    auto manager = ZstdDictionaryManager::GetInstance();
+    LogstoreFeedBackKey key = 12345;
+    // disabled by default
+    manager->Feed(key, MakeLogGroup(0).data(), MakeLogGroup(0).size());
+    APSARA_TEST_TRUE(manager->mEntries.empty());
+
+    BOOL_FLAG(enable_zstd_dictionary_evaluation) = true;
+    manager->ExchangeStatistics();
+    for (int i = 0; i < 38; ++i) {
+        std::string data = MakeLogGroup(i);
+        manager->Feed(key, data.data(), data.size());
+    }
+    APSARA_TEST_EQUAL(nullptr, manager->GetDictionary(key));
+    APSARA_TEST_EQUAL(19U, manager->mEntries[key].mSamples.size());
+    std::string data = MakeLogGroup(38);
+    manager->Feed(key, data.data(), data.size());
+    // trained in background
+    for (int i = 0; i < 1000 && manager->GetDictionary(key) == nullptr; ++i) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    APSARA_TEST_EQUAL(39U, manager->mEntries[key].mFedCount);
+    APSARA_TEST_FALSE(manager->mEntries[key].mTraining);
+    auto dict = manager->GetDictionary(key);
+    APSARA_TEST_NOT_EQUAL(nullptr, dict);
+    APSARA_TEST_TRUE(manager->mEntries[key].mSamples.empty());
+    APSARA_TEST_EQUAL(0U, manager->ExchangeStatistics().mRawBytes);
+
+    // sampled log groups are evaluated with the dictionary and no longer kept before refreshing
+    size_t sampledSize = 0;
+    for (int i = 39; i < 43; ++i) {
+        std::string data = MakeLogGroup(i);
+        manager->Feed(key, data.data(), data.size());
+        sampledSize += i % 2 ? 0 : data.size();
+    }
+    APSARA_TEST_TRUE(manager->mEntries[key].mSamples.empty());
+    auto stat = manager->ExchangeStatistics();
+    APSARA_TEST_EQUAL(sampledSize, stat.mRawBytes);
+    APSARA_TEST_TRUE(stat.mCompressedBytes > 0 && stat.mCompressedBytes < stat.mRawBytes);
+
+    manager->RemoveExpired(time(NULL));
+    APSARA_TEST_EQUAL(1U, manager->mEntries.size());
+    manager->RemoveExpired(time(NULL) + 3600);
+    APSARA_TEST_TRUE(manager->mEntries.empty());
+}
+
+UNIT_TEST_CASE(CompressToolsUnittest, TestCompressData);
+UNIT_TEST_CASE(CompressToolsUnittest, TestCompressInThreads);
+UNIT_TEST_CASE(CompressToolsUnittest, TestStatistics);
+UNIT_TEST_CASE(ZstdDictionaryUnittest, TestTrain);
+UNIT_TEST_CASE(ZstdDictionaryUnittest, TestFeed);
+
+} // namespace logtail
+
+int main(int argc, char** argv) {
+    logtail::Logger::Instance().InitGlobalLoggers();
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
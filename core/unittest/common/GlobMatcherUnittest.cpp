@@ -0,0 +1,72 @@
+// Copyright 2024 iLogtail Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <fnmatch.h>
+
+#include <string>
+#include <vector>
+
+#include "common/GlobMatcher.h"
+#include "unittest/Unittest.h"
+
+namespace logtail {
+
+class GlobMatcherUnittest : public ::testing::Test {
+public:
+    void TestCompile();
+    void TestSameAsFnmatch();
+};
+
+void GlobMatcherUnittest::TestCompile() {
+    APSARA_TEST_TRUE(GlobMatcher("a.log").mType == GlobMatcher::Type::LITERAL);
+    APSARA_TEST_TRUE(GlobMatcher("*.log").mType == GlobMatcher::Type::SUFFIX);
+    APSARA_TEST_EQUAL(".log", GlobMatcher("*.log").mLiteral);
+    APSARA_TEST_TRUE(GlobMatcher("app*").mType == GlobMatcher::Type::PREFIX);
+    APSARA_TEST_EQUAL("app", GlobMatcher("app*").mLiteral);
+    APSARA_TEST_TRUE(GlobMatcher("*").mType == GlobMatcher::Type::ANY);
+    APSARA_TEST_TRUE(GlobMatcher("*.log.[0-9]").mType == GlobMatcher::Type::GENERIC);
+    APSARA_TEST_TRUE(GlobMatcher("a?.log").mType == GlobMatcher::Type::GENERIC);
+    APSARA_TEST_TRUE(GlobMatcher("*a*").mType == GlobMatcher::Type::GENERIC);
+    APSARA_TEST_TRUE(GlobMatcher("\\*.log").mType == GlobMatcher::Type::GENERIC);
+    APSARA_TEST_TRUE(GlobMatcher("*.log", FNM_NOESCAPE).mType == GlobMatcher::Type::GENERIC);
+    APSARA_TEST_EQUAL("*.log", GlobMatcher("*.log").GetPattern());
+}
+
+void GlobMatcherUnittest::TestSameAsFnmatch() {
+    std::vector<std::string> patterns = {"",        "*",      "**",         "a.log", "*.log",     "app*",   "/home/*",
+                                         "*/a.log", "*.log*", "*.log.[0-9]", "a?.log", "\\*.log", "/home/*/b"};
+    std::vector<std::string> inputs = {"",          "a.log",   "b.log",     ".log",       "app",      "app.log",
+                                       "/home/a",   "/home/a/b", "x/a.log", "a.log.1",    "*.log",    "ab.log",
+                                       "/home//b", "/home/x/b", "/home/",  "a.logx.log", "app/x.log"};
+    for (const auto& pattern : patterns) {
+        for (int flags : {0, FNM_PATHNAME}) {
+            GlobMatcher matcher(pattern, flags);
+            for (const auto& input : inputs) {
+                EXPECT_EQ(fnmatch(pattern.c_str(), input.c_str(), flags) == 0, matcher.Match(input))
+                    << pattern << " " << input << " " << flags;
+            }
+        }
+    }
+}
+
+UNIT_TEST_CASE(GlobMatcherUnittest, TestCompile);
+UNIT_TEST_CASE(GlobMatcherUnittest, TestSameAsFnmatch);
+
+} // namespace logtail
+
+int main(int argc, char** argv) {
+    logtail::Logger::Instance().InitGlobalLoggers();
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
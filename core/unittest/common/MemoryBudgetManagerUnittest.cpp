@@ -0,0 +1,232 @@
+// Copyright 2024 iLogtail Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <memory>
+#include <vector>
+
+#include "common/FeedbackInterface.h"
+#include "common/memory/MemoryBudgetManager.h"
+#include "unittest/Unittest.h"
+
+using namespace std;
+
+namespace logtail {
+
+class CountingFeedbackInterface : public FeedbackInterface {
+public:
+    void Feedback(int64_t key) override {
+        ++mCnt;
+        mKey = key;
+    }
+
+    int mCnt = 0;
+    int64_t mKey = -1;
+};
+
+class MemoryBudgetManagerUnittest : public testing::Test {
+public:
+    void TestPipelineBudget();
+    void TestGlobalBudget();
+    void TestLowPriorityFeedback();
+    void TestOverLimit();
+    void TestUnlimited();
+    void TestDeleteBudget();
+
+protected:
+    void SetUp() override { sManager->SetGlobalLimit(1000); }
+    void TearDown() override { sManager->Clear(); }
+
+    static shared_ptr<PipelineMemoryBudget>
+    CreateBudget(const string& configName, bool lowPriority, int64_t key, CountingFeedbackInterface& feedback) {
+        auto budget = sManager->CreateOrUpdateBudget(configName, lowPriority);
+        budget->SetUpStreamFeedbacks(key, vector<FeedbackInterface*>{&feedback});
+        return budget;
+    }
+
+private:
+    static MemoryBudgetManager* sManager;
+};
+
+MemoryBudgetManager* MemoryBudgetManagerUnittest::sManager = MemoryBudgetManager::GetInstance();
+
+void MemoryBudgetManagerUnittest::TestPipelineBudget() {
+    CountingFeedbackInterface feedback;
+    auto budget = CreateBudget("test_config", false, 1, feedback);
+    APSARA_TEST_EQUAL(500, sManager->GetPipelineLimit());
+
+    budget->Reserve(300);
+    APSARA_TEST_TRUE(budget->IsValidToPush());
+    // pipeline limit is reached
+    budget->Reserve(200);
+    APSARA_TEST_FALSE(budget->IsValidToPush());
+    APSARA_TEST_EQUAL(500, budget->GetUsage());
+    APSARA_TEST_EQUAL(500, sManager->GetGlobalUsage());
+    APSARA_TEST_EQUAL(1U, budget->mBlockTotal->GetValue());
+    // others are not affected
+    APSARA_TEST_TRUE(sManager->IsValidToPush(false));
+
+    // above the low watermark
+    budget->Release(50);
+    APSARA_TEST_FALSE(budget->IsValidToPush());
+    APSARA_TEST_EQUAL(0, feedback.mCnt);
+    // at the low watermark
+    budget->Release(50);
+    APSARA_TEST_TRUE(budget->IsValidToPush());
+    APSARA_TEST_EQUAL(1, feedback.mCnt);
+    APSARA_TEST_EQUAL(1, feedback.mKey);
+
+    budget->Release(400);
+    APSARA_TEST_EQUAL(0, budget->GetUsage());
+    APSARA_TEST_EQUAL(0, sManager->GetGlobalUsage());
+    APSARA_TEST_EQUAL(1, feedback.mCnt);
+}
+
+void MemoryBudgetManagerUnittest::TestGlobalBudget() {
+    CountingFeedbackInterface feedback1, feedback2, feedback3;
+    auto budget1 = CreateBudget("test_config_1", false, 1, feedback1);
+    auto budget2 = CreateBudget("test_config_2", false, 2, feedback2);
+    auto budget3 = CreateBudget("test_config_3", true, 3, feedback3);
+
+    budget1->Reserve(400);
+    budget2->Reserve(200);
+    APSARA_TEST_TRUE(budget3->IsValidToPush());
+    // pipelines of the lowest priority are paused first
+    budget2->Reserve(100);
+    APSARA_TEST_TRUE(budget1->IsValidToPush());
+    APSARA_TEST_TRUE(budget2->IsValidToPush());
+    APSARA_TEST_FALSE(budget3->IsValidToPush());
+
+    // global limit is reached
+    budget2->Reserve(300);
+    APSARA_TEST_EQUAL(1000, sManager->GetGlobalUsage());
+    APSARA_TEST_FALSE(budget1->IsValidToPush());
+    APSARA_TEST_FALSE(budget2->IsValidToPush());
+    APSARA_TEST_FALSE(budget3->IsValidToPush());
+
+    // above the global low watermark
+    budget1->Release(100);
+    APSARA_TEST_FALSE(budget1->IsValidToPush());
+    APSARA_TEST_EQUAL(0, feedback1.mCnt);
+
+    // at the global low watermark, pipelines which are allowed to push again are given feedback
+    budget2->Release(100);
+    APSARA_TEST_EQUAL(800, sManager->GetGlobalUsage());
+    APSARA_TEST_TRUE(budget1->IsValidToPush());
+    APSARA_TEST_FALSE(budget2->IsValidToPush());
+    APSARA_TEST_EQUAL(1, feedback1.mCnt);
+    APSARA_TEST_EQUAL(0, feedback2.mCnt);
+
+    // at the pipeline low watermark
+    budget2->Release(100);
+    APSARA_TEST_TRUE(budget2->IsValidToPush());
+    APSARA_TEST_FALSE(budget3->IsValidToPush());
+    APSARA_TEST_EQUAL(1, feedback1.mCnt);
+    APSARA_TEST_EQUAL(1, feedback2.mCnt);
+    APSARA_TEST_EQUAL(0, feedback3.mCnt);
+
+    // a larger limit ends the backpressure
+    budget1->Reserve(300);
+    APSARA_TEST_FALSE(budget1->IsValidToPush());
+    sManager->SetGlobalLimit(10000);
+    APSARA_TEST_FALSE(budget1->IsValidToPush());
+    budget1->Release(0);
+    APSARA_TEST_TRUE(budget1->IsValidToPush());
+    APSARA_TEST_TRUE(budget3->IsValidToPush());
+}
+
+void MemoryBudgetManagerUnittest::TestLowPriorityFeedback() {
+    CountingFeedbackInterface feedback1, feedback2;
+    auto budget1 = CreateBudget("test_config_1", false, 1, feedback1);
+    auto budget2 = CreateBudget("test_config_2", true, 2, feedback2);
+
+    budget1->Reserve(400);
+    budget2->Reserve(300);
+    APSARA_TEST_TRUE(budget1->IsValidToPush());
+    APSARA_TEST_FALSE(budget2->IsValidToPush());
+
+    // still at the low priority threshold
+    budget1->Release(0);
+    APSARA_TEST_FALSE(budget2->IsValidToPush());
+    APSARA_TEST_EQUAL(0, feedback2.mCnt);
+    // below the low priority threshold, only pipelines of the lowest priority are given feedback
+    budget1->Release(100);
+    APSARA_TEST_TRUE(budget2->IsValidToPush());
+    APSARA_TEST_EQUAL(1, feedback2.mCnt);
+    APSARA_TEST_EQUAL(2, feedback2.mKey);
+    APSARA_TEST_EQUAL(0, feedback1.mCnt);
+    budget1->Release(100);
+    APSARA_TEST_EQUAL(1, feedback2.mCnt);
+
+    // a larger limit lifts the threshold
+    budget1->Reserve(200);
+    APSARA_TEST_FALSE(budget2->IsValidToPush());
+    sManager->SetGlobalLimit(2000);
+    APSARA_TEST_TRUE(budget2->IsValidToPush());
+    APSARA_TEST_EQUAL(2, feedback2.mCnt);
+    APSARA_TEST_EQUAL(0, feedback1.mCnt);
+}
+
+void MemoryBudgetManagerUnittest::TestOverLimit() {
+    CountingFeedbackInterface feedback;
+    auto budget = CreateBudget("test_config", false, 1, feedback);
+
+    sManager->SetOverLimit(true);
+    APSARA_TEST_TRUE(sManager->IsOverLimit());
+    APSARA_TEST_FALSE(budget->IsValidToPush());
+    sManager->SetOverLimit(true);
+    APSARA_TEST_EQUAL(0, feedback.mCnt);
+
+    sManager->SetOverLimit(false);
+    APSARA_TEST_TRUE(budget->IsValidToPush());
+    APSARA_TEST_EQUAL(1, feedback.mCnt);
+    sManager->SetOverLimit(false);
+    APSARA_TEST_EQUAL(1, feedback.mCnt);
+}
+
+void MemoryBudgetManagerUnittest::TestUnlimited() {
+    sManager->SetGlobalLimit(0);
+    CountingFeedbackInterface feedback;
+    auto budget = CreateBudget("test_config", true, 1, feedback);
+    budget->Reserve(1000000);
+    APSARA_TEST_TRUE(budget->IsValidToPush());
+    budget->Release(1000000);
+    APSARA_TEST_EQUAL(0, sManager->GetGlobalUsage());
+}
+
+void MemoryBudgetManagerUnittest::TestDeleteBudget() {
+    CountingFeedbackInterface feedback;
+    auto budget = CreateBudget("test_config", false, 1, feedback);
+    // kept on update
+    APSARA_TEST_EQUAL(budget, sManager->CreateOrUpdateBudget("test_config", true));
+    APSARA_TEST_TRUE(budget->IsLowPriority());
+    APSARA_TEST_EQUAL(budget, sManager->GetBudget("test_config"));
+
+    budget->Reserve(100);
+    sManager->DeleteBudget("test_config");
+    APSARA_TEST_EQUAL(nullptr, sManager->GetBudget("test_config"));
+    // data in flight is still released
+    budget->Release(100);
+    APSARA_TEST_EQUAL(0, sManager->GetGlobalUsage());
+}
+
+UNIT_TEST_CASE(MemoryBudgetManagerUnittest, TestPipelineBudget)
+UNIT_TEST_CASE(MemoryBudgetManagerUnittest, TestGlobalBudget)
+UNIT_TEST_CASE(MemoryBudgetManagerUnittest, TestLowPriorityFeedback)
+UNIT_TEST_CASE(MemoryBudgetManagerUnittest, TestOverLimit)
+UNIT_TEST_CASE(MemoryBudgetManagerUnittest, TestUnlimited)
+UNIT_TEST_CASE(MemoryBudgetManagerUnittest, TestDeleteBudget)
+
+} // namespace logtail
+
+UNIT_TEST_MAIN
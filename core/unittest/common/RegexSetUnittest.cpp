@@ -0,0 +1,156 @@
+// Copyright 2024 iLogtail Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <string>
+#include <vector>
+
+#include "common/RegexSet.h"
+#include "common/StringTools.h"
+#include "unittest/Unittest.h"
+
+namespace logtail {
+
+class RegexSetUnittest : public ::testing::Test {
+public:
+    void TestParseRegexEngine();
+    void TestAdd();
+    void TestSameAsBoost();
+    void TestMatchAll();
+};
+
+void RegexSetUnittest::TestParseRegexEngine() {
+    RegexEngine engine = RegexEngine::BOOST;
+    APSARA_TEST_TRUE(ParseRegexEngine("re2", engine));
+    APSARA_TEST_TRUE(RegexEngine::RE2 == engine);
+    APSARA_TEST_EQUAL("re2", RegexEngineToString(engine));
+    APSARA_TEST_TRUE(ParseRegexEngine("boost", engine));
+    APSARA_TEST_TRUE(RegexEngine::BOOST == engine);
+    APSARA_TEST_FALSE(ParseRegexEngine("hyperscan", engine));
+    APSARA_TEST_TRUE(RegexEngine::BOOST == engine);
+
+    Json::Value config;
+    std::string errorMsg;
+    APSARA_TEST_TRUE(GetOptionalRegexEngineParam(config, "RegexEngine", engine, errorMsg));
+    APSARA_TEST_TRUE(RegexEngine::BOOST == engine);
+    config["RegexEngine"] = "re2";
+    APSARA_TEST_TRUE(GetOptionalRegexEngineParam(config, "RegexEngine", engine, errorMsg));
+    APSARA_TEST_TRUE(RegexEngine::RE2 == engine);
+    config["RegexEngine"] = "hyperscan";
+    APSARA_TEST_FALSE(GetOptionalRegexEngineParam(config, "RegexEngine", engine, errorMsg));
+    APSARA_TEST_EQUAL("string param RegexEngine is not valid", errorMsg);
+    config["RegexEngine"] = 1;
+    APSARA_TEST_FALSE(GetOptionalRegexEngineParam(config, "RegexEngine", engine, errorMsg));
+    APSARA_TEST_TRUE(RegexEngine::RE2 == engine);
+}
+
+void RegexSetUnittest::TestAdd() {
+    RegexSet set(RegexEngine::RE2, RegexSet::Anchor::FULL);
+    APSARA_TEST_EQUAL(0, set.Add("abc"));
+    APSARA_TEST_EQUAL(-1, set.Add("(abc"));
+    // back references are not supported by RE2
+    APSARA_TEST_EQUAL(1, set.Add("(a)\\1"));
+    APSARA_TEST_EQUAL(2, set.Add("\\d+"));
+    APSARA_TEST_TRUE(set.Compile());
+    APSARA_TEST_EQUAL(3U, set.Size());
+    APSARA_TEST_EQUAL(std::vector<int>({0, 2}), set.mRE2Indexes);
+    APSARA_TEST_EQUAL(std::vector<int>({1}), set.mBoostOnlyIndexes);
+    APSARA_TEST_EQUAL(-1, set.Add("def"));
+}
+
+void RegexSetUnittest::TestSameAsBoost() {
+    const std::vector<std::string> patterns = {"\\[\\d{4}-\\d{2}-\\d{2}",
+                                               "\\d+",
+                                               ".*error.*",
+                                               "\\s+at .*",
+                                               "(a)\\1.*",
+                                               "a.b",
+                                               "[^\\n]*end$",
+                                               "^line\\d",
+                                               "(?i)warn.*",
+                                               "\\w+:\\s\\S+"};
+    const std::vector<std::string> inputs = {"[2024-01-02 10:00:00] INFO start",
+                                             "12345",
+                                             "12345 error",
+                                             "an error occurs",
+                                             "    at com.example.Main(Main.java:10)",
+                                             "aa and more",
+                                             "a\nb",
+                                             "axb",
+                                             "the end",
+                                             "the end\nnext",
+                                             "line1\nline2",
+                                             "WARNING: disk",
+                                             "key: value",
+                                             "\xe4\xb8\xad\xe6\x96\x87 error",
+                                             ""};
+    for (auto anchor : {RegexSet::Anchor::FULL, RegexSet::Anchor::PREFIX}) {
+        for (auto engine : {RegexEngine::BOOST, RegexEngine::RE2}) {
+            RegexSet set(engine, anchor);
+            for (const auto& pattern : patterns) {
+                APSARA_TEST_TRUE(set.Add(pattern) >= 0);
+            }
+            APSARA_TEST_TRUE(set.Compile());
+            for (const auto& input : inputs) {
+                std::vector<int> expected;
+                std::string exception;
+                for (size_t i = 0; i < patterns.size(); ++i) {
+                    boost::regex reg(patterns[i]);
+                    if (anchor == RegexSet::Anchor::FULL
+                            ? BoostRegexMatch(input.data(), input.size(), reg, exception)
+                            : BoostRegexSearch(input.data(), input.size(), reg, exception)) {
+                        expected.push_back(static_cast<int>(i));
+                    }
+                }
+                std::vector<int> matched;
+                EXPECT_EQ(!expected.empty(), set.Match(input.data(), input.size(), matched, exception));
+                EXPECT_EQ(expected, matched) << input << " " << RegexEngineToString(engine);
+                EXPECT_TRUE(exception.empty());
+            }
+        }
+    }
+}
+
+void RegexSetUnittest::TestMatchAll() {
+    for (auto engine : {RegexEngine::BOOST, RegexEngine::RE2}) {
+        RegexSet set(engine, RegexSet::Anchor::FULL);
+        std::string exception;
+        APSARA_TEST_TRUE(set.Compile());
+        APSARA_TEST_TRUE(set.MatchAll("any", 3, exception));
+
+        RegexSet set2(engine, RegexSet::Anchor::FULL);
+        set2.Add(".*error.*");
+        set2.Add("\\d+.*");
+        set2.Add("(\\d)\\1.*");
+        APSARA_TEST_TRUE(set2.Compile());
+        std::string input = "11 error";
+        APSARA_TEST_TRUE(set2.MatchAll(input.data(), input.size(), exception));
+        input = "12 error";
+        APSARA_TEST_FALSE(set2.MatchAll(input.data(), input.size(), exception));
+        input = "11 warning";
+        APSARA_TEST_FALSE(set2.MatchAll(input.data(), input.size(), exception));
+    }
+}
+
+UNIT_TEST_CASE(RegexSetUnittest, TestParseRegexEngine);
+UNIT_TEST_CASE(RegexSetUnittest, TestAdd);
+UNIT_TEST_CASE(RegexSetUnittest, TestSameAsBoost);
+UNIT_TEST_CASE(RegexSetUnittest, TestMatchAll);
+
+} // namespace logtail
+
+int main(int argc, char** argv) {
+    logtail::Logger::Instance().InitGlobalLoggers();
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,136 @@
+// Copyright 2024 iLogtail Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include "common/SimdUtil.h"
+#include "unittest/Unittest.h"
+
+namespace logtail {
+
+class SimdUtilUnittest : public ::testing::Test {
+public:
+    void TestFindFirstOf();
+    void TestFindFirstOfTwoChars();
+    void TestFindAllOf();
+    void TestClassifyBlock64();
+    void TestPrefixXor();
+
+protected:
+    void SetUp() override {
+        // cover every block boundary of 16 and 32 bytes
+        for (size_t len = 0; len < 100; ++len) {
+            std::string s(len, 'a');
+            for (size_t i = 0; i < len; i += (len % 7) + 1) {
+                s[i] = (i % 3 == 0) ? '\n' : '"';
+            }
+            mSamples.emplace_back(std::move(s));
+        }
+    }
+    void TearDown() override { SetSimdLevelForTest(SimdLevel::AVX2); }
+
+    std::vector<std::string> mSamples;
+    std::vector<SimdLevel> mLevels = {SimdLevel::SCALAR, SimdLevel::SSE2, SimdLevel::AVX2};
+};
+
+void SimdUtilUnittest::TestFindFirstOf() {
+    for (auto level : mLevels) {
+        SetSimdLevelForTest(level);
+        for (const auto& s : mSamples) {
+            const char* end = s.data() + s.size();
+            for (size_t begin = 0; begin <= s.size(); ++begin) {
+                size_t expected = s.find('\n', begin);
+                const char* res = FindFirstOf(s.data() + begin, end, '\n');
+                APSARA_TEST_EQUAL(expected == std::string::npos ? end : s.data() + expected, res);
+            }
+        }
+    }
+}
+
+void SimdUtilUnittest::TestFindFirstOfTwoChars() {
+    for (auto level : mLevels) {
+        SetSimdLevelForTest(level);
+        for (const auto& s : mSamples) {
+            const char* end = s.data() + s.size();
+            for (size_t begin = 0; begin <= s.size(); ++begin) {
+                size_t expected = s.find_first_of("\n\"", begin);
+                const char* res = FindFirstOf(s.data() + begin, end, '\n', '"');
+                APSARA_TEST_EQUAL(expected == std::string::npos ? end : s.data() + expected, res);
+            }
+        }
+    }
+}
+
+void SimdUtilUnittest::TestFindAllOf() {
+    for (auto level : mLevels) {
+        SetSimdLevelForTest(level);
+        for (const auto& s : mSamples) {
+            std::vector<size_t> expected;
+            for (size_t i = 0; i < s.size(); ++i) {
+                if (s[i] == '\n') {
+                    expected.push_back(i);
+                }
+            }
+            std::vector<size_t> res;
+            FindAllOf(s.data(), s.size(), '\n', res);
+            APSARA_TEST_TRUE(expected == res);
+        }
+    }
+}
+
+void SimdUtilUnittest::TestClassifyBlock64() {
+    for (auto level : mLevels) {
+        SetSimdLevelForTest(level);
+        for (const auto& s : mSamples) {
+            for (size_t begin = 0; begin < s.size(); begin += 64) {
+                size_t size = std::min<size_t>(s.size() - begin, 64);
+                uint64_t expected1 = 0, expected2 = 0;
+                for (size_t i = 0; i < size; ++i) {
+                    expected1 |= static_cast<uint64_t>(s[begin + i] == '\n') << i;
+                    expected2 |= static_cast<uint64_t>(s[begin + i] == '"') << i;
+                }
+                uint64_t mask1 = 0, mask2 = 0;
+                ClassifyBlock64(s.data() + begin, size, '\n', '"', mask1, mask2);
+                APSARA_TEST_EQUAL(expected1, mask1);
+                APSARA_TEST_EQUAL(expected2, mask2);
+            }
+        }
+    }
+}
+
+void SimdUtilUnittest::TestPrefixXor() {
+    APSARA_TEST_EQUAL(0ULL, PrefixXor(0));
+    // quotes at 1 and 4, then an unclosed one at 62
+    APSARA_TEST_EQUAL(0b1110ULL | (3ULL << 62), PrefixXor((1ULL << 1) | (1ULL << 4) | (1ULL << 62)));
+    APSARA_TEST_EQUAL(~0ULL, PrefixXor(1));
+    APSARA_TEST_EQUAL(1ULL << 63, PrefixXor(1ULL << 63));
+    APSARA_TEST_EQUAL(3U, PopCount64((1ULL << 1) | (1ULL << 4) | (1ULL << 62)));
+    APSARA_TEST_EQUAL(62U, CountTrailingZeros64(1ULL << 62));
+}
+
+UNIT_TEST_CASE(SimdUtilUnittest, TestFindFirstOf);
+UNIT_TEST_CASE(SimdUtilUnittest, TestFindFirstOfTwoChars);
+UNIT_TEST_CASE(SimdUtilUnittest, TestFindAllOf);
+UNIT_TEST_CASE(SimdUtilUnittest, TestClassifyBlock64);
+UNIT_TEST_CASE(SimdUtilUnittest, TestPrefixXor);
+
+} // namespace logtail
+
+int main(int argc, char** argv) {
+    logtail::Logger::Instance().InitGlobalLoggers();
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,110 @@
+// Copyright 2024 iLogtail Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <cstdio>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "common/TimeFormatParser.h"
+#include "unittest/Unittest.h"
+
+using namespace logtail;
+
+// consecutive log times of @format, one per 1.001 seconds, so that the sub-second part always changes
+static std::vector<std::string> MakeTimeStrs(const char* format, bool withNanosecond, size_t cnt) {
+    std::vector<std::string> res;
+    time_t base = 1712476960;
+    for (size_t i = 0; i < cnt; ++i) {
+        time_t t = base + static_cast<time_t>(i);
+        struct tm tm;
+        localtime_r(&t, &tm);
+        char buf[128];
+        size_t len = strftime(buf, sizeof(buf), format, &tm);
+        std::string s(buf, len);
+        if (withNanosecond) {
+            size_t pos = s.find("NS");
+            char ns[16];
+            snprintf(ns, sizeof(ns), "%09zu", (i * 1000000 + 873971412) % 1000000000);
+            s.replace(pos, 2, ns);
+        }
+        res.emplace_back(std::move(s));
+    }
+    return res;
+}
+
+static void BM_ParseTime(const std::string& family,
+                         const std::string& sourceFormat,
+                         const std::vector<std::string>& timeStrs,
+                         int batchSize) {
+    TimeFormatParser parser;
+    if (!parser.Compile(sourceFormat)) {
+        std::cout << "compile failed: " << sourceFormat << std::endl;
+        return;
+    }
+    LogtailTime ts = {0, 0};
+    int nanosecondLength = -1;
+    uint64_t sum = 0;
+
+    uint64_t startTime = GetCurrentTimeInMicroSeconds();
+    for (int i = 0; i < batchSize; ++i) {
+        for (const auto& s : timeStrs) {
+            Strptime(s.c_str(), sourceFormat.c_str(), &ts, nanosecondLength);
+            sum += ts.tv_sec + ts.tv_nsec;
+        }
+    }
+    uint64_t strptimeTime = GetCurrentTimeInMicroSeconds() - startTime;
+
+    startTime = GetCurrentTimeInMicroSeconds();
+    for (int i = 0; i < batchSize; ++i) {
+        for (const auto& s : timeStrs) {
+            if (!parser.Parse(s, ts, nanosecondLength)) {
+                std::cout << "parse failed: " << s << std::endl;
+                return;
+            }
+            sum -= ts.tv_sec + ts.tv_nsec;
+        }
+    }
+    uint64_t compiledTime = GetCurrentTimeInMicroSeconds() - startTime;
+    if (strptimeTime == 0) {
+        strptimeTime = 1;
+    }
+    if (compiledTime == 0) {
+        compiledTime = 1;
+    }
+
+    uint64_t cnt = timeStrs.size() * static_cast<uint64_t>(batchSize);
+    std::cout << family << "\tformat: " << sourceFormat << "\tstrptime: " << cnt * 1000000 / strptimeTime
+              << " /s\tcompiled: " << cnt * 1000000 / compiledTime << " /s\t"
+              << (sum == 0 ? "" : "results differ") << std::endl;
+}
+
+int main(int argc, char** argv) {
+    logtail::Logger::Instance().InitGlobalLoggers();
+#ifdef NDEBUG
+    std::cout << "release" << std::endl;
+#else
+    std::cout << "debug" << std::endl;
+#endif
+    const size_t cnt = 10000;
+    const int batchSize = 100;
+    BM_ParseTime("rfc3339", "%Y-%m-%dT%H:%M:%S.%f%z", MakeTimeStrs("%Y-%m-%dT%H:%M:%S.NS+08:00", true, cnt), batchSize);
+    BM_ParseTime("iso8601", "%Y-%m-%d %H:%M:%S.%f", MakeTimeStrs("%Y-%m-%d %H:%M:%S.NS", true, cnt), batchSize);
+    BM_ParseTime("iso8601", "%Y-%m-%d %H:%M:%S", MakeTimeStrs("%Y-%m-%d %H:%M:%S", false, cnt), batchSize);
+    BM_ParseTime("nginx", "%d/%b/%Y:%H:%M:%S %z", MakeTimeStrs("%d/%b/%Y:%H:%M:%S +0800", false, cnt), batchSize);
+    BM_ParseTime("syslog", "%b %d %H:%M:%S %Y", MakeTimeStrs("%b %d %H:%M:%S %Y", false, cnt), batchSize);
+    BM_ParseTime("epoch", "%s", MakeTimeStrs("%s", false, cnt), batchSize);
+    BM_ParseTime("epoch", "%s", MakeTimeStrs("%sNS", true, cnt), batchSize);
+    return 0;
+}
@@ -0,0 +1,154 @@
+// Copyright 2024 iLogtail Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <string>
+#include <vector>
+
+#include "common/TimeFormatParser.h"
+#include "unittest/Unittest.h"
+
+namespace logtail {
+
+class TimeFormatParserUnittest : public ::testing::Test {
+public:
+    void TestCompile();
+    void TestParse();
+    void TestParseEpoch();
+    void TestSameAsStrptime();
+};
+
+void TimeFormatParserUnittest::TestCompile() {
+    TimeFormatParser parser;
+    APSARA_TEST_TRUE(parser.Compile("%Y-%m-%d %H:%M:%S"));
+    APSARA_TEST_TRUE(parser.Compile("%Y-%m-%dT%H:%M:%S.%f%z"));
+    APSARA_TEST_TRUE(parser.Compile("%d/%b/%Y:%H:%M:%S %z"));
+    APSARA_TEST_TRUE(parser.Compile("%F %T"));
+    APSARA_TEST_TRUE(parser.Compile("%s"));
+    // without year
+    APSARA_TEST_FALSE(parser.Compile("%b %d %H:%M:%S"));
+    APSARA_TEST_FALSE(parser.Compile("%b %d %H:%M:%S", 0));
+    APSARA_TEST_TRUE(parser.Compile("%b %d %H:%M:%S", 2024));
+    // unsupported conversions
+    APSARA_TEST_FALSE(parser.Compile("%Y-%m-%d %I:%M:%S %p"));
+    APSARA_TEST_FALSE(parser.Compile("%Y %j"));
+    APSARA_TEST_FALSE(parser.Compile("%Ey"));
+    APSARA_TEST_FALSE(parser.Compile("%Y %y"));
+    APSARA_TEST_FALSE(parser.Compile("%f"));
+    APSARA_TEST_FALSE(parser.Compile("%f %Y %T"));
+    APSARA_TEST_FALSE(parser.IsCompiled());
+    LogtailTime ts = {0, 0};
+    int nanosecondLength = -1;
+    APSARA_TEST_FALSE(parser.Parse("2024", ts, nanosecondLength));
+}
+
+void TimeFormatParserUnittest::TestParse() {
+    TimeFormatParser parser;
+    LogtailTime ts = {0, 0};
+    LogtailTime expected = {0, 0};
+    int nanosecondLength = -1;
+    int expectedNanosecondLength = -1;
+
+    APSARA_TEST_TRUE(parser.Compile("%Y-%m-%dT%H:%M:%S.%f%z"));
+    APSARA_TEST_TRUE(parser.Parse("2017-01-11T15:05:07.012999999+08:00", ts, nanosecondLength));
+    Strptime("2017-01-11T15:05:07.012999999+08:00", "%Y-%m-%dT%H:%M:%S.%f%z", &expected, expectedNanosecondLength);
+    APSARA_TEST_EQUAL(expected.tv_sec, ts.tv_sec);
+    APSARA_TEST_EQUAL(12999999L, ts.tv_nsec);
+    APSARA_TEST_EQUAL(9, nanosecondLength);
+    // the input is bounded by the view
+    APSARA_TEST_FALSE(parser.Parse(StringView("2017-01-11T15:05:07.012999999+08:00", 19), ts, nanosecondLength));
+    // more than 9 digits of nanosecond is left to strptime
+    APSARA_TEST_FALSE(parser.Parse("2017-01-11T15:05:07.0129999990+08:00", ts, nanosecondLength));
+    // time zone names are left to strptime
+    APSARA_TEST_FALSE(parser.Parse("2017-01-11T15:05:07.0 MST", ts, nanosecondLength));
+
+    APSARA_TEST_TRUE(parser.Compile("%d/%b/%Y:%H:%M:%S %z"));
+    nanosecondLength = -1;
+    APSARA_TEST_TRUE(parser.Parse("11/Jan/2017:15:05:07 +0800", ts, nanosecondLength));
+    Strptime("11/Jan/2017:15:05:07 +0800", "%d/%b/%Y:%H:%M:%S %z", &expected, expectedNanosecondLength);
+    APSARA_TEST_EQUAL(expected.tv_sec, ts.tv_sec);
+    APSARA_TEST_EQUAL(0L, ts.tv_nsec);
+    APSARA_TEST_EQUAL(-1, nanosecondLength);
+    APSARA_TEST_FALSE(parser.Parse("11/Jan/2017:15:05:07 +08:60", ts, nanosecondLength));
+    APSARA_TEST_FALSE(parser.Parse("11/Jax/2017:15:05:07 +0800", ts, nanosecondLength));
+
+    APSARA_TEST_TRUE(parser.Compile("%b %d %H:%M:%S", 2017));
+    APSARA_TEST_TRUE(parser.Parse("Jan 11 15:05:07", ts, nanosecondLength));
+    APSARA_TEST_EQUAL(expected.tv_sec, ts.tv_sec);
+}
+
+void TimeFormatParserUnittest::TestParseEpoch() {
+    TimeFormatParser parser;
+    LogtailTime ts = {0, 0};
+    int nanosecondLength = -1;
+    APSARA_TEST_TRUE(parser.Compile("%s"));
+    APSARA_TEST_TRUE(parser.Parse("1484147107", ts, nanosecondLength));
+    APSARA_TEST_EQUAL(1484147107, ts.tv_sec);
+    APSARA_TEST_EQUAL(0L, ts.tv_nsec);
+    APSARA_TEST_EQUAL(0, nanosecondLength);
+    APSARA_TEST_TRUE(parser.Parse("1484147107123", ts, nanosecondLength));
+    APSARA_TEST_EQUAL(1484147107, ts.tv_sec);
+    APSARA_TEST_EQUAL(123000000L, ts.tv_nsec);
+    APSARA_TEST_EQUAL(3, nanosecondLength);
+    APSARA_TEST_FALSE(parser.Parse("0", ts, nanosecondLength));
+    APSARA_TEST_FALSE(parser.Parse(" 1484147107", ts, nanosecondLength));
+    APSARA_TEST_FALSE(parser.Parse("14841471071234567890", ts, nanosecondLength));
+}
+
+void TimeFormatParserUnittest::TestSameAsStrptime() {
+    struct Case {
+        std::string mFormat;
+        std::vector<std::string> mInputs;
+        int32_t mYear;
+    };
+    std::vector<Case> cases = {
+        {"%Y-%m-%d %H:%M:%S", {"2017-01-11 15:05:07", "2017-1-11 15:05:07.012", "2024-03-10 02:30:00", "2017-13-11"}, -1},
+        {"%Y-%m-%d %H:%M:%S.%f", {"2017-01-11 15:05:07.012", "2017-1-11 15:05:07.1", "2017-01-11 15:05:07."}, -1},
+        {"%A, %d-%b-%y %H:%M:%S.%f", {"Tuesday, 11-Jan-17 15:05:07.0123 MST", "tue, 11-January-99 15:05:07.5"}, -1},
+        {"%Y-%m-%d %H:%M:%S.%f %z (%Z)", {"2017-1-11 15:05:07.012 +0700 (UTC)", "2017-1-11 15:05:07.0 GMT (x)"}, -1},
+        {"%H:%M:%S.%f %Y-%m-%d", {"15:05:07.012 2017-1-11", "15:05:61.012 2017-1-11"}, -1},
+        {"%c", {"Tue Nov 20 14:12:58 2020", "Tue Nov 20 14:12:58"}, -1},
+        {"%s", {"1484147107", "148414710712345", "12"}, -1},
+    };
+    for (const auto& c : cases) {
+        TimeFormatParser parser;
+        APSARA_TEST_TRUE(parser.Compile(c.mFormat, c.mYear));
+        for (const auto& input : c.mInputs) {
+            LogtailTime ts = {0, 0};
+            LogtailTime expected = {0, 0};
+            int nanosecondLength = -1;
+            int expectedNanosecondLength = -1;
+            if (!parser.Parse(input, ts, nanosecondLength)) {
+                continue;
+            }
+            const char* res = Strptime(input.c_str(), c.mFormat.c_str(), &expected, expectedNanosecondLength, c.mYear);
+            EXPECT_NE(nullptr, res) << input;
+            EXPECT_EQ(expected.tv_sec, ts.tv_sec) << input;
+            EXPECT_EQ(expected.tv_nsec, ts.tv_nsec) << input;
+            EXPECT_EQ(expectedNanosecondLength, nanosecondLength) << input;
+        }
+    }
+}
+
+UNIT_TEST_CASE(TimeFormatParserUnittest, TestCompile);
+UNIT_TEST_CASE(TimeFormatParserUnittest, TestParse);
+UNIT_TEST_CASE(TimeFormatParserUnittest, TestParseEpoch);
+UNIT_TEST_CASE(TimeFormatParserUnittest, TestSameAsStrptime);
+
+} // namespace logtail
+
+int main(int argc, char** argv) {
+    logtail::Logger::Instance().InitGlobalLoggers();
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,149 @@
+// Copyright 2024 iLogtail Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <atomic>
+#include <mutex>
+#include <set>
+#include <thread>
+#include <vector>
+
+#include "event/Event.h"
+#include "event_handler/EventHandler.h"
+#include "event_handler/ShardedReaderPool.h"
+#include "unittest/Unittest.h"
+
+using namespace std;
+
+namespace logtail {
+
+class RecordEventHandler : public EventHandler {
+public:
+    void Handle(const Event& event) override {
+        // handler is never accessed concurrently
+        APSARA_TEST_EQUAL_FATAL(0, mConcurrency.fetch_add(1));
+        APSARA_TEST_TRUE_FATAL(ShardedReaderPool::IsReaderThread());
+        mObjects.push_back(event.GetObject());
+        mThreads.insert(this_thread::get_id());
+        this_thread::sleep_for(chrono::microseconds(100));
+        --mConcurrency;
+    }
+    void HandleTimeOut() override {}
+    bool DumpReaderMeta(bool isRotatorReader, bool checkConfigFlag) override { return true; }
+
+    vector<string> mObjects;
+    set<thread::id> mThreads;
+    atomic_int mConcurrency{0};
+};
+
+class ShardedReaderPoolUnittest : public ::testing::Test {
+public:
+    void TestIsShardable();
+    void TestDispatchInOrder();
+    void TestWaitAllDone();
+    void TestStopAndRestart();
+
+protected:
+    void SetUp() override { ShardedReaderPool::GetInstance()->Start(4); }
+    void TearDown() override { ShardedReaderPool::GetInstance()->Stop(); }
+};
+
+void ShardedReaderPoolUnittest::TestIsShardable() {
+    APSARA_TEST_TRUE(ShardedReaderPool::IsShardable(Event("/dir", "a.log", EVENT_MODIFY, 0)));
+    APSARA_TEST_TRUE(
+        ShardedReaderPool::IsShardable(Event("/dir", "a.log", EVENT_MODIFY | EVENT_READER_FLUSH_TIMEOUT, 0)));
+    APSARA_TEST_FALSE(ShardedReaderPool::IsShardable(Event("/dir", "a.log", EVENT_CREATE, 0)));
+    APSARA_TEST_FALSE(ShardedReaderPool::IsShardable(Event("/dir", "a.log", EVENT_DELETE, 0)));
+    APSARA_TEST_FALSE(ShardedReaderPool::IsShardable(Event("/dir", "sub", EVENT_MODIFY | EVENT_ISDIR, 0)));
+    APSARA_TEST_FALSE(ShardedReaderPool::IsShardable(Event("/dir", "", EVENT_TIMEOUT, 0)));
+    APSARA_TEST_FALSE(ShardedReaderPool::IsShardable(Event("/dir", "", EVENT_CONTAINER_STOPPED, 0)));
+}
+
+void ShardedReaderPoolUnittest::TestDispatchInOrder() {
+    ShardedReaderPool* pool = ShardedReaderPool::GetInstance();
+    APSARA_TEST_TRUE_FATAL(pool->IsEnabled());
+    APSARA_TEST_EQUAL(4U, pool->GetThreadCount());
+    APSARA_TEST_FALSE(ShardedReaderPool::IsReaderThread());
+
+    const size_t handlerCount = 16;
+    const size_t eventCount = 100;
+    vector<unique_ptr<RecordEventHandler>> handlers;
+    for (size_t i = 0; i < handlerCount; ++i) {
+        handlers.emplace_back(new RecordEventHandler);
+    }
+    for (size_t i = 0; i < eventCount; ++i) {
+        for (auto& handler : handlers) {
+            pool->Dispatch(handler.get(), new Event("/dir", to_string(i), EVENT_MODIFY, 0));
+        }
+    }
+    pool->WaitAllDone();
+
+    set<thread::id> allThreads;
+    for (auto& handler : handlers) {
+        APSARA_TEST_EQUAL_FATAL(eventCount, handler->mObjects.size());
+        for (size_t i = 0; i < eventCount; ++i) {
+            APSARA_TEST_EQUAL(to_string(i), handler->mObjects[i]);
+        }
+        // all events of a handler are handled in the same thread
+        APSARA_TEST_EQUAL(1U, handler->mThreads.size());
+        allThreads.insert(handler->mThreads.begin(), handler->mThreads.end());
+    }
+    APSARA_TEST_TRUE(allThreads.size() > 1U);
+}
+
+void ShardedReaderPoolUnittest::TestWaitAllDone() {
+    ShardedReaderPool* pool = ShardedReaderPool::GetInstance();
+    RecordEventHandler handler;
+    for (size_t i = 0; i < 200; ++i) {
+        pool->Dispatch(&handler, new Event("/dir", to_string(i), EVENT_MODIFY, 0));
+    }
+    int32_t waitCount = 0;
+    pool->WaitAllDone([&waitCount]() { ++waitCount; });
+    APSARA_TEST_EQUAL(200U, handler.mObjects.size());
+    // 200 events take at least 20ms, onWait must have been called
+    APSARA_TEST_TRUE(waitCount > 0);
+    APSARA_TEST_EQUAL(0, pool->mPendingCount.load());
+}
+
+void ShardedReaderPoolUnittest::TestStopAndRestart() {
+    ShardedReaderPool* pool = ShardedReaderPool::GetInstance();
+    RecordEventHandler handler;
+    for (size_t i = 0; i < 100; ++i) {
+        pool->Dispatch(&handler, new Event("/dir", to_string(i), EVENT_MODIFY, 0));
+    }
+    // events left in queues are handled before stop returns, as LogInput dumps readers right after it
+    pool->Stop();
+    APSARA_TEST_FALSE(pool->IsEnabled());
+    APSARA_TEST_EQUAL(100U, handler.mObjects.size());
+    APSARA_TEST_EQUAL(0, pool->mPendingCount.load());
+
+    // started again on resume
+    pool->Start(2);
+    APSARA_TEST_EQUAL(2U, pool->GetThreadCount());
+    pool->Dispatch(&handler, new Event("/dir", "100", EVENT_MODIFY, 0));
+    pool->WaitAllDone();
+    APSARA_TEST_EQUAL(101U, handler.mObjects.size());
+}
+
+UNIT_TEST_CASE(ShardedReaderPoolUnittest, TestIsShardable)
+UNIT_TEST_CASE(ShardedReaderPoolUnittest, TestDispatchInOrder)
+UNIT_TEST_CASE(ShardedReaderPoolUnittest, TestWaitAllDone)
+UNIT_TEST_CASE(ShardedReaderPoolUnittest, TestStopAndRestart)
+
+} // namespace logtail
+
+int main(int argc, char** argv) {
+    logtail::Logger::Instance().InitGlobalLoggers();
+    testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
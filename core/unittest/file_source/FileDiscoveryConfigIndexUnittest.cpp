@@ -0,0 +1,160 @@
+// Copyright 2024 iLogtail Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <algorithm>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <json/json.h>
+
+#include "file_server/FileDiscoveryConfigIndex.h"
+#include "pipeline/PipelineContext.h"
+#include "unittest/Unittest.h"
+
+using namespace std;
+
+namespace logtail {
+
+class FileDiscoveryConfigIndexUnittest : public testing::Test {
+public:
+    void TestFindCandidates();
+    void TestRemove();
+    void TestSameAsScan();
+
+protected:
+    void TearDown() override { mOptions.clear(); }
+
+private:
+    FileDiscoveryOptions* MakeOptions(const string& filePath, int maxDirSearchDepth = 0) {
+        Json::Value configJson;
+        configJson["FilePaths"].append(Json::Value(filePath));
+        configJson["MaxDirSearchDepth"] = Json::Value(maxDirSearchDepth);
+        mOptions.emplace_back(new FileDiscoveryOptions());
+        APSARA_TEST_TRUE(mOptions.back()->Init(configJson, ctx, "test"));
+        return mOptions.back().get();
+    }
+
+    static bool HasCandidate(const FileDiscoveryConfigIndex& index,
+                             const string& path,
+                             const FileDiscoveryOptions* options) {
+        vector<FileDiscoveryConfig> candidates;
+        index.FindCandidates(path, candidates);
+        return any_of(candidates.begin(), candidates.end(), [options](const FileDiscoveryConfig& config) {
+            return config.first == options;
+        });
+    }
+
+    PipelineContext ctx;
+    vector<unique_ptr<FileDiscoveryOptions>> mOptions;
+};
+
+void FileDiscoveryConfigIndexUnittest::TestFindCandidates() {
+    FileDiscoveryConfigIndex index;
+    auto app = MakeOptions("/home/admin/app/**/*.log", 2);
+    auto wildcard = MakeOptions("/home/*/app/*.log");
+    auto root = MakeOptions("/**/*.log", 2);
+    auto container = MakeOptions("/home/admin/app/*.log");
+    container->SetEnableContainerDiscoveryFlag(true);
+    index.Add("app", make_pair(app, &ctx));
+    index.Add("wildcard", make_pair(wildcard, &ctx));
+    index.Add("root", make_pair(root, &ctx));
+    index.Add("container", make_pair(container, &ctx));
+    APSARA_TEST_EQUAL(4U, index.Size());
+
+    APSARA_TEST_TRUE(HasCandidate(index, "/home/admin/app", app));
+    APSARA_TEST_TRUE(HasCandidate(index, "/home/admin/app/sub", app));
+    APSARA_TEST_FALSE(HasCandidate(index, "/home/admin/app1", app));
+    APSARA_TEST_FALSE(HasCandidate(index, "/home/admin", app));
+    APSARA_TEST_TRUE(HasCandidate(index, "/home/admin/app", wildcard));
+    APSARA_TEST_TRUE(HasCandidate(index, "/home/test", wildcard));
+    APSARA_TEST_FALSE(HasCandidate(index, "/var/admin/app", wildcard));
+    // configs on the root directory and with container discovery are candidates of any path
+    APSARA_TEST_TRUE(HasCandidate(index, "/var/admin/app", root));
+    APSARA_TEST_TRUE(HasCandidate(index, "/var/admin/app", container));
+
+    vector<FileDiscoveryConfig> candidates;
+    index.FindCandidates("/var/log", candidates);
+    APSARA_TEST_EQUAL(2U, candidates.size());
+}
+
+void FileDiscoveryConfigIndexUnittest::TestRemove() {
+    FileDiscoveryConfigIndex index;
+    auto app = MakeOptions("/home/admin/app/*.log");
+    auto other = MakeOptions("/home/admin/other/*.log");
+    index.Add("app", make_pair(app, &ctx));
+    index.Add("other", make_pair(other, &ctx));
+    // replaced by name
+    index.Add("app", make_pair(other, &ctx));
+    APSARA_TEST_EQUAL(2U, index.Size());
+    APSARA_TEST_FALSE(HasCandidate(index, "/home/admin/app", app));
+    APSARA_TEST_TRUE(HasCandidate(index, "/home/admin/other", other));
+
+    index.Remove("app");
+    index.Remove("unknown");
+    APSARA_TEST_EQUAL(1U, index.Size());
+    APSARA_TEST_TRUE(HasCandidate(index, "/home/admin/other", other));
+    index.Remove("other");
+    APSARA_TEST_EQUAL(0U, index.Size());
+    // empty nodes are pruned
+    APSARA_TEST_TRUE(index.mRoot.mChildren.empty());
+    APSARA_TEST_TRUE(index.mUnindexedConfigs.empty());
+}
+
+void FileDiscoveryConfigIndexUnittest::TestSameAsScan() {
+    FileDiscoveryConfigIndex index;
+    vector<string> filePaths = {"/home/admin/app/*.log",
+                                "/home/admin/app/**/*.log",
+                                "/home/admin/*/*.log",
+                                "/home/*/app/**/*.log",
+                                "/home/ad?in/app/*.log",
+                                "/home/admin/app/sub/*.log",
+                                "/home/admin/ap/*.log",
+                                "/var/log/*.log",
+                                "/**/*.log"};
+    for (size_t i = 0; i < filePaths.size(); ++i) {
+        index.Add(to_string(i), make_pair(MakeOptions(filePaths[i], 3), &ctx));
+    }
+    vector<string> paths = {"/home/admin/app",
+                            "/home/admin/app/sub",
+                            "/home/admin/app/sub/a/b/c/d",
+                            "/home/admin/ap",
+                            "/home/admin/app1",
+                            "/home/test/app",
+                            "/home/admin",
+                            "/var/log",
+                            "/var/log/app",
+                            "/",
+                            "/tmp"};
+    for (const auto& path : paths) {
+        vector<FileDiscoveryConfig> candidates;
+        index.FindCandidates(path, candidates);
+        for (const auto& options : mOptions) {
+            bool matched = options->IsMatch(path, "a.log");
+            bool found = any_of(candidates.begin(), candidates.end(), [&options](const FileDiscoveryConfig& config) {
+                return config.first == options.get();
+            });
+            // candidates are a superset of matched configs
+            EXPECT_TRUE(!matched || found) << path << " " << options->GetBasePath();
+        }
+    }
+}
+
+UNIT_TEST_CASE(FileDiscoveryConfigIndexUnittest, TestFindCandidates)
+UNIT_TEST_CASE(FileDiscoveryConfigIndexUnittest, TestRemove)
+UNIT_TEST_CASE(FileDiscoveryConfigIndexUnittest, TestSameAsScan)
+
+} // namespace logtail
+
+UNIT_TEST_MAIN
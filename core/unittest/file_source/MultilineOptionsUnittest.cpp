@@ -16,6 +16,8 @@
 
 #include <memory>
 #include <string>
+#include <tuple>
+#include <vector>
 
 #include "common/JsonUtil.h"
 #include "file_server/MultilineOptions.h"
@@ -29,6 +31,7 @@ namespace logtail {
 class MultilineOptionsUnittest : public testing::Test {
 public:
     void OnSuccessfulInit() const;
+    void TestIsLineMatched() const;
 
 private:
     const string pluginName = "test";
@@ -212,7 +215,59 @@ void MultilineOptionsUnittest::OnSuccessfulInit() const {
     APSARA_TEST_EQUAL(MultilineOptions::UnmatchedContentTreatment::SINGLE_LINE, config->mUnmatchedContentTreatment);
 }
 
+void MultilineOptionsUnittest::TestIsLineMatched() const {
+    Json::Value configJson;
+    string configStr, errorMsg;
+    for (const string engine : {"boost", "re2"}) {
+        configStr = R"(
+            {
+                "StartPattern": "\\d+:\\d+.*",
+                "EndPattern": ".*end$",
+                "RegexEngine": ")"
+            + engine + R"("
+            }
+        )";
+        APSARA_TEST_TRUE(ParseJsonTable(configStr, configJson, errorMsg));
+        MultilineOptions config;
+        APSARA_TEST_TRUE(config.Init(configJson, ctx, pluginName));
+        APSARA_TEST_EQUAL(engine, RegexEngineToString(config.mRegexEngine));
+        APSARA_TEST_EQUAL(engine == "re2", config.mPatternSet != nullptr);
+
+        const vector<tuple<string, bool, bool>> cases = {{"10:00 start", true, false},
+                                                          {"10:00 start and end", true, true},
+                                                          {"the end", false, true},
+                                                          {"the end\nnext", false, true},
+                                                          {"  10:00", false, false},
+                                                          {"", false, false}};
+        for (const auto& item : cases) {
+            MultilineOptions::LineMatchResult result;
+            string exception;
+            StringView line(get<0>(item));
+            APSARA_TEST_EQUAL(get<1>(item),
+                              config.IsLineMatched(line, MultilineOptions::PatternType::START, result, exception));
+            APSARA_TEST_EQUAL(get<2>(item),
+                              config.IsLineMatched(line, MultilineOptions::PatternType::END, result, exception));
+            APSARA_TEST_FALSE(config.IsLineMatched(line, MultilineOptions::PatternType::CONTINUE, result, exception));
+            APSARA_TEST_TRUE(exception.empty());
+        }
+    }
+
+    // invalid engine
+    configStr = R"(
+        {
+            "StartPattern": "\\d+",
+            "RegexEngine": "unknown"
+        }
+    )";
+    APSARA_TEST_TRUE(ParseJsonTable(configStr, configJson, errorMsg));
+    MultilineOptions config;
+    APSARA_TEST_TRUE(config.Init(configJson, ctx, pluginName));
+    APSARA_TEST_TRUE(RegexEngine::BOOST == config.mRegexEngine);
+    APSARA_TEST_EQUAL(nullptr, config.mPatternSet);
+}
+
 UNIT_TEST_CASE(MultilineOptionsUnittest, OnSuccessfulInit)
+UNIT_TEST_CASE(MultilineOptionsUnittest, TestIsLineMatched)
 
 } // namespace logtail
 
@@ -0,0 +1,114 @@
+// Copyright 2024 iLogtail Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "common/TimeUtil.h"
+#include "go_pipeline/LogGroupColumns.h"
+#include "log_pb/sls_logs.pb.h"
+#include "logger/Logger.h"
+#include "models/LogEvent.h"
+#include "models/PipelineEventGroup.h"
+
+using namespace logtail;
+
+static PipelineEventGroup MakeEventGroup(int seq, size_t logCnt) {
+    PipelineEventGroup eventGroup(std::make_shared<SourceBuffer>());
+    eventGroup.SetMetadata(EventGroupMetaKey::SOURCE_ID, std::string("pack-id"));
+    eventGroup.SetTag(std::string("__hostname__"), std::string("host-192-168-0-1"));
+    eventGroup.SetTag(std::string("__path__"), std::string("/var/log/app/app.log"));
+    for (size_t i = 0; i < logCnt; ++i) {
+        auto logEvent = eventGroup.AddLogEvent();
+        logEvent->SetTimestamp(1700000000 + i);
+        logEvent->SetContent(std::string("level"), std::string("INFO"));
+        logEvent->SetContent(std::string("thread"), "http-nio-8080-exec-" + std::to_string(i % 8));
+        logEvent->SetContent(std::string("logger"), std::string("com.example.BookController"));
+        logEvent->SetContent(std::string("message"),
+                             "request " + std::to_string(seq * 131 + i) + " done, cost " + std::to_string(i) + "ms");
+    }
+    return eventGroup;
+}
+
+// the same as LogProcess::FillLogGroupLogs and FillLogGroupTags, followed by the serialization in ProcessLogGroup
+static size_t SerializeAsProtobuf(const PipelineEventGroup& eventGroup, const std::string& logstore) {
+    sls_logs::LogGroup logGroup;
+    for (const auto& event : eventGroup.GetEvents()) {
+        const auto& logEvent = event.Cast<LogEvent>();
+        auto log = logGroup.add_logs();
+        log->set_time(logEvent.GetTimestamp());
+        for (const auto& kv : logEvent) {
+            auto content = log->add_contents();
+            content->set_key(kv.first.to_string());
+            content->set_value(kv.second.to_string());
+        }
+    }
+    for (const auto& tag : eventGroup.GetTags()) {
+        auto logTag = logGroup.add_logtags();
+        logTag->set_key(tag.first.to_string());
+        logTag->set_value(tag.second.to_string());
+    }
+    logGroup.set_category(logstore);
+    logGroup.set_topic(eventGroup.GetMetadata(EventGroupMetaKey::TOPIC).to_string());
+    return logGroup.SerializeAsString().size();
+}
+
+static void BM_PassLogGroups(size_t groupCnt, size_t logCnt, int batchSize) {
+    std::vector<PipelineEventGroup> eventGroups;
+    for (size_t i = 0; i < groupCnt; ++i) {
+        eventGroups.emplace_back(MakeEventGroup(i, logCnt));
+    }
+    std::string logstore = "logstore";
+
+    size_t pbSize = 0;
+    uint64_t startTime = GetCurrentTimeInMicroSeconds();
+    for (int i = 0; i < batchSize; ++i) {
+        for (const auto& eventGroup : eventGroups) {
+            pbSize += SerializeAsProtobuf(eventGroup, logstore);
+        }
+    }
+    uint64_t pbTime = GetCurrentTimeInMicroSeconds() - startTime;
+
+    LogGroupColumns columns;
+    size_t columnsSize = 0;
+    startTime = GetCurrentTimeInMicroSeconds();
+    for (int i = 0; i < batchSize; ++i) {
+        columns.Clear();
+        for (const auto& eventGroup : eventGroups) {
+            columns.Add(eventGroup, logstore, false);
+        }
+        columnsSize += columns.GetData().size()
+            + sizeof(uint32_t) * (columns.GetStrings().size() + columns.GetLogs().size() + columns.GetGroups().size());
+    }
+    uint64_t columnsTime = GetCurrentTimeInMicroSeconds() - startTime;
+
+    std::cout << "groups: " << groupCnt << "\tlogs per group: " << logCnt << "\tprotobuf: " << pbTime << "us, "
+              << pbSize / batchSize << " bytes\tcolumns: " << columnsTime << "us, " << columnsSize / batchSize
+              << " bytes" << std::endl;
+}
+
+int main(int argc, char** argv) {
+    logtail::Logger::Instance().InitGlobalLoggers();
+#ifdef NDEBUG
+    std::cout << "release" << std::endl;
+#else
+    std::cout << "debug" << std::endl;
+#endif
+    BM_PassLogGroups(1, 1024, 100);
+    BM_PassLogGroups(16, 64, 100);
+    BM_PassLogGroups(16, 1024, 10);
+    return 0;
+}
@@ -0,0 +1,117 @@
+// Copyright 2024 iLogtail Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <memory>
+#include <string>
+
+#include "go_pipeline/LogGroupColumns.h"
+#include "models/LogEvent.h"
+#include "models/PipelineEventGroup.h"
+#include "unittest/Unittest.h"
+
+namespace logtail {
+
+class LogGroupColumnsUnittest : public ::testing::Test {
+public:
+    void TestAdd();
+    void TestSkipEmptyGroup();
+    void TestTimestampNanosecond();
+
+protected:
+    std::string GetString(uint32_t idx) const {
+        const auto& strs = mColumns.GetStrings();
+        return mColumns.GetData().substr(strs[2 * idx], strs[2 * idx + 1]);
+    }
+
+    PipelineEventGroup MakeEventGroup(const std::string& topic, size_t logCnt) {
+        PipelineEventGroup eventGroup(std::make_shared<SourceBuffer>());
+        eventGroup.SetMetadata(EventGroupMetaKey::TOPIC, topic);
+        eventGroup.SetMetadata(EventGroupMetaKey::SOURCE_ID, std::string("pack-") + topic);
+        eventGroup.SetTag(std::string("__hostname__"), std::string("host"));
+        for (size_t i = 0; i < logCnt; ++i) {
+            auto logEvent = eventGroup.AddLogEvent();
+            logEvent->SetTimestamp(1700000000 + i, 100 + i);
+            logEvent->SetContent(std::string("content"), topic + "-" + std::to_string(i));
+        }
+        return eventGroup;
+    }
+
+    LogGroupColumns mColumns;
+};
+
+void LogGroupColumnsUnittest::TestAdd() {
+    mColumns.Add(MakeEventGroup("a", 2), "logstore", false);
+    mColumns.Add(MakeEventGroup("b", 1), "logstore", false);
+    APSARA_TEST_EQUAL(2U, mColumns.GetGroupCount());
+    APSARA_TEST_EQUAL(3U * LogGroupColumns::kLogFieldCount, mColumns.GetLogs().size());
+
+    const auto& logs = mColumns.GetLogs();
+    const auto& groups = mColumns.GetGroups();
+    // the second group
+    const uint32_t* group = &groups[LogGroupColumns::kGroupFieldCount];
+    APSARA_TEST_EQUAL(2U, group[0]);
+    APSARA_TEST_EQUAL(1U, group[1]);
+    APSARA_TEST_EQUAL(1U, group[3]);
+    APSARA_TEST_EQUAL("__hostname__", GetString(group[2]));
+    APSARA_TEST_EQUAL("host", GetString(group[2] + 1));
+    APSARA_TEST_EQUAL("logstore", GetString(group[4]));
+    APSARA_TEST_EQUAL("b", GetString(group[5]));
+    APSARA_TEST_EQUAL("pack-b", GetString(group[6]));
+
+    const uint32_t* log = &logs[group[0] * LogGroupColumns::kLogFieldCount];
+    APSARA_TEST_EQUAL(1U, log[1]);
+    APSARA_TEST_EQUAL("content", GetString(log[0]));
+    APSARA_TEST_EQUAL("b-0", GetString(log[0] + 1));
+    APSARA_TEST_EQUAL(1700000000U, log[2]);
+    APSARA_TEST_EQUAL(0U, log[4]);
+
+    log = &logs[LogGroupColumns::kLogFieldCount];
+    APSARA_TEST_EQUAL("a-1", GetString(log[0] + 1));
+
+    mColumns.Clear();
+    APSARA_TEST_EQUAL(0U, mColumns.GetGroupCount());
+    APSARA_TEST_TRUE(mColumns.GetData().empty());
+    APSARA_TEST_TRUE(mColumns.GetStrings().empty());
+    APSARA_TEST_TRUE(mColumns.GetLogs().empty());
+}
+
+void LogGroupColumnsUnittest::TestSkipEmptyGroup() {
+    auto eventGroup = MakeEventGroup("a", 0);
+    eventGroup.AddMetricEvent();
+    mColumns.Add(eventGroup, "logstore", false);
+    APSARA_TEST_EQUAL(0U, mColumns.GetGroupCount());
+    APSARA_TEST_TRUE(mColumns.GetStrings().empty());
+
+    mColumns.Add(MakeEventGroup("b", 1), "logstore", false);
+    APSARA_TEST_EQUAL(1U, mColumns.GetGroupCount());
+    APSARA_TEST_EQUAL(0U, mColumns.GetGroups()[0]);
+}
+
+void LogGroupColumnsUnittest::TestTimestampNanosecond() {
+    auto eventGroup = MakeEventGroup("a", 2);
+    eventGroup.MutableEvents()[1].Cast<LogEvent>().SetTimestamp(1700000001, std::nullopt);
+    mColumns.Add(eventGroup, "logstore", true);
+    const auto& logs = mColumns.GetLogs();
+    APSARA_TEST_EQUAL(100U, logs[3]);
+    APSARA_TEST_EQUAL(1U, logs[4]);
+    APSARA_TEST_EQUAL(0U, logs[LogGroupColumns::kLogFieldCount + 4]);
+}
+
+UNIT_TEST_CASE(LogGroupColumnsUnittest, TestAdd)
+UNIT_TEST_CASE(LogGroupColumnsUnittest, TestSkipEmptyGroup)
+UNIT_TEST_CASE(LogGroupColumnsUnittest, TestTimestampNanosecond)
+
+} // namespace logtail
+
+UNIT_TEST_MAIN
@@ -14,6 +14,7 @@
 
 #include <logger/Logger.h>
 #include "unittest/Unittest.h"
+#include "log_pb/LogGroupSerializer.h"
 #include "log_pb/RawLogGroup.h"
 #include "log_pb/sls_logs.pb.h"
 
@@ -384,6 +385,79 @@ public:
         printf("%d %d \n", (int)(c3 - c2), (int)(c2 - c1));
         EXPECT_EQ(rawLogStr, logStr);
     }
+
+    void TestLogGroupSerializer() {
+        vector<pair<string, string>> contents
+            = {{"key1", "value1"}, {"key2", ""}, {"", "value3"}, {"key4", longLogValue100}};
+        uint32_t logTime = 1712345678;
+
+        LogGroup loggroup;
+        SerializedLogGroup serializedGroup;
+        LogGroupSerializer serializer(serializedGroup.mLogsData);
+        for (int i = 0; i < 3; ++i) {
+            bool hasTimeNs = i != 1;
+            Log* log = loggroup.add_logs();
+            log->set_time(logTime + i);
+            size_t contentsSize = 0;
+            for (const auto& kv : contents) {
+                Log_Content* content = log->add_contents();
+                content->set_key(kv.first);
+                content->set_value(kv.second);
+                contentsSize += LogGroupSerializer::CalculateContentSize(kv.first.size(), kv.second.size());
+            }
+            if (hasTimeNs) {
+                log->set_time_ns(123456789);
+            }
+
+            size_t logSize = LogGroupSerializer::CalculateLogSize(logTime + i, contentsSize, hasTimeNs);
+            EXPECT_EQ(log->ByteSizeLong(), logSize);
+            size_t offset = serializedGroup.mLogsData.size();
+            serializer.StartToAddLog(logSize);
+            serializer.AddLogTime(logTime + i);
+            for (const auto& kv : contents) {
+                serializer.AddLogContent(kv.first, kv.second);
+            }
+            if (hasTimeNs) {
+                serializer.AddLogTimeNs(123456789);
+            }
+            EXPECT_EQ(LogGroupSerializer::CalculateLogFieldSize(logSize), serializedGroup.mLogsData.size() - offset);
+            serializedGroup.mLogRanges.emplace_back(offset, serializedGroup.mLogsData.size() - offset);
+            serializedGroup.mLogTimes.push_back(logTime + i);
+        }
+        loggroup.set_category("logstore");
+        loggroup.set_topic("topic");
+        sls_logs::LogTag* tag = loggroup.add_logtags();
+        tag->set_key("__path__");
+        tag->set_value("/var/log/test.log");
+        serializedGroup.mGroup.set_category("logstore");
+        serializedGroup.mGroup.set_topic("topic");
+        tag = serializedGroup.mGroup.add_logtags();
+        tag->set_key("__path__");
+        tag->set_value("/var/log/test.log");
+
+        string expected;
+        loggroup.SerializeToString(&expected);
+        string res;
+        serializedGroup.AppendToString(&res);
+        EXPECT_EQ(expected, res);
+        EXPECT_EQ(expected.size(), serializedGroup.ByteSize());
+
+        // group level fields written by serializer
+        string groupStr;
+        LogGroupSerializer groupSerializer(groupStr);
+        groupSerializer.AddCategory("logstore");
+        groupSerializer.AddTopic("topic");
+        groupSerializer.AddLogTag("__path__", "/var/log/test.log");
+        EXPECT_EQ(serializedGroup.mLogsData + groupStr, expected);
+
+        LogGroup parsed;
+        EXPECT_TRUE(parsed.ParseFromString(res));
+        EXPECT_EQ(3, parsed.logs_size());
+        EXPECT_EQ(logTime + 1, parsed.logs(1).time());
+        EXPECT_FALSE(parsed.logs(1).has_time_ns());
+        EXPECT_EQ(123456789U, parsed.logs(2).time_ns());
+        EXPECT_EQ(longLogValue100, parsed.logs(0).contents(3).value());
+    }
 };
 
 APSARA_UNIT_TEST_CASE(PBUnittest, TestFullWrite, 0);
@@ -394,6 +468,7 @@ APSARA_UNIT_TEST_CASE(PBUnittest, TestBigLog, 0);
 APSARA_UNIT_TEST_CASE(PBUnittest, TestLogGroup, 0);
 APSARA_UNIT_TEST_CASE(PBUnittest, TestNoOptionLogGroup, 0);
 APSARA_UNIT_TEST_CASE(PBUnittest, TestMultiLog, 0);
+APSARA_UNIT_TEST_CASE(PBUnittest, TestLogGroupSerializer, 0);
 
 } // namespace logtail
 
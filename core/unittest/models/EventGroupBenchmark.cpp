@@ -13,8 +13,10 @@
 // limitations under the License.
 
 #include <cstdlib>
+#include "common/Flags.h"
 #include "common/JsonUtil.h"
 #include "common/TimeUtil.h"
+#include "models/EventPool.h"
 #include "models/LogEvent.h"
 #include "models/PipelineEventGroup.h"
 
@@ -28,12 +30,16 @@ void* __wrap_memcpy(void* dest, const void* src, size_t n) {
 }
 #endif
 
+DECLARE_FLAG_INT32(event_pool_batch_size);
+
 namespace logtail {
 
 class EventGroupBenchmark {
 public:
     void TestEraseInLoop();
     void TestWriteIndexInLoop();
+    void TestLogEventContents(size_t contentCount);
+    void TestEventGroupLifecycle(bool enablePool);
 };
 
 void EraseInLoop(PipelineEventGroup& logGroup) {
@@ -101,15 +107,121 @@ void EventGroupBenchmark::TestWriteIndexInLoop() {
     printf("%s costs %lums\n", __func__, timeelapsed);
 }
 
+void EventGroupBenchmark::TestLogEventContents(size_t contentCount) {
+    // SetUp
+    const size_t eventCount = 100000;
+    PipelineEventGroup group(std::make_shared<SourceBuffer>());
+    std::vector<std::string> keys;
+    for (size_t i = 0; i < contentCount; ++i) {
+        keys.emplace_back("content_key_" + std::to_string(i));
+    }
+    std::string value = "content value";
+    for (size_t i = 0; i < eventCount; ++i) {
+        group.AddLogEvent();
+    }
+    EventsContainer& events = group.MutableEvents();
+    // Test
+    uint64_t starttime = GetCurrentTimeInMicroSeconds();
+    for (auto& event : events) {
+        LogEvent& logEvent = event.Cast<LogEvent>();
+        for (const auto& key : keys) {
+            logEvent.SetContentNoCopy(StringView(key), StringView(value));
+        }
+    }
+    uint64_t setTime = GetCurrentTimeInMicroSeconds() - starttime;
+
+    size_t found = 0;
+    starttime = GetCurrentTimeInMicroSeconds();
+    for (auto& event : events) {
+        const LogEvent& logEvent = event.Cast<LogEvent>();
+        for (const auto& key : keys) {
+            found += logEvent.GetContent(StringView(key)).size();
+        }
+    }
+    uint64_t getTime = GetCurrentTimeInMicroSeconds() - starttime;
+
+    starttime = GetCurrentTimeInMicroSeconds();
+    for (auto& event : events) {
+        LogEvent& logEvent = event.Cast<LogEvent>();
+        for (const auto& key : keys) {
+            logEvent.DelContent(StringView(key));
+        }
+    }
+    uint64_t delTime = GetCurrentTimeInMicroSeconds() - starttime;
+
+    uint64_t opCount = eventCount * contentCount;
+    printf("%s contents %zu: set %.1fM/s, get %.1fM/s, del %.1fM/s (%zu)\n",
+           __func__,
+           contentCount,
+           1.0 * opCount / (setTime ? setTime : 1),
+           1.0 * opCount / (getTime ? getTime : 1),
+           1.0 * opCount / (delTime ? delTime : 1),
+           found);
+}
+
+void EventGroupBenchmark::TestEventGroupLifecycle(bool enablePool) {
+    // SetUp
+    const size_t groupCount = 2000;
+    const size_t eventCount = 1000;
+    int32_t batchSize = INT32_FLAG(event_pool_batch_size);
+    if (!enablePool) {
+        INT32_FLAG(event_pool_batch_size) = 0;
+    }
+    std::vector<std::string> keys;
+    for (size_t i = 0; i < 10; ++i) {
+        keys.emplace_back("content_key_" + std::to_string(i));
+    }
+    std::string value = "content value";
+    uint64_t acquireCount = 0, hitCount = 0;
+    EventPool::FetchStatistics(acquireCount, hitCount);
+    // Test
+    uint64_t starttime = GetCurrentTimeInMicroSeconds();
+    for (size_t i = 0; i < groupCount; ++i) {
+        PipelineEventGroup group(std::make_shared<SourceBuffer>());
+        for (size_t j = 0; j < eventCount; ++j) {
+            LogEvent* e = group.AddLogEvent();
+            for (const auto& key : keys) {
+                e->SetContentNoCopy(StringView(key), StringView(value));
+            }
+        }
+    }
+    uint64_t timeelapsed = GetCurrentTimeInMicroSeconds() - starttime;
+    EventPool::FetchStatistics(acquireCount, hitCount);
+    printf("%s pool %s: %.1fM events/s, hit rate %.3f, retained %ldKB\n",
+           __func__,
+           enablePool ? "on" : "off",
+           1.0 * groupCount * eventCount / (timeelapsed ? timeelapsed : 1),
+           acquireCount ? 1.0 * hitCount / acquireCount : 0.0,
+           EventPool::GetRetainedBytes() / 1024);
+    INT32_FLAG(event_pool_batch_size) = batchSize;
+}
+
 } // namespace logtail
 
 int main(int argc, char* argv[]) {
     logtail::EventGroupBenchmark benchmark;
     benchmark.TestEraseInLoop();
     benchmark.TestWriteIndexInLoop();
+    for (size_t contentCount : {5, 10, 20, 50}) {
+        benchmark.TestLogEventContents(contentCount);
+    }
+    benchmark.TestEventGroupLifecycle(false);
+    benchmark.TestEventGroupLifecycle(true);
     /* Result:
        TestEraseInLoop costs 453ms
        TestWriteIndexInLoop costs 22ms
+       LogEvent contents, std::map index:
+       TestLogEventContents contents 5: set 7.0M/s, get 33.9M/s, del 25.1M/s
+       TestLogEventContents contents 10: set 6.5M/s, get 33.3M/s, del 25.1M/s
+       TestLogEventContents contents 20: set 5.9M/s, get 24.5M/s, del 17.8M/s
+       TestLogEventContents contents 50: set 5.0M/s, get 18.5M/s, del 15.4M/s
+       LogEvent contents, linear scan with hash index beyond 16 contents:
+       TestLogEventContents contents 5: set 15.1M/s, get 55.9M/s, del 56.7M/s
+       TestLogEventContents contents 10: set 14.0M/s, get 36.9M/s, del 35.6M/s
+       TestLogEventContents contents 20: set 12.0M/s, get 59.6M/s, del 48.5M/s
+       TestLogEventContents contents 50: set 9.8M/s, get 45.6M/s, del 55.1M/s
+       TestEventGroupLifecycle pool off: 1.9M events/s, hit rate 0.000
+       TestEventGroupLifecycle pool on: 3.2M events/s, hit rate 1.000
      */
     return 0;
 }
\ No newline at end of file
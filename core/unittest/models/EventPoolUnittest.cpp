@@ -0,0 +1,188 @@
+// Copyright 2024 iLogtail Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "common/Flags.h"
+#include "models/EventPool.h"
+#include "models/PipelineEventGroup.h"
+#include "unittest/Unittest.h"
+
+DECLARE_FLAG_INT32(event_pool_batch_size);
+
+using namespace std;
+
+namespace logtail {
+
+class EventPoolUnittest : public ::testing::Test {
+public:
+    void TestReuseLogEvent();
+    void TestReuseMetricEvent();
+    void TestReuseSpanEvent();
+    void TestCrossThread();
+    void TestDisabled();
+
+protected:
+    void SetUp() override {
+        mBatchSize = INT32_FLAG(event_pool_batch_size);
+        uint64_t acquireCount = 0, hitCount = 0;
+        EventPool::FetchStatistics(acquireCount, hitCount);
+    }
+    void TearDown() override { INT32_FLAG(event_pool_batch_size) = mBatchSize; }
+
+private:
+    int32_t mBatchSize = 0;
+};
+
+void EventPoolUnittest::TestReuseLogEvent() {
+    LogEvent* released = nullptr;
+    {
+        PipelineEventGroup group(make_shared<SourceBuffer>());
+        LogEvent* e = group.AddLogEvent();
+        e->SetTimestamp(12345678901, 1);
+        e->SetPosition(1, 2);
+        for (size_t i = 0; i < 20; ++i) {
+            e->SetContent("key" + to_string(i), "value" + to_string(i));
+        }
+        released = e;
+    }
+
+    PipelineEventGroup group(make_shared<SourceBuffer>());
+    LogEvent* e = group.AddLogEvent();
+    // the most recently released event is reused first
+    APSARA_TEST_EQUAL(released, e);
+    APSARA_TEST_EQUAL(group.GetSourceBuffer().get(), e->GetSourceBuffer().get());
+    APSARA_TEST_EQUAL(0, e->GetTimestamp());
+    APSARA_TEST_FALSE(e->GetTimestampNanosecond().has_value());
+    APSARA_TEST_EQUAL(0U, e->GetPosition().first);
+    APSARA_TEST_EQUAL(0U, e->GetPosition().second);
+    APSARA_TEST_TRUE(e->Empty());
+    APSARA_TEST_TRUE(e->begin() == e->end());
+    APSARA_TEST_EQUAL(group.CreateLogEvent()->DataSize(), e->DataSize());
+    for (size_t i = 0; i < 20; ++i) {
+        APSARA_TEST_FALSE(e->HasContent("key" + to_string(i)));
+    }
+
+    // contents of a reused event behave as those of a new one, including the index built for many contents
+    for (size_t i = 0; i < 30; ++i) {
+        e->SetContent("k" + to_string(i), "v" + to_string(i));
+    }
+    APSARA_TEST_EQUAL(30U, e->Size());
+    for (size_t i = 0; i < 30; ++i) {
+        APSARA_TEST_EQUAL("v" + to_string(i), e->GetContent("k" + to_string(i)).to_string());
+    }
+}
+
+void EventPoolUnittest::TestReuseMetricEvent() {
+    MetricEvent* released = nullptr;
+    {
+        PipelineEventGroup group(make_shared<SourceBuffer>());
+        MetricEvent* e = group.AddMetricEvent();
+        e->SetName("test");
+        e->SetValue(UntypedSingleValue{10.0});
+        e->SetTag(string("key"), string("value"));
+        released = e;
+    }
+    PipelineEventGroup group(make_shared<SourceBuffer>());
+    MetricEvent* e = group.AddMetricEvent();
+    APSARA_TEST_EQUAL(released, e);
+    APSARA_TEST_TRUE(e->GetName().empty());
+    APSARA_TEST_FALSE(e->Is<UntypedSingleValue>());
+    APSARA_TEST_FALSE(e->HasTag("key"));
+    APSARA_TEST_EQUAL(group.GetSourceBuffer().get(), e->GetSourceBuffer().get());
+}
+
+void EventPoolUnittest::TestReuseSpanEvent() {
+    SpanEvent* released = nullptr;
+    {
+        PipelineEventGroup group(make_shared<SourceBuffer>());
+        SpanEvent* e = group.AddSpanEvent();
+        e->SetName("test");
+        e->SetTraceId("trace");
+        e->SetKind(SpanEvent::Kind::Client);
+        e->SetStatus(SpanEvent::StatusCode::Ok);
+        e->SetTag(string("key"), string("value"));
+        e->AddEvent()->SetName("event");
+        e->AddLink()->SetTraceId("link");
+        released = e;
+    }
+    PipelineEventGroup group(make_shared<SourceBuffer>());
+    SpanEvent* e = group.AddSpanEvent();
+    APSARA_TEST_EQUAL(released, e);
+    APSARA_TEST_TRUE(e->GetName().empty());
+    APSARA_TEST_TRUE(e->GetTraceId().empty());
+    APSARA_TEST_EQUAL(SpanEvent::Kind::Unspecified, e->GetKind());
+    APSARA_TEST_EQUAL(SpanEvent::StatusCode::Unset, e->GetStatus());
+    APSARA_TEST_FALSE(e->HasTag("key"));
+    APSARA_TEST_TRUE(e->GetEvents().empty());
+    APSARA_TEST_TRUE(e->GetLinks().empty());
+}
+
+void EventPoolUnittest::TestCrossThread() {
+    const size_t eventCount = 4 * INT32_FLAG(event_pool_batch_size);
+    // events created in this thread are released in another thread, like those passed from input to processor
+    auto group = make_unique<PipelineEventGroup>(make_shared<SourceBuffer>());
+    for (size_t i = 0; i < eventCount; ++i) {
+        group->AddLogEvent();
+    }
+    thread releaser([&group]() { group.reset(); });
+    releaser.join();
+    APSARA_TEST_TRUE(EventPool::GetRetainedBytes() > 0);
+
+    // events released by the exited thread have been moved to the global pool or freed
+    thread acquirer([eventCount]() {
+        PipelineEventGroup group(make_shared<SourceBuffer>());
+        for (size_t i = 0; i < eventCount; ++i) {
+            group.AddLogEvent();
+        }
+    });
+    acquirer.join();
+
+    uint64_t acquireCount = 0, hitCount = 0;
+    EventPool::FetchStatistics(acquireCount, hitCount);
+    APSARA_TEST_TRUE(acquireCount >= eventCount);
+    APSARA_TEST_TRUE(hitCount >= static_cast<uint64_t>(INT32_FLAG(event_pool_batch_size)));
+}
+
+void EventPoolUnittest::TestDisabled() {
+    INT32_FLAG(event_pool_batch_size) = 0;
+    int64_t retainedBytes = EventPool::GetRetainedBytes();
+    // counters of a thread are published on its exit
+    thread worker([]() {
+        for (size_t i = 0; i < 10; ++i) {
+            PipelineEventGroup group(make_shared<SourceBuffer>());
+            group.AddLogEvent()->SetContent(string("key"), string("value"));
+            group.AddMetricEvent();
+            group.AddSpanEvent();
+        }
+    });
+    worker.join();
+    APSARA_TEST_EQUAL(retainedBytes, EventPool::GetRetainedBytes());
+    uint64_t acquireCount = 0, hitCount = 0;
+    EventPool::FetchStatistics(acquireCount, hitCount);
+    APSARA_TEST_EQUAL(30U, acquireCount);
+    APSARA_TEST_EQUAL(0U, hitCount);
+}
+
+UNIT_TEST_CASE(EventPoolUnittest, TestReuseLogEvent)
+UNIT_TEST_CASE(EventPoolUnittest, TestReuseMetricEvent)
+UNIT_TEST_CASE(EventPoolUnittest, TestReuseSpanEvent)
+UNIT_TEST_CASE(EventPoolUnittest, TestCrossThread)
+UNIT_TEST_CASE(EventPoolUnittest, TestDisabled)
+
+} // namespace logtail
+
+UNIT_TEST_MAIN
@@ -26,6 +26,7 @@ public:
     void TestSetContent();
     void TestDelContent();
     void TestReadContentOp();
+    void TestManyContents();
     void TestIterateContent();
     void TestMeta();
     void TestSize();
@@ -119,6 +120,49 @@ void LogEventUnittest::TestReadContentOp() {
     }
 }
 
+void LogEventUnittest::TestManyContents() {
+    // enough contents to build hash index
+    const size_t count = 100;
+    map<string, string> expected;
+    for (size_t i = 0; i < count; ++i) {
+        mLogEvent->SetContent("key" + to_string(i), "value" + to_string(i));
+        expected["key" + to_string(i)] = "value" + to_string(i);
+    }
+    APSARA_TEST_EQUAL(count, mLogEvent->Size());
+    // overwrite, delete and set again after deletion
+    for (size_t i = 0; i < count; i += 3) {
+        mLogEvent->SetContent("key" + to_string(i), string("new"));
+        expected["key" + to_string(i)] = "new";
+    }
+    for (size_t i = 0; i < count; i += 2) {
+        mLogEvent->DelContent("key" + to_string(i));
+        expected.erase("key" + to_string(i));
+    }
+    for (size_t i = 0; i < count; i += 4) {
+        mLogEvent->SetContent("key" + to_string(i), string("again"));
+        expected["key" + to_string(i)] = "again";
+    }
+    APSARA_TEST_EQUAL(expected.size(), mLogEvent->Size());
+    for (size_t i = 0; i < count + 10; ++i) {
+        string key = "key" + to_string(i);
+        auto it = expected.find(key);
+        if (it == expected.end()) {
+            APSARA_TEST_FALSE(mLogEvent->HasContent(key));
+            APSARA_TEST_TRUE(mLogEvent->FindContent(key) == mLogEvent->end());
+        } else {
+            APSARA_TEST_TRUE(mLogEvent->HasContent(key));
+            APSARA_TEST_EQUAL(it->second, mLogEvent->GetContent(key).to_string());
+            APSARA_TEST_EQUAL(it->second, mLogEvent->FindContent(key)->second.to_string());
+        }
+    }
+    size_t iterated = 0;
+    for (const auto& content : *mLogEvent) {
+        APSARA_TEST_EQUAL(expected[content.first.to_string()], content.second.to_string());
+        ++iterated;
+    }
+    APSARA_TEST_EQUAL(expected.size(), iterated);
+}
+
 void LogEventUnittest::TestIterateContent() {
     {
         // first element is valid
@@ -206,6 +250,7 @@ UNIT_TEST_CASE(LogEventUnittest, TestTimestampOp)
 UNIT_TEST_CASE(LogEventUnittest, TestSetContent)
 UNIT_TEST_CASE(LogEventUnittest, TestDelContent)
 UNIT_TEST_CASE(LogEventUnittest, TestReadContentOp)
+UNIT_TEST_CASE(LogEventUnittest, TestManyContents)
 UNIT_TEST_CASE(LogEventUnittest, TestIterateContent)
 UNIT_TEST_CASE(LogEventUnittest, TestMeta)
 UNIT_TEST_CASE(LogEventUnittest, TestSize)
@@ -17,6 +17,8 @@
 #include <json/json.h>
 #include "LogIntegrity.h"
 #include "LogLineCount.h"
+#include "aggregator/Aggregator.h"
+#include "log_pb/LogGroupSerializer.h"
 
 namespace logtail {
 
@@ -29,6 +31,7 @@ public:
     void TestReloadIntegrityData();
     void TestReloadLineCountData();
     void TestReloadInvalidJsonFile();
+    void TestGetLastLogLineFromSerializedLogs();
 
     void MockIntegrityData();
     void MockLineCountData();
@@ -50,6 +53,7 @@ public:
 APSARA_UNIT_TEST_CASE(DataIntegrityUnittest, TestReloadIntegrityData, 0);
 APSARA_UNIT_TEST_CASE(DataIntegrityUnittest, TestReloadLineCountData, 0);
 APSARA_UNIT_TEST_CASE(DataIntegrityUnittest, TestReloadInvalidJsonFile, 0);
+APSARA_UNIT_TEST_CASE(DataIntegrityUnittest, TestGetLastLogLineFromSerializedLogs, 0);
 
 void DataIntegrityUnittest::TestReloadIntegrityData() {
     MockIntegrityData();
@@ -454,6 +458,35 @@ void DataIntegrityUnittest::MockCreateInvalidIntegrityJsonFile() {
     }
 }
 
+void DataIntegrityUnittest::TestGetLastLogLineFromSerializedLogs() {
+    MergeItem item("test_project",
+                   "test_config",
+                   "abc.log",
+                   true,
+                   "",
+                   "cn-gzone-ant",
+                   0,
+                   FlusherSLS::Batch::MergeType::TOPIC,
+                   "",
+                   0);
+    APSARA_TEST_EQUAL(LogIntegrity::GetInstance()->GetLastLogLine(&item), "");
+
+    LogGroupSerializer serializer(item.mSerializedLogs);
+    for (const std::string line : {"first line", "last line"}) {
+        size_t logSize = LogGroupSerializer::CalculateLogSize(
+            1539091741, LogGroupSerializer::CalculateContentSize(7, line.size()), false);
+        size_t offset = item.mSerializedLogs.size();
+        serializer.StartToAddLog(logSize);
+        serializer.AddLogTime(1539091741);
+        serializer.AddLogContent("content", line);
+        item.mLastSerializedLog = std::make_pair(static_cast<uint32_t>(offset),
+                                                 static_cast<uint32_t>(item.mSerializedLogs.size() - offset));
+    }
+    // logs merged in wire format are not kept in mLogGroup
+    APSARA_TEST_EQUAL(item.mLogGroup.logs_size(), 0);
+    APSARA_TEST_EQUAL(LogIntegrity::GetInstance()->GetLastLogLine(&item), "last line");
+}
+
 } // namespace logtail
 
 int main(int argc, char** argv) {
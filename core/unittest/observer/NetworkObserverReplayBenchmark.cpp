@@ -0,0 +1,269 @@
+// Copyright 2024 iLogtail Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+#include <string>
+#include <vector>
+
+#include "common/Flags.h"
+#include "common/TimeUtil.h"
+#include "logger/Logger.h"
+#include "observer/interface/helper.h"
+#include "observer/interface/statistics.h"
+#include "observer/metas/ContainerProcessGroup.h"
+#include "observer/network/NetworkObserver.h"
+#include "observer/network/protocols/utils.h"
+#include "observer/network/sources/dump/PacketEventDumpReader.h"
+
+DECLARE_FLAG_INT32(sls_observer_network_parse_thread_count);
+DECLARE_FLAG_INT32(sls_observer_network_parse_queue_size);
+
+// allocations of all threads, counted to find parsers allocating per packet
+static std::atomic<uint64_t> sAllocationCnt{0};
+
+void* operator new(size_t size) {
+    sAllocationCnt.fetch_add(1, std::memory_order_relaxed);
+    void* ptr = malloc(size);
+    if (ptr == nullptr) {
+        throw std::bad_alloc();
+    }
+    return ptr;
+}
+
+void operator delete(void* ptr) noexcept {
+    free(ptr);
+}
+
+void operator delete(void* ptr, size_t) noexcept {
+    free(ptr);
+}
+
+namespace logtail {
+
+class NetworkObserverReplayBenchmark {
+public:
+    // writes request and response packets of each protocol benchmarked to the file, as NetworkObserver dumps them
+    void GenerateDump(const std::string& fileName, size_t connCnt, size_t requestCntPerConn);
+    // replays the packets of the protocol in the file as fast as possible, parsed by the capturing thread if
+    // parseThreadCnt is 0
+    void Replay(const std::string& fileName, ProtocolType protocol, int32_t parseThreadCnt);
+
+    static const std::vector<ProtocolType> sProtocols;
+
+private:
+    struct Sample {
+        ProtocolType mProtocol;
+        uint16_t mPort;
+        std::string mRequest;
+        std::string mResponse;
+    };
+
+    static std::vector<Sample> GetSamples();
+    static std::string FromHex(const std::string& hex);
+    static void AppendPacket(FILE* file,
+                             uint32_t pid,
+                             uint32_t sockHash,
+                             uint16_t localPort,
+                             const Sample& sample,
+                             bool request,
+                             uint64_t timeNano);
+};
+
+const std::vector<ProtocolType> NetworkObserverReplayBenchmark::sProtocols
+    = {ProtocolType_HTTP, ProtocolType_MySQL, ProtocolType_Redis, ProtocolType_PgSQL, ProtocolType_DNS};
+
+std::string NetworkObserverReplayBenchmark::FromHex(const std::string& hex) {
+    std::vector<uint8_t> data;
+    hexstring_to_bin(hex, data);
+    return std::string(data.begin(), data.end());
+}
+
+std::vector<NetworkObserverReplayBenchmark::Sample> NetworkObserverReplayBenchmark::GetSamples() {
+    // binary ones are taken from the protocol unittests
+    return {{ProtocolType_HTTP,
+             80,
+             "GET /index.html HTTP/1.1\r\nHost: www.example.com\r\nUser-Agent: curl/7.77.0\r\nAccept: */*\r\n\r\n",
+             "HTTP/1.1 200 OK\r\nContent-Type: text/html\r\nContent-Length: 5\r\n\r\nhello"},
+            {ProtocolType_MySQL,
+             3306,
+             FromHex("210000000373656c65637420404076657273696f6e5f636f6d6d656e74206c696d69742031"),
+             FromHex("0700000100010102000000")},
+            {ProtocolType_Redis, 6379, "*2\r\n$3\r\nGET\r\n$3\r\nkey\r\n", "$5\r\nvalue\r\n"},
+            {ProtocolType_PgSQL,
+             5432,
+             std::string("Q\000\000\000\033select * from account;\000", 28),
+             FromHex("540000006e000475696400000040220001000000170004ffffffff0000757365726e616d650000004022000200000413"
+                     "ffff0000006800006465706172746e616d650000004022000300000413ffff000001f800006372656174656400000040"
+                     "2200040000043a0004ffffffff0000440000003c0004000000033331360000000d617374617869657570646174650000"
+                     "000ce7a094e58f91e983a8e997a80000000a323031322d31322d3039430000000d53454c4543542031005a0000000549")},
+            {ProtocolType_DNS,
+             53,
+             FromHex("661b010000010000000000000377777705626169647503636f6d0000010001"),
+             FromHex("661b818000010003000000000377777705626169647503636f6d0000010001c00c000500010000046a000f037777770161"
+                     "0673686966656ec016c02b000100010000003300046ef24403c02b000100010000003300046ef24404")}};
+}
+
+void NetworkObserverReplayBenchmark::AppendPacket(FILE* file,
+                                                  uint32_t pid,
+                                                  uint32_t sockHash,
+                                                  uint16_t localPort,
+                                                  const Sample& sample,
+                                                  bool request,
+                                                  uint64_t timeNano) {
+    const std::string& payload = request ? sample.mRequest : sample.mResponse;
+    char event[sizeof(PacketEventHeader) + sizeof(PacketEventData)] = {0};
+    auto header = reinterpret_cast<PacketEventHeader*>(event);
+    auto data = reinterpret_cast<PacketEventData*>(event + sizeof(PacketEventHeader));
+    header->PID = pid;
+    header->SockHash = sockHash;
+    header->EventType = PacketEventType_Data;
+    header->RoleType = PacketRoleType::Client;
+    header->TimeNano = timeNano;
+    header->SrcAddr = SockAddressFromString("10.0.0.1");
+    header->SrcPort = localPort;
+    header->DstAddr = SockAddressFromString("10.0.0.2");
+    header->DstPort = sample.mPort;
+    data->PtlType = sample.mProtocol;
+    data->MsgType = request ? MessageType_Request : MessageType_Response;
+    data->PktType = request ? PacketType_Out : PacketType_In;
+    data->RealLen = static_cast<int32_t>(payload.size());
+    data->BufferLen = static_cast<int32_t>(payload.size());
+    data->Buffer = const_cast<char*>(payload.data());
+    std::string buffer;
+    PacketEventToBuffer(event, static_cast<int32_t>(sizeof(event) + payload.size()), buffer);
+    fwrite(buffer.data(), 1, buffer.size(), file);
+}
+
+void NetworkObserverReplayBenchmark::GenerateDump(const std::string& fileName,
+                                                  size_t connCnt,
+                                                  size_t requestCntPerConn) {
+    FILE* file = fopen(fileName.c_str(), "wb");
+    if (file == nullptr) {
+        printf("open %s failed\n", fileName.c_str());
+        return;
+    }
+    uint64_t timeNano = GetCurrentTimeInNanoSeconds();
+    uint32_t sockHash = 0;
+    for (const auto& sample : GetSamples()) {
+        for (size_t i = 0; i < connCnt; ++i) {
+            // connections are spread over processes, and thus over the parsing threads
+            uint32_t pid = 4000000 + i % 64;
+            uint16_t localPort = 10000 + i % 50000;
+            ++sockHash;
+            for (size_t j = 0; j < requestCntPerConn; ++j) {
+                AppendPacket(file, pid, sockHash, localPort, sample, true, timeNano);
+                AppendPacket(file, pid, sockHash, localPort, sample, false, timeNano + 1000000);
+                timeNano += 1000;
+            }
+        }
+    }
+    fclose(file);
+}
+
+void NetworkObserverReplayBenchmark::Replay(const std::string& fileName,
+                                            ProtocolType protocol,
+                                            int32_t parseThreadCnt) {
+    // SetUp
+    PacketEventDumpReader reader;
+    if (!reader.Open(fileName)) {
+        printf("open %s failed\n", fileName.c_str());
+        return;
+    }
+    // packets of other protocols are skipped before replaying, so that only the parser of the protocol is measured
+    std::vector<size_t> positions;
+    uint64_t bytes = 0;
+    void* event = nullptr;
+    int32_t len = 0;
+    size_t pos = 0;
+    size_t recordPos = 0;
+    while (reader.Read(pos, event, len)) {
+        auto header = static_cast<PacketEventHeader*>(event);
+        auto data = reinterpret_cast<PacketEventData*>(header + 1);
+        if (header->EventType == PacketEventType_Data && data->PtlType == protocol) {
+            positions.push_back(recordPos);
+            bytes += data->BufferLen;
+        }
+        recordPos = pos;
+    }
+    if (positions.empty()) {
+        return;
+    }
+    INT32_FLAG(sls_observer_network_parse_thread_count) = parseThreadCnt;
+    // packets should never be dropped
+    INT32_FLAG(sls_observer_network_parse_queue_size) = static_cast<int32_t>(positions.size());
+    ContainerProcessGroupManager::GetInstance()->Clear();
+    NetworkStatistic::GetInstance()->mParseQueueDropCount = 0;
+    NetworkObserver* observer = new NetworkObserver();
+    observer->StartParseWorkers();
+
+    // Test
+    uint64_t allocationCnt = sAllocationCnt.load();
+    uint64_t startTime = GetCurrentTimeInMicroSeconds();
+    for (size_t position : positions) {
+        reader.Read(position, event, len);
+        observer->OnPacketEvent(event, len);
+    }
+    observer->StopParseWorkers();
+    uint64_t timeElapsed = GetCurrentTimeInMicroSeconds() - startTime;
+    allocationCnt = sAllocationCnt.load() - allocationCnt;
+    if (timeElapsed == 0) {
+        timeElapsed = 1;
+    }
+
+    std::vector<sls_logs::Log> allData;
+    observer->FlushOutMetrics(allData);
+    printf("%s %s threads %d: %.3fM events/s %.2fMB/s %.2f allocations/event (%zu events, %zu logs, %lu dropped)\n",
+           __func__,
+           ProtocolTypeToString(protocol).c_str(),
+           parseThreadCnt,
+           1.0 * positions.size() / timeElapsed,
+           1.0 * bytes / timeElapsed,
+           1.0 * allocationCnt / positions.size(),
+           positions.size(),
+           allData.size(),
+           static_cast<unsigned long>(NetworkStatistic::GetInstance()->mParseQueueDropCount));
+
+    // TearDown
+    delete observer;
+    ContainerProcessGroupManager::GetInstance()->Clear();
+}
+
+} // namespace logtail
+
+// usage: network_observer_replay_benchmark [dump file]
+// Packets dumped by the observer with sls_observer_network_save_filename are replayed if the file is given, otherwise
+// packets of all protocols supported are generated.
+int main(int argc, char* argv[]) {
+    logtail::Logger::Instance().InitGlobalLoggers();
+    logtail::NetworkObserverReplayBenchmark benchmark;
+    std::string fileName;
+    if (argc > 1) {
+        fileName = argv[1];
+    } else {
+        fileName = "network_observer_replay_benchmark.dump";
+        benchmark.GenerateDump(fileName, 1000, 100);
+    }
+    for (auto protocol : logtail::NetworkObserverReplayBenchmark::sProtocols) {
+        for (int32_t parseThreadCnt : {0, 1, 2, 4, 8}) {
+            benchmark.Replay(fileName, protocol, parseThreadCnt);
+        }
+    }
+    if (argc <= 1) {
+        remove(fileName.c_str());
+    }
+    return 0;
+}
@@ -13,6 +13,9 @@
 // limitations under the License.
 
 
+#include <atomic>
+#include <thread>
+#include <unistd.h>
 #include "unittest/Unittest.h"
 #include "unittest/UnittestHelper.h"
 #include "observer/network/NetworkObserver.h"
@@ -25,6 +28,10 @@
 #include "network/protocols/ProtocolEventAggregators.h"
 #include "metas/ContainerProcessGroup.h"
 #include "observer/network/protocols/infer.h"
+#include "observer/network/sources/dump/PacketEventDumpReader.h"
+
+DECLARE_FLAG_INT32(sls_observer_network_parse_thread_count);
+DECLARE_FLAG_INT32(sls_observer_network_parse_queue_size);
 
 namespace logtail {
 
@@ -41,10 +48,11 @@ public:
         data->PtlType = ProtocolType_HTTP;
         mObserver->OnPacketEvent(packetType, sizeof(PacketEventHeader) + sizeof(PacketEventData));
 
-        APSARA_TEST_EQUAL_FATAL(mObserver->mAllProcesses.size(), size_t(1));
-        APSARA_TEST_EQUAL_FATAL(mObserver->mAllProcesses.begin()->first, 8);
-        APSARA_TEST_EQUAL_FATAL(mObserver->mAllProcesses.begin()->second->mAllConnections.size(), size_t(1));
-        ProtocolEventAggregators* agg = mObserver->mAllProcesses.begin()->second->GetAggregator();
+        auto& allProcesses = mObserver->GetShard(8).mAllProcesses;
+        APSARA_TEST_EQUAL_FATAL(mObserver->GetProcessCount(), size_t(1));
+        APSARA_TEST_EQUAL_FATAL(allProcesses.begin()->first, 8);
+        APSARA_TEST_EQUAL_FATAL(allProcesses.begin()->second->mAllConnections.size(), size_t(1));
+        ProtocolEventAggregators* agg = allProcesses.begin()->second->GetAggregator();
         DNSProtocolEventAggregator* dnsAgg = agg->GetDNSAggregator();
         DNSProtocolEvent dnsEvent;
         dnsEvent.Info.ReqBytes = 100;
@@ -74,6 +82,181 @@ public:
     }
 
 
+    void TestMergeShardAggregators() {
+        ProcessMetaPtr meta(new ProcessMeta);
+        meta->PID = 9;
+        ContainerProcessGroup group(meta, 2);
+        for (size_t shard = 0; shard < 2; ++shard) {
+            for (int i = 0; i <= (int)shard; ++i) {
+                DNSProtocolEvent dnsEvent;
+                dnsEvent.Info.ReqBytes = 100;
+                dnsEvent.Info.RespBytes = 200;
+                dnsEvent.Info.LatencyNs = 300;
+                dnsEvent.Key.ReqResource = "cn-hangzhou.log.aliyuncs.com";
+                dnsEvent.Key.RespStatus = 1;
+                dnsEvent.Key.ConnKey.Role = PacketRoleType::Server;
+                group.GetShardAggregator(shard)->GetDNSAggregator()->AddEvent(std::move(dnsEvent));
+            }
+        }
+        DNSProtocolEvent dnsEvent;
+        dnsEvent.Key.ReqResource = "cn-shanghai.log.aliyuncs.com";
+        dnsEvent.Key.RespStatus = 1;
+        dnsEvent.Key.ConnKey.Role = PacketRoleType::Server;
+        group.GetShardAggregator(1)->GetDNSAggregator()->AddEvent(std::move(dnsEvent));
+        group.MergeShardAggregator(0);
+        group.MergeShardAggregator(1);
+
+        std::vector<sls_logs::Log> allData;
+        std::vector<std::pair<std::string, std::string>> tags;
+        group.FlushOutMetrics(GetCurrentTimeInNanoSeconds(), allData, tags, 15);
+        APSARA_TEST_EQUAL(allData.size(), size_t(2));
+        for (auto& log : allData) {
+            if (UnitTestHelper::LogKeyMatched(&log, "req_resource", "cn-hangzhou.log.aliyuncs.com")) {
+                APSARA_TEST_TRUE(UnitTestHelper::LogKeyMatched(&log, "count", "3"));
+                APSARA_TEST_TRUE(UnitTestHelper::LogKeyMatched(&log, "latency_ns", "900"));
+            } else {
+                APSARA_TEST_TRUE(UnitTestHelper::LogKeyMatched(&log, "count", "1"));
+            }
+        }
+
+        // shards are empty after merged
+        group.MergeShardAggregator(0);
+        group.MergeShardAggregator(1);
+        allData.clear();
+        group.FlushOutMetrics(GetCurrentTimeInNanoSeconds(), allData, tags, 15);
+        APSARA_TEST_EQUAL(allData.size(), size_t(0));
+    }
+
+    void TestParseWorkers() {
+        INT32_FLAG(sls_observer_network_parse_thread_count) = 2;
+        INT32_FLAG(sls_observer_network_parse_queue_size) = 1000;
+        ContainerProcessGroupManager::GetInstance()->Clear();
+        NetworkStatistic::GetInstance()->mParseQueueDropCount = 0;
+        NetworkObserver* observer = new NetworkObserver();
+        observer->StartParseWorkers();
+
+        char packetType[sizeof(PacketEventHeader) + sizeof(PacketEventData)] = {0};
+        PacketEventHeader* header = (PacketEventHeader*)packetType;
+        header->EventType = PacketEventType_Data;
+        PacketEventData* data = (PacketEventData*)(packetType + sizeof(PacketEventHeader));
+        data->BufferLen = 0;
+        data->RealLen = 1024;
+        data->PtlType = ProtocolType_HTTP;
+        for (uint32_t pid = 8; pid < 12; ++pid) {
+            header->PID = pid;
+            header->SockHash = pid;
+            APSARA_TEST_EQUAL(observer->OnPacketEvent(packetType, sizeof(packetType)), 0);
+        }
+
+        // the worker of shard 0 cannot parse while the processes are locked, so its queue overflows
+        INT32_FLAG(sls_observer_network_parse_queue_size) = 1;
+        header->PID = 12;
+        header->SockHash = 12;
+        {
+            std::lock_guard<std::mutex> lock(observer->GetShard(12).mProcessesMutex);
+            for (int i = 0; i < 10; ++i) {
+                observer->OnPacketEvent(packetType, sizeof(packetType));
+            }
+        }
+        observer->StopParseWorkers();
+        // at most one event is taken by the worker and one more is queued
+        APSARA_TEST_TRUE(NetworkStatistic::GetInstance()->mParseQueueDropCount >= 8U);
+        APSARA_TEST_TRUE(NetworkStatistic::GetInstance()->mParseQueueDropCount <= 9U);
+
+        APSARA_TEST_EQUAL_FATAL(observer->GetProcessCount(), size_t(5));
+        for (uint32_t pid = 8; pid < 12; ++pid) {
+            NetworkObserverShard& shard = observer->GetShard(pid);
+            APSARA_TEST_EQUAL(shard.mIndex, size_t(pid % 2));
+            auto iter = shard.mAllProcesses.find(pid);
+            APSARA_TEST_TRUE_FATAL(iter != shard.mAllProcesses.end());
+            APSARA_TEST_EQUAL(iter->second->mAllConnections.size(), size_t(1));
+            // pid 8 gets 1 event, pid 9 gets 2 events, and so on
+            for (uint32_t i = 8; i <= pid; ++i) {
+                DNSProtocolEvent dnsEvent;
+                dnsEvent.Info.LatencyNs = 100;
+                dnsEvent.Key.ReqResource = "cn-hangzhou.log.aliyuncs.com";
+                dnsEvent.Key.RespStatus = 1;
+                dnsEvent.Key.ConnKey.Role = PacketRoleType::Server;
+                iter->second->GetAggregator()->GetDNSAggregator()->AddEvent(std::move(dnsEvent));
+            }
+        }
+
+        std::vector<sls_logs::Log> allData;
+        observer->FlushOutMetrics(allData);
+        APSARA_TEST_EQUAL(allData.size(), size_t(4));
+        // the aggregators of both shards are merged on flush, one log for each pid
+        for (uint32_t pid = 8; pid < 12; ++pid) {
+            const std::string pidInfo = "\"_process_pid_\":\"" + std::to_string(pid) + "\"";
+            size_t matched = 0;
+            for (auto& log : allData) {
+                auto localInfo = UnitTestHelper::GetLogKey(&log, "local_info");
+                if (localInfo.second && localInfo.first.find(pidInfo) != std::string::npos) {
+                    ++matched;
+                    APSARA_TEST_TRUE(UnitTestHelper::LogKeyMatched(&log, "count", std::to_string(pid - 7)));
+                    APSARA_TEST_TRUE(
+                        UnitTestHelper::LogKeyMatched(&log, "latency_ns", std::to_string((pid - 7) * 100)));
+                }
+            }
+            APSARA_TEST_EQUAL(matched, size_t(1));
+        }
+
+        delete observer;
+        ContainerProcessGroupManager::GetInstance()->Clear();
+        ContainerProcessGroupManager::GetInstance()->SetShardCount(1);
+        INT32_FLAG(sls_observer_network_parse_thread_count) = 0;
+        INT32_FLAG(sls_observer_network_parse_queue_size) = 100000;
+    }
+
+    void TestPacketEventDumpReader() {
+        const std::string fileName = "packet_event_dump_reader_unittest.dump";
+        const std::string payload = "GET / HTTP/1.1\r\n\r\n";
+        char dataEvent[sizeof(PacketEventHeader) + sizeof(PacketEventData)] = {0};
+        PacketEventHeader* header = (PacketEventHeader*)dataEvent;
+        header->EventType = PacketEventType_Data;
+        header->PID = 8;
+        header->SockHash = 10;
+        PacketEventData* data = (PacketEventData*)(dataEvent + sizeof(PacketEventHeader));
+        data->PtlType = ProtocolType_HTTP;
+        data->BufferLen = payload.size();
+        data->RealLen = payload.size();
+        data->Buffer = (char*)payload.data();
+        PacketEventHeader closeEvent = *header;
+        closeEvent.EventType = PacketEventType_Closed;
+
+        std::string content, buffer;
+        PacketEventToBuffer(dataEvent, sizeof(dataEvent) + payload.size(), buffer);
+        content += buffer;
+        PacketEventToBuffer(&closeEvent, sizeof(closeEvent), buffer);
+        content += buffer;
+        // torn record
+        content += buffer.substr(0, buffer.size() - 1);
+        FILE* file = fopen(fileName.c_str(), "wb");
+        APSARA_TEST_TRUE_FATAL(file != nullptr);
+        fwrite(content.data(), 1, content.size(), file);
+        fclose(file);
+
+        PacketEventDumpReader reader;
+        APSARA_TEST_TRUE_FATAL(reader.Open(fileName));
+        APSARA_TEST_EQUAL(reader.GetFileSize(), content.size());
+        size_t pos = 0;
+        void* event = nullptr;
+        int32_t len = 0;
+        APSARA_TEST_TRUE_FATAL(reader.Read(pos, event, len));
+        APSARA_TEST_EQUAL(len, int32_t(sizeof(dataEvent) + payload.size()));
+        APSARA_TEST_EQUAL(((PacketEventHeader*)event)->SockHash, 10U);
+        PacketEventData* readData = (PacketEventData*)((char*)event + sizeof(PacketEventHeader));
+        APSARA_TEST_EQUAL(readData->PtlType, ProtocolType_HTTP);
+        APSARA_TEST_EQUAL(std::string(readData->Buffer, readData->BufferLen), payload);
+        APSARA_TEST_TRUE_FATAL(reader.Read(pos, event, len));
+        APSARA_TEST_EQUAL(len, int32_t(sizeof(PacketEventHeader)));
+        APSARA_TEST_EQUAL(((PacketEventHeader*)event)->EventType, PacketEventType_Closed);
+        size_t tornPos = pos;
+        APSARA_TEST_FALSE(reader.Read(pos, event, len));
+        APSARA_TEST_EQUAL(pos, tornPos);
+        reader.Close();
+        remove(fileName.c_str());
+    }
+
     void TestJsonPacketToPB() {
         JsonNetPacketReader reader("/tmp/wireshark.json", "30.43.121.41", false, ProtocolType_DNS);
         APSARA_TEST_TRUE(reader.OK());
@@ -238,16 +421,49 @@ public:
         inferMySQL();
     }
 
+    void TestRefreshMetaWhileParsing() {
+        ContainerProcessGroupManager* manager = ContainerProcessGroupManager::GetInstance();
+        uint32_t pid = getpid();
+        ProcessMetaPtr meta = manager->GetProcessMeta(pid);
+        std::string cmdLine = manager->GetProcessCMD(meta);
+
+        // housekeeping: make the meta stale and let FlushPids clear and refresh it in place, as FlushMetas does
+        std::atomic_bool stop(false);
+        std::thread housekeeping([&]() {
+            while (!stop) {
+                std::lock_guard<std::mutex> lock(manager->mMutex);
+                meta->ProcessCMD = "stale";
+                manager->mLastNormalProcessMetaUpdateTime = 0;
+                manager->FlushPids(std::unordered_set<uint32_t>());
+            }
+        });
+        // parsing: the accessors used by the parsing shards must only see a consistent meta
+        for (int i = 0; i < 10000; ++i) {
+            APSARA_TEST_TRUE(manager->PassFilterRules(meta));
+            std::string cmd = manager->GetProcessCMD(meta);
+            APSARA_TEST_TRUE(cmd == cmdLine || cmd == "stale");
+            std::string metaStr = manager->GetMetaString(meta);
+            APSARA_TEST_TRUE(metaStr.find("\"_process_pid_\":\"" + std::to_string(pid) + "\"") != std::string::npos);
+        }
+        stop = true;
+        housekeeping.join();
+        APSARA_TEST_EQUAL(manager->GetProcessCMD(meta), cmdLine);
+    }
+
     NetworkObserver* mObserver = NetworkObserver::GetInstance();
 };
 
 
 APSARA_UNIT_TEST_CASE(NetworkObserverUnittest, TestToPB, 0);
+APSARA_UNIT_TEST_CASE(NetworkObserverUnittest, TestMergeShardAggregators, 0);
+APSARA_UNIT_TEST_CASE(NetworkObserverUnittest, TestParseWorkers, 0);
+APSARA_UNIT_TEST_CASE(NetworkObserverUnittest, TestPacketEventDumpReader, 0);
 //    APSARA_UNIT_TEST_CASE(NetworkObserverUnittest, TestJsonNetPacketReader, 0);
 //    APSARA_UNIT_TEST_CASE(NetworkObserverUnittest, TestJsonPacketToPB, 0);
 APSARA_UNIT_TEST_CASE(NetworkObserverUnittest, TestRawPacketUDPReader, 0);
 APSARA_UNIT_TEST_CASE(NetworkObserverUnittest, TestRawPacketTCPReader, 0);
 APSARA_UNIT_TEST_CASE(NetworkObserverUnittest, TestInferProtocol, 0);
+APSARA_UNIT_TEST_CASE(NetworkObserverUnittest, TestRefreshMetaWhileParsing, 0);
 } // namespace logtail
 
 
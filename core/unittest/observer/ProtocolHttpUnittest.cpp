@@ -420,7 +420,7 @@ public:
         ProtocolDebugStatistic* protocolDebugStatistic = ProtocolDebugStatistic::GetInstance();
         mObserver->GarbageCollection(GetCurrentTimeInNanoSeconds());
         networkStatistic->Clear();
-        APSARA_TEST_EQUAL(mObserver->mAllProcesses.size(), 0);
+        APSARA_TEST_EQUAL(mObserver->GetProcessCount(), 0);
 
         {
             std::vector<std::string> rawHexs{rawHex1};
@@ -437,7 +437,7 @@ public:
 
 
             mObserver->GarbageCollection(GetCurrentTimeInNanoSeconds() - 60000000000000ULL);
-            APSARA_TEST_EQUAL(mObserver->mAllProcesses.size(), 1);
+            APSARA_TEST_EQUAL(mObserver->GetProcessCount(), 1);
             APSARA_TEST_EQUAL(networkStatistic->mGCCount, 1);
             APSARA_TEST_EQUAL(networkStatistic->mGCReleaseConnCount, 0);
             APSARA_TEST_EQUAL(networkStatistic->mGCReleaseProcessCount, 0);
@@ -445,7 +445,7 @@ public:
             APSARA_TEST_EQUAL(protocolDebugStatistic->mHTTPConnectionCachedSize, 1);
 
             mObserver->GarbageCollection(GetCurrentTimeInNanoSeconds());
-            APSARA_TEST_EQUAL(mObserver->mAllProcesses.size(), 0);
+            APSARA_TEST_EQUAL(mObserver->GetProcessCount(), 0);
             APSARA_TEST_EQUAL(networkStatistic->mGCCount, 2);
             APSARA_TEST_EQUAL(networkStatistic->mGCReleaseConnCount, 1);
             APSARA_TEST_EQUAL(networkStatistic->mGCReleaseProcessCount, 1);
@@ -467,7 +467,7 @@ public:
             APSARA_TEST_EQUAL(allData.size(), 0);
 
             mObserver->GarbageCollection(GetCurrentTimeInNanoSeconds() - 60000000000000ULL);
-            APSARA_TEST_EQUAL(mObserver->mAllProcesses.size(), 1);
+            APSARA_TEST_EQUAL(mObserver->GetProcessCount(), 1);
             APSARA_TEST_EQUAL(networkStatistic->mGCCount, 1);
             APSARA_TEST_EQUAL(networkStatistic->mGCReleaseConnCount, 0);
             APSARA_TEST_EQUAL(networkStatistic->mGCReleaseProcessCount, 0);
@@ -476,7 +476,7 @@ public:
 
 
             mObserver->GarbageCollection(GetCurrentTimeInNanoSeconds());
-            APSARA_TEST_EQUAL(mObserver->mAllProcesses.size(), 0);
+            APSARA_TEST_EQUAL(mObserver->GetProcessCount(), 0);
             APSARA_TEST_EQUAL(networkStatistic->mGCCount, 2);
             APSARA_TEST_EQUAL(networkStatistic->mGCReleaseConnCount, 1);
             APSARA_TEST_EQUAL(networkStatistic->mGCReleaseProcessCount, 1);
@@ -143,7 +143,7 @@ public:
         NetworkStatistic* networkStatistic = NetworkStatistic::GetInstance();
         ProtocolDebugStatistic* protocolDebugStatistic = ProtocolDebugStatistic::GetInstance();
         mObserver->GarbageCollection(GetCurrentTimeInNanoSeconds());
-        APSARA_TEST_EQUAL(mObserver->mAllProcesses.size(), 0);
+        APSARA_TEST_EQUAL(mObserver->GetProcessCount(), 0);
         networkStatistic->Clear();
         {
             std::vector<std::string> rawHexs{rawHex1};
@@ -159,7 +159,7 @@ public:
             APSARA_TEST_EQUAL(allData.size(), 0);
 
             mObserver->GarbageCollection(GetCurrentTimeInNanoSeconds() - 60000000000000ULL);
-            APSARA_TEST_EQUAL(mObserver->mAllProcesses.size(), 1);
+            APSARA_TEST_EQUAL(mObserver->GetProcessCount(), 1);
             APSARA_TEST_EQUAL(networkStatistic->mGCCount, 1);
             APSARA_TEST_EQUAL(networkStatistic->mGCReleaseConnCount, 0);
             APSARA_TEST_EQUAL(networkStatistic->mGCReleaseProcessCount, 0);
@@ -167,7 +167,7 @@ public:
             APSARA_TEST_EQUAL(protocolDebugStatistic->mPgSQLConnectionCachedSize, 1);
 
             mObserver->GarbageCollection(GetCurrentTimeInNanoSeconds());
-            APSARA_TEST_EQUAL(mObserver->mAllProcesses.size(), 0);
+            APSARA_TEST_EQUAL(mObserver->GetProcessCount(), 0);
             APSARA_TEST_EQUAL(networkStatistic->mGCCount, 2);
             APSARA_TEST_EQUAL(networkStatistic->mGCReleaseConnCount, 1);
             APSARA_TEST_EQUAL(networkStatistic->mGCReleaseProcessCount, 1);
@@ -189,7 +189,7 @@ public:
             APSARA_TEST_EQUAL(allData.size(), 0);
 
             mObserver->GarbageCollection(GetCurrentTimeInNanoSeconds() - 60000000000000ULL);
-            APSARA_TEST_EQUAL(mObserver->mAllProcesses.size(), 1);
+            APSARA_TEST_EQUAL(mObserver->GetProcessCount(), 1);
             APSARA_TEST_EQUAL(networkStatistic->mGCCount, 1);
             APSARA_TEST_EQUAL(networkStatistic->mGCReleaseConnCount, 0);
             APSARA_TEST_EQUAL(networkStatistic->mGCReleaseProcessCount, 0);
@@ -197,7 +197,7 @@ public:
             APSARA_TEST_EQUAL(protocolDebugStatistic->mPgSQLConnectionCachedSize, 1);
 
             mObserver->GarbageCollection(GetCurrentTimeInNanoSeconds());
-            APSARA_TEST_EQUAL(mObserver->mAllProcesses.size(), 0);
+            APSARA_TEST_EQUAL(mObserver->GetProcessCount(), 0);
             APSARA_TEST_EQUAL(networkStatistic->mGCCount, 2);
             APSARA_TEST_EQUAL(networkStatistic->mGCReleaseConnCount, 1);
             APSARA_TEST_EQUAL(networkStatistic->mGCReleaseProcessCount, 1);
@@ -125,7 +125,7 @@ public:
         ProtocolDebugStatistic* protocolDebugStatistic = ProtocolDebugStatistic::GetInstance();
         mObserver->GarbageCollection(GetCurrentTimeInNanoSeconds());
         NetworkStatistic::Clear();
-        APSARA_TEST_EQUAL(mObserver->mAllProcesses.size(), 0);
+        APSARA_TEST_EQUAL(mObserver->GetProcessCount(), 0);
 
         {
             std::vector<std::string> rawHexs{rawHex1};
@@ -141,7 +141,7 @@ public:
             APSARA_TEST_EQUAL(allData.size(), 0);
 
             mObserver->GarbageCollection(GetCurrentTimeInNanoSeconds() - 60000000000000ULL);
-            APSARA_TEST_EQUAL(mObserver->mAllProcesses.size(), 1);
+            APSARA_TEST_EQUAL(mObserver->GetProcessCount(), 1);
             APSARA_TEST_EQUAL(networkStatistic->mGCCount, 1);
             APSARA_TEST_EQUAL(networkStatistic->mGCReleaseConnCount, 0);
             APSARA_TEST_EQUAL(networkStatistic->mGCReleaseProcessCount, 0);
@@ -150,7 +150,7 @@ public:
             APSARA_TEST_EQUAL(protocolDebugStatistic->mRedisConnectionCachedSize, 1);
 
             mObserver->GarbageCollection(GetCurrentTimeInNanoSeconds());
-            APSARA_TEST_EQUAL(mObserver->mAllProcesses.size(), 0);
+            APSARA_TEST_EQUAL(mObserver->GetProcessCount(), 0);
             APSARA_TEST_EQUAL(networkStatistic->mGCCount, 2);
             APSARA_TEST_EQUAL(networkStatistic->mGCReleaseConnCount, 1);
             APSARA_TEST_EQUAL(networkStatistic->mGCReleaseProcessCount, 1);
@@ -172,7 +172,7 @@ public:
             APSARA_TEST_EQUAL(allData.size(), 0);
 
             mObserver->GarbageCollection(GetCurrentTimeInNanoSeconds() - 60000000000000ULL);
-            APSARA_TEST_EQUAL(mObserver->mAllProcesses.size(), 1);
+            APSARA_TEST_EQUAL(mObserver->GetProcessCount(), 1);
             APSARA_TEST_EQUAL(networkStatistic->mGCCount, 1);
             APSARA_TEST_EQUAL(networkStatistic->mGCReleaseConnCount, 0);
             APSARA_TEST_EQUAL(networkStatistic->mGCReleaseProcessCount, 0);
@@ -180,7 +180,7 @@ public:
             APSARA_TEST_EQUAL(protocolDebugStatistic->mRedisConnectionCachedSize, 1);
 
             mObserver->GarbageCollection(GetCurrentTimeInNanoSeconds());
-            APSARA_TEST_EQUAL(mObserver->mAllProcesses.size(), 0);
+            APSARA_TEST_EQUAL(mObserver->GetProcessCount(), 0);
             APSARA_TEST_EQUAL(networkStatistic->mGCCount, 2);
             APSARA_TEST_EQUAL(networkStatistic->mGCReleaseConnCount, 1);
             APSARA_TEST_EQUAL(networkStatistic->mGCReleaseProcessCount, 1);
@@ -327,6 +327,64 @@ public:
         APSARA_TEST_EQUAL(cache.GetResponsesSize(), 0);
         APSARA_TEST_EQUAL(count, 1);
     }
+
+    void TestLatencySketchBucket() {
+        for (uint64_t v = 0; v < (1ULL << 20); v += 7) {
+            uint32_t index = LatencySketch::GetBucketIndex(v);
+            APSARA_TEST_TRUE(index < LatencySketch::kBucketCount);
+            APSARA_TEST_TRUE(LatencySketch::GetBucketLowerBound(index) <= v);
+            APSARA_TEST_TRUE(v < LatencySketch::GetBucketUpperBound(index));
+        }
+        APSARA_TEST_EQUAL(LatencySketch::kBucketCount - 1, LatencySketch::GetBucketIndex(1ULL << 40));
+        APSARA_TEST_EQUAL(LatencySketch::GetBucketUpperBound(10), LatencySketch::GetBucketLowerBound(11));
+        APSARA_TEST_EQUAL(LatencySketch::GetBucketUpperBound(100), LatencySketch::GetBucketLowerBound(101));
+    }
+
+    void TestLatencySketchQuantile() {
+        LatencySketch sketch;
+        APSARA_TEST_EQUAL(0, sketch.GetQuantileNs(0.5));
+        // 1ms ~ 100ms
+        for (int64_t i = 1; i <= 100; ++i) {
+            sketch.Add(i * 1000 * 1000);
+        }
+        APSARA_TEST_EQUAL(100U, sketch.Count());
+        for (double q : {0.5, 0.9, 0.99}) {
+            double expected = q * 100 * 1000 * 1000;
+            double actual = sketch.GetQuantileNs(q);
+            APSARA_TEST_TRUE(std::abs(actual - expected) / expected <= 1.0 / 16);
+        }
+        sketch.Clear();
+        APSARA_TEST_EQUAL(0U, sketch.Count());
+        APSARA_TEST_EQUAL("3|", sketch.Serialize());
+    }
+
+    void TestLatencySketchMerge() {
+        LatencySketch lhs, rhs, all;
+        for (int64_t i = 0; i < 1000; ++i) {
+            int64_t latencyNs = (i * 7919 % 1000) * 3000;
+            (i % 3 == 0 ? lhs : rhs).Add(latencyNs);
+            all.Add(latencyNs);
+        }
+        lhs.Merge(rhs);
+        APSARA_TEST_EQUAL(all.Count(), lhs.Count());
+        APSARA_TEST_EQUAL(all.Serialize(), lhs.Serialize());
+
+        CommonProtocolAggResult result;
+        CommonProtocolEventInfo info;
+        info.LatencyNs = 100 * 1000;
+        result.AddEventInfo(info);
+        result.AddEventInfo(info);
+        info.LatencyNs = 500;
+        result.AddEventInfo(info);
+        APSARA_TEST_EQUAL("3|0:1,96:2", result.Latency.Serialize());
+        sls_logs::Log log;
+        result.ToPB(&log);
+        APSARA_TEST_EQUAL(observer::kTdigestLatency, log.contents(4).key());
+        APSARA_TEST_EQUAL("3|0:1,96:2", log.contents(4).value());
+        result.Clear();
+        APSARA_TEST_TRUE(result.IsEmpty());
+        APSARA_TEST_EQUAL("3|", result.Latency.Serialize());
+    }
 };
 
 
@@ -339,6 +397,9 @@ APSARA_UNIT_TEST_CASE(ProtocolUtilUnittest, TestCommonCacheContinueOneByOneAndRe
 APSARA_UNIT_TEST_CASE(ProtocolUtilUnittest, TestCommonCacheInsertOldResp, 0);
 APSARA_UNIT_TEST_CASE(ProtocolUtilUnittest, TestCommonCacheInsertNewReq, 0);
 APSARA_UNIT_TEST_CASE(ProtocolUtilUnittest, TestCommonCacheTryMatchingReq, 0);
+APSARA_UNIT_TEST_CASE(ProtocolUtilUnittest, TestLatencySketchBucket, 0);
+APSARA_UNIT_TEST_CASE(ProtocolUtilUnittest, TestLatencySketchQuantile, 0);
+APSARA_UNIT_TEST_CASE(ProtocolUtilUnittest, TestLatencySketchMerge, 0);
 } // namespace logtail
 
 
@@ -12,6 +12,9 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <atomic>
+#include <thread>
+
 #include "pipeline/Pipeline.h"
 #include "pipeline/PipelineManager.h"
 #include "unittest/Unittest.h"
@@ -23,6 +26,7 @@ namespace logtail {
 class PipelineManagerUnittest : public testing::Test {
 public:
     void TestPipelineManagement() const;
+    void TestRemovePipelinesWhileFinding() const;
 };
 
 void PipelineManagerUnittest::TestPipelineManagement() const {
@@ -34,7 +38,37 @@ void PipelineManagerUnittest::TestPipelineManagement() const {
     APSARA_TEST_EQUAL(nullptr, PipelineManager::GetInstance()->FindPipelineByName("test3"));
 }
 
+void PipelineManagerUnittest::TestRemovePipelinesWhileFinding() const {
+    auto manager = PipelineManager::GetInstance();
+    manager->mPipelineNameEntityMap.clear();
+    ConfigDiff diff;
+    for (int i = 0; i < 100; ++i) {
+        manager->mPipelineNameEntityMap["test" + to_string(i)] = make_shared<Pipeline>();
+        diff.mRemoved.push_back("test" + to_string(i));
+    }
+    auto held = manager->FindPipelineByName("test0");
+
+    // pipelines are looked up by process threads without holding process threads on during config update
+    atomic_bool stop(false);
+    thread finder([&]() {
+        for (int i = 0; !stop; ++i) {
+            auto p = manager->FindPipelineByName("test" + to_string(i % 100));
+            if (p) {
+                p->Name();
+            }
+        }
+    });
+    manager->UpdatePipelines(diff);
+    stop = true;
+    finder.join();
+
+    APSARA_TEST_TRUE(manager->GetAllPipelineNames().empty());
+    // removed pipelines are kept alive by their users
+    APSARA_TEST_EQUAL(1L, held.use_count());
+}
+
 UNIT_TEST_CASE(PipelineManagerUnittest, TestPipelineManagement)
+UNIT_TEST_CASE(PipelineManagerUnittest, TestRemovePipelinesWhileFinding)
 
 } // namespace logtail
 
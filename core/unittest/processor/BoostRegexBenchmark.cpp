@@ -12,12 +12,15 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <algorithm>
 #include <boost/regex.hpp>
 #include <cstdlib>
 #include <cstring>
 #include <iostream>
 #include <sstream>
+#include <vector>
 
+#include "common/RegexSet.h"
 #include "unittest/Unittest.h"
 
 
@@ -94,6 +97,45 @@ static void BM_Regex_Search(int size, int batchSize) {
     }
 }
 
+// patterns of multiline start, continue and end, and of filters, evaluated against the same lines
+static void BM_Regex_Set(RegexEngine engine, RegexSet::Anchor anchor, int patternCount, int batchSize) {
+    const std::vector<std::string> patterns = {"\\[\\d{4}-\\d{2}-\\d{2} \\d{2}:\\d{2}:\\d{2}\\.\\d{3}\\].*",
+                                               "\\s+at .*",
+                                               ".*Exception.*",
+                                               "\\d+\\.\\d+\\.\\d+\\.\\d+ - .*",
+                                               ".*(ERROR|FATAL).*",
+                                               "\\S+ \\S+ \\S+ \\[.*\\] \"GET .*",
+                                               ".*caused by.*",
+                                               "\\{\"level\":\"\\w+\".*"};
+    const std::vector<std::string> lines
+        = {"[2024-01-02 10:00:00.123] ERROR c.e.BookController - request failed, id=12345, cost=13ms",
+           "    at com.example.BookController.get(BookController.java:42)",
+           "java.lang.IllegalStateException: book not found in the repository of the shelf",
+           "192.168.0.1 - - [02/Jan/2024:10:00:00 +0800] \"GET /books/12345 HTTP/1.1\" 200 512",
+           "{\"level\":\"info\",\"msg\":\"request done\",\"cost\":13,\"path\":\"/books/12345\"}"};
+    RegexSet set(engine, anchor);
+    for (int i = 0; i < patternCount; ++i) {
+        set.Add(patterns[i % patterns.size()]);
+    }
+    set.Compile();
+
+    std::vector<int> matched;
+    std::string exception;
+    uint64_t size = 0, matchedCount = 0;
+    uint64_t startTime = GetCurrentTimeInMicroSeconds();
+    for (int i = 0; i < batchSize; ++i) {
+        for (const auto& line : lines) {
+            set.Match(line.data(), line.size(), matched, exception);
+            matchedCount += matched.size();
+            size += line.size();
+        }
+    }
+    uint64_t durationTime = GetCurrentTimeInMicroSeconds() - startTime;
+    std::cout << RegexEngineToString(engine) << '\t' << (anchor == RegexSet::Anchor::FULL ? "full" : "prefix")
+              << "\tpatterns: " << patternCount << "\tmatched: " << matchedCount << "\tdurationTime: " << durationTime
+              << "\tprocess: " << formatSize(size * 1000000 / std::max(durationTime, (uint64_t)1)) << std::endl;
+}
+
 int main(int argc, char** argv) {
     logtail::Logger::Instance().InitGlobalLoggers();
 #ifdef NDEBUG
@@ -105,5 +147,13 @@ int main(int argc, char** argv) {
     BM_Regex_Match(100, 10000);
     std::cout << "BM_Regex_Search" << std::endl;
     BM_Regex_Search(100, 10000);
+    std::cout << "BM_Regex_Set" << std::endl;
+    for (auto anchor : {RegexSet::Anchor::FULL, RegexSet::Anchor::PREFIX}) {
+        for (int patternCount : {1, 2, 4, 8}) {
+            for (auto engine : {RegexEngine::BOOST, RegexEngine::RE2}) {
+                BM_Regex_Set(engine, anchor, patternCount, 20000);
+            }
+        }
+    }
     return 0;
 }
\ No newline at end of file
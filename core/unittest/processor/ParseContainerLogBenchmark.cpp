@@ -17,6 +17,7 @@
 #include <iostream>
 #include <sstream>
 
+#include "common/SimdUtil.h"
 #include "config/Config.h"
 #include "models/LogEvent.h"
 #include "plugin/instance/ProcessorInstance.h"
@@ -266,6 +267,65 @@ static void BM_ContainerdText(int size, int batchSize) {
     }
 }
 
+// @log is the escaped value of the log field, repeated to form lines of about @lineSize bytes
+static std::string makeDockerJsonLine(const std::string& log, size_t lineSize) {
+    std::string value;
+    while (value.size() < lineSize) {
+        value += log;
+    }
+    return R"({"log":")" + value + R"(\n","stream":"stdout","time":"2024-04-07T08:02:40.873971412Z"})";
+}
+
+static void BM_DockerJsonEscape(const std::string& name, const std::string& log, int size, int batchSize) {
+    PipelineContext mContext;
+    mContext.SetConfigName("project##config_0");
+
+    Json::Value config;
+    ProcessorParseContainerLogNative processor;
+    processor.SetContext(mContext);
+    processor.SetMetricsRecordRef(ProcessorParseContainerLogNative::sName, "1");
+    if (!processor.Init(config)) {
+        return;
+    }
+
+    std::string data = makeDockerJsonLine(log, 1024);
+    Json::Value root;
+    Json::Value events;
+    for (int i = 0; i < size; i++) {
+        Json::Value event;
+        event["type"] = 1;
+        event["timestamp"] = 1234567890;
+        event["timestampNanosecond"] = 0;
+        event["contents"]["content"] = data;
+        events.append(event);
+    }
+    root["events"] = events;
+    Json::StreamWriterBuilder builder;
+    builder["commentStyle"] = "None";
+    std::unique_ptr<Json::StreamWriter> writer(builder.newStreamWriter());
+    std::ostringstream oss;
+    writer->write(root, &oss);
+    std::string inJson = oss.str();
+
+    uint64_t durationTime = 0;
+    for (int i = 0; i < batchSize; i++) {
+        auto sourceBuffer = std::make_shared<SourceBuffer>();
+        PipelineEventGroup eventGroup(sourceBuffer);
+        eventGroup.SetMetadata(EventGroupMetaKey::LOG_FORMAT, ProcessorParseContainerLogNative::DOCKER_JSON_FILE);
+        eventGroup.FromJsonString(inJson);
+
+        uint64_t startTime = GetCurrentTimeInMicroSeconds();
+        processor.Process(eventGroup);
+        durationTime += GetCurrentTimeInMicroSeconds() - startTime;
+    }
+    if (durationTime == 0) {
+        durationTime = 1;
+    }
+    std::cout << name << "\tdurationTime: " << durationTime << "\tprocess: "
+              << formatSize(data.size() * (uint64_t)batchSize * 1000000 * (uint64_t)size / durationTime) << "/s"
+              << std::endl;
+}
+
 int main(int argc, char** argv) {
     logtail::Logger::Instance().InitGlobalLoggers();
 #ifdef NDEBUG
@@ -277,5 +337,12 @@ int main(int argc, char** argv) {
     BM_DockerJson(512, 100);
     std::cout << "containerdText" << std::endl;
     BM_ContainerdText(512, 100);
+    std::cout << "docker json with " << logtail::SimdLevelToString(logtail::GetSimdLevel()) << std::endl;
+    // from no escapes at all to one every few bytes, and non-ASCII text escaped as \uXXXX
+    BM_DockerJsonEscape("no escape", "at com.example.myproject.Book.getTitle(Book.java:16) ", 512, 100);
+    BM_DockerJsonEscape(
+        "sparse escape", R"(at com.example.myproject.Book.getTitle(Book.java:16) \"main\"\n\tat )", 512, 100);
+    BM_DockerJsonEscape("dense escape", R"({\"k\":\"v\",\"p\":\"C:\\\\tmp\"}\n)", 512, 100);
+    BM_DockerJsonEscape("unicode escape", R"(\u4e3a\u53ef\u89c2\u6d4b abc \ud83c\udf0d )", 512, 100);
     return 0;
 }
\ No newline at end of file
@@ -0,0 +1,126 @@
+// Copyright 2024 iLogtail Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <sstream>
+
+#include "common/SimdUtil.h"
+#include "common/StringTools.h"
+#include "config/Config.h"
+#include "models/LogEvent.h"
+#include "plugin/instance/ProcessorInstance.h"
+#include "processor/ProcessorParseDelimiterNative.h"
+#include "unittest/Unittest.h"
+
+
+using namespace logtail;
+
+
+std::string formatSize(long long size) {
+    static const char* units[] = {" B", "KB", "MB", "GB", "TB"};
+    int index = 0;
+    double doubleSize = static_cast<double>(size);
+    while (doubleSize >= 1024.0 && index < 4) {
+        doubleSize /= 1024.0;
+        index++;
+    }
+    std::ostringstream ss;
+    ss << std::fixed << std::setprecision(1) << std::setw(6) << std::setfill(' ') << doubleSize << " " << units[index];
+    return ss.str();
+}
+
+// an access log of @columnCnt columns, where every @quotedEvery-th column is quoted and contains the separator, and
+// no column is quoted if @quotedEvery is 0
+static std::string makeAccessLog(size_t columnCnt, size_t quotedEvery) {
+    static const std::vector<std::string> sFields = {"2024-04-07T08:02:40.873971412Z",
+                                                     "10.0.0.1",
+                                                     "GET",
+                                                     "/api/v1/namespaces/default/pods",
+                                                     "200",
+                                                     "1024",
+                                                     "0.024",
+                                                     "Mozilla/5.0 (X11; Linux x86_64)"};
+    std::string line;
+    for (size_t i = 0; i < columnCnt; ++i) {
+        if (i != 0) {
+            line += ',';
+        }
+        if (quotedEvery != 0 && i % quotedEvery == 0) {
+            line += "'" + sFields[i % sFields.size()] + ",-," + ToString(i) + "'";
+        } else {
+            line += sFields[i % sFields.size()];
+        }
+    }
+    return line;
+}
+
+static void BM_ParseDelimiter(SimdLevel level, size_t columnCnt, size_t quotedEvery, size_t lineCnt, int batchSize) {
+    Json::Value config;
+    config["SourceKey"] = "content";
+    config["Separator"] = ",";
+    config["Quote"] = "'";
+    config["Keys"] = Json::arrayValue;
+    for (size_t i = 0; i < columnCnt; ++i) {
+        config["Keys"].append("k" + ToString(i));
+    }
+    PipelineContext mContext;
+    mContext.SetConfigName("project##config_0");
+    ProcessorParseDelimiterNative& processor = *(new ProcessorParseDelimiterNative);
+    ProcessorInstance processorInstance(&processor, "testID");
+    if (!processorInstance.Init(config, mContext)) {
+        std::cout << "init processor failed" << std::endl;
+        return;
+    }
+
+    std::string line = makeAccessLog(columnCnt, quotedEvery);
+    SetSimdLevelForTest(level);
+    uint64_t durationTime = 0;
+    for (int i = 0; i < batchSize; i++) {
+        auto sourceBuffer = std::make_shared<SourceBuffer>();
+        PipelineEventGroup eventGroup(sourceBuffer);
+        for (size_t j = 0; j < lineCnt; ++j) {
+            eventGroup.AddLogEvent()->SetContentNoCopy(StringView("content"), StringView(line));
+        }
+
+        uint64_t startTime = GetCurrentTimeInMicroSeconds();
+        processor.Process(eventGroup);
+        durationTime += GetCurrentTimeInMicroSeconds() - startTime;
+    }
+    if (durationTime == 0) {
+        durationTime = 1;
+    }
+    std::cout << SimdLevelToString(GetSimdLevel()) << "\tcolumns: " << columnCnt << "\tquoted every: " << quotedEvery
+              << "\tline length: " << line.size() << "\tdurationTime: " << durationTime << "\tprocess: "
+              << formatSize(line.size() * lineCnt * (uint64_t)batchSize * 1000000 / durationTime) << "/s" << std::endl;
+}
+
+int main(int argc, char** argv) {
+    logtail::Logger::Instance().InitGlobalLoggers();
+#ifdef NDEBUG
+    std::cout << "release" << std::endl;
+#else
+    std::cout << "debug" << std::endl;
+#endif
+    std::vector<SimdLevel> levels = {SimdLevel::SCALAR, SimdLevel::SSE2, SimdLevel::AVX2};
+    for (size_t columnCnt : {10, 50, 100}) {
+        for (size_t quotedEvery : {0, 10, 2}) {
+            for (auto level : levels) {
+                BM_ParseDelimiter(level, columnCnt, quotedEvery, 1000, 100);
+            }
+        }
+    }
+    return 0;
+}
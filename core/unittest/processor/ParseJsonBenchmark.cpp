@@ -0,0 +1,108 @@
+// Copyright 2024 iLogtail Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <sstream>
+
+#include "config/Config.h"
+#include "models/LogEvent.h"
+#include "plugin/instance/ProcessorInstance.h"
+#include "processor/ProcessorParseJsonNative.h"
+#include "unittest/Unittest.h"
+
+
+using namespace logtail;
+
+
+std::string formatSize(long long size) {
+    static const char* units[] = {" B", "KB", "MB", "GB", "TB"};
+    int index = 0;
+    double doubleSize = static_cast<double>(size);
+    while (doubleSize >= 1024.0 && index < 4) {
+        doubleSize /= 1024.0;
+        index++;
+    }
+    std::ostringstream ss;
+    ss << std::fixed << std::setprecision(1) << std::setw(6) << std::setfill(' ') << doubleSize << " " << units[index];
+    return ss.str();
+}
+
+// a typical application log of about @logSize bytes, with a few escaped strings, numbers and a nested object
+static std::string MakeJsonLog(size_t logSize, bool escaped) {
+    std::string log
+        = R"({"time":"2024-04-07T08:02:40.873971412Z","level":"INFO","host":"host-192-168-0-1","pid":12345,)"
+          R"("thread":"http-nio-8080-exec-3","logger":"com.example.myproject.BookController","cost":0.035,)"
+          R"("success":true,"request":{"method":"POST","url":"/api/v1/books","status":200,"size":1024},"msg":")";
+    std::string msg = escaped ? R"(query \"select * from books\" returned\n)" : "query select * from books returned ";
+    size_t tail = strlen(R"("})");
+    while (log.size() + msg.size() + tail <= logSize) {
+        log += msg;
+    }
+    log += R"("})";
+    return log;
+}
+
+static void BM_ParseJson(size_t logSize, bool escaped, size_t logCnt, int batchSize) {
+    PipelineContext mContext;
+    mContext.SetConfigName("project##config_0");
+
+    Json::Value config;
+    config["SourceKey"] = "content";
+    config["KeepingSourceWhenParseFail"] = true;
+    config["KeepingSourceWhenParseSucceed"] = false;
+    ProcessorParseJsonNative processor;
+    processor.SetContext(mContext);
+    processor.SetMetricsRecordRef(ProcessorParseJsonNative::sName, "1");
+    if (!processor.Init(config)) {
+        std::cout << "init processor failed" << std::endl;
+        return;
+    }
+
+    std::string log = MakeJsonLog(logSize, escaped);
+    uint64_t durationTime = 0;
+    for (int i = 0; i < batchSize; i++) {
+        auto sourceBuffer = std::make_shared<SourceBuffer>();
+        PipelineEventGroup eventGroup(sourceBuffer);
+        for (size_t j = 0; j < logCnt; ++j) {
+            eventGroup.AddLogEvent()->SetContent(std::string("content"), log);
+        }
+
+        uint64_t startTime = GetCurrentTimeInMicroSeconds();
+        processor.Process(eventGroup);
+        durationTime += GetCurrentTimeInMicroSeconds() - startTime;
+    }
+    if (durationTime == 0) {
+        durationTime = 1;
+    }
+    std::cout << "log size: " << log.size() << "\tescaped: " << escaped << "\tdurationTime: " << durationTime
+              << "\tprocess: " << formatSize(log.size() * logCnt * (uint64_t)batchSize * 1000000 / durationTime)
+              << "/s\t" << logCnt * (uint64_t)batchSize * 1000000 / durationTime << " logs/s" << std::endl;
+}
+
+int main(int argc, char** argv) {
+    logtail::Logger::Instance().InitGlobalLoggers();
+#ifdef NDEBUG
+    std::cout << "release" << std::endl;
+#else
+    std::cout << "debug" << std::endl;
+#endif
+    std::vector<size_t> logSizes = {1024, 2048, 4096};
+    for (auto logSize : logSizes) {
+        BM_ParseJson(logSize, false, 1024, 100);
+        BM_ParseJson(logSize, true, 1024, 100);
+    }
+    return 0;
+}
@@ -29,6 +29,7 @@ public:
     void OnSuccessfulInit();
     void OnFailedInit();
     void TestLogFilterRule();
+    void TestLogFilterRuleWithRE2();
     void TestBaseFilter();
     void TestFilterNoneUtf8();
 
@@ -38,6 +39,7 @@ public:
 UNIT_TEST_CASE(ProcessorFilterNativeUnittest, OnSuccessfulInit)
 UNIT_TEST_CASE(ProcessorFilterNativeUnittest, OnFailedInit)
 UNIT_TEST_CASE(ProcessorFilterNativeUnittest, TestLogFilterRule)
+UNIT_TEST_CASE(ProcessorFilterNativeUnittest, TestLogFilterRuleWithRE2)
 UNIT_TEST_CASE(ProcessorFilterNativeUnittest, TestBaseFilter)
 UNIT_TEST_CASE(ProcessorFilterNativeUnittest, TestFilterNoneUtf8)
 
@@ -205,6 +207,95 @@ void ProcessorFilterNativeUnittest::TestLogFilterRule() {
     // judge result
     APSARA_TEST_STREQ_FATAL("null", CompactJson(outJson).c_str());
 }
+
+void ProcessorFilterNativeUnittest::TestLogFilterRuleWithRE2() {
+    Json::Value configJson;
+    string configStr, errorMsg;
+    configStr = R"(
+        {
+            "Type": "processor_filter_regex_native",
+            "FilterKey": [
+                "key1",
+                "key1",
+                "key2"
+            ],
+            "FilterRegex": [
+                ".*value1",
+                "abc.*",
+                "(x)\\1.*"
+            ],
+            "RegexEngine": "re2"
+        }
+    )";
+    APSARA_TEST_TRUE(ParseJsonTable(configStr, configJson, errorMsg));
+    ProcessorFilterNative& processor = *(new ProcessorFilterNative);
+    ProcessorInstance processorInstance(&processor, "testID");
+    APSARA_TEST_TRUE_FATAL(processorInstance.Init(configJson, mContext));
+    APSARA_TEST_TRUE(RegexEngine::RE2 == processor.mRegexEngine);
+    // the regexes of key1 are evaluated together, and the one of key2 is not supported by re2
+    APSARA_TEST_EQUAL(2U, processor.mFilterRule->KeyRegexSets.size());
+    APSARA_TEST_EQUAL(2U, processor.mFilterRule->KeyRegexSets[0].second->Size());
+
+    auto sourceBuffer = std::make_shared<SourceBuffer>();
+    PipelineEventGroup eventGroup(sourceBuffer);
+    std::string inJson = R"({
+        "events" :
+        [
+            {
+                "contents" :
+                {
+                    "key1" : "value1xxxxx",
+                    "key2" : "xxyyy"
+                },
+                "timestampNanosecond" : 0,
+                "timestamp" : 12345678901,
+                "type" : 1
+            },
+            {
+                "contents" :
+                {
+                    "key1" : "abcdeavalue1",
+                    "key2" : "xxyyy"
+                },
+                "timestampNanosecond" : 0,
+                "timestamp" : 12345678901,
+                "type" : 1
+            },
+            {
+                "contents" :
+                {
+                    "key1" : "abcdeavalue1",
+                    "key2" : "xyyyy"
+                },
+                "timestampNanosecond" : 0,
+                "timestamp" : 12345678901,
+                "type" : 1
+            }
+        ]
+    })";
+    eventGroup.FromJsonString(inJson);
+    std::vector<PipelineEventGroup> eventGroupList;
+    eventGroupList.emplace_back(std::move(eventGroup));
+    processorInstance.Process(eventGroupList);
+
+    std::string expectJson = R"({
+        "events" :
+        [
+            {
+                "contents" :
+                {
+                    "key1" : "abcdeavalue1",
+                    "key2" : "xxyyy"
+                },
+                "timestamp" : 12345678901,
+                "timestampNanosecond" : 0,
+                "type" : 1
+            }
+        ]
+    })";
+    APSARA_TEST_STREQ_FATAL(CompactJson(expectJson).c_str(), CompactJson(eventGroupList[0].ToJsonString()).c_str());
+}
+
 // To test bool ProcessorFilterNative::Filter(LogEvent& sourceEvent, const BaseFilterNodePtr& node)
 void ProcessorFilterNativeUnittest::TestBaseFilter() {
     // case 1
@@ -759,6 +759,7 @@ void ProcessorParseContainerLogNativeUnittest::TestContainerdLog() {
         // case3: PartLogFlag不存在，第二个空格存在
         // case4: 第二个空格不存在
         // case5: 第一个空格不存在
+        // case6: 第二个空格后紧跟空格
         PipelineEventGroup eventGroup(sourceBuffer);
         eventGroup.SetMetadata(EventGroupMetaKey::LOG_FORMAT, ProcessorParseContainerLogNative::CONTAINERD_TEXT);
         std::string inJson = R"({
@@ -808,6 +809,15 @@ void ProcessorParseContainerLogNativeUnittest::TestContainerdLog() {
                     "timestamp" : 12345678901,
                     "timestampNanosecond" : 0,
                     "type" : 1
+                },
+                {
+                    "contents" :
+                    {
+                        "content" : "2024-01-05T23:28:06.818486411+08:00 stdout   x"
+                    },
+                    "timestamp" : 12345678901,
+                    "timestampNanosecond" : 0,
+                    "type" : 1
                 }
             ]
         })";
@@ -869,6 +879,17 @@ void ProcessorParseContainerLogNativeUnittest::TestContainerdLog() {
                     "timestamp" : 12345678901,
                     "timestampNanosecond" : 0,
                     "type" : 1
+                },
+                {
+                    "contents" :
+                    {
+                        "_source_": "stdout",
+                        "_time_": "2024-01-05T23:28:06.818486411+08:00",
+                        "content": "  x"
+                    },
+                    "timestamp" : 12345678901,
+                    "timestampNanosecond" : 0,
+                    "type" : 1
                 }
             ],
             "metadata": {
@@ -2262,6 +2283,77 @@ void ProcessorParseContainerLogNativeUnittest::TestParseDockerLog() {
         APSARA_TEST_FALSE(result);
         delete[] buffer;
     }
+    // Test with surrogate pairs and malformed unicode escapes
+    {
+        DockerLog dockerLog;
+        std::string str
+            = R"({"log":"🌍 \ud83c \udf0d \uzzzz 中","stream":"stdout","time":"2021-12-01T00:00:00.000Z"})";
+        int32_t size = str.size();
+
+        char* buffer = new char[size + 1]();
+        strcpy(buffer, str.c_str());
+
+        bool result = ProcessorParseContainerLogNative::ParseDockerLog(buffer, size, dockerLog);
+
+        APSARA_TEST_TRUE(result);
+        APSARA_TEST_STREQ("🌍 \xEF\xBF\xBD \xEF\xBF\xBD \\uzzzz 中", dockerLog.log.to_string().c_str());
+        APSARA_TEST_EQUAL("stdout", dockerLog.stream);
+        APSARA_TEST_EQUAL("2021-12-01T00:00:00.000Z", dockerLog.time);
+        delete[] buffer;
+    }
+    // Test with a surrogate pair escaped as two code units
+    {
+        DockerLog dockerLog;
+        std::string str = R"({"log":"\ud83c\udf0d","stream":"stdout","time":"2021-12-01T00:00:00.000Z"})";
+        int32_t size = str.size();
+
+        char* buffer = new char[size + 1]();
+        strcpy(buffer, str.c_str());
+
+        bool result = ProcessorParseContainerLogNative::ParseDockerLog(buffer, size, dockerLog);
+
+        APSARA_TEST_TRUE(result);
+        APSARA_TEST_STREQ("🌍", dockerLog.log.to_string().c_str());
+        APSARA_TEST_EQUAL("stdout", dockerLog.stream);
+        APSARA_TEST_EQUAL("2021-12-01T00:00:00.000Z", dockerLog.time);
+        delete[] buffer;
+    }
+    // Test with a high surrogate followed by an escape truncated at the end of the value
+    {
+        DockerLog dockerLog;
+        std::string str = R"({"log":"\ud83c\u00","stream":"stdout","time":"2021-12-01T00:00:00.000Z"})";
+        int32_t size = str.size();
+
+        char* buffer = new char[size + 1]();
+        strcpy(buffer, str.c_str());
+
+        bool result = ProcessorParseContainerLogNative::ParseDockerLog(buffer, size, dockerLog);
+
+        APSARA_TEST_TRUE(result);
+        APSARA_TEST_STREQ("\xEF\xBF\xBD\\u00", dockerLog.log.to_string().c_str());
+        APSARA_TEST_EQUAL("stdout", dockerLog.stream);
+        APSARA_TEST_EQUAL("2021-12-01T00:00:00.000Z", dockerLog.time);
+        delete[] buffer;
+    }
+    // Test with escapes scattered over a long log, which are scanned in blocks
+    {
+        DockerLog dockerLog;
+        std::string plain(100, 'a');
+        std::string str = R"({"log":")" + plain + R"(\t)" + plain + R"(\"\\)" + plain
+            + R"(\n","stream":"stderr","time":"2021-12-01T00:00:00.000Z"})";
+        int32_t size = str.size();
+
+        char* buffer = new char[size + 1]();
+        strcpy(buffer, str.c_str());
+
+        bool result = ProcessorParseContainerLogNative::ParseDockerLog(buffer, size, dockerLog);
+
+        APSARA_TEST_TRUE(result);
+        APSARA_TEST_EQUAL(plain + "\t" + plain + "\"\\" + plain + "\n", dockerLog.log.to_string());
+        APSARA_TEST_EQUAL("stderr", dockerLog.stream);
+        APSARA_TEST_EQUAL("2021-12-01T00:00:00.000Z", dockerLog.time);
+        delete[] buffer;
+    }
 }
 
 } // namespace logtail
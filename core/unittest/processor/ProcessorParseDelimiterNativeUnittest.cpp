@@ -13,10 +13,14 @@
 // limitations under the License.
 
 #include <cstdlib>
+#include <random>
 
 #include "common/JsonUtil.h"
+#include "common/SimdUtil.h"
+#include "common/StringTools.h"
 #include "config/Config.h"
 #include "models/LogEvent.h"
+#include "parser/DelimiterModeFsmParser.h"
 #include "plugin/instance/ProcessorInstance.h"
 #include "processor/inner/ProcessorMergeMultilineLogNative.h"
 #include "processor/ProcessorParseDelimiterNative.h"
@@ -45,6 +49,8 @@ public:
     void TestProcessEventDiscardUnmatch();
     void TestAllowingShortenedFields();
     void TestExtend();
+    void TestProcessWideLine();
+    void TestStructuralIndexMatchesFsm();
     PipelineContext mContext;
 };
 
@@ -60,6 +66,8 @@ UNIT_TEST_CASE(ProcessorParseDelimiterNativeUnittest, TestProcessEventKeepUnmatc
 UNIT_TEST_CASE(ProcessorParseDelimiterNativeUnittest, TestProcessEventDiscardUnmatch);
 UNIT_TEST_CASE(ProcessorParseDelimiterNativeUnittest, TestAllowingShortenedFields);
 UNIT_TEST_CASE(ProcessorParseDelimiterNativeUnittest, TestExtend);
+UNIT_TEST_CASE(ProcessorParseDelimiterNativeUnittest, TestProcessWideLine);
+UNIT_TEST_CASE(ProcessorParseDelimiterNativeUnittest, TestStructuralIndexMatchesFsm);
 
 void ProcessorParseDelimiterNativeUnittest::TestAllowingShortenedFields() {
     // make config
@@ -2188,6 +2196,115 @@ void ProcessorParseDelimiterNativeUnittest::TestProcessEventDiscardUnmatch() {
     APSARA_TEST_EQUAL_FATAL(uint64_t(count), processor.mProcParseErrorTotal->GetValue());
 }
 
+void ProcessorParseDelimiterNativeUnittest::TestProcessWideLine() {
+    // quoted columns straddle the 64-byte blocks of the structural index
+    const size_t columnCnt = 60;
+    Json::Value config;
+    config["SourceKey"] = "content";
+    config["Separator"] = ",";
+    config["Quote"] = "'";
+    config["Keys"] = Json::arrayValue;
+    std::vector<std::string> expectedValues;
+    std::string line;
+    for (size_t i = 0; i < columnCnt; ++i) {
+        config["Keys"].append("k" + ToString(i));
+        std::string value;
+        if (i % 7 == 3) {
+            value = "GET,/index.html," + ToString(i);
+            line += "'" + value + "'";
+        } else if (i == 10) {
+            line += "''";
+        } else {
+            value = "v" + ToString(i);
+            line += value;
+        }
+        line += i + 1 == columnCnt ? "" : ",";
+        expectedValues.push_back(value);
+    }
+    config["KeepingSourceWhenParseFail"] = true;
+    config["KeepingSourceWhenParseSucceed"] = false;
+    config["RenamedSourceKey"] = "rawLog";
+
+    ProcessorParseDelimiterNative& processor = *(new ProcessorParseDelimiterNative);
+    std::string pluginId = "testID";
+    ProcessorInstance processorInstance(&processor, pluginId);
+    APSARA_TEST_TRUE_FATAL(processorInstance.Init(config, mContext));
+    {
+        auto sourceBuffer = std::make_shared<SourceBuffer>();
+        PipelineEventGroup eventGroup(sourceBuffer);
+        eventGroup.AddLogEvent()->SetContent(std::string("content"), line);
+        processor.Process(eventGroup);
+        const auto& event = eventGroup.GetEvents()[0].Cast<LogEvent>();
+        APSARA_TEST_EQUAL(columnCnt, event.Size());
+        for (size_t i = 0; i < columnCnt; ++i) {
+            APSARA_TEST_EQUAL(expectedValues[i], event.GetContent("k" + ToString(i)).to_string());
+        }
+    }
+    // a quote within a column is left to the FSM, which fails the line
+    {
+        std::string invalidLine = line + ",a'b";
+        auto sourceBuffer = std::make_shared<SourceBuffer>();
+        PipelineEventGroup eventGroup(sourceBuffer);
+        eventGroup.AddLogEvent()->SetContent(std::string("content"), invalidLine);
+        processor.Process(eventGroup);
+        const auto& event = eventGroup.GetEvents()[0].Cast<LogEvent>();
+        APSARA_TEST_EQUAL(1U, event.Size());
+        APSARA_TEST_EQUAL(invalidLine, event.GetContent("rawLog").to_string());
+    }
+}
+
+void ProcessorParseDelimiterNativeUnittest::TestStructuralIndexMatchesFsm() {
+    const char sep = ',';
+    const char quote = '\'';
+    const char chars[] = {sep, quote, 'a', ' '};
+    DelimiterModeFsmParser parser(quote, sep);
+    for (SimdLevel level : {SimdLevel::SCALAR, SimdLevel::SSE2, SimdLevel::AVX2}) {
+        SetSimdLevelForTest(level);
+        // the same lines for each level
+        std::mt19937 rng(20240101);
+        size_t structuralCnt = 0;
+        for (size_t i = 0; i < 20000; ++i) {
+            std::string line;
+            if (i % 2 == 0) {
+                // any chars, mostly handled by the FSM
+                line.resize(rng() % 200);
+                for (auto& c : line) {
+                    c = chars[rng() % 4];
+                }
+            } else {
+                // well-formed columns, some quoted with separators inside
+                size_t size = 40 + rng() % 160;
+                while (line.size() < size) {
+                    bool quoted = rng() % 2 == 0;
+                    std::string column(rng() % 40, 'a');
+                    for (auto& c : column) {
+                        // separators are only allowed in quoted columns
+                        c = quoted ? chars[(2 + rng() % 3) % 4] : chars[2 + rng() % 2];
+                    }
+                    line += quoted ? quote + column + quote : column;
+                    line += sep;
+                }
+                line.pop_back();
+            }
+            // lines over 64 bytes are classified in several blocks, and the range may start within a block
+            int begin = line.empty() ? 0 : static_cast<int>(rng() % std::min<size_t>(line.size(), 8));
+            int end = static_cast<int>(line.size());
+            std::vector<StringView> structuralValues, fsmValues;
+            if (!parser.ParseDelimiterLineByStructuralIndex(line.data(), begin, end, structuralValues)) {
+                continue;
+            }
+            ++structuralCnt;
+            APSARA_TEST_TRUE_FATAL(parser.ParseDelimiterLineByFsm(StringView(line), begin, end, fsmValues));
+            APSARA_TEST_EQUAL_FATAL(fsmValues.size(), structuralValues.size());
+            for (size_t j = 0; j < fsmValues.size(); ++j) {
+                APSARA_TEST_EQUAL_FATAL(fsmValues[j].to_string(), structuralValues[j].to_string());
+            }
+        }
+        APSARA_TEST_TRUE(structuralCnt > 5000);
+    }
+    SetSimdLevelForTest(SimdLevel::AVX2);
+}
+
 } // namespace logtail
 
 UNIT_TEST_MAIN
\ No newline at end of file
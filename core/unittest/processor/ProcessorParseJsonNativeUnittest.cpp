@@ -34,6 +34,7 @@ public:
     void TestProcessEventDiscardUnmatch();
     void TestProcessJsonContent();
     void TestProcessJsonRaw();
+    void TestProcessJsonEscape();
     void TestMultipleLines();
 
     PipelineContext mContext;
@@ -53,6 +54,8 @@ UNIT_TEST_CASE(ProcessorParseJsonNativeUnittest, TestProcessJsonContent);
 
 UNIT_TEST_CASE(ProcessorParseJsonNativeUnittest, TestProcessJsonRaw);
 
+UNIT_TEST_CASE(ProcessorParseJsonNativeUnittest, TestProcessJsonEscape);
+
 UNIT_TEST_CASE(ProcessorParseJsonNativeUnittest, TestMultipleLines);
 
 void ProcessorParseJsonNativeUnittest::TestMultipleLines() {
@@ -338,6 +341,68 @@ void ProcessorParseJsonNativeUnittest::TestProcessJson() {
     APSARA_TEST_GT_FATAL(processorInstance.mProcTimeMS->GetValue(), uint64_t(0));
 }
 
+void ProcessorParseJsonNativeUnittest::TestProcessJsonEscape() {
+    // make config
+    Json::Value config;
+    config["SourceKey"] = "content";
+    config["KeepingSourceWhenParseFail"] = true;
+    config["KeepingSourceWhenParseSucceed"] = false;
+    config["RenamedSourceKey"] = "rawLog";
+
+    // make events
+    // strings with escapes are unescaped, while the others are referenced in the original content, including those
+    // whose unescaped length happens to end right after an escaped quote, e.g. "\"\n"
+    auto sourceBuffer = std::make_shared<SourceBuffer>();
+    PipelineEventGroup eventGroup(sourceBuffer);
+    std::string inJson = R"({
+        "events" :
+        [
+            {
+                "contents" :
+                {
+                    "content" : "{\"msg\":\"say \\\"hi\\\"\",\"k\\\"ey\":\"\\u0041\",\"plain\":\"value\",\"empty\":null,\"neg\":-1,\"list\":[\"a\\\"b\",{}],\"k\":\"\\\"\\n\",\"\\\"\\t\":\"v\"}"
+                },
+                "timestampNanosecond" : 0,
+                "timestamp" : 12345678901,
+                "type" : 1
+            }
+        ]
+    })";
+    eventGroup.FromJsonString(inJson);
+    // run function
+    ProcessorParseJsonNative& processor = *(new ProcessorParseJsonNative);
+    std::string pluginId = "testID";
+    ProcessorInstance processorInstance(&processor, pluginId);
+    APSARA_TEST_TRUE_FATAL(processorInstance.Init(config, mContext));
+    std::vector<PipelineEventGroup> eventGroupList;
+    eventGroupList.emplace_back(std::move(eventGroup));
+    processorInstance.Process(eventGroupList);
+    // judge result
+    std::string expectJson = R"({
+        "events" :
+        [
+            {
+                "contents" :
+                {
+                    "\"\t" : "v",
+                    "empty" : "",
+                    "k" : "\"\n",
+                    "k\"ey" : "A",
+                    "list" : "[\"a\\\"b\",{}]",
+                    "msg" : "say \"hi\"",
+                    "neg" : "-1",
+                    "plain" : "value"
+                },
+                "timestamp" : 12345678901,
+                "timestampNanosecond" : 0,
+                "type" : 1
+            }
+        ]
+    })";
+    std::string outJson = eventGroupList[0].ToJsonString();
+    APSARA_TEST_STREQ_FATAL(CompactJson(expectJson).c_str(), CompactJson(outJson).c_str());
+}
+
 void ProcessorParseJsonNativeUnittest::TestProcessJsonContent() {
     // make config
     Json::Value config;
@@ -35,6 +35,7 @@ public:
     void TestProcessEventKeyCountUnmatch();
     void TestProcessRegexRaw();
     void TestProcessRegexContent();
+    void TestProcessRegexRE2();
 
 protected:
     void SetUp() override { ctx.SetConfigName("test_config"); }
@@ -680,6 +681,149 @@ void ProcessorParseRegexNativeUnittest::TestProcessEventKeyCountUnmatch() {
     APSARA_TEST_EQUAL_FATAL(count, processor.mProcKeyCountNotMatchErrorTotal->GetValue());
 }
 
+void ProcessorParseRegexNativeUnittest::TestProcessRegexRE2() {
+    // parses the events with the given engine, and returns the events as json
+    auto parse = [this](const std::string& regex,
+                        const std::vector<std::string>& keys,
+                        const std::string& engine,
+                        const std::string& inJson,
+                        bool& usingRE2) {
+        Json::Value config;
+        config["SourceKey"] = "content";
+        config["Regex"] = regex;
+        config["Keys"] = Json::arrayValue;
+        for (const auto& key : keys) {
+            config["Keys"].append(key);
+        }
+        config["KeepingSourceWhenParseFail"] = true;
+        config["KeepingSourceWhenParseSucceed"] = false;
+        config["RenamedSourceKey"] = "rawLog";
+        config["RegexEngine"] = engine;
+
+        auto sourceBuffer = std::make_shared<SourceBuffer>();
+        PipelineEventGroup eventGroup(sourceBuffer);
+        eventGroup.FromJsonString(inJson);
+        ProcessorParseRegexNative& processor = *(new ProcessorParseRegexNative);
+        std::string pluginId = "testID";
+        ProcessorInstance processorInstance(&processor, pluginId);
+        APSARA_TEST_TRUE(processorInstance.Init(config, ctx));
+        usingRE2 = processor.mRE2 != nullptr;
+        std::vector<PipelineEventGroup> eventGroupList;
+        eventGroupList.emplace_back(std::move(eventGroup));
+        processorInstance.Process(eventGroupList);
+        return CompactJson(eventGroupList[0].ToJsonString());
+    };
+
+    {
+        // the optional group does not match in the second event, and the third event does not match at all
+        std::string inJson = R"({
+            "events" :
+            [
+                {
+                    "contents" :
+                    {
+                        "content" : "abc 123 def"
+                    },
+                    "timestamp" : 12345678901,
+                    "type" : 1
+                },
+                {
+                    "contents" :
+                    {
+                        "content" : "abc def"
+                    },
+                    "timestamp" : 12345678901,
+                    "type" : 1
+                },
+                {
+                    "contents" :
+                    {
+                        "content" : "abc 123"
+                    },
+                    "timestamp" : 12345678901,
+                    "type" : 1
+                }
+            ]
+        })";
+        std::string expectJson = R"({
+            "events" :
+            [
+                {
+                    "contents" :
+                    {
+                        "key1" : "abc",
+                        "key2" : "123",
+                        "key3" : "def"
+                    },
+                    "timestamp" : 12345678901,
+                    "type" : 1
+                },
+                {
+                    "contents" :
+                    {
+                        "key1" : "abc",
+                        "key2" : "",
+                        "key3" : "def"
+                    },
+                    "timestamp" : 12345678901,
+                    "type" : 1
+                },
+                {
+                    "contents" :
+                    {
+                        "rawLog" : "abc 123"
+                    },
+                    "timestamp" : 12345678901,
+                    "type" : 1
+                }
+            ]
+        })";
+        std::string regex = R"((\w+)(?: (\d+))? ([a-z]+))";
+        std::vector<std::string> keys = {"key1", "key2", "key3"};
+        bool usingRE2 = false;
+        std::string boostJson = parse(regex, keys, "boost", inJson, usingRE2);
+        APSARA_TEST_FALSE(usingRE2);
+        std::string re2Json = parse(regex, keys, "re2", inJson, usingRE2);
+        APSARA_TEST_TRUE(usingRE2);
+        APSARA_TEST_EQUAL(CompactJson(expectJson), boostJson);
+        APSARA_TEST_EQUAL(boostJson, re2Json);
+    }
+    {
+        // back references are not supported by RE2, so boost is used instead
+        std::string inJson = R"({
+            "events" :
+            [
+                {
+                    "contents" :
+                    {
+                        "content" : "abc abc def"
+                    },
+                    "timestamp" : 12345678901,
+                    "type" : 1
+                },
+                {
+                    "contents" :
+                    {
+                        "content" : "abc xyz def"
+                    },
+                    "timestamp" : 12345678901,
+                    "type" : 1
+                }
+            ]
+        })";
+        std::string regex = R"((\w+) \1 (\w+))";
+        std::vector<std::string> keys = {"key1", "key2"};
+        bool usingRE2 = true;
+        std::string boostJson = parse(regex, keys, "boost", inJson, usingRE2);
+        APSARA_TEST_FALSE(usingRE2);
+        std::string re2Json = parse(regex, keys, "re2", inJson, usingRE2);
+        APSARA_TEST_FALSE(usingRE2);
+        APSARA_TEST_EQUAL(boostJson, re2Json);
+        APSARA_TEST_TRUE(re2Json.find(R"("key1":"abc","key2":"def")") != std::string::npos);
+        APSARA_TEST_TRUE(re2Json.find(R"("rawLog":"abc xyz def")") != std::string::npos);
+    }
+}
+
 UNIT_TEST_CASE(ProcessorParseRegexNativeUnittest, TestInit)
 UNIT_TEST_CASE(ProcessorParseRegexNativeUnittest, OnSuccessfulInit)
 UNIT_TEST_CASE(ProcessorParseRegexNativeUnittest, TestProcessWholeLine)
@@ -690,6 +834,7 @@ UNIT_TEST_CASE(ProcessorParseRegexNativeUnittest, TestProcessEventDiscardUnmatch
 UNIT_TEST_CASE(ProcessorParseRegexNativeUnittest, TestProcessEventKeyCountUnmatch)
 UNIT_TEST_CASE(ProcessorParseRegexNativeUnittest, TestProcessRegexRaw)
 UNIT_TEST_CASE(ProcessorParseRegexNativeUnittest, TestProcessRegexContent)
+UNIT_TEST_CASE(ProcessorParseRegexNativeUnittest, TestProcessRegexRE2)
 
 } // namespace logtail
 
@@ -0,0 +1,135 @@
+// Copyright 2024 iLogtail Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <sstream>
+
+#include "common/SimdUtil.h"
+#include "config/Config.h"
+#include "models/LogEvent.h"
+#include "processor/inner/ProcessorSplitLogStringNative.h"
+#include "unittest/Unittest.h"
+
+
+using namespace logtail;
+
+
+std::string formatSize(long long size) {
+    static const char* units[] = {" B", "KB", "MB", "GB", "TB"};
+    int index = 0;
+    double doubleSize = static_cast<double>(size);
+    while (doubleSize >= 1024.0 && index < 4) {
+        doubleSize /= 1024.0;
+        index++;
+    }
+    std::ostringstream ss;
+    ss << std::fixed << std::setprecision(1) << std::setw(6) << std::setfill(' ') << doubleSize << " " << units[index];
+    return ss.str();
+}
+
+// lines of @lineLength bytes (including the trailing \n) are concatenated into one block of about @blockSize bytes,
+// which is the same as what LogFileReader produces for single line logs.
+static void BM_SplitLogString(SimdLevel level, size_t lineLength, size_t blockSize, int batchSize) {
+    PipelineContext mContext;
+    mContext.SetConfigName("project##config_0");
+
+    Json::Value config;
+    ProcessorSplitLogStringNative processor;
+    processor.SetContext(mContext);
+    if (!processor.Init(config)) {
+        std::cout << "init processor failed" << std::endl;
+        return;
+    }
+
+    std::string line(lineLength - 1, 'a');
+    line += '\n';
+    std::string block;
+    while (block.size() + lineLength <= blockSize) {
+        block += line;
+    }
+    block.pop_back();
+
+    SetSimdLevelForTest(level);
+    uint64_t durationTime = 0;
+    for (int i = 0; i < batchSize; i++) {
+        auto sourceBuffer = std::make_shared<SourceBuffer>();
+        PipelineEventGroup eventGroup(sourceBuffer);
+        LogEvent* event = eventGroup.AddLogEvent();
+        event->SetContentNoCopy(StringView(DEFAULT_CONTENT_KEY), StringView(block));
+        event->SetPosition(0, block.size() + 1);
+
+        uint64_t startTime = GetCurrentTimeInMicroSeconds();
+        processor.Process(eventGroup);
+        durationTime += GetCurrentTimeInMicroSeconds() - startTime;
+    }
+    if (durationTime == 0) {
+        durationTime = 1;
+    }
+    std::cout << SimdLevelToString(GetSimdLevel()) << "\tline length: " << lineLength
+              << "\tdurationTime: " << durationTime << "\tprocess: "
+              << formatSize(block.size() * (uint64_t)batchSize * 1000000 / durationTime) << "/s" << std::endl;
+}
+
+// the raw scanning speed without event construction
+static void BM_FindAllOf(SimdLevel level, size_t lineLength, size_t blockSize, int batchSize) {
+    std::string line(lineLength - 1, 'a');
+    line += '\n';
+    std::string block;
+    while (block.size() + lineLength <= blockSize) {
+        block += line;
+    }
+
+    SetSimdLevelForTest(level);
+    std::vector<size_t> offsets;
+    offsets.reserve(block.size() / lineLength + 1);
+    uint64_t startTime = GetCurrentTimeInMicroSeconds();
+    for (int i = 0; i < batchSize; i++) {
+        offsets.clear();
+        FindAllOf(block.data(), block.size(), '\n', offsets);
+    }
+    uint64_t durationTime = GetCurrentTimeInMicroSeconds() - startTime;
+    if (durationTime == 0) {
+        durationTime = 1;
+    }
+    std::cout << SimdLevelToString(GetSimdLevel()) << "\tline length: " << lineLength
+              << "\tdurationTime: " << durationTime << "\tscan: "
+              << formatSize(block.size() * (uint64_t)batchSize * 1000000 / durationTime) << "/s" << std::endl;
+}
+
+int main(int argc, char** argv) {
+    logtail::Logger::Instance().InitGlobalLoggers();
+#ifdef NDEBUG
+    std::cout << "release" << std::endl;
+#else
+    std::cout << "debug" << std::endl;
+#endif
+    const size_t blockSize = 512 * 1024;
+    std::vector<size_t> lineLengths = {16, 64, 256, 1024, 4096};
+    std::vector<SimdLevel> levels = {SimdLevel::SCALAR, SimdLevel::SSE2, SimdLevel::AVX2};
+    std::cout << "BM_FindAllOf" << std::endl;
+    for (auto lineLength : lineLengths) {
+        for (auto level : levels) {
+            BM_FindAllOf(level, lineLength, blockSize, 1000);
+        }
+    }
+    std::cout << "BM_SplitLogString" << std::endl;
+    for (auto lineLength : lineLengths) {
+        for (auto level : levels) {
+            BM_SplitLogString(level, lineLength, blockSize, 100);
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,368 @@
+// Copyright 2024 iLogtail Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <atomic>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "common/FeedbackInterface.h"
+#include "models/PipelineEventGroup.h"
+#include "queue/ConcurrentProcessQueueManager.h"
+#include "queue/LockFreeRingBuffer.h"
+#include "queue/QueueKeyManager.h"
+#include "queue/QueueParam.h"
+#include "unittest/Unittest.h"
+
+using namespace std;
+
+namespace logtail {
+
+class CountingFeedbackInterface : public FeedbackInterface {
+public:
+    void Feedback(QueueKey key) override { ++mCnt; }
+
+    atomic_int mCnt{0};
+};
+
+class ConcurrentProcessQueueManagerUnittest : public testing::Test {
+public:
+    void TestRingBuffer();
+    void TestPushQueue();
+    void TestPopFromQueue();
+    void TestUpdateQueue();
+    void TestPopItem();
+    void TestPopItems();
+    void TestStealItem();
+    void TestConcurrentPushAndPop();
+
+protected:
+    void SetUp() override {
+        ProcessQueueParam::GetInstance()->SetParam(sCap, sLowWatermark, sHighWatermark);
+        mManager.reset(new ConcurrentProcessQueueManager(3));
+    }
+    void TearDown() override {
+        QueueKeyManager::GetInstance()->Clear();
+        ProcessQueueParam::GetInstance()->SetParam(20, 10, 15);
+    }
+
+private:
+    static unique_ptr<ProcessQueueItem> CreateItem(size_t index = 0) {
+        return unique_ptr<ProcessQueueItem>(
+            new ProcessQueueItem(PipelineEventGroup(make_shared<SourceBuffer>()), index));
+    }
+
+    static const size_t sCap = 6;
+    static const size_t sLowWatermark = 2;
+    static const size_t sHighWatermark = 4;
+
+    unique_ptr<ConcurrentProcessQueueManager> mManager;
+};
+
+void ConcurrentProcessQueueManagerUnittest::TestRingBuffer() {
+    LockFreeRingBuffer<unique_ptr<int>> buffer(3);
+    APSARA_TEST_EQUAL(4U, buffer.Capacity());
+    for (int i = 0; i < 4; ++i) {
+        APSARA_TEST_TRUE(buffer.TryPush(make_unique<int>(i)));
+    }
+    // item is kept when the buffer is full
+    auto extra = make_unique<int>(4);
+    APSARA_TEST_FALSE(buffer.TryPush(std::move(extra)));
+    APSARA_TEST_TRUE(extra != nullptr);
+
+    unique_ptr<int> item;
+    for (int i = 0; i < 4; ++i) {
+        APSARA_TEST_TRUE(buffer.TryPop(item));
+        APSARA_TEST_EQUAL(i, *item);
+    }
+    APSARA_TEST_FALSE(buffer.TryPop(item));
+
+    // wrap around
+    for (int lap = 0; lap < 3; ++lap) {
+        APSARA_TEST_TRUE(buffer.TryPush(make_unique<int>(lap)));
+        APSARA_TEST_TRUE(buffer.TryPop(item));
+        APSARA_TEST_EQUAL(lap, *item);
+    }
+}
+
+void ConcurrentProcessQueueManagerUnittest::TestPushQueue() {
+    ConcurrentProcessQueue que(sCap, sLowWatermark, sHighWatermark, 0, 0, "test_config");
+    CountingFeedbackInterface feedback;
+    vector<FeedbackInterface*> feedbacks{&feedback};
+    que.SetUpStreamFeedbacks(feedbacks);
+
+    for (size_t i = 0; i < sHighWatermark; ++i) {
+        APSARA_TEST_TRUE(que.Push(CreateItem()));
+    }
+    // now queue size comes to high watermark, push is forbidden and the item is kept
+    APSARA_TEST_FALSE(que.IsValidToPush());
+    auto item = CreateItem();
+    APSARA_TEST_FALSE(que.Push(std::move(item)));
+    APSARA_TEST_TRUE(item != nullptr);
+
+    // still not valid to push before low watermark is reached
+    unique_ptr<ProcessQueueItem> res;
+    APSARA_TEST_TRUE(que.Pop(res));
+    APSARA_TEST_FALSE(que.IsValidToPush());
+    APSARA_TEST_EQUAL(0, feedback.mCnt.load());
+    APSARA_TEST_TRUE(que.Pop(res));
+    // now queue size comes to low watermark, push can be resumed
+    APSARA_TEST_TRUE(que.IsValidToPush());
+    APSARA_TEST_EQUAL(1, feedback.mCnt.load());
+    APSARA_TEST_TRUE(que.Push(std::move(item)));
+}
+
+void ConcurrentProcessQueueManagerUnittest::TestPopFromQueue() {
+    ConcurrentProcessQueue que(sCap, sLowWatermark, sHighWatermark, 0, 0, "test_config");
+    SingleLogstoreSenderManager<SenderQueueParam> senderQueue;
+    vector<SingleLogstoreSenderManager<SenderQueueParam>*> queues{&senderQueue};
+    que.SetDownStreamQueues(queues);
+
+    unique_ptr<ProcessQueueItem> item;
+    // nothing to pop
+    APSARA_TEST_FALSE(que.Pop(item));
+
+    que.Push(CreateItem(1));
+    que.Push(CreateItem(2));
+    // invalidate pop
+    que.InvalidatePop();
+    APSARA_TEST_FALSE(que.Pop(item));
+    que.ValidatePop();
+
+    // downstream queues are not valid to push
+    senderQueue.mValid = false;
+    APSARA_TEST_FALSE(que.Pop(item));
+    senderQueue.mValid = true;
+
+    APSARA_TEST_TRUE(que.Pop(item));
+    APSARA_TEST_EQUAL(1U, item->mInputIndex);
+    APSARA_TEST_TRUE(que.Pop(item));
+    APSARA_TEST_EQUAL(2U, item->mInputIndex);
+    APSARA_TEST_TRUE(que.Empty());
+}
+
+void ConcurrentProcessQueueManagerUnittest::TestUpdateQueue() {
+    // create queue
+    APSARA_TEST_TRUE(mManager->CreateOrUpdateQueue(0, 0));
+    APSARA_TEST_TRUE(mManager->CreateOrUpdateQueue(1, 0));
+    APSARA_TEST_EQUAL(2U, mManager->GetCnt());
+    APSARA_TEST_EQUAL(2U, mManager->mSnapshot->mPriorityQueues[0].size());
+    APSARA_TEST_TRUE(mManager->FindQueue(0) != nullptr);
+    APSARA_TEST_TRUE(mManager->FindQueue(2) == nullptr);
+
+    // update queue with same priority
+    APSARA_TEST_FALSE(mManager->CreateOrUpdateQueue(0, 0));
+
+    // update queue with different priority, the queue and its items are kept
+    APSARA_TEST_EQUAL(0, mManager->PushQueue(0, CreateItem()));
+    auto que = mManager->FindQueue(0);
+    APSARA_TEST_TRUE(mManager->CreateOrUpdateQueue(0, 1));
+    APSARA_TEST_EQUAL(que, mManager->FindQueue(0));
+    APSARA_TEST_EQUAL(1U, que->GetPriority());
+    APSARA_TEST_EQUAL(1U, mManager->mSnapshot->mPriorityQueues[0].size());
+    APSARA_TEST_EQUAL(1U, mManager->mSnapshot->mPriorityQueues[1].size());
+    APSARA_TEST_FALSE(mManager->IsAllQueueEmpty());
+
+    // delete queue
+    APSARA_TEST_TRUE(mManager->DeleteQueue(0));
+    APSARA_TEST_FALSE(mManager->DeleteQueue(0));
+    APSARA_TEST_EQUAL(1U, mManager->GetCnt());
+    APSARA_TEST_EQUAL(0U, mManager->mSnapshot->mPriorityQueues[1].size());
+    APSARA_TEST_TRUE(mManager->FindQueue(0) == nullptr);
+    APSARA_TEST_EQUAL(2, mManager->PushQueue(0, CreateItem()));
+    APSARA_TEST_TRUE(mManager->IsAllQueueEmpty());
+}
+
+void ConcurrentProcessQueueManagerUnittest::TestPopItem() {
+    QueueKey key0 = QueueKeyManager::GetInstance()->GetKey("test_config_0");
+    QueueKey key1 = QueueKeyManager::GetInstance()->GetKey("test_config_1");
+    QueueKey key2 = QueueKeyManager::GetInstance()->GetKey("test_config_2");
+    mManager->CreateOrUpdateQueue(key0, 0);
+    mManager->CreateOrUpdateQueue(key1, 1);
+    mManager->CreateOrUpdateQueue(key2, 1);
+
+    mManager->PushQueue(key1, CreateItem());
+    mManager->PushQueue(key2, CreateItem());
+    mManager->PushQueue(key1, CreateItem());
+    mManager->PushQueue(key0, CreateItem());
+
+    unique_ptr<ProcessQueueItem> item;
+    string configName;
+    // only queues with the given priority are consulted
+    APSARA_TEST_TRUE(mManager->PopItem(0, 1, 1, item, configName));
+    APSARA_TEST_EQUAL("test_config_1", configName);
+    // round robin among queues with the same priority
+    APSARA_TEST_TRUE(mManager->PopItem(0, 1, 1, item, configName));
+    APSARA_TEST_EQUAL("test_config_2", configName);
+    APSARA_TEST_TRUE(mManager->PopItem(0, 1, 1, item, configName));
+    APSARA_TEST_EQUAL("test_config_1", configName);
+    APSARA_TEST_FALSE(mManager->PopItem(0, 1, 1, item, configName));
+    APSARA_TEST_TRUE(mManager->PopItem(0, 1, 0, item, configName));
+    APSARA_TEST_EQUAL("test_config_0", configName);
+
+    // invalidate pop
+    mManager->PushQueue(key0, CreateItem());
+    mManager->FindQueue(key0)->InvalidatePop();
+    APSARA_TEST_FALSE(mManager->PopItem(0, 1, 0, item, configName));
+    mManager->FindQueue(key0)->ValidatePop();
+    APSARA_TEST_TRUE(mManager->PopItem(0, 1, 0, item, configName));
+}
+
+void ConcurrentProcessQueueManagerUnittest::TestPopItems() {
+    QueueKey key1 = QueueKeyManager::GetInstance()->GetKey("test_config_1");
+    QueueKey key2 = QueueKeyManager::GetInstance()->GetKey("test_config_2");
+    mManager->CreateOrUpdateQueue(key1, 0);
+    mManager->CreateOrUpdateQueue(key2, 0);
+    for (size_t i = 0; i < 3; ++i) {
+        mManager->PushQueue(key1, CreateItem(i));
+    }
+    mManager->PushQueue(key2, CreateItem());
+
+    vector<unique_ptr<ProcessQueueItem>> items;
+    string configName;
+    // items come from the same queue in order
+    APSARA_TEST_TRUE(mManager->PopItems(0, 1, 0, 2, 1024 * 1024, items, configName));
+    APSARA_TEST_EQUAL("test_config_1", configName);
+    APSARA_TEST_EQUAL(2U, items.size());
+    APSARA_TEST_EQUAL(0U, items[0]->mInputIndex);
+    APSARA_TEST_EQUAL(1U, items[1]->mInputIndex);
+    APSARA_TEST_EQUAL(1U, mManager->FindQueue(key1)->mSize.load());
+
+    // the queue is empty before the count limit is reached
+    items.clear();
+    APSARA_TEST_TRUE(mManager->PopItems(0, 1, 0, 10, 1024 * 1024, items, configName));
+    APSARA_TEST_EQUAL("test_config_2", configName);
+    APSARA_TEST_EQUAL(1U, items.size());
+
+    // the byte limit is reached by the first item
+    mManager->PushQueue(key1, CreateItem(3));
+    items.clear();
+    APSARA_TEST_TRUE(mManager->PopItems(0, 1, 0, 10, 1, items, configName));
+    APSARA_TEST_EQUAL("test_config_1", configName);
+    APSARA_TEST_EQUAL(1U, items.size());
+    APSARA_TEST_EQUAL(2U, items[0]->mInputIndex);
+
+    items.clear();
+    APSARA_TEST_TRUE(mManager->PopItems(0, 1, 0, 10, 1024 * 1024, items, configName));
+    APSARA_TEST_EQUAL(1U, items.size());
+    APSARA_TEST_EQUAL(3U, items[0]->mInputIndex);
+    APSARA_TEST_FALSE(mManager->PopItems(0, 1, 0, 10, 1024 * 1024, items, configName));
+}
+
+void ConcurrentProcessQueueManagerUnittest::TestStealItem() {
+    vector<QueueKey> keys;
+    for (size_t i = 0; i < 4; ++i) {
+        keys.push_back(QueueKeyManager::GetInstance()->GetKey("test_config_" + to_string(i)));
+        mManager->CreateOrUpdateQueue(keys.back(), 0);
+    }
+    for (auto key : keys) {
+        mManager->PushQueue(key, CreateItem());
+    }
+
+    // with 2 threads, thread 1 owns queue 1 and 3, and pops from them first
+    unique_ptr<ProcessQueueItem> item;
+    string configName;
+    APSARA_TEST_TRUE(mManager->PopItem(1, 2, 0, item, configName));
+    APSARA_TEST_EQUAL("test_config_1", configName);
+    APSARA_TEST_TRUE(mManager->PopItem(1, 2, 0, item, configName));
+    APSARA_TEST_EQUAL("test_config_3", configName);
+    // then steals from queues owned by thread 0
+    APSARA_TEST_TRUE(mManager->PopItem(1, 2, 0, item, configName));
+    APSARA_TEST_EQUAL("test_config_0", configName);
+    APSARA_TEST_TRUE(mManager->PopItem(1, 2, 0, item, configName));
+    APSARA_TEST_EQUAL("test_config_2", configName);
+    APSARA_TEST_FALSE(mManager->PopItem(1, 2, 0, item, configName));
+}
+
+void ConcurrentProcessQueueManagerUnittest::TestConcurrentPushAndPop() {
+    ProcessQueueParam::GetInstance()->SetParam(64, 16, 48);
+    const size_t queueCnt = 8;
+    const size_t producerCnt = 4;
+    const size_t consumerCnt = 4;
+    const size_t itemCntPerProducer = 20000;
+    vector<QueueKey> keys;
+    for (size_t i = 0; i < queueCnt; ++i) {
+        keys.push_back(QueueKeyManager::GetInstance()->GetKey("test_config_" + to_string(i)));
+        mManager->CreateOrUpdateQueue(keys.back(), i % 2);
+    }
+    vector<unique_ptr<CountingFeedbackInterface>> feedbacks;
+    for (auto key : keys) {
+        feedbacks.emplace_back(new CountingFeedbackInterface);
+        vector<FeedbackInterface*> tmp{feedbacks.back().get()};
+        mManager->FindQueue(key)->SetUpStreamFeedbacks(tmp);
+    }
+
+    atomic_size_t poppedCnt{0};
+    atomic_size_t poppedSum{0};
+    atomic_bool stop{false};
+    vector<thread> consumers;
+    for (size_t i = 0; i < consumerCnt; ++i) {
+        consumers.emplace_back([&, i]() {
+            unique_ptr<ProcessQueueItem> item;
+            string configName;
+            while (!stop || !mManager->IsAllQueueEmpty()) {
+                bool popped = false;
+                for (uint32_t priority = 0; priority <= 1 && !popped; ++priority) {
+                    popped = mManager->PopItem(i, consumerCnt, priority, item, configName);
+                }
+                if (popped) {
+                    ++poppedCnt;
+                    poppedSum += item->mInputIndex;
+                } else {
+                    this_thread::yield();
+                }
+            }
+        });
+    }
+    vector<thread> producers;
+    for (size_t i = 0; i < producerCnt; ++i) {
+        producers.emplace_back([&, i]() {
+            for (size_t j = 0; j < itemCntPerProducer; ++j) {
+                auto item = CreateItem(j);
+                // retry until the queue is valid to push, like LogProcess::PushBuffer
+                while (mManager->PushQueue(keys[(i + j) % queueCnt], std::move(item)) != 0) {
+                    this_thread::yield();
+                }
+            }
+        });
+    }
+    for (auto& t : producers) {
+        t.join();
+    }
+    stop = true;
+    for (auto& t : consumers) {
+        t.join();
+    }
+
+    APSARA_TEST_EQUAL(producerCnt * itemCntPerProducer, poppedCnt.load());
+    APSARA_TEST_EQUAL(producerCnt * itemCntPerProducer * (itemCntPerProducer - 1) / 2, poppedSum.load());
+    for (size_t i = 0; i < queueCnt; ++i) {
+        // no queue is left blocked
+        APSARA_TEST_TRUE(mManager->FindQueue(keys[i])->IsValidToPush());
+        APSARA_TEST_TRUE(mManager->FindQueue(keys[i])->Empty());
+    }
+}
+
+UNIT_TEST_CASE(ConcurrentProcessQueueManagerUnittest, TestRingBuffer)
+UNIT_TEST_CASE(ConcurrentProcessQueueManagerUnittest, TestPushQueue)
+UNIT_TEST_CASE(ConcurrentProcessQueueManagerUnittest, TestPopFromQueue)
+UNIT_TEST_CASE(ConcurrentProcessQueueManagerUnittest, TestUpdateQueue)
+UNIT_TEST_CASE(ConcurrentProcessQueueManagerUnittest, TestPopItem)
+UNIT_TEST_CASE(ConcurrentProcessQueueManagerUnittest, TestPopItems)
+UNIT_TEST_CASE(ConcurrentProcessQueueManagerUnittest, TestStealItem)
+UNIT_TEST_CASE(ConcurrentProcessQueueManagerUnittest, TestConcurrentPushAndPop)
+
+} // namespace logtail
+
+UNIT_TEST_MAIN
@@ -0,0 +1,132 @@
+// Copyright 2024 iLogtail Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <atomic>
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "common/Flags.h"
+#include "common/TimeUtil.h"
+#include "models/PipelineEventGroup.h"
+#include "queue/ProcessQueueManager.h"
+#include "queue/QueueKeyManager.h"
+#include "queue/QueueParam.h"
+
+DECLARE_FLAG_INT32(process_thread_count);
+
+namespace logtail {
+
+class ProcessQueueManagerBenchmark {
+public:
+    // producers push to all queues in turn like input threads, consumers pop like process threads
+    void TestContention(bool concurrent, size_t queueCnt, size_t producerCnt, size_t consumerCnt);
+};
+
+void ProcessQueueManagerBenchmark::TestContention(bool concurrent,
+                                                  size_t queueCnt,
+                                                  size_t producerCnt,
+                                                  size_t consumerCnt) {
+    // SetUp
+    const size_t itemCntPerProducer = 200000;
+    ProcessQueueManager* manager = ProcessQueueManager::GetInstance();
+    manager->Clear();
+    if (concurrent) {
+        manager->mConcurrentQueueManager.reset(new ConcurrentProcessQueueManager(ProcessQueueManager::sMaxPriority));
+    } else {
+        manager->mConcurrentQueueManager.reset();
+    }
+    INT32_FLAG(process_thread_count) = consumerCnt;
+    ProcessQueueParam::GetInstance()->SetParam(256, 64, 192);
+    std::vector<QueueKey> keys;
+    for (size_t i = 0; i < queueCnt; ++i) {
+        keys.push_back(QueueKeyManager::GetInstance()->GetKey("benchmark_config_" + std::to_string(i)));
+        manager->CreateOrUpdateQueue(keys.back(), 0);
+    }
+    auto sourceBuffer = std::make_shared<SourceBuffer>();
+    std::vector<std::vector<std::unique_ptr<ProcessQueueItem>>> items(producerCnt);
+    for (auto& producerItems : items) {
+        for (size_t i = 0; i < itemCntPerProducer; ++i) {
+            producerItems.emplace_back(new ProcessQueueItem(PipelineEventGroup(sourceBuffer), 0));
+        }
+    }
+
+    // Test
+    std::atomic_bool stop{false};
+    std::atomic_size_t poppedCnt{0};
+    uint64_t starttime = GetCurrentTimeInMicroSeconds();
+    std::vector<std::thread> consumers;
+    for (size_t i = 0; i < consumerCnt; ++i) {
+        consumers.emplace_back([&, i]() {
+            std::unique_ptr<ProcessQueueItem> item;
+            std::string configName;
+            size_t cnt = 0;
+            while (!stop || !manager->IsAllQueueEmpty()) {
+                if (!manager->PopItem(i, item, configName)) {
+                    manager->Wait(10);
+                    continue;
+                }
+                ++cnt;
+            }
+            poppedCnt += cnt;
+        });
+    }
+    std::vector<std::thread> producers;
+    for (size_t i = 0; i < producerCnt; ++i) {
+        producers.emplace_back([&, i]() {
+            size_t queueIdx = i;
+            for (auto& item : items[i]) {
+                while (manager->PushQueue(keys[queueIdx % queueCnt], std::move(item)) != 0) {
+                    std::this_thread::yield();
+                }
+                ++queueIdx;
+            }
+        });
+    }
+    for (auto& t : producers) {
+        t.join();
+    }
+    stop = true;
+    manager->Trigger();
+    for (auto& t : consumers) {
+        t.join();
+    }
+    uint64_t timeelapsed = GetCurrentTimeInMicroSeconds() - starttime;
+    printf("%s %s queues %zu producers %zu consumers %zu: %.2fM items/s (%zu)\n",
+           __func__,
+           concurrent ? "concurrent" : "locked",
+           queueCnt,
+           producerCnt,
+           consumerCnt,
+           1.0 * poppedCnt / (timeelapsed ? timeelapsed : 1),
+           poppedCnt.load());
+
+    // TearDown
+    manager->Clear();
+    manager->mConcurrentQueueManager.reset();
+    QueueKeyManager::GetInstance()->Clear();
+}
+
+} // namespace logtail
+
+int main(int argc, char* argv[]) {
+    logtail::ProcessQueueManagerBenchmark benchmark;
+    for (size_t consumerCnt : {1, 2, 4, 8, 16}) {
+        benchmark.TestContention(false, 32, 4, consumerCnt);
+        benchmark.TestContention(true, 32, 4, consumerCnt);
+    }
+    return 0;
+}
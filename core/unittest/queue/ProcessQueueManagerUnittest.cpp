@@ -14,6 +14,7 @@
 
 #include <memory>
 
+#include "common/memory/MemoryBudgetManager.h"
 #include "models/PipelineEventGroup.h"
 #include "queue/ExactlyOnceQueueManager.h"
 #include "queue/ProcessQueueManager.h"
@@ -30,7 +31,9 @@ public:
     void TestSetQueueUpstreamAndDownStream();
     void TestPushQueue();
     void TestPopItem();
+    void TestPopItems();
     void TestIsAllQueueEmpty();
+    void TestMemoryBudget();
     void OnPipelineUpdate();
 
 protected:
@@ -39,6 +42,12 @@ protected:
         QueueKeyManager::GetInstance()->Clear();
         sProcessQueueManager->Clear();
         ExactlyOnceQueueManager::GetInstance()->Clear();
+        MemoryBudgetManager::GetInstance()->Clear();
+    }
+
+    static unique_ptr<ProcessQueueItem> CreateItem(size_t index) {
+        return unique_ptr<ProcessQueueItem>(
+            new ProcessQueueItem(PipelineEventGroup(make_shared<SourceBuffer>()), index));
     }
 
 private:
@@ -269,6 +278,58 @@ void ProcessQueueManagerUnittest::TestPopItem() {
     APSARA_TEST_TRUE(sProcessQueueManager->mCurrentQueueIndex.second == sProcessQueueManager->mQueues[key1]);
 }
 
+void ProcessQueueManagerUnittest::TestPopItems() {
+    vector<unique_ptr<ProcessQueueItem>> items;
+    string configName;
+
+    QueueKey key1 = QueueKeyManager::GetInstance()->GetKey("test_config_1");
+    QueueKey key2 = QueueKeyManager::GetInstance()->GetKey("test_config_2");
+    sProcessQueueManager->CreateOrUpdateQueue(key1, 0);
+    sProcessQueueManager->CreateOrUpdateQueue(key2, 0);
+    ExactlyOnceQueueManager::GetInstance()->CreateOrUpdateQueue(5, 1, "test_config_5", vector<RangeCheckpointPtr>(5));
+    for (size_t i = 0; i < 3; ++i) {
+        sProcessQueueManager->PushQueue(key1, CreateItem(i));
+    }
+    sProcessQueueManager->PushQueue(key2,
+                                    unique_ptr<ProcessQueueItem>(new ProcessQueueItem(std::move(*sEventGroup), 0)));
+
+    // items come from the same queue in order, and current index moves to the next queue
+    APSARA_TEST_TRUE(sProcessQueueManager->PopItems(0, 2, 1024 * 1024, items, configName));
+    APSARA_TEST_EQUAL("test_config_1", configName);
+    APSARA_TEST_EQUAL(2U, items.size());
+    APSARA_TEST_EQUAL(0U, items[0]->mInputIndex);
+    APSARA_TEST_EQUAL(1U, items[1]->mInputIndex);
+    APSARA_TEST_TRUE(sProcessQueueManager->mCurrentQueueIndex.second == sProcessQueueManager->mQueues[key2]);
+
+    // the queue is empty before the count limit is reached
+    items.clear();
+    APSARA_TEST_TRUE(sProcessQueueManager->PopItems(0, 10, 1024 * 1024, items, configName));
+    APSARA_TEST_EQUAL("test_config_2", configName);
+    APSARA_TEST_EQUAL(1U, items.size());
+
+    // the byte limit is reached by the first item
+    sProcessQueueManager->PushQueue(key1, CreateItem(3));
+    items.clear();
+    APSARA_TEST_TRUE(sProcessQueueManager->PopItems(0, 10, 1, items, configName));
+    APSARA_TEST_EQUAL("test_config_1", configName);
+    APSARA_TEST_EQUAL(1U, items.size());
+    APSARA_TEST_EQUAL(2U, items[0]->mInputIndex);
+    items.clear();
+    APSARA_TEST_TRUE(sProcessQueueManager->PopItems(0, 10, 1024 * 1024, items, configName));
+    APSARA_TEST_EQUAL(1U, items.size());
+    APSARA_TEST_EQUAL(3U, items[0]->mInputIndex);
+
+    // items come from exactly once queue
+    for (size_t i = 0; i < 2; ++i) {
+        sProcessQueueManager->PushQueue(5, CreateItem(i));
+    }
+    items.clear();
+    APSARA_TEST_TRUE(sProcessQueueManager->PopItems(0, 10, 1024 * 1024, items, configName));
+    APSARA_TEST_EQUAL("test_config_5", configName);
+    APSARA_TEST_EQUAL(2U, items.size());
+    APSARA_TEST_FALSE(sProcessQueueManager->PopItems(0, 10, 1024 * 1024, items, configName));
+}
+
 void ProcessQueueManagerUnittest::TestIsAllQueueEmpty() {
     sProcessQueueManager->CreateOrUpdateQueue(0, 0);
     sProcessQueueManager->CreateOrUpdateQueue(1, 1);
@@ -293,6 +354,39 @@ void ProcessQueueManagerUnittest::TestIsAllQueueEmpty() {
     APSARA_TEST_TRUE(sProcessQueueManager->IsAllQueueEmpty());
 }
 
+void ProcessQueueManagerUnittest::TestMemoryBudget() {
+    QueueKey key = QueueKeyManager::GetInstance()->GetKey("test_config");
+    // pipelines without priority configured are not of low priority
+    sProcessQueueManager->CreateOrUpdateQueue(key, ProcessQueueManager::sMaxPriority);
+    auto budget = MemoryBudgetManager::GetInstance()->GetBudget("test_config");
+    APSARA_TEST_NOT_EQUAL(nullptr, budget);
+    APSARA_TEST_FALSE(budget->IsLowPriority());
+    sProcessQueueManager->CreateOrUpdateQueue(key, ProcessQueueManager::sMaxPriority - 1, true);
+    APSARA_TEST_TRUE(budget->IsLowPriority());
+    sProcessQueueManager->CreateOrUpdateQueue(key, 0);
+    APSARA_TEST_FALSE(budget->IsLowPriority());
+
+    auto item = CreateItem(0);
+    int64_t size = item->mEventGroup.GetSourceBuffer()->GetAllocatedSize();
+    // the pipeline limit is exactly the size of one item
+    MemoryBudgetManager::GetInstance()->SetGlobalLimit(size * 2);
+    APSARA_TEST_TRUE(sProcessQueueManager->IsValidToPush(key));
+    sProcessQueueManager->PushQueue(key, std::move(item));
+    APSARA_TEST_EQUAL(size, budget->GetUsage());
+    APSARA_TEST_FALSE(sProcessQueueManager->IsValidToPush(key));
+
+    // the item is charged until it is destroyed after processing
+    string configName;
+    sProcessQueueManager->PopItem(0, item, configName);
+    APSARA_TEST_FALSE(sProcessQueueManager->IsValidToPush(key));
+    item.reset();
+    APSARA_TEST_EQUAL(0, budget->GetUsage());
+    APSARA_TEST_TRUE(sProcessQueueManager->IsValidToPush(key));
+
+    sProcessQueueManager->DeleteQueue(key);
+    APSARA_TEST_EQUAL(nullptr, MemoryBudgetManager::GetInstance()->GetBudget("test_config"));
+}
+
 void ProcessQueueManagerUnittest::OnPipelineUpdate() {
     QueueKey key = QueueKeyManager::GetInstance()->GetKey("test_config_1");
     sProcessQueueManager->CreateOrUpdateQueue(key, 0);
@@ -319,7 +413,9 @@ UNIT_TEST_CASE(ProcessQueueManagerUnittest, TestDeleteQueue)
 UNIT_TEST_CASE(ProcessQueueManagerUnittest, TestSetQueueUpstreamAndDownStream)
 UNIT_TEST_CASE(ProcessQueueManagerUnittest, TestPushQueue)
 UNIT_TEST_CASE(ProcessQueueManagerUnittest, TestPopItem)
+UNIT_TEST_CASE(ProcessQueueManagerUnittest, TestPopItems)
 UNIT_TEST_CASE(ProcessQueueManagerUnittest, TestIsAllQueueEmpty)
+UNIT_TEST_CASE(ProcessQueueManagerUnittest, TestMemoryBudget)
 UNIT_TEST_CASE(ProcessQueueManagerUnittest, OnPipelineUpdate)
 
 } // namespace logtail
@@ -0,0 +1,141 @@
+// Copyright 2024 iLogtail Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <string>
+
+#include "common/Flags.h"
+#include "sender/BufferFileReader.h"
+#include "sender/BufferFileWriter.h"
+#include "unittest/Unittest.h"
+
+DECLARE_FLAG_INT32(buffer_file_write_batch_size);
+
+namespace logtail {
+
+class BufferFileUnittest : public ::testing::Test {
+public:
+    void TestAppend();
+    void TestSwitchFile();
+    void TestReader();
+
+protected:
+    void SetUp() override {
+        mFileName = "buffer_file_unittest_0";
+        mFileName2 = "buffer_file_unittest_1";
+        remove(mFileName.c_str());
+        remove(mFileName2.c_str());
+        mBatchSize = INT32_FLAG(buffer_file_write_batch_size);
+        INT32_FLAG(buffer_file_write_batch_size) = 16;
+    }
+
+    void TearDown() override {
+        remove(mFileName.c_str());
+        remove(mFileName2.c_str());
+        INT32_FLAG(buffer_file_write_batch_size) = mBatchSize;
+    }
+
+    static std::string ReadFile(const std::string& fileName) {
+        std::ifstream fin(fileName, std::ios::binary);
+        std::stringstream ss;
+        ss << fin.rdbuf();
+        return ss.str();
+    }
+
+    std::string mFileName;
+    std::string mFileName2;
+    int32_t mBatchSize = 0;
+};
+
+void BufferFileUnittest::TestAppend() {
+    BufferFileWriter writer;
+    APSARA_TEST_TRUE(writer.Open(mFileName));
+    APSARA_TEST_EQUAL(0, writer.GetFileSize());
+    // batched
+    APSARA_TEST_TRUE(writer.Append({StringView("header")}));
+    APSARA_TEST_EQUAL(6, writer.GetFileSize());
+    APSARA_TEST_EQUAL("", ReadFile(mFileName));
+    // not split, the batch is written before the record
+    APSARA_TEST_TRUE(writer.Append({StringView("meta"), StringView("-"), StringView("data")}));
+    APSARA_TEST_TRUE(writer.Append({StringView("0123456789abcdef")}));
+    APSARA_TEST_EQUAL("headermeta-data0123456789abcdef", ReadFile(mFileName));
+    APSARA_TEST_EQUAL(0U, writer.mBuffer.size());
+    APSARA_TEST_TRUE(writer.Append({StringView("tail")}));
+    APSARA_TEST_EQUAL(35, writer.GetFileSize());
+    APSARA_TEST_TRUE(writer.Flush(true));
+    APSARA_TEST_EQUAL("headermeta-data0123456789abcdeftail", ReadFile(mFileName));
+    APSARA_TEST_EQUAL(35U, writer.ExchangeWrittenBytes());
+    APSARA_TEST_EQUAL(0U, writer.ExchangeWrittenBytes());
+    writer.Close();
+    APSARA_TEST_FALSE(writer.IsOpen());
+    APSARA_TEST_FALSE(writer.Append({StringView("lost")}));
+
+    // appended to the existing file
+    APSARA_TEST_TRUE(writer.Open(mFileName));
+    APSARA_TEST_EQUAL(35, writer.GetFileSize());
+    APSARA_TEST_TRUE(writer.Append({StringView("more")}));
+    writer.Close();
+    APSARA_TEST_EQUAL("headermeta-data0123456789abcdeftailmore", ReadFile(mFileName));
+}
+
+void BufferFileUnittest::TestSwitchFile() {
+    BufferFileWriter writer;
+    APSARA_TEST_TRUE(writer.Open(mFileName));
+    APSARA_TEST_TRUE(writer.Append({StringView("first")}));
+    // the same file
+    APSARA_TEST_TRUE(writer.Open(mFileName));
+    APSARA_TEST_EQUAL(5, writer.GetFileSize());
+    // the last file is flushed before switching
+    APSARA_TEST_TRUE(writer.Open(mFileName2));
+    APSARA_TEST_EQUAL(mFileName2, writer.GetFileName());
+    APSARA_TEST_EQUAL("first", ReadFile(mFileName));
+    APSARA_TEST_EQUAL(0, writer.GetFileSize());
+    APSARA_TEST_TRUE(writer.Append({StringView("second")}));
+    writer.Close();
+    APSARA_TEST_EQUAL("second", ReadFile(mFileName2));
+}
+
+void BufferFileUnittest::TestReader() {
+    BufferFileReader reader;
+    APSARA_TEST_FALSE(reader.Open(mFileName));
+    {
+        BufferFileWriter writer;
+        writer.Open(mFileName);
+        writer.Append({StringView("header"), StringView("0000"), StringView("data")});
+    }
+    APSARA_TEST_TRUE(reader.Open(mFileName));
+    APSARA_TEST_EQUAL(14, reader.GetFileSize());
+    APSARA_TEST_EQUAL("0000", std::string(reader.GetData(6, 4), 4));
+    APSARA_TEST_EQUAL("data", std::string(reader.GetData(10, 4), 4));
+    APSARA_TEST_TRUE(reader.GetData(14, 0) != nullptr);
+    APSARA_TEST_TRUE(reader.GetData(10, 5) == nullptr);
+    APSARA_TEST_TRUE(reader.GetData(15, 0) == nullptr);
+    APSARA_TEST_TRUE(reader.Write(6, "1111", 4));
+    reader.Close();
+    APSARA_TEST_EQUAL("header1111data", ReadFile(mFileName));
+}
+
+UNIT_TEST_CASE(BufferFileUnittest, TestAppend);
+UNIT_TEST_CASE(BufferFileUnittest, TestSwitchFile);
+UNIT_TEST_CASE(BufferFileUnittest, TestReader);
+
+} // namespace logtail
+
+int main(int argc, char** argv) {
+    logtail::Logger::Instance().InitGlobalLoggers();
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
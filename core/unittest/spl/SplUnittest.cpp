@@ -43,6 +43,7 @@ public:
     void TestRegexCSV();
 
     void TestTag();
+    void TestBatch();
     //void TestMultiParse();
 };
 
@@ -54,6 +55,7 @@ APSARA_UNIT_TEST_CASE(SplUnittest, TestRegexParse, 3);
 APSARA_UNIT_TEST_CASE(SplUnittest, TestRegexCSV, 4);
 APSARA_UNIT_TEST_CASE(SplUnittest, TestRegexKV, 5);
 APSARA_UNIT_TEST_CASE(SplUnittest, TestTag, 6);
+APSARA_UNIT_TEST_CASE(SplUnittest, TestBatch, 8);
 //APSARA_UNIT_TEST_CASE(SplUnittest, TestMultiParse, 7);
 
 
@@ -563,6 +565,64 @@ void SplUnittest::TestTag() {
 
 
 
+void SplUnittest::TestBatch() {
+    // make config
+    Json::Value config = GetCastConfig("* | where content='keep'");
+
+    // make events, groups of the same config are processed in a batch
+    std::vector<PipelineEventGroup> logGroupList;
+    for (size_t i = 0; i < 3; ++i) {
+        auto sourceBuffer = std::make_shared<SourceBuffer>();
+        PipelineEventGroup eventGroup(sourceBuffer);
+        std::string inJson = R"({
+            "events" :
+            [
+                {
+                    "contents" :
+                    {
+                        "content" : "keep"
+                    },
+                    "timestamp" : 1234567890,
+                    "timestampNanosecond" : 0,
+                    "type" : 1
+                },
+                {
+                    "contents" :
+                    {
+                        "content" : "drop"
+                    },
+                    "timestamp" : 1234567890,
+                    "timestampNanosecond" : 0,
+                    "type" : 1
+                }
+            ],
+            "tags" : {
+                "group": ")" + std::to_string(i) + R"("
+            }
+        })";
+        eventGroup.FromJsonString(inJson);
+        logGroupList.emplace_back(std::move(eventGroup));
+    }
+    // run function
+    ProcessorSPL& processor = *(new ProcessorSPL);
+    std::string pluginId = "testID";
+    ProcessorInstance processorInstance(&processor, pluginId);
+
+    APSARA_TEST_TRUE_FATAL(processorInstance.Init(config, mContext));
+    processor.Process(logGroupList);
+
+    // every group of the batch is processed, in order
+    APSARA_TEST_EQUAL_FATAL((u_int)3, logGroupList.size());
+    for (size_t i = 0; i < logGroupList.size(); ++i) {
+        auto& logGroup = logGroupList[i];
+        APSARA_TEST_EQUAL(std::to_string(i), logGroup.GetTag("group"));
+        APSARA_TEST_EQUAL_FATAL((u_int)1, logGroup.GetEvents().size());
+        const LogEvent* log = logGroup.GetEvents()[0].Get<LogEvent>();
+        APSARA_TEST_EQUAL("keep", log->GetContent("content"));
+    }
+}
+
+
 /*
 void SplUnittest::TestMultiParse() {
     // make config
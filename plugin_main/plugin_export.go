@@ -173,6 +173,16 @@ func ProcessLogGroup(configName string, logBytes []byte, packID string) int {
 	return config.ProcessLogGroup(logBytes, packID)
 }
 
+//export ProcessLogGroupColumns
+func ProcessLogGroupColumns(configName string, data []byte, strs []uint32, logs []uint32, groups []uint32) int {
+	config, exists := pluginmanager.LogtailConfig[configName]
+	if !exists {
+		logger.Debug(context.Background(), "config not found", configName)
+		return -1
+	}
+	return config.ProcessLogGroupColumns(data, strs, logs, groups)
+}
+
 //export HoldOn
 func HoldOn(exitFlag int) {
 	logger.Info(context.Background(), "Hold on", "start", "flag", exitFlag)
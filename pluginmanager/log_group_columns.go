@@ -0,0 +1,128 @@
+// Copyright 2024 iLogtail Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+package pluginmanager
+
+import (
+	"fmt"
+
+	"github.com/alibaba/ilogtail/pkg/protocol"
+)
+
+// Numbers of fields of each log and each log group in the columns passed by C++ core, the layout is described in
+// core/go_pipeline/LogGroupColumns.h and must be kept in sync with it.
+const (
+	logColumnFieldCount      = 5
+	logGroupColumnFieldCount = 7
+)
+
+// decodeLogGroupColumns builds log groups from the columns passed by C++ core, along with the pack id of each group.
+//
+// The columns are read in place. Since logs are processed after the cgo call returns, data is copied into Go memory
+// once, and all keys and values are substrings of the copy rather than allocated one by one.
+func decodeLogGroupColumns(data []byte, strs, logs, groups []uint32) ([]*protocol.LogGroup, []string, error) {
+	if len(strs)%2 != 0 || len(logs)%logColumnFieldCount != 0 || len(groups)%logGroupColumnFieldCount != 0 {
+		return nil, nil, fmt.Errorf("invalid column length, strings: %d, logs: %d, groups: %d",
+			len(strs), len(logs), len(groups))
+	}
+	strCount := uint64(len(strs) / 2)
+	for i := 0; i < len(strs); i += 2 {
+		if uint64(strs[i])+uint64(strs[i+1]) > uint64(len(data)) {
+			return nil, nil, fmt.Errorf("string %d out of range", i/2)
+		}
+	}
+	logCount := len(logs) / logColumnFieldCount
+	contentCount := 0
+	for i := 0; i < len(logs); i += logColumnFieldCount {
+		if uint64(logs[i])+2*uint64(logs[i+1]) > strCount {
+			return nil, nil, fmt.Errorf("contents of log %d out of range", i/logColumnFieldCount)
+		}
+		contentCount += int(logs[i+1])
+	}
+	groupCount := len(groups) / logGroupColumnFieldCount
+	tagCount := 0
+	for i := 0; i < len(groups); i += logGroupColumnFieldCount {
+		if uint64(groups[i])+uint64(groups[i+1]) > uint64(logCount) ||
+			uint64(groups[i+2])+2*uint64(groups[i+3]) > strCount ||
+			uint64(groups[i+4]) >= strCount || uint64(groups[i+5]) >= strCount || uint64(groups[i+6]) >= strCount {
+			return nil, nil, fmt.Errorf("log group %d out of range", i/logGroupColumnFieldCount)
+		}
+		tagCount += int(groups[i+3])
+	}
+
+	buf := string(data)
+	getString := func(i uint32) string {
+		return buf[strs[2*i] : strs[2*i]+strs[2*i+1]]
+	}
+
+	// objects are allocated in batches, and the slices handed out are capped so that appending to one never overwrites
+	// its neighbor
+	contents := make([]protocol.Log_Content, contentCount)
+	contentPtrs := make([]*protocol.Log_Content, contentCount)
+	logObjs := make([]protocol.Log, logCount)
+	logPtrs := make([]*protocol.Log, logCount)
+	timeNs := make([]uint32, logCount)
+	contentIdx := 0
+	for i := 0; i < logCount; i++ {
+		fields := logs[i*logColumnFieldCount : (i+1)*logColumnFieldCount]
+		log := &logObjs[i]
+		log.Time = fields[2]
+		if fields[4] != 0 {
+			timeNs[i] = fields[3]
+			log.TimeNs = &timeNs[i]
+		}
+		start := contentIdx
+		for j := uint32(0); j < fields[1]; j++ {
+			content := &contents[contentIdx]
+			content.Key = getString(fields[0] + 2*j)
+			content.Value = getString(fields[0] + 2*j + 1)
+			contentPtrs[contentIdx] = content
+			contentIdx++
+		}
+		if contentIdx > start {
+			log.Contents = contentPtrs[start:contentIdx:contentIdx]
+		}
+		logPtrs[i] = log
+	}
+
+	tags := make([]protocol.LogTag, tagCount)
+	tagPtrs := make([]*protocol.LogTag, tagCount)
+	logGroups := make([]*protocol.LogGroup, groupCount)
+	packIDs := make([]string, groupCount)
+	tagIdx := 0
+	for i := 0; i < groupCount; i++ {
+		fields := groups[i*logGroupColumnFieldCount : (i+1)*logGroupColumnFieldCount]
+		logGroup := &protocol.LogGroup{
+			Category: getString(fields[4]),
+			Topic:    getString(fields[5]),
+		}
+		if fields[1] > 0 {
+			logGroup.Logs = logPtrs[fields[0] : fields[0]+fields[1] : fields[0]+fields[1]]
+		}
+		start := tagIdx
+		for j := uint32(0); j < fields[3]; j++ {
+			tag := &tags[tagIdx]
+			tag.Key = getString(fields[2] + 2*j)
+			tag.Value = getString(fields[2] + 2*j + 1)
+			tagPtrs[tagIdx] = tag
+			tagIdx++
+		}
+		if tagIdx > start {
+			logGroup.LogTags = tagPtrs[start:tagIdx:tagIdx]
+		}
+		logGroups[i] = logGroup
+		packIDs[i] = getString(fields[6])
+	}
+	return logGroups, packIDs, nil
+}
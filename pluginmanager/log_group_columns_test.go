@@ -0,0 +1,162 @@
+// Copyright 2024 iLogtail Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+package pluginmanager
+
+import (
+	"strconv"
+	"testing"
+
+	"github.com/stretchr/testify/assert"
+	"github.com/stretchr/testify/require"
+
+	"github.com/alibaba/ilogtail/pkg/protocol"
+)
+
+// logGroupColumns is the same as LogGroupColumns in C++ core.
+type logGroupColumns struct {
+	data   []byte
+	strs   []uint32
+	logs   []uint32
+	groups []uint32
+}
+
+func (c *logGroupColumns) addString(s string) uint32 {
+	c.strs = append(c.strs, uint32(len(c.data)), uint32(len(s)))
+	c.data = append(c.data, s...)
+	return uint32(len(c.strs)/2 - 1)
+}
+
+func (c *logGroupColumns) add(logGroup *protocol.LogGroup, packID string) {
+	firstLog := uint32(len(c.logs) / logColumnFieldCount)
+	for _, log := range logGroup.Logs {
+		firstString := uint32(len(c.strs) / 2)
+		for _, content := range log.Contents {
+			c.addString(content.Key)
+			c.addString(content.Value)
+		}
+		var timeNs, hasTimeNs uint32
+		if log.TimeNs != nil {
+			timeNs, hasTimeNs = *log.TimeNs, 1
+		}
+		c.logs = append(c.logs, firstString, uint32(len(log.Contents)), log.Time, timeNs, hasTimeNs)
+	}
+	firstTag := uint32(len(c.strs) / 2)
+	for _, tag := range logGroup.LogTags {
+		c.addString(tag.Key)
+		c.addString(tag.Value)
+	}
+	c.groups = append(c.groups, firstLog, uint32(len(logGroup.Logs)), firstTag, uint32(len(logGroup.LogTags)),
+		c.addString(logGroup.Category), c.addString(logGroup.Topic), c.addString(packID))
+}
+
+func makeLogGroup(seq int, logCount int) *protocol.LogGroup {
+	logGroup := &protocol.LogGroup{
+		Category: "logstore",
+		Topic:    "topic-" + strconv.Itoa(seq),
+		LogTags: []*protocol.LogTag{
+			{Key: "__hostname__", Value: "host-192-168-0-1"},
+			{Key: "__path__", Value: "/var/log/app/app.log"},
+		},
+	}
+	for i := 0; i < logCount; i++ {
+		log := &protocol.Log{Time: uint32(1700000000 + i)}
+		if i%2 == 0 {
+			timeNs := uint32(i * 1000)
+			log.TimeNs = &timeNs
+		}
+		log.Contents = []*protocol.Log_Content{
+			{Key: "level", Value: "INFO"},
+			{Key: "thread", Value: "http-nio-8080-exec-" + strconv.Itoa(i%8)},
+			{Key: "logger", Value: "com.example.BookController"},
+			{Key: "message", Value: "request " + strconv.Itoa(seq*131+i) + " done, cost " + strconv.Itoa(i) + "ms"},
+		}
+		logGroup.Logs = append(logGroup.Logs, log)
+	}
+	return logGroup
+}
+
+func TestDecodeLogGroupColumns(t *testing.T) {
+	var columns logGroupColumns
+	expected := []*protocol.LogGroup{makeLogGroup(0, 10), makeLogGroup(1, 1), {Category: "logstore"}, makeLogGroup(3, 5)}
+	for i, logGroup := range expected {
+		columns.add(logGroup, "pack-"+strconv.Itoa(i))
+	}
+
+	logGroups, packIDs, err := decodeLogGroupColumns(columns.data, columns.strs, columns.logs, columns.groups)
+	require.NoError(t, err)
+	require.Len(t, logGroups, len(expected))
+	for i := range expected {
+		assert.Equal(t, expected[i].String(), logGroups[i].String())
+		assert.Equal(t, "pack-"+strconv.Itoa(i), packIDs[i])
+	}
+
+	// decoded logs do not share memory with the columns, and appending to one log does not affect others
+	for i := range columns.data {
+		columns.data[i] = 0
+	}
+	logGroups[0].Logs[0].Contents = append(logGroups[0].Logs[0].Contents, &protocol.Log_Content{Key: "k", Value: "v"})
+	assert.Equal(t, expected[0].Logs[1].String(), logGroups[0].Logs[1].String())
+	assert.Equal(t, expected[3].String(), logGroups[3].String())
+}
+
+func TestDecodeInvalidLogGroupColumns(t *testing.T) {
+	var columns logGroupColumns
+	columns.add(makeLogGroup(0, 2), "pack")
+
+	_, _, err := decodeLogGroupColumns(columns.data[:len(columns.data)-1], columns.strs, columns.logs, columns.groups)
+	assert.Error(t, err)
+	_, _, err = decodeLogGroupColumns(columns.data, columns.strs[:len(columns.strs)-2], columns.logs, columns.groups)
+	assert.Error(t, err)
+	_, _, err = decodeLogGroupColumns(columns.data, columns.strs, columns.logs[:logColumnFieldCount], columns.groups)
+	assert.Error(t, err)
+	_, _, err = decodeLogGroupColumns(columns.data, columns.strs, columns.logs, columns.groups[1:])
+	assert.Error(t, err)
+	logGroups, _, err := decodeLogGroupColumns(nil, nil, nil, nil)
+	assert.NoError(t, err)
+	assert.Empty(t, logGroups)
+}
+
+// The protobuf path, where a log group is marshalled by C++ core and unmarshalled here, compared with the columns.
+func BenchmarkUnmarshalLogGroups(b *testing.B) {
+	var buffers [][]byte
+	for i := 0; i < 16; i++ {
+		buf, _ := makeLogGroup(i, 64).Marshal()
+		buffers = append(buffers, buf)
+	}
+	b.ReportAllocs()
+	b.ResetTimer()
+	for i := 0; i < b.N; i++ {
+		for _, buf := range buffers {
+			logGroup := &protocol.LogGroup{}
+			if err := logGroup.Unmarshal(buf); err != nil {
+				b.Fatal(err)
+			}
+		}
+	}
+}
+
+func BenchmarkDecodeLogGroupColumns(b *testing.B) {
+	var columns logGroupColumns
+	for i := 0; i < 16; i++ {
+		columns.add(makeLogGroup(i, 64), "pack")
+	}
+	b.ReportAllocs()
+	b.ResetTimer()
+	for i := 0; i < b.N; i++ {
+		if _, _, err := decodeLogGroupColumns(columns.data, columns.strs, columns.logs, columns.groups); err != nil {
+			b.Fatal(err)
+		}
+	}
+}
@@ -347,6 +347,24 @@ func (lc *LogstoreConfig) ProcessLogGroup(logByte []byte, packID string) int {
 	return 0
 }
 
+// ProcessLogGroupColumns is the same as ProcessLogGroup, except that log groups are passed as columns.
+// unsafe parameter: data, strs, logs and groups
+func (lc *LogstoreConfig) ProcessLogGroupColumns(data []byte, strs, logs, groups []uint32) int {
+	logGroups, packIDs, err := decodeLogGroupColumns(data, strs, logs, groups)
+	if err != nil {
+		logger.Error(lc.Context.GetRuntimeContext(), "WRONG_PROTOBUF_ALARM",
+			"cannot process log group columns passed by core, err", err)
+		return -1
+	}
+	for i, logGroup := range logGroups {
+		lc.PluginRunner.ReceiveLogGroup(pipeline.LogGroupWithContext{
+			LogGroup: logGroup,
+			Context:  map[string]interface{}{ctxKeySource: packIDs[i]}},
+		)
+	}
+	return 0
+}
+
 func hasDockerStdoutInput(plugins map[string]interface{}) bool {
 	inputs, exists := plugins["inputs"]
 	if !exists {